@@ -0,0 +1,144 @@
+// 竞技场吞吐基准：在 size x size 的默认地图上分别放 100、500、1000... 条贪心蛇，
+// 单线程和并行决策各跑一轮，测量每秒推进的tick数和每个tick的延迟分位数，
+// 并与竞技场模式的目标（每秒至少 1000 tick）比较。
+//
+// 用法: ./arena_bench [--size N] [--ticks T] [--snakes K] [--threads N]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "arena.h"
+
+namespace
+{
+    const double kTargetTicksPerSecond = 1000.0;
+
+    struct BenchOptions
+    {
+        int size = 1000;
+        int ticks = 2000;
+        int warmup = 100;
+        int snakes = 0;         // 0 表示跑一组默认数量
+        int threads = 0;
+    };
+
+    struct BenchResult
+    {
+        double ticksPerSecond = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+        int alive = 0;
+    };
+
+    double percentile(std::vector<double>& samples, double p)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+
+    BenchResult runBench(const BenchOptions& options, const Map& map, int snakes, bool parallel)
+    {
+        ArenaConfig config;
+        config.numSnakes = snakes;
+        config.parallel = parallel;
+        config.numThreads = options.threads;
+        config.seed = 12345;
+        Arena arena(map, config);
+
+        for (int t = 0; t < options.warmup; t++)
+        {
+            arena.step();
+        }
+
+        std::vector<double> latencies;
+        latencies.reserve(options.ticks);
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point begin = Clock::now();
+        for (int t = 0; t < options.ticks; t++)
+        {
+            Clock::time_point start = Clock::now();
+            arena.step();
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        BenchResult result;
+        result.ticksPerSecond = seconds > 0.0 ? options.ticks / seconds : 0.0;
+        result.p50 = percentile(latencies, 0.50);
+        result.p99 = percentile(latencies, 0.99);
+        result.alive = arena.getAliveCount();
+        return result;
+    }
+
+    bool parseOptions(int argc, char** argv, BenchOptions& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--size") == 0 && hasValue)
+            {
+                options.size = std::max(16, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue)
+            {
+                options.ticks = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--snakes") == 0 && hasValue)
+            {
+                options.snakes = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+            {
+                options.threads = std::max(0, std::atoi(argv[++i]));
+            }
+            else
+            {
+                std::printf("usage: %s [--size N] [--ticks T] [--snakes K] [--threads N]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 2;
+    }
+
+    Map map(options.size, options.size);
+    map.loadDefaultMap();
+
+    std::vector<int> counts = {100, 500, 1000};
+    if (options.snakes > 0)
+    {
+        counts.assign(1, options.snakes);
+    }
+
+    std::printf("map=%dx%d ticks=%d target=%.0f ticks/s\n", options.size, options.size, options.ticks,
+                kTargetTicksPerSecond);
+    std::printf("  %7s %9s %12s %9s %9s %7s %s\n", "snakes", "decide", "ticks/s", "p50 us", "p99 us", "alive", "target");
+    bool allMet = true;
+    for (int snakes : counts)
+    {
+        for (bool parallel : {false, true})
+        {
+            BenchResult result = runBench(options, map, snakes, parallel);
+            const bool met = result.ticksPerSecond >= kTargetTicksPerSecond;
+            allMet = allMet && met;
+            std::printf("  %7d %9s %12.0f %9.1f %9.1f %7d %s\n", snakes, parallel ? "parallel" : "serial",
+                        result.ticksPerSecond, result.p50, result.p99, result.alive, met ? "ok" : "MISSED");
+        }
+    }
+    return allMet ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// 音频基准：不需要声卡。用WAV文件输出离线混音几段音效，检查输出长度并统计混音速度；
+// 再比较原来每次进入第四关时 popen("which ...") 查找播放器的开销和
+// 进程内 playMusic/stopMusic 提交命令的开销。
+//
+// 用法: ./audio_bench [--effect FILE] [--out FILE] [--runs R]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "audio_engine.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions
+    {
+        std::string effect = "assets/music/mode_select_click.wav";
+        std::string out = "audio_bench_out.wav";
+        int runs = 6;
+    };
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double medianOf(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples.empty() ? 0.0 : samples[samples.size() / 2];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--effect") == 0 && i + 1 < argc)
+        {
+            options.effect = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            options.out = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            options.runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--effect FILE] [--out FILE] [--runs R]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::unique_ptr<AudioDecoder> probe = AudioDecoder::open(options.effect);
+    if (!probe)
+    {
+        std::fprintf(stderr, "cannot decode %s\n", options.effect.c_str());
+        return 1;
+    }
+    size_t sourceFrames = 0;
+    std::vector<int16_t> scratch(4096 * probe->getChannels());
+    while (size_t frames = probe->read(scratch.data(), 4096))
+    {
+        sourceFrames += frames;
+    }
+    const double seconds = static_cast<double>(sourceFrames) / probe->getSampleRate();
+    std::printf("%s: %d Hz, %d ch, %.2f s\n", options.effect.c_str(), probe->getSampleRate(), probe->getChannels(), seconds);
+
+    // 离线混音：两段音效叠加，输出不按实际时长等待
+    {
+        AudioEngine engine(std::unique_ptr<AudioOutput>(new WavFileAudioOutput(options.out, false)));
+        Clock::time_point start = Clock::now();
+        engine.playEffect(options.effect);
+        engine.playEffect(options.effect, 0.5f);
+        engine.waitIdle();
+        const double mixMs = elapsedMs(start);
+        const double mixedSeconds = static_cast<double>(engine.getMixedFrames()) / AudioFormat().sampleRate;
+        std::printf("offline mix to %s: %.2f s of audio in %.1f ms (%.0fx realtime)\n",
+                    options.out.c_str(), mixedSeconds, mixMs, mixMs > 0.0 ? mixedSeconds * 1000.0 / mixMs : 0.0);
+        if (mixedSeconds + 0.05 < seconds)
+        {
+            std::fprintf(stderr, "mixed output shorter than the source\n");
+            return 1;
+        }
+    }
+
+    // 原来的做法：每个候选播放器一次 which
+    std::vector<double> forkSamples;
+    for (int run = 0; run < options.runs; run++)
+    {
+        Clock::time_point start = Clock::now();
+        FILE* pipe = popen("which mpg123 2>/dev/null", "r");
+        if (pipe)
+        {
+            char buffer[128];
+            while (fgets(buffer, sizeof(buffer), pipe))
+            {
+            }
+            pclose(pipe);
+        }
+        forkSamples.push_back(elapsedMs(start));
+    }
+
+    // 进程内：提交开始和停止命令，实时空输出
+    std::vector<double> submitSamples;
+    std::vector<double> applySamples;
+    {
+        AudioEngine engine(std::unique_ptr<AudioOutput>(new NullAudioOutput(true)));
+        for (int run = 0; run < options.runs; run++)
+        {
+            Clock::time_point start = Clock::now();
+            engine.playMusic(options.effect, true);
+            engine.stopMusic();
+            submitSamples.push_back(elapsedMs(start));
+            engine.waitIdle();
+            applySamples.push_back(engine.getLastCommandLatencyMs());
+        }
+    }
+    std::printf("popen(which) per player: median %.3f ms (the old level 4 entry ran up to 6, plus 6 pkill on exit)\n",
+                medianOf(forkSamples));
+    std::printf("playMusic+stopMusic submit: median %.4f ms, applied by the mixer after %.3f ms\n",
+                medianOf(submitSamples), medianOf(applySamples));
+    return 0;
+}
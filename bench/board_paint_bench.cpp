@@ -0,0 +1,246 @@
+// 棋盘绘制基准：在第四关地图（127x38）上用SnakeEnv推进对局，
+// 比较旧的每格一个QLabel加样式表的做法、BoardWidget整帧重绘和按tick增量只重绘变化格子，
+// 统计每帧耗时。每帧包含：推进一步、提交到界面、处理重绘。默认使用offscreen平台，无需显示器。
+//
+// 用法: ./board_paint_bench [--map FILE] [--frames N] [--legacy-frames N] [--cell PX]
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QLabel>
+#include <QVector>
+#include <QWidget>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "board_frame.h"
+#include "snake_env.h"
+#include "gui/board_widget.h"
+
+namespace
+{
+    struct BenchOptions
+    {
+        std::string map = "maps/level4.txt";
+        int frames = 300;
+        int legacyFrames = 20;
+        int cell = 20;
+    };
+
+    struct FrameStats
+    {
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double worst = 0.0;
+    };
+
+    FrameStats summarize(std::vector<double> samples)
+    {
+        FrameStats stats;
+        if (samples.empty())
+        {
+            return stats;
+        }
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double sample : samples)
+        {
+            total += sample;
+        }
+        stats.mean = total / samples.size();
+        stats.p50 = samples[samples.size() / 2];
+        stats.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        stats.worst = samples.back();
+        return stats;
+    }
+
+    void printStats(const char* name, int frames, const FrameStats& stats)
+    {
+        std::printf("%-18s frames %5d  mean %8.3f ms  p50 %8.3f ms  p99 %8.3f ms  max %8.3f ms\n",
+                    name, frames, stats.mean, stats.p50, stats.p99, stats.worst);
+    }
+
+    SnakeEnvConfig levelConfig(const BenchOptions& options)
+    {
+        SnakeEnvConfig config;
+        config.mapFile = options.map;
+        config.width = 127;
+        config.height = 38;
+        config.opponent = true;
+        config.lives = 1000;
+        config.opponentLives = 1000;
+        config.maxSteps = 0;
+        config.seed = 7;
+        return config;
+    }
+
+    int randomAction(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        // 大部分时间保持方向，偶尔转向
+        return (state % 8 == 0) ? static_cast<int>((state >> 8) % 4) : static_cast<int>(EnvAction::Keep);
+    }
+
+    // 改写前的渲染方式：每格一个QLabel，每帧按内容重设样式表
+    FrameStats runLegacy(const BenchOptions& options)
+    {
+        static const char* styles[] = {
+            "QLabel { background-color: white; border: 1px solid lightgray; }",
+            "QLabel { background-color: #888888; border: 1px solid #666666; }",
+            "QLabel { background-color: #0088CC; border: 1px solid #006699; }",
+            "QLabel { background-color: #00AAFF; border: 1px solid #0088CC; }",
+            "QLabel { background-color: #CC8800; border: 1px solid #996600; }",
+            "QLabel { background-color: #FFAA00; border: 1px solid #CC8800; }",
+            "QLabel { background-color: #FF5555; border: 1px solid #CC3333; }",
+            "QLabel { background-color: #FF00FF; border: 1px solid #CC00CC; }",
+            "QLabel { background-color: #AAFF00; border: 1px solid #88CC00; }",
+            "QLabel { background-color: #AA5555; border: 1px solid #884444; }",
+            "QLabel { background-color: #FFFF00; border: 1px solid #CCCC00; }",
+        };
+
+        SnakeEnv env(levelConfig(options));
+        BoardFrame frame;
+        env.writeBoard(frame);
+
+        QWidget board;
+        QGridLayout* layout = new QGridLayout(&board);
+        layout->setSpacing(1);
+        layout->setContentsMargins(0, 0, 0, 0);
+        QVector<QVector<QLabel*>> cells;
+        for (int y = 0; y < frame.height; y++)
+        {
+            QVector<QLabel*> row;
+            for (int x = 0; x < frame.width; x++)
+            {
+                QLabel* cell = new QLabel(&board);
+                cell->setFixedSize(options.cell, options.cell);
+                cell->setStyleSheet(styles[0]);
+                layout->addWidget(cell, y, x);
+                row.append(cell);
+            }
+            cells.append(row);
+        }
+        board.show();
+        QApplication::processEvents();
+
+        uint32_t rng = 12345;
+        std::vector<double> samples;
+        QElapsedTimer timer;
+        for (int i = 0; i < options.legacyFrames; i++)
+        {
+            timer.start();
+            env.step(randomAction(rng));
+            env.writeBoard(frame);
+            for (int y = 0; y < frame.height; y++)
+            {
+                for (int x = 0; x < frame.width; x++)
+                {
+                    cells[y][x]->setStyleSheet(styles[static_cast<int>(frame.at(x, y))]);
+                }
+            }
+            QApplication::processEvents();
+            board.repaint();
+            samples.push_back(timer.nsecsElapsed() / 1000000.0);
+        }
+        return summarize(samples);
+    }
+
+    struct PaintStats
+    {
+        double paintMs = 0.0;
+        double cellsPerFrame = 0.0;
+    };
+
+    FrameStats runBoardWidget(const BenchOptions& options, bool useDelta, PaintStats& paint)
+    {
+        SnakeEnv env(levelConfig(options));
+        BoardFrame frame;
+        env.writeBoard(frame);
+
+        BoardWidget board;
+        board.setFrame(frame);
+        board.resize(frame.width * options.cell, frame.height * options.cell);
+        board.show();
+        QApplication::processEvents();
+        board.resetPaintStats();
+
+        uint32_t rng = 12345;
+        std::vector<double> samples;
+        long long paintedCells = 0;
+        QElapsedTimer timer;
+        for (int i = 0; i < options.frames; i++)
+        {
+            const int paintsBefore = board.getPaintCount();
+            timer.start();
+            env.step(randomAction(rng));
+            if (!useDelta || !board.applyDelta(env.getBoardDelta()))
+            {
+                env.writeBoard(frame);
+                board.setFrame(frame);
+            }
+            // 增量模式下只有update()登记的区域会被重绘
+            QApplication::processEvents();
+            samples.push_back(timer.nsecsElapsed() / 1000000.0);
+            if (board.getPaintCount() != paintsBefore)
+            {
+                paintedCells += board.getLastPaintedCells();
+            }
+        }
+        paint.paintMs = board.getAveragePaintMs();
+        paint.cellsPerFrame = static_cast<double>(paintedCells) / options.frames;
+        return summarize(samples);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--map") == 0 && i + 1 < argc)
+        {
+            options.map = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--legacy-frames") == 0 && i + 1 < argc)
+        {
+            options.legacyFrames = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--cell") == 0 && i + 1 < argc)
+        {
+            options.cell = std::max(4, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--map FILE] [--frames N] [--legacy-frames N] [--cell PX]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    std::printf("map %s, cell %d px\n", options.map.c_str(), options.cell);
+    if (options.legacyFrames > 0)
+    {
+        printStats("QLabel grid", options.legacyFrames, runLegacy(options));
+    }
+    PaintStats full;
+    printStats("BoardWidget", options.frames, runBoardWidget(options, false, full));
+    PaintStats delta;
+    printStats("BoardWidget delta", options.frames, runBoardWidget(options, true, delta));
+    std::printf("paintEvent mean: full %.3f ms (%.0f cells/frame), delta %.3f ms (%.1f cells/frame)\n",
+                full.paintMs, full.cellsPerFrame, delta.paintMs, delta.cellsPerFrame);
+    return 0;
+}
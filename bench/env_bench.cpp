@@ -0,0 +1,199 @@
+// 批量环境吞吐基准：对 maps/ 下每张地图、有无AI对手、1,2,4...N 个线程分别测量
+// 每秒推进的局步数、相对单线程的扩展效率和每步延迟分位数。
+//
+// 用法: ./env_bench [--envs B] [--steps S] [--threads N] [--maps DIR]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "vec_env.h"
+
+namespace
+{
+    struct BenchOptions
+    {
+        int envs = 64;
+        int steps = 2000;
+        int warmup = 100;
+        int maxThreads = 0;
+        std::string mapDir = "maps";
+    };
+
+    struct BenchResult
+    {
+        double stepsPerSecond = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p99 = 0.0;
+    };
+
+    double percentile(std::vector<double>& samples, double p)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+
+    // 固定种子的随机动作，各轮之间完全一致
+    uint32_t nextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    BenchResult runBench(const BenchOptions& options, const std::string& mapFile, bool opponent, int threads)
+    {
+        VecEnvConfig config;
+        config.numEnvs = options.envs;
+        config.numThreads = threads;
+        config.env.mapFile = mapFile;
+        config.env.opponent = opponent;
+        config.env.lives = 3;
+        config.env.opponentLives = 3;
+        VecEnv vecEnv(config);
+
+        const int count = vecEnv.getNumEnvs();
+        std::vector<uint8_t> observations(static_cast<size_t>(vecEnv.getObservationSize()) * count);
+        std::vector<float> rewards(count);
+        std::vector<uint8_t> dones(count);
+        std::vector<int> actions(count);
+        uint32_t rng = 12345;
+
+        vecEnv.reset(observations.data());
+        std::vector<double> latencies;
+        latencies.reserve(options.steps);
+
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point begin = Clock::now();
+        for (int s = -options.warmup; s < options.steps; s++)
+        {
+            for (int& action : actions)
+            {
+                // 大多数时候保持方向，偶尔转弯，接近真实策略的存活时长
+                uint32_t roll = nextRandom(rng) % 16;
+                action = roll < 4 ? static_cast<int>(roll) : static_cast<int>(EnvAction::Keep);
+            }
+            if (s == 0)
+            {
+                begin = Clock::now();
+            }
+            Clock::time_point start = Clock::now();
+            vecEnv.step(actions.data(), observations.data(), rewards.data(), dones.data());
+            if (s >= 0)
+            {
+                latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        BenchResult result;
+        result.stepsPerSecond = seconds > 0.0 ? static_cast<double>(count) * options.steps / seconds : 0.0;
+        result.p50 = percentile(latencies, 0.50);
+        result.p90 = percentile(latencies, 0.90);
+        result.p99 = percentile(latencies, 0.99);
+        return result;
+    }
+
+    bool parseOptions(int argc, char** argv, BenchOptions& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--envs") == 0 && hasValue)
+            {
+                options.envs = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--steps") == 0 && hasValue)
+            {
+                options.steps = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+            {
+                options.maxThreads = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--maps") == 0 && hasValue)
+            {
+                options.mapDir = argv[++i];
+            }
+            else
+            {
+                std::printf("usage: %s [--envs B] [--steps S] [--threads N] [--maps DIR]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    int maxThreads = options.maxThreads;
+    if (maxThreads <= 0)
+    {
+        maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2)
+    {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    // 空字符串表示内置的默认地图
+    std::vector<std::string> maps;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(options.mapDir, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt")
+        {
+            maps.push_back(entry.path().string());
+        }
+    }
+    std::sort(maps.begin(), maps.end());
+    maps.insert(maps.begin(), std::string());
+
+    std::printf("envs=%d steps=%d threads<=%d (hardware %u)\n",
+                options.envs, options.steps, maxThreads, std::thread::hardware_concurrency());
+    std::printf("%-22s %-5s %7s %14s %10s %10s %10s %10s\n",
+                "map", "ai", "threads", "env-steps/s", "scaling", "p50(us)", "p90(us)", "p99(us)");
+
+    for (const std::string& map : maps)
+    {
+        for (int opponent = 0; opponent < 2; opponent++)
+        {
+            double baseline = 0.0;
+            for (int threads : threadCounts)
+            {
+                BenchResult result = runBench(options, map, opponent != 0, threads);
+                if (threads == threadCounts.front())
+                {
+                    baseline = result.stepsPerSecond;
+                }
+                // 扩展效率：相对单线程的加速比除以线程数
+                double efficiency = baseline > 0.0 ? result.stepsPerSecond / (baseline * threads) * 100.0 : 0.0;
+                std::printf("%-22s %-5s %7d %14.0f %9.1f%% %10.1f %10.1f %10.1f\n",
+                            map.empty() ? "(default)" : map.c_str(), opponent ? "yes" : "no", threads,
+                            result.stepsPerSecond, efficiency, result.p50, result.p90, result.p99);
+                std::fflush(stdout);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// 图片缩放基准：解码一张漫画，比较每次都从原图平滑缩放和从金字塔中不小于目标尺寸的
+// 最小一级缩放的耗时，目标尺寸覆盖两个漫画窗口和拖动窗口时的一串中间尺寸。
+// 同时给出建金字塔的一次性开销和金字塔占用的内存。
+//
+// 用法: ./image_pyramid_bench [--image FILE] [--runs R]
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QImageReader>
+#include <QSize>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gui/image_cache.h"
+
+namespace
+{
+    struct BenchOptions
+    {
+        std::string image = "assets/cartoon/0_0.png";
+        int runs = 5;
+    };
+
+    double medianOf(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples.empty() ? 0.0 : samples[samples.size() / 2];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--image") == 0 && i + 1 < argc)
+        {
+            options.image = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            options.runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--image FILE] [--runs R]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    QElapsedTimer timer;
+    timer.start();
+    QImageReader reader(QString::fromStdString(options.image));
+    reader.setAutoTransform(true);
+    QImage source = reader.read();
+    if (source.isNull())
+    {
+        std::fprintf(stderr, "cannot decode %s\n", options.image.c_str());
+        return 1;
+    }
+    source = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const double decodeMs = timer.nsecsElapsed() / 1000000.0;
+
+    timer.start();
+    const QVector<QImage> levels = ImageCache::buildPyramid(source);
+    const double buildMs = timer.nsecsElapsed() / 1000000.0;
+    long long bytes = 0;
+    for (const QImage& level : levels)
+    {
+        bytes += static_cast<long long>(level.bytesPerLine()) * level.height();
+    }
+    std::printf("%s %dx%d: decode %.1f ms, pyramid %d levels built in %.1f ms, %.1f MB\n",
+                options.image.c_str(), source.width(), source.height(), decodeMs,
+                static_cast<int>(levels.size()), buildMs, bytes / (1024.0 * 1024.0));
+
+    // 剧情窗口、漫画窗口，以及把漫画窗口从大拖到小时的几个中间尺寸
+    const QSize targets[] = {
+        QSize(600, 1000), QSize(1476, 904), QSize(1200, 760), QSize(900, 600), QSize(640, 420), QSize(320, 220),
+    };
+    std::printf("%-12s %14s %14s %8s\n", "target", "from source", "from pyramid", "speedup");
+    for (const QSize& target : targets)
+    {
+        std::vector<double> direct;
+        std::vector<double> pyramid;
+        for (int run = 0; run < options.runs; run++)
+        {
+            timer.start();
+            QImage a = source.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            direct.push_back(timer.nsecsElapsed() / 1000000.0);
+            timer.start();
+            QImage b = ImageCache::scaleFromPyramid(levels, target, Qt::KeepAspectRatio);
+            pyramid.push_back(timer.nsecsElapsed() / 1000000.0);
+            if (a.size() != b.size())
+            {
+                std::fprintf(stderr, "size mismatch at %dx%d\n", target.width(), target.height());
+                return 1;
+            }
+        }
+        const double directMs = medianOf(direct);
+        const double pyramidMs = medianOf(pyramid);
+        std::printf("%5dx%-6d %11.2f ms %11.2f ms %7.1fx\n", target.width(), target.height(),
+                    directMs, pyramidMs, pyramidMs > 0.0 ? directMs / pyramidMs : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+// 地图加载基准：生成若干张大尺寸文本地图，分别用旧的iostream逐个读取、
+// Map::loadTextMap（mmap + from_chars）和编译后的 .smap 加载，比较每次加载耗时。
+//
+// 用法: ./map_load_bench [--size N] [--maps K] [--runs R] [--dir DIR]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "map.h"
+
+namespace
+{
+    struct BenchOptions
+    {
+        int size = 1000;
+        int maps = 3;
+        int runs = 10;
+        std::string dir;
+    };
+
+    struct BenchResult
+    {
+        double best = 0.0;
+        double median = 0.0;
+    };
+
+    uint32_t nextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // 四周是墙，内部约15%的随机墙，少量食物格
+    bool generateMap(const std::string& path, int size, uint32_t seed)
+    {
+        std::ofstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        uint32_t rng = seed != 0 ? seed : 1;
+        std::string line;
+        line.reserve(static_cast<size_t>(size) * 2 + 1);
+        file << size << " " << size << "\n";
+        for (int y = 0; y < size; y++)
+        {
+            line.clear();
+            for (int x = 0; x < size; x++)
+            {
+                char tile = '0';
+                if (x == 0 || y == 0 || x == size - 1 || y == size - 1)
+                {
+                    tile = '1';
+                }
+                else
+                {
+                    uint32_t roll = nextRandom(rng) % 100;
+                    tile = roll < 15 ? '1' : (roll < 16 ? '2' : '0');
+                }
+                line.push_back(tile);
+                line.push_back(' ');
+            }
+            line.back() = '\n';
+            file << line;
+        }
+        return file.good();
+    }
+
+    // 改写前的加载方式：ifstream 逐个 >> 读整数
+    bool loadWithIostream(const std::string& path, std::vector<TileType>& tiles)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        int width, height;
+        file >> width >> height;
+        if (width <= 0 || height <= 0 || width > 1000 || height > 1000)
+        {
+            return false;
+        }
+        tiles.resize(static_cast<size_t>(width) * height);
+        for (TileType& tile : tiles)
+        {
+            int tileValue;
+            file >> tileValue;
+            tile = static_cast<TileType>(tileValue);
+        }
+        return true;
+    }
+
+    BenchResult measure(int runs, const std::function<bool()>& load)
+    {
+        std::vector<double> samples;
+        samples.reserve(runs);
+        // 预热一次，让文件进入页缓存
+        load();
+        for (int i = 0; i < runs; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (!load())
+            {
+                return BenchResult();
+            }
+            samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        BenchResult result;
+        result.best = samples.front();
+        result.median = samples[samples.size() / 2];
+        return result;
+    }
+
+    void printResult(const char* loader, const BenchResult& result, const BenchResult& baseline, double megabytes)
+    {
+        double speedup = result.median > 0.0 ? baseline.median / result.median : 0.0;
+        double throughput = result.median > 0.0 ? megabytes / (result.median / 1000.0) : 0.0;
+        std::printf("  %-14s %10.2f %10.2f %10.0f %8.1fx\n", loader, result.best, result.median, throughput, speedup);
+    }
+
+    bool parseOptions(int argc, char** argv, BenchOptions& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--size") == 0 && hasValue)
+            {
+                options.size = std::min(1000, std::max(3, std::atoi(argv[++i])));
+            }
+            else if (std::strcmp(argv[i], "--maps") == 0 && hasValue)
+            {
+                options.maps = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--runs") == 0 && hasValue)
+            {
+                options.runs = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--dir") == 0 && hasValue)
+            {
+                options.dir = argv[++i];
+            }
+            else
+            {
+                std::printf("usage: %s [--size N] [--maps K] [--runs R] [--dir DIR]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+    std::error_code error;
+    if (options.dir.empty())
+    {
+        options.dir = (std::filesystem::temp_directory_path(error) / "snake_map_bench").string();
+    }
+    std::filesystem::create_directories(options.dir, error);
+
+    std::printf("size=%dx%d maps=%d runs=%d dir=%s\n", options.size, options.size, options.maps, options.runs,
+                options.dir.c_str());
+    for (int m = 0; m < options.maps; m++)
+    {
+        const std::string textPath = options.dir + "/bench" + std::to_string(m) + ".txt";
+        const std::string compiledPath = Map::compiledMapPath(textPath);
+        if (!generateMap(textPath, options.size, 2024u + m))
+        {
+            std::printf("cannot write %s\n", textPath.c_str());
+            return 1;
+        }
+
+        Map map(1, 1);
+        if (!map.loadTextMap(textPath) || !map.saveCompiledMap(compiledPath))
+        {
+            std::printf("cannot prepare %s: %s\n", textPath.c_str(), map.getLastError().c_str());
+            return 1;
+        }
+        const double megabytes = static_cast<double>(std::filesystem::file_size(textPath, error)) / (1024.0 * 1024.0);
+
+        std::vector<TileType> tiles;
+        BenchResult iostream = measure(options.runs, [&]() { return loadWithIostream(textPath, tiles); });
+        BenchResult text = measure(options.runs, [&]() { return map.loadTextMap(textPath); });
+        BenchResult compiled = measure(options.runs, [&]() { return map.loadCompiledMap(compiledPath); });
+
+        std::printf("%s (%.1f MB text)\n", textPath.c_str(), megabytes);
+        std::printf("  %-14s %10s %10s %10s %9s\n", "loader", "best(ms)", "p50(ms)", "MB/s", "speedup");
+        printResult("iostream", iostream, iostream, megabytes);
+        printResult("loadTextMap", text, iostream, megabytes);
+        printResult("loadCompiled", compiled, iostream, megabytes);
+        std::fflush(stdout);
+
+        std::filesystem::remove(textPath, error);
+        std::filesystem::remove(compiledPath, error);
+    }
+    return 0;
+}
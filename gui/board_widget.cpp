@@ -0,0 +1,235 @@
+#include "gui/board_widget.h"
+#include <QElapsedTimer>
+#include <QRegion>
+#include <algorithm>
+#include <vector>
+
+BoardWidget::BoardWidget(QWidget *parent)
+    : QWidget(parent),
+      m_nCellSize(0),
+      m_dLastPaintMs(0.0),
+      m_dTotalPaintMs(0.0),
+      m_nPaintCount(0),
+      m_nLastPaintedCells(0)
+{
+    // 每次都会画满重绘区域，不需要Qt先擦背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setFocusPolicy(Qt::NoFocus);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    setupBrushes();
+}
+
+void BoardWidget::setupBrushes()
+{
+    // 与原先各格子样式表的颜色一致：填充色 + 1像素边框
+    struct TileColors
+    {
+        BoardCell cell;
+        const char* fill;
+        const char* border;
+    };
+    static const TileColors colors[] = {
+        {BoardCell::Empty,        "#FFFFFF", "#D3D3D3"},
+        {BoardCell::Wall,         "#888888", "#666666"},
+        {BoardCell::Head,         "#0088CC", "#006699"},
+        {BoardCell::Body,         "#00AAFF", "#0088CC"},
+        {BoardCell::OpponentHead, "#CC8800", "#996600"},
+        {BoardCell::OpponentBody, "#FFAA00", "#CC8800"},
+        {BoardCell::Food,         "#FF5555", "#CC3333"},
+        {BoardCell::SpecialFood,  "#FF00FF", "#CC00CC"},
+        {BoardCell::Poison,       "#AAFF00", "#88CC00"},
+        {BoardCell::CorpseFood,   "#AA5555", "#884444"},
+        {BoardCell::RandomItem,   "#FFFF00", "#CCCC00"},
+    };
+    for (const TileColors& tile : colors) {
+        int index = static_cast<int>(tile.cell);
+        m_aFillBrushes[index] = QBrush(QColor(tile.fill));
+        m_aBorderBrushes[index] = QBrush(QColor(tile.border));
+    }
+    m_aBackgroundBrush = QBrush(palette().color(QPalette::Window));
+}
+
+void BoardWidget::setFrame(const BoardFrame& frame)
+{
+    bool sizeChanged = frame.width != m_aFrame.width || frame.height != m_aFrame.height;
+    m_aFrame = frame;
+    if (sizeChanged) {
+        updateGeometry();
+        updateLayout();
+    }
+    update();
+}
+
+bool BoardWidget::applyDelta(const BoardDelta& delta)
+{
+    if (delta.full || m_aFrame.width <= 0 || m_nCellSize <= 0) {
+        return false;
+    }
+    m_aFrame.apply(delta);
+
+    const int count = static_cast<int>(delta.cells.size());
+    if (count <= kCoalesceThreshold) {
+        // 变化少时逐格提交，Qt会把它们合并成一个重绘区域
+        for (const BoardDeltaCell& change : delta.cells) {
+            update(cellRect(change.x, change.y));
+        }
+        return true;
+    }
+
+    // 合并：每行变化格子的最左到最右合成一个矩形（增量已按行列排好序），
+    // 变化的行再多就直接取外包矩形
+    std::vector<QRect> rows;
+    QRect bounds;
+    for (int i = 0; i < count; ) {
+        const int y = delta.cells[i].y;
+        int minX = delta.cells[i].x;
+        int maxX = minX;
+        for (; i < count && delta.cells[i].y == y; i++) {
+            minX = std::min<int>(minX, delta.cells[i].x);
+            maxX = std::max<int>(maxX, delta.cells[i].x);
+        }
+        QRect row = cellRect(minX, y).united(cellRect(maxX, y));
+        rows.push_back(row);
+        bounds = bounds.united(row);
+    }
+    if (static_cast<int>(rows.size()) > kCoalesceThreshold) {
+        update(bounds);
+    } else {
+        for (const QRect& row : rows) {
+            update(row);
+        }
+    }
+    return true;
+}
+
+void BoardWidget::setSnakeColors(const QColor& fill, const QColor& border)
+{
+    m_aFillBrushes[static_cast<int>(BoardCell::Body)] = QBrush(fill);
+    m_aBorderBrushes[static_cast<int>(BoardCell::Body)] = QBrush(border);
+    m_aFillBrushes[static_cast<int>(BoardCell::Head)] = QBrush(border);
+    m_aBorderBrushes[static_cast<int>(BoardCell::Head)] = QBrush(border.darker(130));
+    buildAtlas();
+    update();
+}
+
+double BoardWidget::getAveragePaintMs() const
+{
+    return m_nPaintCount > 0 ? m_dTotalPaintMs / m_nPaintCount : 0.0;
+}
+
+void BoardWidget::resetPaintStats()
+{
+    m_dLastPaintMs = 0.0;
+    m_dTotalPaintMs = 0.0;
+    m_nPaintCount = 0;
+}
+
+QSize BoardWidget::sizeHint() const
+{
+    if (m_aFrame.width <= 0 || m_aFrame.height <= 0) {
+        return QSize(30 * kPreferredCellSize, 20 * kPreferredCellSize);
+    }
+    return QSize(m_aFrame.width * kPreferredCellSize, m_aFrame.height * kPreferredCellSize);
+}
+
+QSize BoardWidget::minimumSizeHint() const
+{
+    return QSize(std::max(1, m_aFrame.width) * kMinimumCellSize, std::max(1, m_aFrame.height) * kMinimumCellSize);
+}
+
+void BoardWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updateLayout();
+}
+
+void BoardWidget::updateLayout()
+{
+    int cellSize = kPreferredCellSize;
+    if (m_aFrame.width > 0 && m_aFrame.height > 0) {
+        cellSize = std::min(width() / m_aFrame.width, height() / m_aFrame.height);
+        cellSize = std::max(cellSize, kMinimumCellSize);
+    }
+    m_aOrigin = QPoint((width() - m_aFrame.width * cellSize) / 2,
+                       (height() - m_aFrame.height * cellSize) / 2);
+    if (cellSize != m_nCellSize || m_aAtlas.isNull()) {
+        m_nCellSize = cellSize;
+        buildAtlas();
+    }
+}
+
+void BoardWidget::buildAtlas()
+{
+    if (m_nCellSize <= 0) {
+        return;
+    }
+    const qreal ratio = devicePixelRatioF();
+    const int tilePixels = qRound(m_nCellSize * ratio);
+    m_aAtlas = QPixmap(tilePixels * kTileCount, tilePixels);
+    m_aAtlas.setDevicePixelRatio(ratio);
+    m_aAtlas.fill(Qt::transparent);
+
+    QPainter painter(&m_aAtlas);
+    for (int i = 0; i < kTileCount; i++) {
+        QRectF tile(i * tilePixels / ratio, 0, tilePixels / ratio, tilePixels / ratio);
+        if (m_nCellSize >= 6) {
+            painter.fillRect(tile, m_aBorderBrushes[i]);
+            painter.fillRect(tile.adjusted(1, 1, -1, -1), m_aFillBrushes[i]);
+        } else {
+            // 格子太小时不画边框，避免整格都是边框色
+            painter.fillRect(tile, m_aFillBrushes[i]);
+        }
+        m_aTileSources[i] = QRect(i * tilePixels, 0, tilePixels, tilePixels);
+    }
+}
+
+QRect BoardWidget::cellRect(int x, int y) const
+{
+    return QRect(m_aOrigin.x() + x * m_nCellSize, m_aOrigin.y() + y * m_nCellSize, m_nCellSize, m_nCellSize);
+}
+
+int BoardWidget::paintCells(QPainter& painter, const QRect& area)
+{
+    // 只遍历与重绘区域相交的格子
+    const int firstX = (area.left() - m_aOrigin.x()) / m_nCellSize;
+    const int lastX = std::min(m_aFrame.width - 1, (area.right() - m_aOrigin.x()) / m_nCellSize);
+    const int firstY = (area.top() - m_aOrigin.y()) / m_nCellSize;
+    const int lastY = std::min(m_aFrame.height - 1, (area.bottom() - m_aOrigin.y()) / m_nCellSize);
+    for (int y = firstY; y <= lastY; y++) {
+        const BoardCell* row = m_aFrame.cells.data() + static_cast<size_t>(y) * m_aFrame.width;
+        for (int x = firstX; x <= lastX; x++) {
+            painter.drawPixmap(cellRect(x, y).topLeft(), m_aAtlas, m_aTileSources[static_cast<int>(row[x])]);
+        }
+    }
+    return std::max(0, lastX - firstX + 1) * std::max(0, lastY - firstY + 1);
+}
+
+void BoardWidget::paintEvent(QPaintEvent *event)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QPainter painter(this);
+    const QRect board(m_aOrigin, QSize(m_aFrame.width * m_nCellSize, m_aFrame.height * m_nCellSize));
+
+    // 棋盘外的留白
+    if (!board.contains(event->rect())) {
+        painter.fillRect(event->rect(), m_aBackgroundBrush);
+    }
+
+    // 按重绘区域中的每个矩形分别画，分散的几个格子不会扩大成整块外包矩形
+    int painted = 0;
+    if (!m_aAtlas.isNull()) {
+        for (const QRect& rect : event->region()) {
+            const QRect area = rect.intersected(board);
+            if (!area.isEmpty()) {
+                painted += paintCells(painter, area);
+            }
+        }
+    }
+
+    m_nLastPaintedCells = painted;
+    m_dLastPaintMs = timer.nsecsElapsed() / 1000000.0;
+    m_dTotalPaintMs += m_dLastPaintMs;
+    m_nPaintCount++;
+}
@@ -1,18 +1,25 @@
 #include "gui/cartoon_display_window.h"
+#include "gui/image_cache.h"
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QDebug>
 #include <QCoreApplication>
 #include <QDir>
+#include <QFile>
 
 CartoonDisplayWindow::CartoonDisplayWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_currentIndex(0)
     , m_hintTimer(new QTimer(this))
+    , m_resizeTimer(new QTimer(this))
     , m_pageSound(nullptr)
     , m_clickSound(nullptr)
 {
     setupUI();
+    connect(&ImageCache::shared(), &ImageCache::imageReady, this, &CartoonDisplayWindow::onImageReady);
+    m_resizeTimer->setSingleShot(true);
+    m_resizeTimer->setInterval(RESIZE_DEBOUNCE);
+    connect(m_resizeTimer, &QTimer::timeout, this, &CartoonDisplayWindow::showCurrentCartoon);
     setWindowTitle("漫画");
     setFixedSize(1536, 1024);
     
@@ -136,19 +143,62 @@ void CartoonDisplayWindow::showCurrentCartoon()
 
 void CartoonDisplayWindow::loadCartoon(const QString& path)
 {
-    if (QFile::exists(path)) {
-        QPixmap pixmap(path);
-        if (!pixmap.isNull()) {
-            QSize scrollAreaSize = m_scrollArea->size() - QSize(20, 20);
-            QPixmap scaledPixmap = pixmap.scaled(scrollAreaSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            m_cartoonLabel->setPixmap(scaledPixmap);
-        }
+    if (!QFile::exists(path)) {
+        showCartoonError(path);
+        return;
+    }
+    
+    // 解码和缩放都在后台完成，这里只查缓存；未命中时保留上一张，解码完成后在onImageReady中显示
+    const QSize size = cartoonSize();
+    QPixmap pixmap = ImageCache::shared().lookup(path, size);
+    if (!pixmap.isNull()) {
+        m_currentPixmap = pixmap;
+        m_cartoonLabel->setPixmap(m_currentPixmap);
     } else {
-        m_cartoonLabel->setText("无法加载漫画: " + path);
-        m_cartoonLabel->setStyleSheet("QLabel { color: red; font-size: 18px; background: black; }");
+        ImageCache::shared().request(path, size);
+    }
+    prefetchNeighbors();
+}
+
+void CartoonDisplayWindow::onImageReady(const QString& path, const QSize& size, bool ok)
+{
+    // 只处理当前这张，预取的结果留在缓存里
+    if (m_currentIndex < 0 || m_currentIndex >= m_cartoonPaths.size() ||
+        path != m_cartoonPaths[m_currentIndex] || size != cartoonSize()) {
+        return;
+    }
+    if (!ok) {
+        showCartoonError(path);
+        return;
+    }
+    QPixmap pixmap = ImageCache::shared().lookup(path, size);
+    if (!pixmap.isNull()) {
+        m_currentPixmap = pixmap;
+        m_cartoonLabel->setPixmap(m_currentPixmap);
     }
 }
 
+void CartoonDisplayWindow::showCartoonError(const QString& path)
+{
+    m_cartoonLabel->setText("无法加载漫画: " + path);
+    m_cartoonLabel->setStyleSheet("QLabel { color: red; font-size: 18px; background: black; }");
+}
+
+void CartoonDisplayWindow::prefetchNeighbors()
+{
+    const QSize size = cartoonSize();
+    for (int index : {m_currentIndex + 1, m_currentIndex - 1}) {
+        if (index >= 0 && index < m_cartoonPaths.size()) {
+            ImageCache::shared().request(m_cartoonPaths[index], size);
+        }
+    }
+}
+
+QSize CartoonDisplayWindow::cartoonSize() const
+{
+    return m_scrollArea->size() - QSize(20, 20);
+}
+
 void CartoonDisplayWindow::updateNavigationButtons()
 {
     m_previousButton->setEnabled(m_currentIndex > 0);
@@ -210,6 +260,15 @@ void CartoonDisplayWindow::hideEvent(QHideEvent *event)
     m_hintLabel->hide();
 }
 
+void CartoonDisplayWindow::resizeEvent(QResizeEvent *event)
+{
+    QMainWindow::resizeEvent(event);
+    // 拖动窗口时不逐帧缩放，尺寸稳定后按新尺寸从金字塔取一次，期间保留当前这张
+    if (!m_cartoonPaths.isEmpty()) {
+        m_resizeTimer->start();
+    }
+}
+
 void CartoonDisplayWindow::setupAudioEffects()
 {
     // 可以后续添加音效支持
@@ -2,7 +2,10 @@
 #include "gui/mode_select_window.h"
 #include "gui/story_level_window.h"
 #include "gui/story_display_window.h"
-#include <fstream>
+#include "gui/snake_game_window.h"
+#include "gui/image_cache.h"
+#include "gui/sound_bank.h"
+#include "profile_store.h"
 #include <QEventLoop>
 
 GUIManager::GUIManager(QObject *parent)
@@ -10,10 +13,12 @@ GUIManager::GUIManager(QObject *parent)
     , mModeSelectWindow(nullptr)
     , mStoryLevelWindow(nullptr)
     , mStoryDisplayWindow(nullptr)
+    , mSnakeGameWindow(nullptr)
     , mClassicModeSelected(false)
     , mExitRequested(false)
     , mSelectedLevel(0)
     , mShopRequested(false)
+    , mTerminalLevelRequested(false)
 {
     loadLevelProgress();
 }
@@ -25,7 +30,13 @@ GUIManager::~GUIManager()
 
 void GUIManager::start()
 {
+    // 音效在第一次悬停前就开始解码，之后所有窗口共用
+    SoundBank::shared().preload();
     showModeSelectWindow();
+    
+    // 模式选择界面显示期间在后台建好后续界面背景的金字塔，打开时只剩一次缩放
+    ImageCache::shared().preload("assets/images/worldmap.png");
+    ImageCache::shared().preload(QCoreApplication::applicationDirPath() + "/assets/images/storyboard.png");
 }
 
 bool GUIManager::isClassicModeSelected() const
@@ -43,6 +54,35 @@ bool GUIManager::isShopRequested() const
     return mShopRequested;
 }
 
+bool GUIManager::isTerminalLevelRequested() const
+{
+    return mTerminalLevelRequested;
+}
+
+void GUIManager::returnToModeSelect()
+{
+    mClassicModeSelected = false;
+    mExitRequested = false;
+    mShopRequested = false;
+    mTerminalLevelRequested = false;
+    
+    // 商店中可能改变了进度和道具，窗口、图片缓存和音效都沿用上次的
+    syncLevelProgress();
+    showModeSelectWindow();
+}
+
+void GUIManager::returnToStoryLevels()
+{
+    mClassicModeSelected = false;
+    mExitRequested = false;
+    mShopRequested = false;
+    mTerminalLevelRequested = false;
+    
+    // 终端中的关卡可能已经通关并解锁了下一关
+    syncLevelProgress();
+    showStoryLevelWindow();
+}
+
 int GUIManager::getSelectedLevel() const
 {
     return mSelectedLevel;
@@ -117,31 +157,20 @@ void GUIManager::showStoryLevelWindow()
 
 void GUIManager::loadLevelProgress()
 {
-    // 加载关卡进度，默认只解锁第一关
-    mUnlockedLevels = {1};
-    
-    // 尝试从二进制文件读取关卡进度（与Game类格式兼容）
-    std::fstream file("level_progress.dat", std::ios::binary | std::ios::in);
-    if (file.is_open()) {
-        mUnlockedLevels.clear();
-        
-        // 读取关卡状态（二进制格式）
-        int status;
-        int level = 1;
-        while (file.read(reinterpret_cast<char*>(&status), sizeof(status)) && level <= 5) {
-            // 0=Locked, 1=Unlocked, 2=Completed
-            if (status >= 1) { // Unlocked 或 Completed
-                mUnlockedLevels.push_back(level);
-            }
-            level++;
-        }
-        file.close();
-        
-        // 如果文件为空或没有有效关卡，至少解锁第一关
-        if (mUnlockedLevels.empty()) {
-            mUnlockedLevels.push_back(1);
+    // 关卡进度和ncurses一侧共用 ProfileStore 的内存缓存，默认只解锁第一关
+    mUnlockedLevels.clear();
+    const ProfileStore& profile = ProfileStore::shared();
+    for (int level = 1; level <= 5; level++) {
+        // 0=Locked, 1=Unlocked, 2=Completed
+        if (profile.get(ProfileKeys::level(level), level == 1 ? 1 : 0) >= 1) {
+            mUnlockedLevels.push_back(level);
         }
     }
+
+    // 没有有效关卡时至少解锁第一关
+    if (mUnlockedLevels.empty()) {
+        mUnlockedLevels.push_back(1);
+    }
 }
 
 void GUIManager::onStoryModeSelected()
@@ -285,7 +314,7 @@ void GUIManager::onLevelStoryFinished()
         if (mStoryDisplayWindow) {
             mStoryDisplayWindow->hide();
         }
-        QApplication::quit();
+        startSelectedLevel();
     }
 }
 
@@ -295,7 +324,62 @@ void GUIManager::onSkipLevelStoryToGame()
     if (mStoryDisplayWindow) {
         mStoryDisplayWindow->hide();
     }
-    QApplication::quit();
+    startSelectedLevel();
+}
+
+void GUIManager::startSelectedLevel()
+{
+    // Qt游戏窗口还不支持的关卡（第三关起各有专门玩法）退出事件循环，交给ncurses一侧的Game
+    if (!SnakeGameWindow::supportsLevel(mSelectedLevel)) {
+        mTerminalLevelRequested = true;
+        QApplication::quit();
+        return;
+    }
+    
+    // 其余关卡在本进程的Qt事件循环中进行，不切换到ncurses
+    if (!mSnakeGameWindow) {
+        mSnakeGameWindow = std::make_unique<SnakeGameWindow>();
+        
+        connect(mSnakeGameWindow.get(), &SnakeGameWindow::levelCompleted,
+                this, &GUIManager::onGameLevelCompleted);
+        connect(mSnakeGameWindow.get(), &SnakeGameWindow::gameExited,
+                this, &GUIManager::onGameExited);
+    }
+    
+    mSnakeGameWindow->startLevel(mSelectedLevel);
+}
+
+void GUIManager::saveLevelCompleted(int level)
+{
+    // 与Game一侧的LevelStatus取值一致：0=Locked, 1=Unlocked, 2=Completed
+    ProfileStore& profile = ProfileStore::shared();
+    ProfileStore::Transaction transaction;
+    transaction.set(ProfileKeys::level(level), 2);
+    if (level < 5 && profile.get(ProfileKeys::level(level + 1), 0) < 1) {
+        transaction.set(ProfileKeys::level(level + 1), 1);
+    }
+    profile.commit(transaction);
+    syncLevelProgress();
+}
+
+void GUIManager::onGameLevelCompleted(int level)
+{
+    saveLevelCompleted(level);
+    if (mSnakeGameWindow) {
+        mSnakeGameWindow->hide();
+    }
+    
+    // 第一关胜利后播放漫画，其余关卡回到关卡选择
+    if (level == 1) {
+        showCartoonAfterLevelVictory(level);
+    } else {
+        showStoryLevelWindow();
+    }
+}
+
+void GUIManager::onGameExited()
+{
+    showStoryLevelWindow();
 }
 
 // 新增：关卡胜利后显示漫画
@@ -323,11 +407,11 @@ void GUIManager::showCartoonAfterLevelVictory(int level)
 
 void GUIManager::onVictoryCartoonFinished()
 {
-    // 胜利漫画播放完成，退出Qt应用返回游戏主循环
+    // 胜利漫画播放完成，回到关卡选择
     if (mStoryDisplayWindow) {
         mStoryDisplayWindow->hide();
     }
-    QApplication::quit();
+    showStoryLevelWindow();
 }
 
 void GUIManager::onPrologueCartoonFinished()
@@ -341,11 +425,11 @@ void GUIManager::onPrologueCartoonFinished()
 
 void GUIManager::onLevel5CartoonFinished()
 {
-    // Level5漫画播放完成，退出Qt应用开始游戏
+    // Level5漫画播放完成，开始游戏
     if (mStoryDisplayWindow) {
         mStoryDisplayWindow->hide();
     }
-    QApplication::quit();
+    startSelectedLevel();
 }
 
 void GUIManager::showStoryDisplayWindow()
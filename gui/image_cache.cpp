@@ -0,0 +1,243 @@
+#include "gui/image_cache.h"
+#include <QImageReader>
+#include <QMetaObject>
+#include <QMetaType>
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace
+{
+    // 在线程池中解码原图并建金字塔，结果投递回缓存所在的GUI线程
+    class PyramidTask : public QRunnable
+    {
+    public:
+        PyramidTask(ImageCache* cache, const QString& path)
+            : m_pCache(cache), m_sPath(path)
+        {
+        }
+
+        void run() override
+        {
+            QImageReader reader(m_sPath);
+            reader.setAutoTransform(true);
+            QVector<QImage> levels = ImageCache::buildPyramid(reader.read());
+            QMetaObject::invokeMethod(m_pCache, "onPyramidBuilt", Qt::QueuedConnection,
+                                      Q_ARG(QString, m_sPath), Q_ARG(QVector<QImage>, levels));
+        }
+
+    private:
+        ImageCache* m_pCache;       // 共用缓存在进程结束前一直存在
+        QString m_sPath;
+    };
+
+    // 在线程池中从金字塔缩放出一个尺寸
+    class ScaleTask : public QRunnable
+    {
+    public:
+        ScaleTask(ImageCache* cache, const QString& path, const QVector<QImage>& levels,
+                  const QSize& size, Qt::AspectRatioMode mode)
+            : m_pCache(cache), m_sPath(path), m_aLevels(levels), m_aSize(size), m_eMode(mode)
+        {
+        }
+
+        void run() override
+        {
+            QImage image = ImageCache::scaleFromPyramid(m_aLevels, m_aSize, m_eMode);
+            QMetaObject::invokeMethod(m_pCache, "onDecoded", Qt::QueuedConnection,
+                                      Q_ARG(QString, m_sPath), Q_ARG(QSize, m_aSize),
+                                      Q_ARG(int, static_cast<int>(m_eMode)), Q_ARG(QImage, image));
+        }
+
+    private:
+        ImageCache* m_pCache;
+        QString m_sPath;
+        QVector<QImage> m_aLevels;  // QImage隐式共享，引用计数是原子的，跨线程只读没有问题
+        QSize m_aSize;
+        Qt::AspectRatioMode m_eMode;
+    };
+}
+
+ImageCache& ImageCache::shared()
+{
+    static ImageCache cache;
+    return cache;
+}
+
+ImageCache::ImageCache(QObject *parent)
+    : QObject(parent)
+    , m_nHits(0)
+    , m_nMisses(0)
+    , m_nPyramidBuilds(0)
+{
+    qRegisterMetaType<QVector<QImage>>("QVector<QImage>");
+
+    // 内存较小的机器可以用环境变量调低预算
+    const int budgetMb = qEnvironmentVariableIntValue("SNAKE_IMAGE_CACHE_MB");
+    if (budgetMb > 0) {
+        setBudgetBytes(qMin(budgetMb, 1024) * 1024 * 1024);
+    } else {
+        setBudgetBytes(kDefaultBudgetBytes);
+    }
+}
+
+QString ImageCache::cacheKey(const QString& path, const QSize& size, Qt::AspectRatioMode mode)
+{
+    return path + QLatin1Char('@') + QString::number(size.width()) + QLatin1Char('x') + QString::number(size.height())
+        + QLatin1Char('/') + QString::number(static_cast<int>(mode));
+}
+
+int ImageCache::costOf(const QVector<QImage>& levels)
+{
+    qint64 bytes = 0;
+    for (const QImage& level : levels) {
+        bytes += static_cast<qint64>(level.bytesPerLine()) * level.height();
+    }
+    return qMax(1, static_cast<int>(bytes / 1024));
+}
+
+QVector<QImage> ImageCache::buildPyramid(const QImage& source)
+{
+    QVector<QImage> levels;
+    if (source.isNull()) {
+        return levels;
+    }
+    // 绘制时不再需要格式转换
+    levels.append(source.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    while (qMin(levels.last().width(), levels.last().height()) / 2 >= kMinLevelSide) {
+        const QImage& previous = levels.last();
+        levels.append(previous.scaled(previous.width() / 2, previous.height() / 2,
+                                      Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+    return levels;
+}
+
+QImage ImageCache::scaleFromPyramid(const QVector<QImage>& levels, const QSize& size, Qt::AspectRatioMode mode)
+{
+    if (levels.isEmpty()) {
+        return QImage();
+    }
+    if (!size.isValid()) {
+        return levels.first();
+    }
+    // 目标尺寸按原图宽高比算，避免各级取整误差带到结果里
+    const QSize target = levels.first().size().scaled(size, mode);
+    int chosen = 0;
+    for (int i = 1; i < levels.size(); i++) {
+        if (levels[i].width() < target.width() || levels[i].height() < target.height()) {
+            break;
+        }
+        chosen = i;
+    }
+    const QImage& level = levels[chosen];
+    if (level.size() == target) {
+        return level;
+    }
+    return level.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+QPixmap ImageCache::lookup(const QString& path, const QSize& size, Qt::AspectRatioMode mode)
+{
+    const QString key = cacheKey(path, size, mode);
+    QPixmap* pixmap = m_aCache.object(key);
+    if (pixmap) {
+        m_nHits++;
+        return *pixmap;
+    }
+    if (!m_aOversized.isNull() && m_sOversizedKey == key) {
+        m_nHits++;
+        return m_aOversized;
+    }
+    m_nMisses++;
+    return QPixmap();
+}
+
+void ImageCache::request(const QString& path, const QSize& size, Qt::AspectRatioMode mode)
+{
+    const QString key = cacheKey(path, size, mode);
+    if (m_aCache.contains(key) || m_aPending.contains(key) || (!m_aOversized.isNull() && m_sOversizedKey == key)) {
+        return;
+    }
+    const ScaleRequest scale = {size, mode};
+    Pyramid* pyramid = m_aPyramids.object(path);
+    if (pyramid) {
+        startScale(path, pyramid->levels, scale);
+        return;
+    }
+    // 同一张图的金字塔只建一次，建好前的请求都排在后面
+    m_aPending.insert(key);
+    const bool building = m_aWaiting.contains(path);
+    m_aWaiting[path].append(scale);
+    if (!building) {
+        QThreadPool::globalInstance()->start(new PyramidTask(this, path));
+    }
+}
+
+bool ImageCache::isPending(const QString& path, const QSize& size, Qt::AspectRatioMode mode) const
+{
+    return m_aPending.contains(cacheKey(path, size, mode));
+}
+
+void ImageCache::preload(const QString& path)
+{
+    if (m_aPyramids.contains(path) || m_aWaiting.contains(path)) {
+        return;
+    }
+    m_aWaiting.insert(path, QList<ScaleRequest>());
+    QThreadPool::globalInstance()->start(new PyramidTask(this, path));
+}
+
+void ImageCache::setBudgetBytes(int bytes)
+{
+    const int budgetKb = qMax(2, bytes / 1024);
+    m_aPyramids.setMaxCost(budgetKb * 3 / 4);
+    m_aCache.setMaxCost(budgetKb - m_aPyramids.maxCost());
+}
+
+int ImageCache::getBudgetBytes() const
+{
+    return (m_aPyramids.maxCost() + m_aCache.maxCost()) * 1024;
+}
+
+void ImageCache::startScale(const QString& path, const QVector<QImage>& levels, const ScaleRequest& scale)
+{
+    m_aPending.insert(cacheKey(path, scale.size, scale.mode));
+    QThreadPool::globalInstance()->start(new ScaleTask(this, path, levels, scale.size, scale.mode));
+}
+
+void ImageCache::onPyramidBuilt(const QString& path, const QVector<QImage>& levels)
+{
+    const QList<ScaleRequest> waiting = m_aWaiting.take(path);
+    if (levels.isEmpty()) {
+        for (const ScaleRequest& scale : waiting) {
+            m_aPending.remove(cacheKey(path, scale.size, scale.mode));
+            emit imageReady(path, scale.size, false);
+        }
+        return;
+    }
+    m_nPyramidBuilds++;
+    // 超出预算时QCache会直接丢弃，等待中的请求仍然用这里的一份缩放，下次再用到时重新解码
+    m_aPyramids.insert(path, new Pyramid{levels}, costOf(levels));
+    for (const ScaleRequest& scale : waiting) {
+        startScale(path, levels, scale);
+    }
+}
+
+void ImageCache::onDecoded(const QString& path, const QSize& size, int mode, const QImage& image)
+{
+    const QString key = cacheKey(path, size, static_cast<Qt::AspectRatioMode>(mode));
+    m_aPending.remove(key);
+    if (image.isNull()) {
+        emit imageReady(path, size, false);
+        return;
+    }
+    // 代价按KB计；单张超过预算时QCache会直接丢弃，这张图不进缓存，只作为当前显示的图单独保留，
+    // 下一张超预算的图会替换它，预算本身不变
+    const int cost = qMax(1, image.width() * image.height() * 4 / 1024);
+    if (cost > m_aCache.maxCost()) {
+        m_sOversizedKey = key;
+        m_aOversized = QPixmap::fromImage(image);
+    } else {
+        m_aCache.insert(key, new QPixmap(QPixmap::fromImage(image)), cost);
+    }
+    emit imageReady(path, size, true);
+}
@@ -1,4 +1,5 @@
 #include "gui/mode_select_window.h"
+#include "gui/sound_bank.h"
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QSizePolicy>
@@ -19,14 +20,9 @@ ModeSelectWindow::ModeSelectWindow(QWidget *parent)
     , exitButton(nullptr)
     , mainLayout(nullptr)
     , buttonLayout(nullptr)
-    , hoverSound(nullptr)
-    , clickSound(nullptr)
-    , backgroundMusic(nullptr)
 {
     setupUI();
     setupBackgroundImage();
-    setupAudioEffects();
-    setupBackgroundMusic();
 }
 
 ModeSelectWindow::~ModeSelectWindow()
@@ -52,9 +48,8 @@ void ModeSelectWindow::setupUI()
     setCentralWidget(centralWidget);
     
     // 创建背景标签
-    backgroundLabel = new QLabel(centralWidget);
+    backgroundLabel = new ScaledImageLabel(centralWidget);
     backgroundLabel->setGeometry(0, 0, 1536, 1175);
-    backgroundLabel->setScaledContents(true);
     
     // 创建按钮
     directionButton = new QPushButton("Direction", centralWidget);
@@ -106,14 +101,10 @@ void ModeSelectWindow::setupUI()
 
 void ModeSelectWindow::setupBackgroundImage()
 {
-    // 加载背景图片
-    QPixmap background("assets/images/modeselect.png");
-    if (background.isNull()) {
-        // 如果图片加载失败，设置默认背景色
-        backgroundLabel->setStyleSheet("background-color: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #2C3E50, stop:1 #34495E);");
-    } else {
-        backgroundLabel->setPixmap(background);
-    }
+    // 默认背景色在图片解码完成前显示，图片加载失败时保留
+    backgroundLabel->setStyleSheet("background-color: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #2C3E50, stop:1 #34495E);");
+    // 背景图片在后台解码并缩放到标签尺寸
+    backgroundLabel->setImagePaths({"assets/images/modeselect.png"});
 }
 
 void ModeSelectWindow::onDirectionClicked()
@@ -140,94 +131,24 @@ void ModeSelectWindow::onExitClicked()
     emit exitGameRequested();
 }
 
-void ModeSelectWindow::setupAudioEffects()
-{
-    // 获取程序所在目录的绝对路径
-    QString appDir = QCoreApplication::applicationDirPath();
-    
-    // 初始化悬停音效
-    hoverSound = new QSoundEffect(this);
-    QString hoverSoundPath = appDir + "/assets/music/mode_select_hover.wav";
-    hoverSound->setSource(QUrl::fromLocalFile(hoverSoundPath));
-    hoverSound->setVolume(0.7);  // 设置音量为70%
-    
-    // 初始化点击音效
-    clickSound = new QSoundEffect(this);
-    QString clickSoundPath = appDir + "/assets/music/mode_select_click.wav";
-    clickSound->setSource(QUrl::fromLocalFile(clickSoundPath));
-    clickSound->setVolume(0.8);  // 设置音量为80%
-    
-    // 检查音效是否加载成功
-    if (hoverSound->status() != QSoundEffect::Ready) {
-        qDebug() << "悬停音效加载失败:" << hoverSoundPath;
-    }
-    if (clickSound->status() != QSoundEffect::Ready) {
-        qDebug() << "点击音效加载失败:" << clickSoundPath;
-    }
-}
-
-void ModeSelectWindow::setupBackgroundMusic()
-{
-    // 获取程序所在目录的绝对路径
-    QString appDir = QCoreApplication::applicationDirPath();
-    QString musicPath = appDir + "/assets/music/mode_background.mp3";
-    
-    // 初始化背景音乐
-    backgroundMusic = new QMediaPlayer(this);
-    backgroundMusic->setMedia(QUrl::fromLocalFile(musicPath));
-    backgroundMusic->setVolume(80);  // 设置音量为80%
-    
-    // 设置循环播放
-    connect(backgroundMusic, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
-        if (state == QMediaPlayer::StoppedState) {
-            backgroundMusic->play();  // 播放结束时重新开始
-        }
-    });
-    
-    // 检查音乐是否加载成功
-    if (backgroundMusic->error() != QMediaPlayer::NoError) {
-        qDebug() << "背景音乐加载失败:" << backgroundMusic->errorString() << "路径:" << musicPath;
-    } else {
-        qDebug() << "模式选择背景音乐加载成功:" << musicPath;
-    }
-}
-
 void ModeSelectWindow::startBackgroundMusic()
 {
-    if (backgroundMusic && backgroundMusic->error() == QMediaPlayer::NoError) {
-        // 重新连接循环播放的信号
-        connect(backgroundMusic, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
-            if (state == QMediaPlayer::StoppedState) {
-                backgroundMusic->play();  // 播放结束时重新开始
-            }
-        });
-        backgroundMusic->play();
-        qDebug() << "开始播放模式选择背景音乐";
-    }
+    SoundBank::shared().playMusic(SoundBank::Music::ModeSelect, 80);
 }
 
 void ModeSelectWindow::stopBackgroundMusic()
 {
-    if (backgroundMusic && backgroundMusic->state() == QMediaPlayer::PlayingState) {
-        // 先断开循环播放的连接，防止stop()后立即重新播放
-        backgroundMusic->disconnect();
-        backgroundMusic->stop();
-        qDebug() << "停止播放模式选择背景音乐";
-    }
+    SoundBank::shared().stopMusic(SoundBank::Music::ModeSelect);
 }
 
 void ModeSelectWindow::playHoverSound()
 {
-    if (hoverSound && hoverSound->status() == QSoundEffect::Ready) {
-        hoverSound->play();
-    }
+    SoundBank::shared().play(SoundBank::Effect::Hover, 0.7);
 }
 
 void ModeSelectWindow::playClickSound()
 {
-    if (clickSound && clickSound->status() == QSoundEffect::Ready) {
-        clickSound->play();
-    }
+    SoundBank::shared().play(SoundBank::Effect::Click, 0.8);
 }
 
 bool ModeSelectWindow::eventFilter(QObject *obj, QEvent *event)
@@ -0,0 +1,62 @@
+#include "gui/perf_overlay.h"
+#include <QFont>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QString>
+#include <QStringList>
+
+PerfOverlay::PerfOverlay(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setFocusPolicy(Qt::NoFocus);
+
+    QFont monoFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    monoFont.setPointSize(9);
+    setFont(monoFont);
+
+    // 按最长的一行定尺寸，之后内容变化不再改变大小
+    const QFontMetrics metrics(monoFont);
+    resize(metrics.horizontalAdvance(QStringLiteral("tps 100.0  drop 00000 ")) + 2 * kPadding,
+           metrics.lineSpacing() * kLineCount + 2 * kPadding);
+}
+
+void PerfOverlay::setSummary(const FrameStatsSummary& summary)
+{
+    m_aSummary = summary;
+    update();
+}
+
+void PerfOverlay::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 170));
+    painter.drawRoundedRect(rect(), 6, 6);
+
+    const char* phaseNames[] = {"in", "ai", "sim", "spw", "rnd"};
+    auto pair = [](const FrameStatsSummary::Percentiles& value) {
+        return QString::asprintf("%5.2f/%5.2f", value.p50, value.p99);
+    };
+
+    QStringList lines;
+    lines << QStringLiteral("F3  p50/p99 ms (%1)").arg(m_aSummary.samples);
+    for (int i = 0; i < static_cast<int>(FramePhase::Count); i++) {
+        lines << QString::asprintf("%-4s", phaseNames[i]) + pair(m_aSummary.phases[i]);
+    }
+    lines << QStringLiteral("tick") + pair(m_aSummary.frame);
+    lines << QString::asprintf("tps %5.1f  drop %llu", m_aSummary.fps,
+                               static_cast<unsigned long long>(m_aSummary.dropped));
+    lines << QString::asprintf("alloc/tick %.1f", m_aSummary.allocationsPerFrame);
+
+    const QFontMetrics metrics(font());
+    painter.setPen(QColor(120, 255, 120));
+    int y = kPadding + metrics.ascent();
+    for (const QString& line : lines) {
+        painter.drawText(kPadding, y, line);
+        y += metrics.lineSpacing();
+    }
+}
@@ -0,0 +1,70 @@
+#include "gui/scaled_image_label.h"
+#include "gui/image_cache.h"
+
+ScaledImageLabel::ScaledImageLabel(QWidget *parent)
+    : QLabel(parent)
+    , m_nPathIndex(0)
+    , m_eMode(Qt::IgnoreAspectRatio)
+    , m_pResizeTimer(new QTimer(this))
+{
+    m_pResizeTimer->setSingleShot(true);
+    m_pResizeTimer->setInterval(kResizeDebounceMs);
+    connect(m_pResizeTimer, &QTimer::timeout, this, [this]() { requestImage(); });
+    connect(&ImageCache::shared(), &ImageCache::imageReady, this,
+            [this](const QString& path, const QSize& size, bool ok) { onImageReady(path, size, ok); });
+}
+
+void ScaledImageLabel::setImagePaths(const QStringList& paths)
+{
+    m_aPaths = paths;
+    m_nPathIndex = 0;
+    requestImage();
+}
+
+void ScaledImageLabel::setAspectRatioMode(Qt::AspectRatioMode mode)
+{
+    if (m_eMode != mode) {
+        m_eMode = mode;
+        requestImage();
+    }
+}
+
+void ScaledImageLabel::resizeEvent(QResizeEvent *event)
+{
+    QLabel::resizeEvent(event);
+    // 拖动窗口时每一帧都会触发，停下来之后才缩放一次
+    if (!m_aPaths.isEmpty()) {
+        m_pResizeTimer->start();
+    }
+}
+
+void ScaledImageLabel::requestImage()
+{
+    if (m_nPathIndex >= m_aPaths.size() || size().isEmpty()) {
+        return;
+    }
+    const QString& path = m_aPaths[m_nPathIndex];
+    QPixmap pixmap = ImageCache::shared().lookup(path, size(), m_eMode);
+    if (!pixmap.isNull()) {
+        setPixmap(pixmap);
+    } else {
+        ImageCache::shared().request(path, size(), m_eMode);
+    }
+}
+
+void ScaledImageLabel::onImageReady(const QString& path, const QSize& size, bool ok)
+{
+    if (m_nPathIndex >= m_aPaths.size() || path != m_aPaths[m_nPathIndex] || size != this->size()) {
+        return;
+    }
+    if (!ok) {
+        m_nPathIndex++;
+        requestImage();
+        return;
+    }
+    // 同一路径同一尺寸可能是别的窗口按另一种模式请求的，那时继续等自己的结果
+    QPixmap pixmap = ImageCache::shared().lookup(path, size, m_eMode);
+    if (!pixmap.isNull()) {
+        setPixmap(pixmap);
+    }
+}
@@ -1,30 +1,74 @@
 #include "gui/snake_game_window.h"
+#include "profile_store.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QMessageBox>
 #include <QApplication>
 #include <QFont>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 能在Qt窗口中进行的关卡：只有第一、二关是Game::runLevel的普通玩法。地图、目标分数、
+    // 一条命（撞上即失败）、起始速度、第二关的30秒限时和adjustDelay的加速曲线与
+    // Game::initializeLevel/runLevel一致；Qt窗口没有道具栏，不生成随机道具，也就没有护盾。
+    // 第三关（独自/协作选择和镜像蛇）、第四关（音乐和单键转向）和第五关（Boss战）
+    // 由Game各自的循环实现，仍在ncurses中进行
+    struct LevelRule
+    {
+        const char* mapFile;
+        int width;
+        int height;
+        int targetPoints;
+        int tickMs;             // 起始tick间隔
+        int timeLimitSeconds;   // 0 表示不限时
+    };
+
+    const LevelRule kLevelRules[] = {
+        {"maps/level1.txt", 62, 18, 100, 100, 0},
+        {"maps/level2.txt", 62, 18, 5,   200, 30},  // 速度关：Game中为 mBaseDelay * 2
+    };
+    const int kLevelCount = sizeof(kLevelRules) / sizeof(kLevelRules[0]);
+
+    // Game::adjustDelay 的参数
+    const int kBaseTickMs = 100;
+    const int kMinTickMs = 30;
+    const int kMaxDifficulty = 10;
+}
 
 SnakeGameWindow::SnakeGameWindow(QWidget *parent)
-    : QMainWindow(parent), m_bGameRunning(false)
+    : QMainWindow(parent),
+      m_nNextTickAt(0),
+      m_nTickMs(100),
+      m_bGameRunning(false),
+      m_bPaused(false),
+      m_bLevelCompleted(false),
+      m_bLevelMode(false),
+      m_nCurrentLevel(0),
+      m_nTargetPoints(0),
+      m_nDeadlineAt(0),
+      m_nPausedAt(0),
+      m_bTimeUp(false),
+      m_pPerfOverlay(nullptr),
+      m_dPaintMsMark(0.0)
 {
     // 设置窗口属性
     setWindowTitle("贪吃蛇游戏");
     resize(800, 600);
     setFocusPolicy(Qt::StrongFocus);
-    
-    // 初始化定时器
+
+    // 初始化定时器：单次触发，每个tick结束后按截止时间重新设定
     m_aGameTimer = new QTimer(this);
+    m_aGameTimer->setSingleShot(true);
+    m_aGameTimer->setTimerType(Qt::PreciseTimer);
     connect(m_aGameTimer, &QTimer::timeout, this, &SnakeGameWindow::updateGame);
-    
-    // 设置默认游戏区域尺寸
-    m_nGameBoardWidth = 30;
-    m_nGameBoardHeight = 20;
-    
+
     // 初始化UI
     initializeUI();
-    
+
     // 初始化颜色样式
     setupColorStyles();
 }
@@ -34,13 +78,6 @@ SnakeGameWindow::~SnakeGameWindow()
     if (m_aGameTimer->isActive()) {
         m_aGameTimer->stop();
     }
-    
-    // 清理cells
-    for (int i = 0; i < m_aCells.size(); i++) {
-        for (int j = 0; j < m_aCells[i].size(); j++) {
-            delete m_aCells[i][j];
-        }
-    }
 }
 
 void SnakeGameWindow::initializeUI()
@@ -48,145 +85,196 @@ void SnakeGameWindow::initializeUI()
     // 创建中央部件
     m_aCentralWidget = new QWidget(this);
     setCentralWidget(m_aCentralWidget);
-    
+
     // 创建主布局
     m_aGameLayout = new QGridLayout(m_aCentralWidget);
-    
-    // 创建游戏板Widget
-    m_aGameBoardWidget = new QWidget(this);
-    m_aGameBoard = new QGridLayout(m_aGameBoardWidget);
-    m_aGameBoard->setSpacing(1);
-    m_aGameBoard->setContentsMargins(0, 0, 0, 0);
-    
+
+    // 创建游戏板Widget：一个控件画整个棋盘，不再每格一个QLabel
+    m_aBoardWidget = new BoardWidget(this);
+    m_aFrame.resize(kLevelRules[0].width, kLevelRules[0].height);
+    m_aBoardWidget->setFrame(m_aFrame);
+
+    // 性能面板叠在棋盘左上角，默认隐藏
+    m_pPerfOverlay = new PerfOverlay(m_aBoardWidget);
+    m_pPerfOverlay->move(8, 8);
+    m_pPerfOverlay->hide();
+
     // 创建游戏信息区域
     QWidget* infoWidget = new QWidget(this);
     QVBoxLayout* infoLayout = new QVBoxLayout(infoWidget);
-    
+
     QFont labelFont("Arial", 12, QFont::Bold);
-    
+
     m_aScoreLabel = new QLabel("得分: 0", this);
     m_aScoreLabel->setFont(labelFont);
     infoLayout->addWidget(m_aScoreLabel);
-    
+
     m_aLevelLabel = new QLabel("关卡: 1", this);
     m_aLevelLabel->setFont(labelFont);
     infoLayout->addWidget(m_aLevelLabel);
-    
+
     m_aLivesLabel = new QLabel("生命: 3", this);
     m_aLivesLabel->setFont(labelFont);
     infoLayout->addWidget(m_aLivesLabel);
-    
+
     m_aStatusLabel = new QLabel("准备开始", this);
     m_aStatusLabel->setFont(labelFont);
     infoLayout->addWidget(m_aStatusLabel);
-    
+
     // 添加弹簧使布局元素向上对齐
     infoLayout->addStretch();
-    
+
     // 将组件添加到主布局
-    m_aGameLayout->addWidget(m_aGameBoardWidget, 0, 0, 1, 1);
+    m_aGameLayout->addWidget(m_aBoardWidget, 0, 0, 1, 1);
     m_aGameLayout->addWidget(infoWidget, 0, 1, 1, 1);
-    
+
     // 设置列伸缩因子，使游戏区域占更多空间
     m_aGameLayout->setColumnStretch(0, 4);
     m_aGameLayout->setColumnStretch(1, 1);
-    
-    // 初始化游戏板网格
-    for (int i = 0; i < m_nGameBoardHeight; i++) {
-        QVector<QLabel*> row;
-        for (int j = 0; j < m_nGameBoardWidth; j++) {
-            QLabel* cell = new QLabel(this);
-            cell->setFixedSize(20, 20);
-            cell->setStyleSheet(m_sEmptyStyle);
-            m_aGameBoard->addWidget(cell, i, j);
-            row.append(cell);
-        }
-        m_aCells.append(row);
-    }
 }
 
 void SnakeGameWindow::setupColorStyles()
 {
-    m_sEmptyStyle = "QLabel { background-color: white; border: 1px solid lightgray; }";
-    m_sSnakeStyle = "QLabel { background-color: #00AAFF; border: 1px solid #0088CC; }";
-    m_sFoodStyle = "QLabel { background-color: #FF5555; border: 1px solid #CC3333; }";
-    m_sWallStyle = "QLabel { background-color: #888888; border: 1px solid #666666; }";
-    m_sPoisonStyle = "QLabel { background-color: #AAFF00; border: 1px solid #88CC00; }";
-    m_sSpecialFoodStyle = "QLabel { background-color: #FF00FF; border: 1px solid #CC00CC; }";
-    m_sRandomItemStyle = "QLabel { background-color: #FFFF00; border: 1px solid #CCCC00; }";
-    
-    // 设置蛇的颜色映射
-    m_aColorMap[1] = "QLabel { background-color: #00AAFF; border: 1px solid #0088CC; }"; // 默认青色
-    m_aColorMap[2] = "QLabel { background-color: #FF5555; border: 1px solid #CC3333; }"; // 红色
-    m_aColorMap[3] = "QLabel { background-color: #5555FF; border: 1px solid #3333CC; }"; // 蓝色
-    m_aColorMap[4] = "QLabel { background-color: #55FF55; border: 1px solid #33CC33; }"; // 绿色
-    m_aColorMap[5] = "QLabel { background-color: #FFFF55; border: 1px solid #CCCC33; }"; // 黄色
+    // 设置蛇的颜色映射（填充色, 边框色），墙、食物、毒药等格子的颜色在BoardWidget中固定
+    m_aColorMap[1] = qMakePair(QColor("#00AAFF"), QColor("#0088CC")); // 默认青色
+    m_aColorMap[2] = qMakePair(QColor("#FF5555"), QColor("#CC3333")); // 红色
+    m_aColorMap[3] = qMakePair(QColor("#5555FF"), QColor("#3333CC")); // 蓝色
+    m_aColorMap[4] = qMakePair(QColor("#55FF55"), QColor("#33CC33")); // 绿色
+    m_aColorMap[5] = qMakePair(QColor("#FFFF55"), QColor("#CCCC33")); // 黄色
+
+    applySnakeSkin(1);
 }
 
-void SnakeGameWindow::startGame(GameMode mode, int level)
+void SnakeGameWindow::applySnakeSkin(int skin)
 {
-    m_eCurrentMode = mode;
+    QPair<QColor, QColor> colors = m_aColorMap.value(skin, m_aColorMap.value(1));
+    m_aBoardWidget->setSnakeColors(colors.first, colors.second);
+}
+
+void SnakeGameWindow::startClassic()
+{
+    m_bLevelMode = false;
+    m_nCurrentLevel = 0;
+
+    GameSetup setup;
+    setup.config.lives = 1;
+    setup.config.randomItems = false;
+    startGame(setup);
+    m_aLevelLabel->setText("经典模式");
+}
+
+bool SnakeGameWindow::supportsLevel(int level)
+{
+    return level >= 1 && level <= kLevelCount;
+}
+
+void SnakeGameWindow::startLevel(int level)
+{
+    const LevelRule& rule = kLevelRules[std::max(1, std::min(level, kLevelCount)) - 1];
+    m_bLevelMode = true;
     m_nCurrentLevel = level;
+
+    GameSetup setup;
+    setup.config.mapFile = rule.mapFile;
+    setup.config.width = rule.width;
+    setup.config.height = rule.height;
+    setup.config.lives = 1;
+    setup.config.randomItems = false;
+    // 特殊食物和毒药在Game中存在5秒，按起始tick换算
+    setup.config.itemDurationTicks = 5000 / rule.tickMs;
+    setup.targetPoints = rule.targetPoints;
+    setup.tickMs = rule.tickMs;
+    setup.timeLimitSeconds = rule.timeLimitSeconds;
+    startGame(setup);
+    m_aLevelLabel->setText("关卡: " + QString::number(level));
+}
+
+void SnakeGameWindow::startGame(const GameSetup& setup)
+{
+    // 整局都在本窗口的事件循环中推进，不限制步数
+    SnakeEnvConfig config = setup.config;
+    config.maxSteps = 0;
+    config.seed = QRandomGenerator::global()->generate() | 1u;
+    m_pEnv.reset(new SnakeEnv(config));
+    m_pEnv->setFrameStats(&m_aFrameStats);
+    m_nTargetPoints = setup.targetPoints;
+    m_nTickMs = setup.tickMs;
+    m_aPendingActions.clear();
     m_bGameRunning = true;
-    
-    // 初始化游戏数据
-    m_aGame = Game(); // 重置游戏
-    
-    // 根据模式和关卡设置游戏
-    if (mode == GameMode::Classic) {
-        // 使用现有方法初始化经典模式
-        m_aGame.setGameMode(GameMode::Classic);
-        m_aStatusLabel->setText("经典模式");
-    } else if (mode == GameMode::Level) {
-        // 初始化关卡模式
-        m_aGame.setGameMode(GameMode::Level);
-        m_aGame.initializeLevel(level);
-        m_aStatusLabel->setText("关卡 " + QString::number(level+1));
-    }
-    
-    // 设置定时器间隔为100毫秒（可以根据游戏速度调整）
-    m_aGameTimer->start(100);
-    
+    m_bPaused = false;
+    m_bLevelCompleted = false;
+    m_bTimeUp = false;
+    m_nDeadlineAt = setup.timeLimitSeconds > 0 ? static_cast<qint64>(setup.timeLimitSeconds) * 1000 : 0;
+
+    // 当前皮肤与ncurses一侧共用 ProfileStore，皮肤编号从0开始
+    applySnakeSkin(static_cast<int>(ProfileStore::shared().get(ProfileKeys::kCurrentSkin, 0)) + 1);
+
     // 渲染初始游戏板
     renderGameBoard();
     updateGameInfo();
+    m_aStatusLabel->setText("进行中");
+
+    show();
+    raise();
+    activateWindow();
+
+    m_dPaintMsMark = m_aBoardWidget->getTotalPaintMs();
+    m_aClock.start();
+    m_nNextTickAt = m_nTickMs;
+    scheduleNextTick();
 }
 
 void SnakeGameWindow::keyPressEvent(QKeyEvent *event)
 {
+    // F3：显示或隐藏性能面板，不论游戏是否在进行
+    if (event->key() == Qt::Key_F3) {
+        m_pPerfOverlay->setVisible(!m_pPerfOverlay->isVisible());
+        if (m_pPerfOverlay->isVisible()) {
+            // 隐藏期间积压的是开局时的旧样本，从现在开始统计
+            m_aFrameStats.restartWindow();
+            m_pPerfOverlay->setSummary(m_aFrameStats.summarize());
+        }
+        return;
+    }
+
     if (!m_bGameRunning) {
         QMainWindow::keyPressEvent(event);
         return;
     }
-    
+
     // 处理键盘输入
     switch (event->key()) {
         case Qt::Key_Up:
         case Qt::Key_W:
-            processKey(KEY_UP);
+            processKey(static_cast<int>(EnvAction::Up));
             break;
         case Qt::Key_Down:
         case Qt::Key_S:
-            processKey(KEY_DOWN);
+            processKey(static_cast<int>(EnvAction::Down));
             break;
         case Qt::Key_Left:
         case Qt::Key_A:
-            processKey(KEY_LEFT);
+            processKey(static_cast<int>(EnvAction::Left));
             break;
         case Qt::Key_Right:
         case Qt::Key_D:
-            processKey(KEY_RIGHT);
-            break;
-        case Qt::Key_Space:
-            processKey(' '); // 空格键
+            processKey(static_cast<int>(EnvAction::Right));
             break;
         case Qt::Key_Escape:
-            // 暂停游戏或退出
-            if (m_aGameTimer->isActive()) {
+            // 暂停或继续；继续时从现在重新计时，暂停期间不补tick
+            if (!m_bPaused) {
+                m_bPaused = true;
                 m_aGameTimer->stop();
+                m_nPausedAt = m_aClock.elapsed();
                 m_aStatusLabel->setText("已暂停");
             } else {
-                m_aGameTimer->start(100);
+                m_bPaused = false;
+                // 暂停的时间不计入限时
+                if (m_nDeadlineAt > 0) {
+                    m_nDeadlineAt += m_aClock.elapsed() - m_nPausedAt;
+                }
+                m_nNextTickAt = m_aClock.elapsed() + m_nTickMs;
+                scheduleNextTick();
                 m_aStatusLabel->setText("进行中");
             }
             break;
@@ -203,95 +291,155 @@ void SnakeGameWindow::closeEvent(QCloseEvent *event)
     QMainWindow::closeEvent(event);
 }
 
+void SnakeGameWindow::scheduleNextTick()
+{
+    qint64 wait = m_nNextTickAt - m_aClock.elapsed();
+    m_aGameTimer->start(static_cast<int>(std::max<qint64>(0, wait)));
+}
+
 void SnakeGameWindow::updateGame()
 {
-    // TODO: 这里需要修改Game类，增加一个帧更新函数，不依赖于ncurses
-    // 现在暂时使用占位实现
-    
-    // 更新游戏逻辑
-    // m_aGame.update();
-    
-    // 检查游戏是否结束
-    // if (m_aGame.isGameOver()) {
-    //     m_aGameTimer->stop();
-    //     m_bGameRunning = false;
-    //     m_aStatusLabel->setText("游戏结束");
-    //     QMessageBox::information(this, "游戏结束", "你的得分: " + QString::number(m_aGame.getScore()));
-    //     return;
-    // }
-    
-    // 检查关卡是否完成
-    // if (m_eCurrentMode == GameMode::Level && m_aGame.isLevelCompleted()) {
-    //     m_aGameTimer->stop();
-    //     m_bGameRunning = false;
-    //     emit levelCompleted(m_nCurrentLevel);
-    //     return;
-    // }
-    
-    // 更新UI
-    renderGameBoard();
+    if (!m_bGameRunning || m_bPaused) {
+        return;
+    }
+
+    // 按截止时间推进：回调来晚了就补跑错过的tick，下一次的等待时长也相应缩短
+    const qint64 now = m_aClock.elapsed();
+    int ticks = 0;
+    bool finished = false;
+    while (now >= m_nNextTickAt && ticks < kMaxCatchUpTicks && !finished) {
+        const int pointsBefore = m_pEnv->getPoints();
+        stepEngine();
+        adjustTickSpeed(pointsBefore);
+        m_nNextTickAt += m_nTickMs;
+        ticks++;
+        finished = m_pEnv->isDone() || (m_nTargetPoints > 0 && m_pEnv->getPoints() >= m_nTargetPoints);
+    }
+    // 限时关卡：时间到时还没达到目标分数即失败
+    if (!finished && m_nDeadlineAt > 0 && now >= m_nDeadlineAt) {
+        m_bTimeUp = true;
+        finished = true;
+    }
+    // 事件循环被长时间阻塞（如拖动窗口）时放弃积压的tick，从现在重新计时
+    if (now >= m_nNextTickAt) {
+        m_aFrameStats.addDropped(static_cast<int>((now - m_nNextTickAt) / m_nTickMs) + 1);
+        m_nNextTickAt = now + m_nTickMs;
+    }
+
     updateGameInfo();
+    if (m_pPerfOverlay->isVisible()) {
+        m_pPerfOverlay->setSummary(m_aFrameStats.summarize());
+    }
+    if (finished) {
+        finishGame();
+        return;
+    }
+    scheduleNextTick();
 }
 
-void SnakeGameWindow::renderGameBoard()
+void SnakeGameWindow::adjustTickSpeed(int pointsBefore)
 {
-    // TODO: 这里需要从Game类获取当前状态并渲染到UI
-    // 现在暂时使用占位实现
-    
-    // 例如:
-    // - 墙使用m_sWallStyle
-    // - 蛇使用m_sSnakeStyle
-    // - 食物使用m_sFoodStyle
-    // - 毒药使用m_sPoisonStyle
-    // - 特殊食物使用m_sSpecialFoodStyle
-    // - 随机道具使用m_sRandomItemStyle
-    
-    // 清空所有单元格
-    for (int i = 0; i < m_aCells.size(); i++) {
-        for (int j = 0; j < m_aCells[i].size(); j++) {
-            m_aCells[i][j]->setStyleSheet(m_sEmptyStyle);
-        }
+    const int points = m_pEnv->getPoints();
+    if (points == pointsBefore || points % 5 != 0) {
+        return;
+    }
+    const int difficulty = std::min(std::max(points / 5, 0), kMaxDifficulty);
+    m_nTickMs = std::max(static_cast<int>(kBaseTickMs * std::pow(0.95, difficulty)), kMinTickMs);
+}
+
+void SnakeGameWindow::stepEngine()
+{
+    m_aFrameStats.beginFrame();
+    int action = static_cast<int>(EnvAction::Keep);
+    if (!m_aPendingActions.isEmpty()) {
+        action = m_aPendingActions.dequeue();
     }
-    
-    // 这里需要Game类提供获取游戏元素位置的接口
-    // 例如：
-    // auto walls = m_aGame.getWalls();
-    // for (const auto& wall : walls) {
-    //     m_aCells[wall.y][wall.x]->setStyleSheet(m_sWallStyle);
-    // }
-    
-    // auto snakeBody = m_aGame.getSnakeBody();
-    // for (const auto& segment : snakeBody) {
-    //     m_aCells[segment.y][segment.x]->setStyleSheet(m_sSnakeStyle);
-    // }
-    
-    // auto food = m_aGame.getFood();
-    // m_aCells[food.y][food.x]->setStyleSheet(m_sFoodStyle);
+    m_aFrameStats.endPhase(FramePhase::Input);
+    // 对手寻路、移动结算和生成三个阶段由引擎计时
+    m_pEnv->step(action);
+
+    // 只提交本步变化的格子；整盘变化时退回整帧
+    if (!m_aBoardWidget->applyDelta(m_pEnv->getBoardDelta())) {
+        renderGameBoard();
+    }
+    m_aFrameStats.endPhase(FramePhase::Render);
+
+    // paintEvent 在事件循环中异步执行，把上一个tick以来棋盘实际绘制的耗时也计入绘制阶段
+    const double paintMs = m_aBoardWidget->getTotalPaintMs();
+    m_aFrameStats.addPhaseTime(FramePhase::Render, std::chrono::duration_cast<FrameStats::Clock::duration>(
+                                   std::chrono::duration<double, std::milli>(paintMs - m_dPaintMsMark)));
+    m_dPaintMsMark = paintMs;
+    m_aFrameStats.endFrame();
+}
+
+void SnakeGameWindow::finishGame()
+{
+    m_aGameTimer->stop();
+    m_bGameRunning = false;
+    m_aPendingActions.clear();
+
+    const bool won = m_bLevelMode && m_pEnv->getPoints() >= m_nTargetPoints;
+
+    if (won) {
+        m_bLevelCompleted = true;
+        showVictoryScreen(m_nCurrentLevel);
+        emit levelCompleted(m_nCurrentLevel);
+        return;
+    }
+
+    m_aStatusLabel->setText(m_bTimeUp ? "时间到" : "游戏结束");
+    QMessageBox::information(this, "游戏结束", (m_bTimeUp ? "时间到！你的得分: " : "你的得分: ") +
+                             QString::number(m_pEnv->getPoints()));
+    hide();
+    emit gameExited();
+}
+
+void SnakeGameWindow::renderGameBoard()
+{
+    // 整帧提交，只在新开一局或引擎给出整盘增量时使用；
+    // 平时由stepEngine按增量只重绘变化的格子
+    m_pEnv->writeBoard(m_aFrame);
+    m_aBoardWidget->setFrame(m_aFrame);
 }
 
 void SnakeGameWindow::updateGameInfo()
 {
-    // TODO: 更新游戏信息
-    // 例如:
-    // m_aScoreLabel->setText("得分: " + QString::number(m_aGame.getScore()));
-    // m_aLivesLabel->setText("生命: " + QString::number(m_aGame.getLives()));
+    if (!m_pEnv) {
+        return;
+    }
+    if (m_nTargetPoints > 0) {
+        m_aScoreLabel->setText("得分: " + QString::number(m_pEnv->getPoints()) + " / " + QString::number(m_nTargetPoints));
+    } else {
+        m_aScoreLabel->setText("得分: " + QString::number(m_pEnv->getPoints()));
+    }
+    m_aLivesLabel->setText("生命: " + QString::number(m_pEnv->getLives()));
+    if (m_nDeadlineAt > 0 && m_bGameRunning && !m_bPaused) {
+        const qint64 remainingMs = std::max<qint64>(0, m_nDeadlineAt - m_aClock.elapsed());
+        m_aStatusLabel->setText("剩余时间: " + QString::number((remainingMs + 999) / 1000) + " 秒");
+    }
 }
 
-void SnakeGameWindow::processKey(int key)
+void SnakeGameWindow::processKey(int action)
 {
-    // TODO: 处理按键输入，更新游戏状态
-    // m_aGame.handleKeyInput(key);
+    if (m_bPaused || m_aPendingActions.size() >= kMaxQueuedKeys) {
+        return;
+    }
+    // 与队尾（队列为空时与蛇当前方向）相同或相反的按键不入队，
+    // 避免一个tick内连按两次把蛇直接掉头；Direction中相反方向的取值只差最低位
+    int last = m_aPendingActions.isEmpty() ? static_cast<int>(m_pEnv->getSnake().getDirection())
+                                           : m_aPendingActions.back();
+    if (action == last || action == (last ^ 1)) {
+        return;
+    }
+    m_aPendingActions.enqueue(action);
 }
 
 bool SnakeGameWindow::isLevelCompleted() const
 {
-    // TODO: 从Game类获取关卡是否完成
-    // return m_aGame.isLevelCompleted();
-    return false; // 临时返回值
+    return m_bLevelCompleted;
 }
 
 void SnakeGameWindow::showVictoryScreen(int level)
 {
-    m_aStatusLabel->setText("关卡 " + QString::number(level+1) + " 胜利！");
-    // 根据需要显示胜利画面
-} 
\ No newline at end of file
+    m_aStatusLabel->setText("关卡 " + QString::number(level) + " 胜利！");
+}
@@ -0,0 +1,136 @@
+#include "gui/sound_bank.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QPointer>
+#include <QUrl>
+
+namespace
+{
+    const char* const kEffectFiles[] = {
+        "mode_select_hover.wav",
+        "mode_select_click.wav",
+    };
+
+    const char* const kMusicFiles[] = {
+        "mode_background.mp3",
+        "story_background.mp3",
+    };
+
+    QString musicPath(const char* file)
+    {
+        return QCoreApplication::applicationDirPath() + "/assets/music/" + file;
+    }
+}
+
+SoundBank& SoundBank::shared()
+{
+    // 挂在QApplication下，播放器随它销毁；之后再建的QApplication会重新创建
+    static QPointer<SoundBank> bank;
+    if (!bank) {
+        bank = new SoundBank(QCoreApplication::instance());
+    }
+    return *bank;
+}
+
+SoundBank::SoundBank(QObject *parent)
+    : QObject(parent)
+    , m_nCurrentMusic(-1)
+    , m_nPendingStop(-1)
+    , m_pStopTimer(new QTimer(this))
+{
+    for (QSoundEffect*& sound : m_aEffects) {
+        sound = nullptr;
+    }
+    for (QMediaPlayer*& player : m_aMusic) {
+        player = nullptr;
+    }
+    m_pStopTimer->setSingleShot(true);
+    m_pStopTimer->setInterval(0);
+    connect(m_pStopTimer, &QTimer::timeout, this, [this]() { stopPendingMusic(); });
+}
+
+void SoundBank::preload()
+{
+    for (int i = 0; i < static_cast<int>(Effect::Count); i++) {
+        effect(static_cast<Effect>(i));
+    }
+}
+
+QSoundEffect* SoundBank::effect(Effect effect)
+{
+    QSoundEffect*& sound = m_aEffects[static_cast<int>(effect)];
+    if (!sound) {
+        const QString path = musicPath(kEffectFiles[static_cast<int>(effect)]);
+        sound = new QSoundEffect(this);
+        sound->setSource(QUrl::fromLocalFile(path));
+        connect(sound, &QSoundEffect::statusChanged, this, [sound, path]() {
+            if (sound->status() == QSoundEffect::Error) {
+                qDebug() << "音效加载失败:" << path;
+            }
+        });
+    }
+    return sound;
+}
+
+QMediaPlayer* SoundBank::musicPlayer(Music music)
+{
+    QMediaPlayer*& player = m_aMusic[static_cast<int>(music)];
+    if (!player) {
+        // 播放列表只有一首，循环播放不再依赖stateChanged重新play
+        QMediaPlaylist* playlist = new QMediaPlaylist(this);
+        playlist->addMedia(QUrl::fromLocalFile(musicPath(kMusicFiles[static_cast<int>(music)])));
+        playlist->setPlaybackMode(QMediaPlaylist::CurrentItemInLoop);
+        player = new QMediaPlayer(this);
+        player->setPlaylist(playlist);
+        if (player->error() != QMediaPlayer::NoError) {
+            qDebug() << "背景音乐加载失败:" << player->errorString();
+        }
+    }
+    return player;
+}
+
+void SoundBank::play(Effect effect, qreal volume)
+{
+    QSoundEffect* sound = this->effect(effect);
+    if (sound->status() == QSoundEffect::Ready) {
+        sound->setVolume(volume);
+        sound->play();
+    }
+}
+
+void SoundBank::playMusic(Music music, int volume)
+{
+    const int index = static_cast<int>(music);
+    if (m_nPendingStop == index) {
+        m_nPendingStop = -1;
+    }
+    if (m_nCurrentMusic != -1 && m_nCurrentMusic != index) {
+        m_aMusic[m_nCurrentMusic]->stop();
+    }
+    QMediaPlayer* player = musicPlayer(music);
+    player->setVolume(volume);
+    if (player->state() != QMediaPlayer::PlayingState) {
+        player->play();
+    }
+    m_nCurrentMusic = index;
+}
+
+void SoundBank::stopMusic(Music music)
+{
+    if (m_nCurrentMusic != static_cast<int>(music)) {
+        return;
+    }
+    m_nPendingStop = m_nCurrentMusic;
+    m_pStopTimer->start();
+}
+
+void SoundBank::stopPendingMusic()
+{
+    if (m_nPendingStop == -1 || m_nPendingStop != m_nCurrentMusic) {
+        m_nPendingStop = -1;
+        return;
+    }
+    m_aMusic[m_nPendingStop]->stop();
+    m_nPendingStop = -1;
+    m_nCurrentMusic = -1;
+}
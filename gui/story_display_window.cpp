@@ -1,9 +1,11 @@
 #include "gui/story_display_window.h"
+#include "story_index.h"
+#include "gui/image_cache.h"
+#include "gui/sound_bank.h"
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QFont>
 #include <QFontMetrics>
-#include <QTextStream>
 #include <QFile>
 #include <QDebug>
 #include <QCoreApplication>
@@ -21,12 +23,10 @@ StoryDisplayWindow::StoryDisplayWindow(QWidget *parent)
     , m_cartoonLabel(nullptr)
     , m_skipHintLabel(nullptr)
     , m_scrollArea(nullptr)
-    , m_clickSound(nullptr)
-    , m_typewriterSound(nullptr)
-    , m_backgroundMusic(nullptr)
     , m_currentSegmentIndex(0)
     , m_currentLevel(0)
     , m_typewriterTimer(new QTimer(this))
+    , m_typewriterClock(TYPEWRITER_SPEED)
     , m_currentCharIndex(0)
     , m_isTyping(false)
     , m_currentCartoonIndex(0)
@@ -34,13 +34,15 @@ StoryDisplayWindow::StoryDisplayWindow(QWidget *parent)
 {
     setupUI();
     setupBackgroundImage();
-    setupAudioEffects();
-    setupBackgroundMusic();
     loadStoryText();
     
-    // 连接打字机定时器
+    // 连接打字机定时器，按帧刷新，精确计时避免帧间隔抖动
+    m_typewriterTimer->setTimerType(Qt::PreciseTimer);
     connect(m_typewriterTimer, &QTimer::timeout, this, &StoryDisplayWindow::onTypewriterTimer);
     
+    // 漫画在后台解码完成后再显示
+    connect(&ImageCache::shared(), &ImageCache::imageReady, this, &StoryDisplayWindow::onCartoonImageReady);
+    
     // 设置窗口属性
     setWindowTitle("剧情");
     setFixedSize(1536, 1024);
@@ -54,16 +56,7 @@ StoryDisplayWindow::StoryDisplayWindow(QWidget *parent)
 
 StoryDisplayWindow::~StoryDisplayWindow()
 {
-    if (m_backgroundMusic) {
-        m_backgroundMusic->stop();
-        delete m_backgroundMusic;
-    }
-    if (m_clickSound) {
-        delete m_clickSound;
-    }
-    if (m_typewriterSound) {
-        delete m_typewriterSound;
-    }
+    stopBackgroundMusic();
 }
 
 void StoryDisplayWindow::setupUI()
@@ -75,9 +68,8 @@ void StoryDisplayWindow::setupUI()
     m_mainLayout->setContentsMargins(0, 0, 0, 0);
     
     // 背景标签
-    m_backgroundLabel = new QLabel(this);
+    m_backgroundLabel = new ScaledImageLabel(this);
     m_backgroundLabel->setFixedSize(1536, 1024);
-    m_backgroundLabel->setScaledContents(true);
     
     // ===== 📝 剧情文字显示区域 =====
     m_scrollArea = new QScrollArea(this);
@@ -87,10 +79,11 @@ void StoryDisplayWindow::setupUI()
     m_scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     
     // 剧情文本标签 - 仅用于文字显示
-    m_storyTextLabel = new QLabel();
+    m_storyTextLabel = new TypewriterLabel();
     m_storyTextLabel->setWordWrap(true);
     m_storyTextLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
     m_storyTextLabel->setStyleSheet("QLabel { color: #2F2F2F; font-size: 20px; font-family: 'Georgia', serif; padding: 45px; line-height: 2.8; font-weight: bold; background: rgba(255, 255, 255, 0); }");
+    m_storyTextLabel->setTextPadding(45);  // 与样式表中的padding一致
     m_storyTextLabel->setMinimumSize(800, 430);  // 📍 文字区域大小
     m_scrollArea->setWidget(m_storyTextLabel);
     
@@ -126,277 +119,62 @@ void StoryDisplayWindow::setupUI()
 
 void StoryDisplayWindow::setupBackgroundImage()
 {
-    QString imagePath = QCoreApplication::applicationDirPath() + "/assets/images/storyboard.png";
-    QPixmap backgroundPixmap(imagePath);
+    // 默认背景色在图片解码完成前显示，两张图片都加载失败时保留
+    m_backgroundLabel->setStyleSheet("QLabel { background-color: rgb(20, 20, 40); }");
     
-    if (backgroundPixmap.isNull()) {
-        // 如果没有storyboard图片，使用默认背景
-        imagePath = QCoreApplication::applicationDirPath() + "/assets/images/modeselect.png";
-        backgroundPixmap = QPixmap(imagePath);
-    }
-    
-    if (!backgroundPixmap.isNull()) {
-        m_backgroundLabel->setPixmap(backgroundPixmap);
-    } else {
-        // 创建默认背景
-        backgroundPixmap = QPixmap(1024, 768);
-        backgroundPixmap.fill(QColor(20, 20, 40));
-        m_backgroundLabel->setPixmap(backgroundPixmap);
-    }
+    // 如果没有storyboard图片，使用模式选择的背景
+    const QString imageDir = QCoreApplication::applicationDirPath() + "/assets/images/";
+    m_backgroundLabel->setImagePaths({imageDir + "storyboard.png", imageDir + "modeselect.png"});
 }
 
-void StoryDisplayWindow::setupAudioEffects()
+void StoryDisplayWindow::startBackgroundMusic()
 {
-    // 点击音效
-    m_clickSound = new QSoundEffect(this);
-    QString clickSoundPath = QCoreApplication::applicationDirPath() + "/assets/music/mode_select_click.wav";
-    m_clickSound->setSource(QUrl::fromLocalFile(clickSoundPath));
-    m_clickSound->setVolume(0.3);
-    
-    // 打字机音效（使用悬停音效作为替代）
-    m_typewriterSound = new QSoundEffect(this);
-    QString typeSoundPath = QCoreApplication::applicationDirPath() + "/assets/music/mode_select_hover.wav";
-    m_typewriterSound->setSource(QUrl::fromLocalFile(typeSoundPath));
-    m_typewriterSound->setVolume(0.1);
+    SoundBank::shared().playMusic(SoundBank::Music::Story, 60);
 }
 
-void StoryDisplayWindow::setupBackgroundMusic()
+void StoryDisplayWindow::stopBackgroundMusic()
 {
-    m_backgroundMusic = new QMediaPlayer(this);
-    QString musicPath = QCoreApplication::applicationDirPath() + "/assets/music/story_background.mp3";
-    m_backgroundMusic->setMedia(QUrl::fromLocalFile(musicPath));
-    m_backgroundMusic->setVolume(60);
-    
-    // 设置循环播放
-    connect(m_backgroundMusic, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
-        if (state == QMediaPlayer::StoppedState) {
-            m_backgroundMusic->play();  // 播放结束时重新开始
-        }
-    });
-    
-    // 检查音乐是否加载成功
-    if (m_backgroundMusic->error() != QMediaPlayer::NoError) {
-        qDebug() << "剧情背景音乐加载失败:" << m_backgroundMusic->errorString() << "路径:" << musicPath;
-    } else {
-        qDebug() << "剧情背景音乐加载成功:" << musicPath;
-    }
+    SoundBank::shared().stopMusic(SoundBank::Music::Story);
 }
 
-void StoryDisplayWindow::startBackgroundMusic()
+void StoryDisplayWindow::playClickSound()
 {
-    if (m_backgroundMusic && m_backgroundMusic->error() == QMediaPlayer::NoError) {
-        // 重新连接循环播放的信号
-        connect(m_backgroundMusic, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
-            if (state == QMediaPlayer::StoppedState) {
-                m_backgroundMusic->play();  // 播放结束时重新开始
-            }
-        });
-        m_backgroundMusic->play();
-        qDebug() << "开始播放剧情背景音乐";
-    }
+    SoundBank::shared().play(SoundBank::Effect::Click, 0.3);
 }
 
-void StoryDisplayWindow::stopBackgroundMusic()
+void StoryDisplayWindow::playTypewriterSound()
 {
-    if (m_backgroundMusic && m_backgroundMusic->state() == QMediaPlayer::PlayingState) {
-        // 先断开可能的信号连接，防止stop()后立即重新播放
-        m_backgroundMusic->disconnect();
-        m_backgroundMusic->stop();
-        qDebug() << "停止播放剧情背景音乐";
-    }
+    // 打字机音效（使用悬停音效作为替代）
+    SoundBank::shared().play(SoundBank::Effect::Hover, 0.1);
 }
 
 void StoryDisplayWindow::loadStoryText()
 {
+    // 剧情索引进程内只建一次，和ncurses一侧共用；打开剧情界面时只读当前章节的段落
     QString filePath = QCoreApplication::applicationDirPath() + "/assets/text/plot.txt";
-    QFile file(filePath);
-    
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "无法打开剧情文件:" << filePath;
-        return;
+    StoryIndex& story = StoryIndex::shared();
+    if (!story.open(filePath.toStdString())) {
+        qDebug() << "无法打开剧情文件:" << QString::fromStdString(story.getLastError());
     }
-    
-    QTextStream in(&file);
-    in.setCodec("UTF-8");
-    QString content = in.readAll();
-    file.close();
-    
-    // 解析文本内容
-    parseStorySegments();
 }
 
-void StoryDisplayWindow::parseStorySegments()
+void StoryDisplayWindow::showSection(int section)
 {
-    QString filePath = QCoreApplication::applicationDirPath() + "/assets/text/plot.txt";
-    QFile file(filePath);
-    
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return;
-    }
-    
-    QTextStream in(&file);
-    in.setCodec("UTF-8");
-    
-    m_storySegments.clear();
-    m_levelSegmentRanges.clear();
-    m_levelSegmentRanges.resize(6); // 0=序章, 1-5=各关卡
-    
-    QString allContent = in.readAll();
-    file.close();
-    
-    QStringList lines = allContent.split('\n');
-    
-    // 存储各关卡的剧情内容
-    QStringList levelContents;
-    for (int i = 0; i < 6; ++i) {
-        levelContents << QString();
-    }
-    
-    QString currentLevelContent;
-    int currentLevel = -1;
-    bool inTextBlock = false;
-    
-    for (const QString& line : lines) {
-        QString trimmedLine = line.trimmed();
-        
-        // 跳过空行和标题行
-        if (trimmedLine.isEmpty() || trimmedLine.startsWith("《") || 
-            trimmedLine.startsWith("English") || trimmedLine.contains("Description")) {
-            continue;
-        }
-        
-        // 检测序章开始
-        if (trimmedLine.contains("Prologue:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = 0;
-            currentLevelContent = "";
-            inTextBlock = false;
-            continue;
-        }
-        
-        // 检测各关卡开始
-        if (trimmedLine.contains("Level 1:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = 1;
-            currentLevelContent = "";
-            inTextBlock = false;
-            continue;
-        }
-        if (trimmedLine.contains("Level 2:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = 2;
-            currentLevelContent = "";
-            inTextBlock = false;
-            continue;
-        }
-        if (trimmedLine.contains("Level 3:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = 3;
-            currentLevelContent = "";
-            inTextBlock = false;
-            continue;
-        }
-        if (trimmedLine.contains("Level 4:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = 4;
-            currentLevelContent = "";
-            inTextBlock = false;
-            continue;
-        }
-        if (trimmedLine.contains("Final Level:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = 5;
-            currentLevelContent = "";
-            inTextBlock = false;
-            continue;
-        }
-        
-        // 结束当前关卡（遇到Epilogue）
-        if (trimmedLine.contains("Epilogue:")) {
-            if (currentLevel >= 0) {
-                levelContents[currentLevel] = currentLevelContent;
-            }
-            currentLevel = -1;
-            continue;
-        }
-        
-        // 检测文本开始
-        if (trimmedLine.startsWith("[Text]:") || trimmedLine.startsWith("[Scene]:")) {
-            inTextBlock = true;
-            continue;
-        }
-        
-        // 检测其他标记
-        if (trimmedLine.startsWith("[") && trimmedLine.endsWith("]")) {
-            inTextBlock = false;
-            continue;
-        }
-        
-        // 收集文本内容
-        if (currentLevel >= 0 && inTextBlock && !trimmedLine.isEmpty()) {
-            if (!currentLevelContent.isEmpty()) {
-                currentLevelContent += "\n";
-            }
-            currentLevelContent += trimmedLine;
-        }
-    }
-    
-    // 保存最后一个关卡
-    if (currentLevel >= 0) {
-        levelContents[currentLevel] = currentLevelContent;
-    }
+    m_currentLevel = section;
+    m_currentSegmentIndex = 0;
     
-    // 将每个关卡的内容分割成段落并建立索引
-    for (int level = 0; level < levelContents.size(); ++level) {
-        if (!levelContents[level].isEmpty()) {
-            int startIndex = m_storySegments.size();
-            
-            // 按段落分割（双换行分割）
-            QStringList paragraphs = levelContents[level].split("\n\n", Qt::SkipEmptyParts);
-            if (paragraphs.isEmpty()) {
-                // 如果没有双换行，按单换行分割
-                paragraphs = levelContents[level].split("\n", Qt::SkipEmptyParts);
-            }
-            
-            for (const QString& paragraph : paragraphs) {
-                QString cleanParagraph = paragraph.trimmed();
-                if (!cleanParagraph.isEmpty()) {
-                    m_storySegments.push_back(cleanParagraph.toStdString());
-                }
-            }
-            
-            int endIndex = m_storySegments.size();
-            m_levelSegmentRanges[level] = qMakePair(startIndex, endIndex);
-        } else {
-            m_levelSegmentRanges[level] = qMakePair(-1, -1);
-        }
+    // 检查章节剧情是否存在
+    if (StoryIndex::shared().paragraphCount(section) > 0) {
+        showNextSegment();
+    } else {
+        // 如果没有找到剧情，直接完成
+        emit storyFinished();
     }
 }
 
 void StoryDisplayWindow::showPrologue()
 {
-    m_currentLevel = 0;
-    
-    // 检查序章是否存在
-    if (m_levelSegmentRanges.size() > 0 && m_levelSegmentRanges[0].first >= 0) {
-        m_currentSegmentIndex = m_levelSegmentRanges[0].first;
-        showNextSegment();
-    } else {
-        // 如果没有序章，直接完成
-        emit storyFinished();
-    }
+    showSection(StoryIndex::kPrologue);
 }
 
 void StoryDisplayWindow::loadStoryForLevel(int level)
@@ -406,60 +184,29 @@ void StoryDisplayWindow::loadStoryForLevel(int level)
         return;
     }
     
-    m_currentLevel = level;
-    
-    // 检查关卡剧情是否存在
-    if (m_levelSegmentRanges.size() > level && m_levelSegmentRanges[level].first >= 0) {
-        m_currentSegmentIndex = m_levelSegmentRanges[level].first;
-        showNextSegment();
-    } else {
-        // 如果没有找到关卡剧情，直接完成
-        emit storyFinished();
-    }
+    showSection(level);
 }
 
 void StoryDisplayWindow::showEpilogue()
 {
-    m_currentLevel = -1;
-    
-    // 找到结尾段落
-    for (size_t i = 0; i < m_storySegments.size(); ++i) {
-        QString segment = QString::fromStdString(m_storySegments[i]);
-        if (segment.contains("Epilogue:")) {
-            m_currentSegmentIndex = i;
-            break;
-        }
-    }
-    
-    showNextSegment();
+    showSection(StoryIndex::kEpilogue);
 }
 
 void StoryDisplayWindow::showNextSegment()
 {
-    // 检查是否已经到达当前关卡的结尾
-    if (m_currentLevel >= 0 && m_currentLevel < m_levelSegmentRanges.size()) {
-        QPair<int, int> range = m_levelSegmentRanges[m_currentLevel];
-        if (range.first >= 0 && m_currentSegmentIndex >= range.second) {
-            // 已经到达当前关卡的结尾
-            emit storyFinished();
-            return;
-        }
-    }
-    
-    // 检查是否超出所有段落
-    if (m_currentSegmentIndex >= static_cast<int>(m_storySegments.size())) {
+    // 检查是否已经到达当前章节的结尾
+    const StoryIndex& story = StoryIndex::shared();
+    if (m_currentSegmentIndex >= static_cast<int>(story.paragraphCount(m_currentLevel))) {
         emit storyFinished();
         return;
     }
     
-    m_targetText = QString::fromStdString(m_storySegments[m_currentSegmentIndex]);
-    m_currentText.clear();
+    // 整段排版一次，之后每帧只改变显示的字数
+    m_storyTextLabel->startReveal(QString::fromStdString(story.paragraph(m_currentLevel, m_currentSegmentIndex)));
+    m_scrollArea->verticalScrollBar()->setValue(0);
     m_currentCharIndex = 0;
     m_isTyping = true;
     
-    // 清空显示
-    m_storyTextLabel->clear();
-    
     // 开始打字机效果
     startTypewriterEffect();
     
@@ -473,25 +220,27 @@ void StoryDisplayWindow::startTypewriterEffect()
         m_typewriterTimer->stop();
     }
     
-    m_typewriterTimer->start(TYPEWRITER_SPEED);
+    m_typewriterClock.start(m_storyTextLabel->getGlyphCount());
+    m_typewriterTimer->start(TYPEWRITER_FRAME);
 }
 
 void StoryDisplayWindow::onTypewriterTimer()
 {
-    if (m_currentCharIndex < m_targetText.length()) {
-        m_currentText += m_targetText[m_currentCharIndex];
-        m_currentCharIndex++;
-        
-        m_storyTextLabel->setText(m_currentText);
-        
-        // 播放打字音效（每3个字符播放一次）
-        if (m_currentCharIndex % 3 == 0 && m_typewriterSound) {
-            m_typewriterSound->play();
+    // 显示进度按经过的时间计算，某一帧来晚了下一帧就多显示几个字
+    const int revealed = static_cast<int>(m_typewriterClock.revealedAt());
+    if (revealed > m_currentCharIndex) {
+        // 播放打字音效（每3个字符播放一次，一帧跨过几次也只播放一次）
+        if (revealed / 3 > m_currentCharIndex / 3) {
+            playTypewriterSound();
         }
+        m_currentCharIndex = revealed;
+        m_storyTextLabel->setRevealedCount(revealed);
         
-        // 自动滚动到底部
-        m_scrollArea->verticalScrollBar()->setValue(m_scrollArea->verticalScrollBar()->maximum());
-    } else {
+        // 自动滚动，让正在显示的那一行可见
+        m_scrollArea->ensureVisible(0, m_storyTextLabel->getRevealedBottom(), 0, 0);
+    }
+    
+    if (m_currentCharIndex >= m_storyTextLabel->getGlyphCount()) {
         m_typewriterTimer->stop();
         m_isTyping = false;
         showSkipHint();
@@ -502,8 +251,9 @@ void StoryDisplayWindow::completeCurrentSegment()
 {
     if (m_isTyping) {
         m_typewriterTimer->stop();
-        m_currentText = m_targetText;
-        m_storyTextLabel->setText(m_currentText);
+        m_typewriterClock.finish();
+        m_currentCharIndex = m_storyTextLabel->getGlyphCount();
+        m_storyTextLabel->revealAll();
         m_isTyping = false;
         showSkipHint();
     }
@@ -556,9 +306,7 @@ void StoryDisplayWindow::keyPressEvent(QKeyEvent *event)
         if (event->key() == Qt::Key_Escape) {
             emit skipToGame();
         } else if (event->key() == Qt::Key_Space || event->key() == Qt::Key_Return) {
-            if (m_clickSound) {
-                m_clickSound->play();
-            }
+            playClickSound();
             onNextSegment();
         }
         
@@ -572,9 +320,7 @@ void StoryDisplayWindow::mousePressEvent(QMouseEvent *event)
         if (m_isInCartoonMode) {
             onNextCartoon();
         } else {
-            if (m_clickSound) {
-                m_clickSound->play();
-            }
+            playClickSound();
             onNextSegment();
         }
     }
@@ -644,7 +390,7 @@ void StoryDisplayWindow::showCartoonForLevel(int level, const QString& trigger)
     }
 }
 
-void StoryDisplayWindow::showCartoonImage(const QString& path)
+QSize StoryDisplayWindow::cartoonDisplaySize() const
 {
     // 🎨 漫画纯净显示（专为1024×1536竖版漫画优化）：
     // 
@@ -653,114 +399,141 @@ void StoryDisplayWindow::showCartoonImage(const QString& path)
     //       找到 "targetWidth * 1.2f" 这行，修改1.2f为其他值：
     //       - 1.0f = 原尺寸  1.5f = 放大50%  2.0f = 放大100%
     //    2. 【固定尺寸模式】替换智能尺寸部分为：
-    //       QSize displaySize = getOptimalCartoonSize("large"); // 使用预设尺寸
+    //       return getOptimalCartoonSize("large"); // 使用预设尺寸
     //    3. 【可选预设(2:3比例)】: 
     //       "tiny"(320×480), "small"(400×600), "medium"(480×720), "large"(560×840), 
     //       "xlarge"(640×960), "full"(768×1152), "original"(1024×1536), "compact"(360×540)
-    //    4. 【自定义尺寸】直接指定：QSize displaySize(宽度, 高度); // 如QSize(600, 900);
-    //
+    //    4. 【自定义尺寸】直接指定：return QSize(宽度, 高度); // 如QSize(600, 900);
+    
+    // 🎨 针对1024×1536漫画的智能尺寸调整（2:3纵向比例）
+    // 获取漫画显示区域的可用大小，为竖版漫画优化边距
+    QSize availableSize = m_cartoonLabel->size();
+    int maxWidth = qMax(600, availableSize.width() - 120);    // 充分利用漫画框宽度，预留边距
+    int maxHeight = qMax(1400, availableSize.height() - 120); // 充分利用漫画框高度，预留边距
+    
+    // 根据原始1024×1536比例(2:3)选择合适的显示尺寸
+    float aspectRatio = 1024.0f / 1536.0f; // 原始宽高比 ≈ 0.667
+    
+    // 优先保证更大的显示尺寸，适当调大显示效果
+    int targetWidth = qMin(maxWidth, static_cast<int>(maxHeight * aspectRatio));
+    int targetHeight = static_cast<int>(targetWidth / aspectRatio);
+    
+    // 确保高度不超限，如果超限则按高度重新计算
+    if (targetHeight > maxHeight) {
+        targetHeight = maxHeight;
+        targetWidth = static_cast<int>(targetHeight * aspectRatio);
+    }
+    
+    // 适当放大显示尺寸（增加20%），提供更好的视觉效果
+    targetWidth = static_cast<int>(targetWidth * 1.2f);
+    targetHeight = static_cast<int>(targetHeight * 1.2f);
+    
+    // 再次检查是否超出边界，如果超出则回调到安全尺寸
+    if (targetWidth > maxWidth || targetHeight > maxHeight) {
+        float scale = qMin(static_cast<float>(maxWidth) / targetWidth, 
+                         static_cast<float>(maxHeight) / targetHeight);
+        targetWidth = static_cast<int>(targetWidth * scale);
+        targetHeight = static_cast<int>(targetHeight * scale);
+    }
+    
+    // 最终显示尺寸，保持2:3比例
+    return QSize(targetWidth, targetHeight);
+}
+
+void StoryDisplayWindow::showCartoonImage(const QString& path)
+{
     // 🎭 纯净显示模式：
     //    - 无边框、无阴影、无装饰
     //    - 透明背景
     //    - 完全聚焦于漫画内容本身
+    //
+    // 解码和平滑缩放在 ImageCache 的线程池中完成，这里只查缓存：
+    // 命中时立即显示，未命中时发起解码，由 onCartoonImageReady 显示
     
     if (QFile::exists(path)) {
-        QPixmap pixmap(path);
+        const QSize displaySize = cartoonDisplaySize();
+        QPixmap pixmap = ImageCache::shared().lookup(path, displaySize);
         if (!pixmap.isNull()) {
-            // 🎨 针对1024×1536漫画的智能尺寸调整（2:3纵向比例）
-            // 获取漫画显示区域的可用大小，为竖版漫画优化边距
-            QSize availableSize = m_cartoonLabel->size();
-            int maxWidth = qMax(600, availableSize.width() - 120);    // 充分利用漫画框宽度，预留边距
-            int maxHeight = qMax(1400, availableSize.height() - 120); // 充分利用漫画框高度，预留边距
-            
-            // 根据原始1024×1536比例(2:3)选择合适的显示尺寸
-            QSize displaySize;
-            float aspectRatio = 1024.0f / 1536.0f; // 原始宽高比 ≈ 0.667
-            
-            // 优先保证更大的显示尺寸，适当调大显示效果
-            int targetWidth = qMin(maxWidth, static_cast<int>(maxHeight * aspectRatio));
-            int targetHeight = static_cast<int>(targetWidth / aspectRatio);
-            
-            // 确保高度不超限，如果超限则按高度重新计算
-            if (targetHeight > maxHeight) {
-                targetHeight = maxHeight;
-                targetWidth = static_cast<int>(targetHeight * aspectRatio);
-            }
-            
-            // 适当放大显示尺寸（增加20%），提供更好的视觉效果
-            targetWidth = static_cast<int>(targetWidth * 1.2f);
-            targetHeight = static_cast<int>(targetHeight * 1.2f);
-            
-            // 再次检查是否超出边界，如果超出则回调到安全尺寸
-            if (targetWidth > maxWidth || targetHeight > maxHeight) {
-                float scale = qMin(static_cast<float>(maxWidth) / targetWidth, 
-                                 static_cast<float>(maxHeight) / targetHeight);
-                targetWidth = static_cast<int>(targetWidth * scale);
-                targetHeight = static_cast<int>(targetHeight * scale);
+            displayCartoonPixmap(pixmap);
+        } else {
+            ImageCache::shared().request(path, displaySize);
+        }
+        
+        // 预取前后两张，翻页时直接命中缓存
+        for (int index : {m_currentCartoonIndex + 1, m_currentCartoonIndex - 1}) {
+            if (index >= 0 && index < m_cartoonPaths.size()) {
+                ImageCache::shared().request(m_cartoonPaths[index], displaySize);
             }
-            
-            // 设置最终显示尺寸，保持2:3比例
-            displaySize = QSize(targetWidth, targetHeight);
-            
-            QPixmap scaledPixmap = pixmap.scaled(displaySize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            
-            // 创建纯净的画布
-            QPixmap canvas(scaledPixmap.width(), scaledPixmap.height());
-            canvas.fill(Qt::transparent);
-            
-            QPainter painter(&canvas);
-            painter.setRenderHint(QPainter::Antialiasing, true);
-            painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
-            painter.setRenderHint(QPainter::HighQualityAntialiasing, true);
-            
-            // 🎨 纯净显示 - 无边框无阴影
-            QRect imageRect = QRect(0, 0, scaledPixmap.width(), scaledPixmap.height());
-            painter.drawPixmap(imageRect, scaledPixmap);
-            
-            // 设置艺术化漫画到专门的漫画标签
-            m_cartoonLabel->clear();
-            m_cartoonLabel->setPixmap(canvas);
-            m_cartoonLabel->setAlignment(Qt::AlignCenter);
-            m_cartoonLabel->setVisible(true);  // 显示漫画框
-            
-            // 隐藏文字框，显示漫画框
-            m_scrollArea->setVisible(false);
-            
-            // 🎭 纯净样式
-            QString artStyle = QString(
-                "QLabel {"
-                "   background: transparent;"
-                "   border: none;"
-                "   padding: 0px;"
-                "   margin: 0px;"
-                "}"
-            );
-            m_cartoonLabel->setStyleSheet(artStyle);
-            
         }
     } else {
-        // 🎨 艺术化的错误提示
-        m_storyTextLabel->setText("🎭 漫画作品暂时无法展示\n" + path);
-        m_storyTextLabel->setStyleSheet(
-            "QLabel { "
-            "   color: #8B4513; "
-            "   font-size: 22px; "
-            "   font-family: 'Georgia', serif; "
-            "   font-weight: bold; "
-            "   text-align: center; "
-            "   background: qlineargradient(x1:0, y1:0, x2:1, y2:1, "
-            "       stop:0 rgba(255, 228, 196, 240), "
-            "       stop:0.5 rgba(255, 248, 220, 200), "
-            "       stop:1 rgba(255, 255, 240, 220)); "
-            "   border-radius: 25px; "
-            "   padding: 40px; "
-            "   border: 3px dashed rgba(139, 69, 19, 180);"
-            "   margin: 20px;"
-            "}"
-        );
+        showCartoonError(path);
+    }
+}
+
+void StoryDisplayWindow::onCartoonImageReady(const QString& path, const QSize& size, bool ok)
+{
+    // 只处理当前这张，预取的结果留在缓存里
+    if (!m_isInCartoonMode || m_currentCartoonIndex < 0 || m_currentCartoonIndex >= m_cartoonPaths.size() ||
+        path != m_cartoonPaths[m_currentCartoonIndex] || size != cartoonDisplaySize()) {
+        return;
+    }
+    if (!ok) {
+        showCartoonError(path);
+        return;
+    }
+    QPixmap pixmap = ImageCache::shared().lookup(path, size);
+    if (!pixmap.isNull()) {
+        displayCartoonPixmap(pixmap);
     }
 }
 
+void StoryDisplayWindow::displayCartoonPixmap(const QPixmap& pixmap)
+{
+    // 设置艺术化漫画到专门的漫画标签（缓存中的图片已经缩放好，直接显示）
+    m_cartoonLabel->clear();
+    m_cartoonLabel->setPixmap(pixmap);
+    m_cartoonLabel->setAlignment(Qt::AlignCenter);
+    m_cartoonLabel->setVisible(true);  // 显示漫画框
+    
+    // 隐藏文字框，显示漫画框
+    m_scrollArea->setVisible(false);
+    
+    // 🎭 纯净样式
+    QString artStyle = QString(
+        "QLabel {"
+        "   background: transparent;"
+        "   border: none;"
+        "   padding: 0px;"
+        "   margin: 0px;"
+        "}"
+    );
+    m_cartoonLabel->setStyleSheet(artStyle);
+}
+
+void StoryDisplayWindow::showCartoonError(const QString& path)
+{
+    // 🎨 艺术化的错误提示
+    m_storyTextLabel->stopReveal();
+    m_storyTextLabel->setText("🎭 漫画作品暂时无法展示\n" + path);
+    m_storyTextLabel->setStyleSheet(
+        "QLabel { "
+        "   color: #8B4513; "
+        "   font-size: 22px; "
+        "   font-family: 'Georgia', serif; "
+        "   font-weight: bold; "
+        "   text-align: center; "
+        "   background: qlineargradient(x1:0, y1:0, x2:1, y2:1, "
+        "       stop:0 rgba(255, 228, 196, 240), "
+        "       stop:0.5 rgba(255, 248, 220, 200), "
+        "       stop:1 rgba(255, 255, 240, 220)); "
+        "   border-radius: 25px; "
+        "   padding: 40px; "
+        "   border: 3px dashed rgba(139, 69, 19, 180);"
+        "   margin: 20px;"
+        "}"
+    );
+}
+
 QString StoryDisplayWindow::getCartoonPath(const QString& filename)
 {
     QString appDir = QCoreApplication::applicationDirPath();
@@ -801,9 +574,7 @@ QSize StoryDisplayWindow::getOptimalCartoonSize(const QString& sizePreset)
 
 void StoryDisplayWindow::onNextCartoon()
 {
-    if (m_clickSound) {
-        m_clickSound->play();
-    }
+    playClickSound();
     
     if (m_currentCartoonIndex < m_cartoonPaths.size() - 1) {
         // 显示下一张漫画
@@ -818,6 +589,7 @@ void StoryDisplayWindow::onNextCartoon()
         m_scrollArea->setVisible(true);
         
         // 恢复原来的文本样式
+        m_storyTextLabel->stopReveal();
         m_storyTextLabel->clear();
         m_storyTextLabel->setStyleSheet("QLabel { color: #2F2F2F; font-size: 20px; font-family: 'Georgia', serif; padding: 45px; line-height: 2.8; font-weight: bold; background: rgba(255, 255, 255, 0); }");
         m_skipHintLabel->setText("点击任意位置继续 | 按ESC跳过");
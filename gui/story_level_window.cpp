@@ -1,4 +1,5 @@
 #include "gui/story_level_window.h"
+#include "gui/sound_bank.h"
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QShowEvent>
@@ -19,15 +20,10 @@ StoryLevelWindow::StoryLevelWindow(QWidget *parent)
     , level4Button(nullptr)
     , level5Button(nullptr)
     , backButton(nullptr)
-    , hoverSound(nullptr)
-    , clickSound(nullptr)
-    , backgroundMusic(nullptr)
 {
     setupUI();
     setupBackgroundImage();
     setupLevelButtons();
-    setupAudioEffects();
-    setupBackgroundMusic();
     
     // 默认只解锁第一关
     mUnlockedLevels = {1};
@@ -57,21 +53,16 @@ void StoryLevelWindow::setupUI()
     setCentralWidget(centralWidget);
     
     // 创建背景标签
-    backgroundLabel = new QLabel(centralWidget);
+    backgroundLabel = new ScaledImageLabel(centralWidget);
     backgroundLabel->setGeometry(0, 0, 1536, 1000);
-    backgroundLabel->setScaledContents(true);
 }
 
 void StoryLevelWindow::setupBackgroundImage()
 {
-    // 加载背景图片
-    QPixmap background("assets/images/worldmap.png");
-    if (background.isNull()) {
-        // 如果图片加载失败，设置默认背景色
-        backgroundLabel->setStyleSheet("background-color: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #1ABC9C, stop:1 #16A085);");
-    } else {
-        backgroundLabel->setPixmap(background);
-    }
+    // 默认背景色在图片解码完成前显示，图片加载失败时保留
+    backgroundLabel->setStyleSheet("background-color: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #1ABC9C, stop:1 #16A085);");
+    // 背景图片在后台解码并缩放到标签尺寸
+    backgroundLabel->setImagePaths({"assets/images/worldmap.png"});
 }
 
 void StoryLevelWindow::setupLevelButtons()
@@ -156,94 +147,25 @@ void StoryLevelWindow::setupLevelButtons()
     backButton->installEventFilter(this);
 }
 
-void StoryLevelWindow::setupAudioEffects()
-{
-    // 获取程序所在目录的绝对路径
-    QString appDir = QCoreApplication::applicationDirPath();
-    
-    // 初始化悬停音效
-    hoverSound = new QSoundEffect(this);
-    QString hoverSoundPath = appDir + "/assets/music/mode_select_hover.wav";
-    hoverSound->setSource(QUrl::fromLocalFile(hoverSoundPath));
-    hoverSound->setVolume(0.6);  // 设置音量为60%
-    
-    // 初始化点击音效
-    clickSound = new QSoundEffect(this);
-    QString clickSoundPath = appDir + "/assets/music/mode_select_click.wav";
-    clickSound->setSource(QUrl::fromLocalFile(clickSoundPath));
-    clickSound->setVolume(0.7);  // 设置音量为70%
-    
-    // 检查音效是否加载成功
-    if (hoverSound->status() != QSoundEffect::Ready) {
-        qDebug() << "剧情模式悬停音效加载失败:" << hoverSoundPath;
-    }
-    if (clickSound->status() != QSoundEffect::Ready) {
-        qDebug() << "剧情模式点击音效加载失败:" << clickSoundPath;
-    }
-}
-
-void StoryLevelWindow::setupBackgroundMusic()
-{
-    // 获取程序所在目录的绝对路径
-    QString appDir = QCoreApplication::applicationDirPath();
-    QString musicPath = appDir + "/assets/music/story_background.mp3";
-    
-    // 初始化背景音乐
-    backgroundMusic = new QMediaPlayer(this);
-    backgroundMusic->setMedia(QUrl::fromLocalFile(musicPath));
-    backgroundMusic->setVolume(70);  // 设置音量为70%，比剧情窗口稍低
-    
-    // 设置循环播放
-    connect(backgroundMusic, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
-        if (state == QMediaPlayer::StoppedState) {
-            backgroundMusic->play();  // 播放结束时重新开始
-        }
-    });
-    
-    // 检查音乐是否加载成功
-    if (backgroundMusic->error() != QMediaPlayer::NoError) {
-        qDebug() << "关卡选择背景音乐加载失败:" << backgroundMusic->errorString() << "路径:" << musicPath;
-    } else {
-        qDebug() << "关卡选择背景音乐加载成功:" << musicPath;
-    }
-}
-
 void StoryLevelWindow::startBackgroundMusic()
 {
-    if (backgroundMusic && backgroundMusic->error() == QMediaPlayer::NoError) {
-        // 重新连接循环播放的信号
-        connect(backgroundMusic, &QMediaPlayer::stateChanged, this, [this](QMediaPlayer::State state) {
-            if (state == QMediaPlayer::StoppedState) {
-                backgroundMusic->play();  // 播放结束时重新开始
-            }
-        });
-        backgroundMusic->play();
-        qDebug() << "开始播放关卡选择背景音乐";
-    }
+    // 音量比剧情窗口稍高，两个窗口共用同一首时切换不会从头播放
+    SoundBank::shared().playMusic(SoundBank::Music::Story, 70);
 }
 
 void StoryLevelWindow::stopBackgroundMusic()
 {
-    if (backgroundMusic && backgroundMusic->state() == QMediaPlayer::PlayingState) {
-        // 先断开循环播放的连接，防止stop()后立即重新播放
-        backgroundMusic->disconnect();
-        backgroundMusic->stop();
-        qDebug() << "停止播放关卡选择背景音乐";
-    }
+    SoundBank::shared().stopMusic(SoundBank::Music::Story);
 }
 
 void StoryLevelWindow::playHoverSound()
 {
-    if (hoverSound && hoverSound->status() == QSoundEffect::Ready) {
-        hoverSound->play();
-    }
+    SoundBank::shared().play(SoundBank::Effect::Hover, 0.6);
 }
 
 void StoryLevelWindow::playClickSound()
 {
-    if (clickSound && clickSound->status() == QSoundEffect::Ready) {
-        clickSound->play();
-    }
+    SoundBank::shared().play(SoundBank::Effect::Click, 0.7);
 }
 
 void StoryLevelWindow::updateLevelStatus(const std::vector<int>& unlockedLevels)
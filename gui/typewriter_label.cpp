@@ -0,0 +1,181 @@
+#include "gui/typewriter_label.h"
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOption>
+#include <QTextLayout>
+#include <QTextOption>
+#include <QtMath>
+
+TypewriterLabel::TypewriterLabel(QWidget *parent)
+    : QLabel(parent)
+    , m_nRevealed(0)
+    , m_nPadding(0)
+    , m_nLayoutWidth(-1)
+    , m_bRevealing(false)
+{
+}
+
+void TypewriterLabel::setTextPadding(int padding)
+{
+    m_nPadding = qMax(0, padding);
+}
+
+void TypewriterLabel::startReveal(const QString& text)
+{
+    QLabel::clear();
+    m_sText = text;
+    m_nRevealed = 0;
+    m_bRevealing = true;
+    layoutText();
+    update();
+}
+
+void TypewriterLabel::setRevealedCount(int count)
+{
+    count = qBound(0, count, getGlyphCount());
+    if (!m_bRevealing || count == m_nRevealed) {
+        return;
+    }
+    if (count < m_nRevealed || m_nRevealed == 0) {
+        m_nRevealed = count;
+        update();
+        return;
+    }
+    // 只重绘从上次显示到的行到新显示到的行
+    const QRectF dirty = lineSpan(m_aGlyphLine[m_nRevealed - 1], m_aGlyphLine[count - 1]);
+    m_nRevealed = count;
+    update(dirty.toAlignedRect());
+}
+
+void TypewriterLabel::revealAll()
+{
+    setRevealedCount(getGlyphCount());
+}
+
+void TypewriterLabel::stopReveal()
+{
+    m_bRevealing = false;
+    m_sText.clear();
+    m_aRendered = QPixmap();
+    m_aLineRects.clear();
+    m_aGlyphLine.clear();
+    m_aGlyphRight.clear();
+    m_nRevealed = 0;
+    update();
+}
+
+int TypewriterLabel::getRevealedBottom() const
+{
+    if (m_nRevealed == 0 || m_aLineRects.isEmpty()) {
+        return m_nPadding;
+    }
+    return qCeil(m_aLineRects[m_aGlyphLine[m_nRevealed - 1]].bottom());
+}
+
+void TypewriterLabel::layoutText()
+{
+    // 样式表中的字体和颜色在 polish 之后才生效
+    ensurePolished();
+    m_nLayoutWidth = width();
+    m_aLineRects.clear();
+    m_aGlyphLine.clear();
+    m_aGlyphRight.clear();
+
+    // 和QPainter::drawText一样把换行符当作行分隔符，长度不变，字形下标仍与原文对应
+    QString layoutText = m_sText;
+    layoutText.replace(QLatin1Char('\n'), QChar::LineSeparator);
+
+    const QFont textFont = font();
+    const QFontMetricsF metrics(textFont);
+    const qreal lineWidth = qMax(1, width() - 2 * m_nPadding);
+    QTextLayout layout(layoutText, textFont);
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    layout.setTextOption(option);
+
+    layout.beginLayout();
+    qreal y = m_nPadding;
+    while (true) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) {
+            break;
+        }
+        line.setLineWidth(lineWidth);
+        line.setPosition(QPointF(m_nPadding, y));
+        m_aLineRects.append(QRectF(0, y, width(), line.height()));
+        y += line.height() + metrics.leading();
+    }
+    layout.endLayout();
+
+    // 按光标位置划分字形，组合字符和代理对算作一个
+    int pos = 0;
+    while (pos < layoutText.length()) {
+        const int next = layout.nextCursorPosition(pos);
+        const int lineIndex = qMax(0, layout.lineForTextPosition(pos).lineNumber());
+        const QTextLine line = layout.lineAt(lineIndex);
+        const int lineEnd = line.textStart() + line.textLength();
+        m_aGlyphLine.append(lineIndex);
+        m_aGlyphRight.append(line.cursorToX(qMin(next, lineEnd)));
+        pos = next > pos ? next : pos + 1;
+    }
+
+    // 控件高度跟随文字，外层滚动区域才能滚到最后一行
+    const int textHeight = qCeil(y) + m_nPadding;
+    const int targetHeight = qMax(minimumHeight(), textHeight);
+    if (height() != targetHeight) {
+        resize(width(), targetHeight);
+    }
+
+    const qreal ratio = devicePixelRatioF();
+    m_aRendered = QPixmap(size() * ratio);
+    m_aRendered.setDevicePixelRatio(ratio);
+    m_aRendered.fill(Qt::transparent);
+    QPainter painter(&m_aRendered);
+    painter.setPen(palette().color(foregroundRole()));
+    layout.draw(&painter, QPointF(0, 0));
+}
+
+QRectF TypewriterLabel::lineSpan(int firstLine, int lastLine) const
+{
+    return m_aLineRects[firstLine].united(m_aLineRects[lastLine]);
+}
+
+void TypewriterLabel::paintEvent(QPaintEvent *event)
+{
+    if (!m_bRevealing) {
+        QLabel::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    // 样式表背景
+    QStyleOption styleOption;
+    styleOption.initFrom(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &styleOption, &painter, this);
+    if (m_nRevealed == 0 || m_aRendered.isNull()) {
+        return;
+    }
+
+    // 已显示的整行和当前行已显示的部分，各贴一次，与段落长度无关
+    const qreal ratio = m_aRendered.devicePixelRatio();
+    const QRectF& currentLine = m_aLineRects[m_aGlyphLine[m_nRevealed - 1]];
+    const QRectF fullLines(0, 0, width(), currentLine.top());
+    const QRectF partialLine(0, currentLine.top(), m_aGlyphRight[m_nRevealed - 1], currentLine.height());
+    for (const QRectF& target : {fullLines, partialLine}) {
+        if (!target.isEmpty()) {
+            const QRectF source(target.topLeft() * ratio, target.size() * ratio);
+            painter.drawPixmap(target, m_aRendered, source);
+        }
+    }
+}
+
+void TypewriterLabel::resizeEvent(QResizeEvent *event)
+{
+    QLabel::resizeEvent(event);
+    if (m_bRevealing && width() != m_nLayoutWidth) {
+        const int revealed = m_nRevealed;
+        layoutText();
+        m_nRevealed = qMin(revealed, getGlyphCount());
+    }
+}
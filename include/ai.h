@@ -4,6 +4,7 @@
 #include "snake.h"
 #include "map.h"
 #include "food_type.h"
+#include "bitboard.h"
 #include <vector>
 
 class AI {
@@ -59,8 +60,12 @@ private:
     // 检查是否在食物附近打转
     bool isSpinningNearFood(const Snake& aiSnake, int targetX, int targetY) const;
 
+    // 每次决策开始时构建一次可通行位图（面板内、非墙、非蛇身），之后的安全检查都是O(1)查位
+    void buildFreeCells(const Map& map, const Snake& playerSnake, const Snake& aiSnake) const;
+
     int mGameBoardWidth;
     int mGameBoardHeight;
+    mutable Bitboard mFreeCells;
 };
 
 #endif // AI_H
@@ -0,0 +1,86 @@
+#ifndef APP_CONTROLLER_H
+#define APP_CONTROLLER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+class QApplication;
+class GUIManager;
+class Game;
+
+// 整个会话只有一个应用控制器：QApplication、GUIManager（连同它的窗口、图片缓存和音效）
+// 和 Game（地图、存档线程、排行榜、预加载器）各只创建一次。模式选择（Qt）与经典模式、
+// 商店、第三关起的剧情关卡（ncurses）之间的切换只是场景切换：Qt一侧重新进入事件循环，ncurses一侧用
+// def_prog_mode/endwin 挂起、reset_prog_mode 恢复，不再递归调用 main 或重建 QApplication。
+//
+// 每次切换的耗时（从上一个场景结束到下一个场景可以交互）都会记录，第一次进入某个场景
+// 标为cold（包含创建QApplication、initscr和Game的开销，即原来每次切换都要付出的代价），
+// 之后标为warm。设置环境变量 SNAKE_TRANSITION_LOG=文件路径 时退出前把记录追加到该文件。
+class AppController
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Scene { ModeSelect, Classic, Shop, StoryLevel, Exit };
+
+    // argc 必须在控制器的整个生命周期内有效（QApplication 持有它的引用）
+    AppController(int& argc, char** argv);
+    ~AppController();
+
+    AppController(const AppController&) = delete;
+    AppController& operator=(const AppController&) = delete;
+
+    // 运行到用户退出，返回进程退出码
+    int run();
+
+    // 已完成的场景切换
+    struct Transition
+    {
+        Scene from;
+        Scene to;
+        double ms;
+        bool cold;
+    };
+    const std::vector<Transition>& getTransitions() const { return mTransitions; }
+
+private:
+    Scene runModeSelect();
+    Scene runClassic();
+    Scene runShop();
+    // Qt游戏窗口不支持的剧情关卡在ncurses中进行，结束后回到关卡选择
+    Scene runStoryLevel();
+
+    // 第一次需要时创建QApplication和GUIManager，没有图形环境或创建失败时返回false
+    bool ensureGui();
+    // 第一次调用时 initscr，之后从挂起状态恢复
+    void enterCurses();
+    // 挂起ncurses并恢复终端，保留程序模式以便下次恢复
+    void leaveCurses();
+    Game& game();
+
+    void beginTransition(Scene from);
+    void finishTransition(Scene to);
+    void writeTransitionLog() const;
+    static const char* sceneName(Scene scene);
+
+    int& mArgc;
+    char** mArgv;
+    std::unique_ptr<QApplication> mApp;     // 必须比 mGuiManager 后销毁
+    std::unique_ptr<GUIManager> mGuiManager;
+    std::unique_ptr<Game> mGame;
+    bool mGuiFailed = false;
+    bool mGuiStarted = false;
+    bool mCursesStarted = false;
+    bool mCursesActive = false;
+    bool mResumeStoryLevels = false;        // 下次进入Qt时回到关卡选择而不是模式选择
+
+    bool mTransitionPending = false;
+    Scene mTransitionFrom = Scene::Exit;
+    Clock::time_point mTransitionStart;
+    bool mVisited[5] = {false, false, false, false, false};
+    std::vector<Transition> mTransitions;
+};
+
+#endif // APP_CONTROLLER_H
@@ -0,0 +1,124 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "snake.h"
+#include "map.h"
+#include "snake_population.h"
+
+// 竞技场中蛇的控制策略
+enum class ArenaPolicy
+{
+    Greedy,   // 贪心地朝最近的食物移动
+    Scripted  // 直行，遇到障碍或随机时转弯
+};
+
+// 竞技场参数
+struct ArenaConfig
+{
+    int numSnakes = 500;        // 同时存在的蛇数量
+    int initialLength = 3;      // 初始长度
+    int numFoods = 0;           // 同时存在的食物数量，0 表示与蛇数量相同
+    int respawnDelay = 20;      // 死亡后多少tick重生，<0 表示不重生
+    bool corpseFood = true;     // 死亡蛇身是否变成食物（与尸体食物规则一致）
+    bool parallel = false;      // 是否把决策阶段分摊到多个核心
+    int numThreads = 0;         // 并行线程数，0 表示使用硬件并发数
+    ArenaPolicy policy = ArenaPolicy::Greedy;
+    unsigned int seed = 1;
+};
+
+// 竞技场：在一张大地图上同时模拟成百上千条蛇
+// 与Game解耦，不依赖ncurses，可以独立运行
+class Arena
+{
+public:
+    // 占用网格中的特殊取值，>=0 表示占据该格的蛇编号
+    static constexpr int kEmpty = -1;
+    static constexpr int kWall = -2;
+    static constexpr int kFood = -3;
+
+    Arena(const Map& map, const ArenaConfig& config);
+    ~Arena();
+
+    // 重新放置所有蛇和食物
+    void reset();
+    // 推进一个tick：批量决策 -> 批量移动 -> 一次遍历所有蛇头解决碰撞
+    void step();
+
+    void setParallel(bool parallel);
+    bool isParallel() const;
+
+    int getWidth() const;
+    int getHeight() const;
+    // 查询占用网格，越界视为墙
+    int getCell(int x, int y) const;
+
+    int getSnakeCount() const;
+    int getAliveCount() const;
+    bool isAlive(int id) const;
+    int getSnakeLength(int id) const;
+    int getSnakeScore(int id) const;
+    SnakeBody getSnakeHead(int id) const;
+    long long getTickCount() const;
+    const SnakePopulation& getPopulation() const;
+
+private:
+    bool spawnSnake(int id);
+    void killSnake(int id);
+    void refillFoods();
+    int randomEmptyCell(uint32_t& rng) const;
+
+    void decideRange(int begin, int end);
+    void decide(int id);
+    int moveCell(int cell, Direction direction) const;
+    bool isFreeCell(int cell) const;
+    void resolveMoves();
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(int index);
+
+    int mWidth;
+    int mHeight;
+    ArenaConfig mConfig;
+    long long mTick = 0;
+    int mAliveCount = 0;
+    uint32_t mSpawnRng;
+
+    // 占用网格：墙、食物、蛇身体，一格一个int
+    std::vector<int> mGrid;
+    std::vector<int> mWalls;
+    // 供批量蛇头内核查询的墙体字节图（末尾带填充）
+    std::vector<uint8_t> mWallMask;
+    // 蛇头认领表：记录本tick哪条蛇的蛇头进入了该格
+    std::vector<long long> mClaimTick;
+    std::vector<int> mClaimOwner;
+
+    // 蛇的身体与运动状态以结构数组方式存放
+    SnakePopulation mPopulation;
+    // 各条蛇的策略状态，同样按编号平行存放
+    std::vector<uint8_t> mEating;
+    std::vector<int> mTarget;            // 贪心策略追逐的食物格子
+    std::vector<int> mScore;
+    std::vector<long long> mRespawnTick;
+    std::vector<uint32_t> mRng;          // 每条蛇独立的随机状态，保证并行决策可复现
+    std::vector<uint8_t> mDead;
+
+    std::vector<int> mFoods;
+
+    // 常驻工作线程，避免每个tick创建线程
+    std::vector<std::thread> mWorkers;
+    std::mutex mPoolMutex;
+    std::condition_variable mPoolStart;
+    std::condition_variable mPoolDone;
+    int mThreadCount = 1;
+    long long mPoolGeneration = 0;
+    int mPoolPending = 0;
+    bool mPoolStop = false;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,176 @@
+#ifndef AUDIO_ENGINE_H
+#define AUDIO_ENGINE_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// 进程内音频：解码器按块流式读文件，混音线程把所有声部混成一路交给输出后端。
+// 游戏线程只往命令队列里放一条命令就返回，打开文件、解码和写声卡都在混音线程中完成，
+// 不再为放一首背景音乐 fork/exec 外部播放器，也不再用 pkill 按名字结束进程。
+//
+// 支持的格式：WAV（8/16/24/32位整数PCM）始终可用；编译时检测到 libmpg123 时支持mp3。
+// 输出后端：ALSA（编译时检测到时）、空输出和WAV文件输出，后两者不需要声卡，
+// 可以在无界面的环境里运行和检查混音结果。
+
+// 混音和输出使用的格式，样本为交错的16位有符号整数
+struct AudioFormat
+{
+    int sampleRate = 48000;
+    int channels = 2;
+};
+
+// 流式解码器：每次只解出调用方要的帧数，整首歌不会一次读进内存
+class AudioDecoder
+{
+public:
+    virtual ~AudioDecoder() = default;
+
+    virtual int getSampleRate() const = 0;
+    virtual int getChannels() const = 0;
+    // 读最多 frames 帧交错样本到 out，返回实际读到的帧数，0 表示已到结尾或出错
+    virtual size_t read(int16_t* out, size_t frames) = 0;
+    // 回到开头，循环播放时使用
+    virtual bool rewind() = 0;
+
+    // 按文件头选择解码器，无法打开或格式不支持时返回空
+    static std::unique_ptr<AudioDecoder> open(const std::string& path);
+    // 只按扩展名判断是否可能支持，不读文件，游戏线程可以放心调用
+    static bool isSupported(const std::string& path);
+};
+
+// 输出后端：write 阻塞到后端能接收这一块为止，由它决定混音线程的节奏
+class AudioOutput
+{
+public:
+    virtual ~AudioOutput() = default;
+
+    virtual bool open(const AudioFormat& format) = 0;
+    virtual bool write(const int16_t* samples, size_t frames) = 0;
+    virtual void close() = 0;
+    virtual const char* getName() const = 0;
+};
+
+// 丢弃所有样本；realtime 为true时按采样率的实际时长等待，否则立即返回
+class NullAudioOutput : public AudioOutput
+{
+public:
+    explicit NullAudioOutput(bool realtime = true);
+
+    bool open(const AudioFormat& format) override;
+    bool write(const int16_t* samples, size_t frames) override;
+    void close() override;
+    const char* getName() const override { return "null"; }
+
+    uint64_t getWrittenFrames() const { return mWrittenFrames; }
+
+private:
+    bool mRealtime;
+    AudioFormat mFormat;
+    uint64_t mWrittenFrames = 0;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+// 把混音结果写成WAV文件，close 时补写文件头中的长度
+class WavFileAudioOutput : public AudioOutput
+{
+public:
+    explicit WavFileAudioOutput(const std::string& path, bool realtime = true);
+    ~WavFileAudioOutput();
+
+    bool open(const AudioFormat& format) override;
+    bool write(const int16_t* samples, size_t frames) override;
+    void close() override;
+    const char* getName() const override { return "wav"; }
+
+private:
+    std::string mPath;
+    NullAudioOutput mPacer;         // 只用来按实际时长等待
+    AudioFormat mFormat;
+    std::FILE* mFile = nullptr;
+    uint64_t mDataBytes = 0;
+};
+
+// 按环境变量 SNAKE_AUDIO_OUTPUT 选择后端："null"、"wav:文件路径"，
+// 不设置时有ALSA用ALSA，否则用空输出
+std::unique_ptr<AudioOutput> createAudioOutput();
+
+class AudioEngine
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const size_t kBlockFrames = 1024;    // 每次混音的帧数，48kHz下约21ms
+
+    explicit AudioEngine(std::unique_ptr<AudioOutput> output, AudioFormat format = AudioFormat());
+    // 停止混音线程并关闭输出
+    ~AudioEngine();
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    // 以下调用都只是提交命令，立即返回；实际的打开和停止在下一个混音块生效。
+    // 格式明显不支持时返回false
+    bool playMusic(const std::string& path, bool loop, float volume = 1.0f);
+    void stopMusic();
+    bool playEffect(const std::string& path, float volume = 1.0f);
+    void stopAll();
+
+    bool isMusicPlaying() const;
+    const char* getOutputName() const;
+    // 混音线程已经交给输出的总帧数
+    uint64_t getMixedFrames() const;
+    // 最近一次命令从提交到在混音线程中生效的毫秒数
+    double getLastCommandLatencyMs() const;
+    // 阻塞直到命令队列处理完且没有正在播放的声部（非循环），用于离线渲染
+    void waitIdle();
+
+private:
+    enum class CommandType { PlayMusic, StopMusic, PlayEffect, StopAll };
+
+    struct Command
+    {
+        CommandType type;
+        std::string path;
+        bool loop = false;
+        float volume = 1.0f;
+        Clock::time_point submitted;
+    };
+
+    struct Voice;
+
+    void submit(Command command);
+    void run();
+    void applyCommands(std::deque<Command>& commands);
+    void mixBlock(std::vector<int32_t>& accumulator, std::vector<int16_t>& block);
+
+    std::unique_ptr<AudioOutput> mOutput;
+    AudioFormat mFormat;
+    bool mOutputOpen = false;
+
+    std::thread mThread;
+    mutable std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mIdle;
+    std::deque<Command> mCommands;
+    bool mStop = false;
+    bool mActive = false;                   // 混音线程持有正在播放的声部
+
+    // 以下只在混音线程中访问
+    std::vector<std::unique_ptr<Voice>> mVoices;
+
+    std::atomic<bool> mMusicPlaying{false};
+    std::atomic<uint64_t> mMixedFrames{0};
+    std::atomic<int64_t> mLastLatencyUs{0};
+};
+
+#endif // AUDIO_ENGINE_H
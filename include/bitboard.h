@@ -0,0 +1,71 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+#include <cstdint>
+
+// 按行打包的位图：每行占若干个64位字，第 x 列对应第 x / 64 个字的第 x % 64 位
+// 用于墙体/占用表示，连通性、死路判断和空格计数都可以按字做移位、与、或和popcount
+class Bitboard
+{
+public:
+    Bitboard();
+    Bitboard(int width, int height);
+
+    // 调整大小并清空
+    void resize(int width, int height);
+    void clear();
+    // 把所有格子置位
+    void fill();
+
+    int getWidth() const;
+    int getHeight() const;
+    int getWordsPerRow() const;
+
+    // 越界视为未置位
+    bool test(int x, int y) const;
+    void set(int x, int y);
+    void reset(int x, int y);
+
+    uint64_t* row(int y);
+    const uint64_t* row(int y) const;
+
+    // 置位格子总数
+    int count() const;
+    // 上下左右四个邻居中置位的数量
+    int countNeighbours(int x, int y) const;
+
+    // 把本位图当作可通行区域，从 (x, y) 出发做四连通填充，结果写入 region，返回连通格子数
+    int floodFill(int x, int y, Bitboard& region) const;
+    int countReachable(int x, int y) const;
+
+    // 按行优先顺序遍历所有置位的格子
+    template <typename Callback>
+    void forEachSet(Callback callback) const
+    {
+        for (int y = 0; y < mHeight; y++)
+        {
+            const uint64_t* words = row(y);
+            for (int w = 0; w < mWordsPerRow; w++)
+            {
+                uint64_t bits = words[w];
+                while (bits != 0)
+                {
+                    callback(w * 64 + __builtin_ctzll(bits), y);
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+private:
+    // 每行最后一个字中超出宽度的位
+    uint64_t tailMask() const;
+
+    int mWidth;
+    int mHeight;
+    int mWordsPerRow;
+    std::vector<uint64_t> mWords;
+};
+
+#endif // BITBOARD_H
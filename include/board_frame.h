@@ -0,0 +1,108 @@
+#ifndef BOARD_FRAME_H
+#define BOARD_FRAME_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 棋盘格子上显示的内容，图形界面按这个取贴图
+enum class BoardCell : uint8_t
+{
+    Empty = 0,
+    Wall,
+    Head,
+    Body,
+    OpponentHead,
+    OpponentBody,
+    Food,
+    SpecialFood,
+    Poison,
+    CorpseFood,
+    RandomItem,
+    Count
+};
+
+// 一次tick中某个格子发生的变化
+enum class BoardChange : uint8_t
+{
+    Head,           // 蛇头进入，或原蛇头变成蛇身
+    TailCleared,    // 蛇尾离开（移动或被毒药缩短）
+    Spawned,        // 食物、道具、尸体食物或重生的蛇身出现
+    Despawned       // 被吃掉、超时消失或死亡的蛇身移除
+};
+
+// 变化格子：位置、变化后的内容和变化原因
+struct BoardDeltaCell
+{
+    int16_t x;
+    int16_t y;
+    BoardCell cell;
+    BoardChange change;
+};
+
+// 一次tick的棋盘增量。full 为真时表示整盘都变了（新开一局），需要重新取整帧
+struct BoardDelta
+{
+    bool full = false;
+    std::vector<BoardDeltaCell> cells;
+
+    void clear()
+    {
+        full = false;
+        cells.clear();
+    }
+};
+
+// 一帧棋盘：每格一个字节，按行存放。由引擎填写，界面只读，不依赖Qt
+struct BoardFrame
+{
+    int width = 0;
+    int height = 0;
+    std::vector<BoardCell> cells;
+
+    void resize(int newWidth, int newHeight)
+    {
+        width = newWidth;
+        height = newHeight;
+        cells.assign(static_cast<size_t>(width) * height, BoardCell::Empty);
+    }
+
+    void clear()
+    {
+        cells.assign(cells.size(), BoardCell::Empty);
+    }
+
+    bool contains(int x, int y) const
+    {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+
+    BoardCell at(int x, int y) const
+    {
+        return cells[static_cast<size_t>(y) * width + x];
+    }
+
+    void set(int x, int y, BoardCell cell)
+    {
+        if (contains(x, y))
+        {
+            cells[static_cast<size_t>(y) * width + x] = cell;
+        }
+    }
+
+    // 把增量写入本帧；full 增量无法增量应用，返回false，调用方需要重新取整帧
+    bool apply(const BoardDelta& delta)
+    {
+        if (delta.full)
+        {
+            return false;
+        }
+        for (const BoardDeltaCell& change : delta.cells)
+        {
+            set(change.x, change.y, change.cell);
+        }
+        return true;
+    }
+};
+
+#endif // BOARD_FRAME_H
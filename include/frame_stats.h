@@ -0,0 +1,156 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 性能面板的数据来源：游戏循环每帧（每个tick）记录各阶段耗时，写进单生产者单消费者的
+// 无锁环形缓冲区；面板在绘制时取出新样本，对最近 kWindow 帧算 p50/p99、帧率、丢帧数
+// 和每帧的内存分配次数。生产者只做几次 steady_clock 读数和一次数组写入，不加锁也不分配内存，
+// 面板关闭时不取样本也不影响游戏循环（环满后新样本直接丢弃并计数）；面板打开时先调用
+// restartWindow 丢掉积压的旧样本，统计窗口只包含打开之后的帧。
+
+// 一帧中的阶段，顺序即面板上的显示顺序
+enum class FramePhase : uint8_t
+{
+    Input = 0,      // 读按键、处理道具和存档请求
+    AI,             // 对手寻路
+    Sim,            // 移动、碰撞和道具结算
+    Spawn,          // 生成食物、道具，死亡后重生
+    Render,         // 绘制
+    Count
+};
+
+struct FrameSample
+{
+    uint32_t phaseUs[static_cast<size_t>(FramePhase::Count)];
+    uint32_t frameUs;           // 从帧开始到帧结束，不含 idle() 标出的等待
+    uint32_t intervalUs;        // 与上一帧开始的间隔，0 表示没有上一帧
+    uint32_t dropped;           // 这一帧之前丢掉（或迟到到错过）的帧数
+    uint32_t allocations;       // 这一帧内 operator new 的调用次数
+};
+
+// 单生产者单消费者无锁环形缓冲区，容量必须是2的幂。
+// push 只在生产者线程调用，pop 只在消费者线程调用，两边可以是同一个线程
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // 满时返回false，不覆盖消费者还没取走的样本
+    bool push(const T& item)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        mItems[head & (Capacity - 1)] = item;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mHead.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = mItems[tail & (Capacity - 1)];
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> mItems;
+    alignas(64) std::atomic<size_t> mHead{0};   // 生产者写，下一个写入位置
+    alignas(64) std::atomic<size_t> mTail{0};   // 消费者写，下一个读取位置
+};
+
+// 最近 kWindow 帧的统计结果，时间单位为毫秒
+struct FrameStatsSummary
+{
+    struct Percentiles
+    {
+        double p50 = 0.0;
+        double p99 = 0.0;
+    };
+
+    size_t samples = 0;
+    Percentiles phases[static_cast<size_t>(FramePhase::Count)];
+    Percentiles frame;
+    double fps = 0.0;                   // 按帧间隔算出的实际帧率
+    uint64_t dropped = 0;               // 开始统计以来的累计丢帧数
+    uint64_t overflowed = 0;            // 环满时丢弃的样本数（面板关闭期间）
+    double allocationsPerFrame = 0.0;   // 窗口内平均每帧的分配次数
+};
+
+class FrameStats
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const size_t kRingCapacity = 256;
+    static const size_t kWindow = 120;      // 统计最近多少帧
+
+    FrameStats();
+
+    // ---- 生产者：只在游戏循环所在的线程调用 ----
+    // 开始一帧；targetIntervalMs 大于0时，帧间隔超过目标的1.5倍按错过的帧数计入丢帧
+    void beginFrame(int targetIntervalMs = 0);
+    // 把上一个阶段结束（或帧开始）以来的时间计入 phase，同一阶段可以多次累加
+    void endPhase(FramePhase phase);
+    // 上一个阶段结束以来的时间是帧内的等待（如按节奏睡眠），不计入任何阶段和帧耗时
+    void idle();
+    // 计入一段在帧外测得的耗时（如Qt中异步完成的绘制）
+    void addPhaseTime(FramePhase phase, Clock::duration duration);
+    // 调用方自己判断出的丢帧（如放弃积压的tick）
+    void addDropped(int frames);
+    // 结束这一帧并写入环形缓冲区
+    void endFrame();
+
+    // ---- 消费者：只在一个线程（绘制面板的线程）调用 ----
+    // 丢掉环中积压的样本并清空统计窗口，面板打开时调用
+    void restartWindow();
+    // 取出所有新样本并重新统计
+    const FrameStatsSummary& summarize();
+
+    // 进程内 operator new 的累计调用次数；没有链接 alloc_counter.o 时恒为0
+    static uint64_t getAllocationCount();
+
+private:
+    static uint32_t toMicros(Clock::duration duration);
+    static FrameStatsSummary::Percentiles percentiles(std::vector<uint32_t>& values);
+
+    SpscRing<FrameSample, kRingCapacity> mRing;
+    std::atomic<uint64_t> mOverflowed{0};
+
+    // 生产者状态
+    FrameSample mCurrent;
+    Clock::time_point mFrameStart;
+    Clock::time_point mPhaseStart;
+    Clock::time_point mLastFrameStart;
+    bool mHasLastFrame = false;
+    uint64_t mAllocationsAtStart = 0;
+    Clock::duration mIdle{0};
+    uint32_t mPendingDropped = 0;
+
+    // 消费者状态
+    std::array<FrameSample, kWindow> mWindow;
+    size_t mWindowCount = 0;
+    size_t mWindowNext = 0;
+    uint64_t mTotalDropped = 0;
+    std::vector<uint32_t> mScratch;     // 求分位数用，预先分配好
+    FrameStatsSummary mSummary;
+};
+
+// operator new 调用计数，由 alloc_counter.cpp 中替换的全局 operator new 累加
+extern std::atomic<uint64_t> gAllocationCount;
+
+#endif // FRAME_STATS_H
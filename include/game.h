@@ -14,18 +14,27 @@
 #include <set>
 #include <map>
 #include <fstream>   // 用于文件检查
-#include <cstdlib>   // 用于system函数
-#include <cstdio>    // 用于popen函数
+#include <cstdlib>
+#include <cstdio>
 
 // 自定义模块
 #include "snake.h"
 #include "map.h"
 // #include "ai.h" // 移除
 #include "food_type.h"
+#include "story_index.h"
+#include "frame_stats.h"
 class AI;
+class Arena;
+class SaveWorker;
+class LeaderboardStore;
+class LevelPreloader;
+class AudioEngine;
+struct LeaderboardKey;
+struct GameSnapshot;
 
 // ========== 枚举定义 ==========
-enum class GameMode { Classic, Level, Timed, Battle ,Shop};
+enum class GameMode { Classic, Level, Timed, Battle ,Shop, Arena};
 enum class LevelType { Normal, Speed, Maze, Custom1, Custom2 };
 enum class LevelStatus { Locked, Unlocked, Completed };
 enum class BossState { Red, Green };
@@ -159,18 +168,47 @@ private:
     int mPlayerLives = 3; // 玩家生命值
     int mPlayer2Lives = 3; // 玩家2/AI生命值
 
-    // 排行榜
-    const std::string mRecordBoardFilePath = "record.dat";
-    std::vector<int> mLeaderBoard;
+    // 排行榜：按模式、地图和关卡分榜存放在 leaderboard/ 目录
+    const std::string mRecordBoardFilePath = "record.dat"; // 旧版所有模式共用的前5名，启动时迁移
+    const std::string mLeaderboardDirectory = "leaderboard";
+    std::unique_ptr<LeaderboardStore> mPtrLeaderboard;
+    std::vector<int> mLeaderBoard; // 当前榜单的前几名，供侧边栏显示
     const int mNumLeaders = 5;
+    std::string mCurrentMapName; // 经典/限时模式当前的地图
+    std::chrono::steady_clock::time_point mRoundStartTime; // 本局开始时刻，记录用时
+    LeaderboardKey currentLeaderboardKey() const;
+    void migrateLegacyLeaderBoard();
     bool readLeaderBoard();
     bool updateLeaderBoard();
-    bool writeLeaderBoard();
     void renderLeaderBoard() const;
     void renderPoints() const;
     
     // 存档文件路径
     const std::string mSaveFilePath = "game_save.dat";
+    // 最近一次读档失败的原因
+    std::string mSaveError;
+    // 游戏状态与存档快照之间的转换
+    void captureSnapshot(GameSnapshot& snapshot) const;
+    void applySnapshot(const GameSnapshot& snapshot);
+    // 后台写盘线程，saveGame只拍快照并提交
+    std::unique_ptr<SaveWorker> mPtrSaveWorker;
+    // 信息栏中的存档提示，显示一段时间后自动清除，不阻塞游戏循环
+    std::string mSaveToastText;
+    std::chrono::steady_clock::time_point mSaveToastExpire;
+    bool mSaveToastVisible = false;
+    double mLastSaveWriteMs = 0.0;      // 最近一次存档的落盘耗时（写临时文件+fsync+rename）
+    double mLastSaveVisibleMs = 0.0;    // 最近一次从按键到提示画出的耗时
+    void showSaveToast(const std::string& text, int durationMs);
+    void updateSaveToast();
+
+    // 自动存档：每隔一段时间和在关卡检查点拍一次快照，编码和写盘都在后台线程；
+    // 程序崩溃后 Load Game 会在手动存档和自动存档中取较新的一个
+    int mAutosaveIntervalSeconds = 10;
+    const std::string mAutosaveFilePath = "autosave.dat";
+    std::chrono::steady_clock::time_point mLastAutosaveTime;
+    void maybeAutosave();
+    void autosaveNow();
+    void clearAutosave();
 
     // 食物与控制
     void createRamdonFood();
@@ -209,7 +247,7 @@ private:
     bool mReturnToModeSelect = false;
     bool mIsLevelMode = false;
     bool mIsLevelRetry = false; // 标记是否是重试关卡
-    const std::string mLevelProgressFilePath = "level_progress.dat";
+    const std::string mLevelProgressFilePath = "level_progress.dat"; // 旧版关卡进度，启动时迁移
     std::vector<std::string> mLevelMapFiles = {
         "maps/level1.txt", "maps/level2.txt", "maps/level3.txt",
         "maps/level4.txt", "maps/level5.txt"
@@ -224,7 +262,34 @@ private:
     void unlockLevel(int level);
     bool saveLevelProgress();
     bool loadLevelProgress();
+    // 关卡切换：通关叙述期间后台预加载下一关，并统计从 initializeLevel 到关卡循环开始的耗时
+    std::unique_ptr<LevelPreloader> mPtrLevelPreloader;
+    std::chrono::steady_clock::time_point mLevelTransitionStart;
+    bool mLevelStartupPending = false;
+    bool mLevelMapPreloaded = false;     // 当前关卡的地图是否来自预加载
+    // 进程内播放背景音乐，第一次需要时才创建混音线程
+    std::unique_ptr<AudioEngine> mPtrAudioEngine;
+    // 性能面板（F3切换）：每帧各阶段的耗时写入 mFrameStats，面板画在侧边栏下半部分
+    FrameStats mFrameStats;
+    bool mShowPerfHud = false;
+    std::chrono::steady_clock::time_point mLastPerfHudDraw;
+    void togglePerfHud();
+    void updatePerfHud();               // 面板打开时限频重画，慢终端上面板本身不成为负担
+    void renderPerfHud() const;
+    // 存档落盘、关卡启动等开发用耗时不显示给玩家；设置环境变量 SNAKE_PERF_LOG=文件路径 时追加到该文件
+    void appendPerfLog(const char* text) const;
+    double mLastLevelStartupMs = 0.0;
+    std::string levelMapPath(int level) const;
+    void preloadLevel(int level);
+    std::unique_ptr<Map> acquireLevelMap(int level);
+    void showLevelIntroduction(int level);  // 非重试时显示开场介绍，介绍时长不计入启动耗时
+    void reportLevelStartup();
     void renderLevel() const;
+    const std::string mStoryFilePath = "assets/text/plot.txt";
+    // 剧情索引中某关的开场或结尾，按宽度折好行，每段一组，空组表示短暂停顿
+    std::vector<std::vector<std::string>> levelStoryPages(int level, StoryIndex::Part part, int width);
+    // 打字机效果显示一页已折好的行（每行居中），按ESC时返回false
+    bool typewriteLines(WINDOW* win, const std::vector<std::string>& lines, int firstRow, int width);
     void displayLevelIntroduction(int level); // 显示关卡开场介绍文字
     void displayLevelCompletion(int level);   // 显示关卡通关后的文字叙述
     void runLevel3Mode1();                    // 第三关模式一：镜像之舞
@@ -304,6 +369,10 @@ private:
     const char mSnakeSymbol2 = '&';
     bool selectBattleType();
     void initializeBattle(BattleType type);
+    // 死亡后在离对手尽量远、不压住对手和尸体食物的出生点复活，找不到时用固定位置
+    void respawnBattleSnake(Snake& snake, const Snake& opponent, int fallbackX, int fallbackY,
+                            InitialDirection fallbackDirection);
+    const int mBattleSpawnSpace = 3; // 复活点前方至少留出的空间
     void runBattle();
     void controlSnakes(int key);
     std::string checkBattleCollisions();
@@ -316,6 +385,23 @@ private:
     bool mAccelerateP1 = false;
     bool mAccelerateP2 = false;
 
+    // ========== 竞技场模式 ==========
+    std::unique_ptr<Arena> mPtrArena;
+    std::unique_ptr<Map> mPtrArenaMap;
+    const std::string mArenaMapFile = "maps/arena.txt"; // 可选的自定义竞技场地图
+    const int mArenaMapSize = 1000;     // 没有自定义地图时使用 1000x1000 的空地图
+    int mArenaSnakeCount = 500;
+    int mArenaFollowId = 0;             // 视窗跟随的蛇
+    int mArenaTicksPerFrame = 1;        // 每帧推进的tick数，快进时增大
+    double mArenaTickMs = 0.0;          // 最近一帧的平均tick耗时
+    void initializeArena();
+    void runArena();
+    void renderArena() const;
+    void renderArenaStatus() const;
+
+    // 皮肤、金币、道具和关卡进度都存放在 ProfileStore（profile.db + profile.wal）
+    void migrateLegacyProfile(); // 旧版三个 .dat 文件在一个事务里导入，之后改名为 .migrated
+
     // 皮肤和金币相关
     int mCoins = 100; // 初始金币
     SnakeSkin mCurrentSkin = SnakeSkin::Default;
@@ -0,0 +1,80 @@
+#ifndef BOARD_WIDGET_H
+#define BOARD_WIDGET_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QBrush>
+#include <QColor>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QPainter>
+#include "board_frame.h"
+
+// 游戏棋盘：整个棋盘只有这一个控件，paintEvent 按 BoardFrame 从贴图集中逐格拷贝。
+// 每种格子的贴图在格子尺寸变化时用预先建好的画刷画一次，之后每帧只做位图拷贝，
+// 并且只画与重绘区域相交的格子。格子尺寸随控件大小缩放，棋盘居中显示。
+// 每个tick通过 applyDelta 只提交变化的格子，重绘量与变化量成正比，而不是与棋盘大小成正比。
+class BoardWidget : public QWidget
+{
+public:
+    explicit BoardWidget(QWidget *parent = nullptr);
+
+    // 复制一帧并请求整块重绘
+    void setFrame(const BoardFrame& frame);
+    const BoardFrame& frame() const { return m_aFrame; }
+    // 应用一个tick的增量，只对变化的格子请求重绘；full 增量返回false，调用方应改用setFrame
+    bool applyDelta(const BoardDelta& delta);
+
+    // 玩家蛇的颜色（皮肤），会重建贴图集
+    void setSnakeColors(const QColor& fill, const QColor& border);
+
+    // 绘制耗时统计（毫秒），只计 paintEvent 内的时间
+    double getLastPaintMs() const { return m_dLastPaintMs; }
+    double getAveragePaintMs() const;
+    double getTotalPaintMs() const { return m_dTotalPaintMs; }
+    int getPaintCount() const { return m_nPaintCount; }
+    // 最近一次 paintEvent 画了多少格
+    int getLastPaintedCells() const { return m_nLastPaintedCells; }
+    void resetPaintStats();
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    static const int kPreferredCellSize = 20;
+    static const int kMinimumCellSize = 4;
+    static const int kTileCount = static_cast<int>(BoardCell::Count);
+    // 一个tick变化的格子超过这个数时合并成按行的矩形再提交
+    static const int kCoalesceThreshold = 32;
+
+    void setupBrushes();
+    // 根据控件大小重新计算格子尺寸和棋盘左上角；尺寸变化时重建贴图集
+    void updateLayout();
+    void buildAtlas();
+    QRect cellRect(int x, int y) const;
+    // 画与 area 相交的格子，返回画了多少格
+    int paintCells(QPainter& painter, const QRect& area);
+
+    BoardFrame m_aFrame;
+    QBrush m_aFillBrushes[kTileCount];
+    QBrush m_aBorderBrushes[kTileCount];
+    QBrush m_aBackgroundBrush;
+    QPixmap m_aAtlas;           // 一行 kTileCount 个格子贴图，按设备像素比绘制
+    QRect m_aTileSources[kTileCount];   // 每种格子在贴图集中的位置（设备像素）
+    int m_nCellSize;
+    QPoint m_aOrigin;
+
+    double m_dLastPaintMs;
+    double m_dTotalPaintMs;
+    int m_nPaintCount;
+    int m_nLastPaintedCells;
+};
+
+#endif // BOARD_WIDGET_H
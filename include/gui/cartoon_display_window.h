@@ -8,6 +8,7 @@
 #include <QHBoxLayout>
 #include <QKeyEvent>
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <QPixmap>
 #include <QPushButton>
 #include <QScrollArea>
@@ -37,16 +38,21 @@ protected:
     void mousePressEvent(QMouseEvent *event) override;
     void showEvent(QShowEvent *event) override;
     void hideEvent(QHideEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private slots:
     void onNextCartoon();                 // 显示下一张漫画
     void onPreviousCartoon();             // 显示上一张漫画
     void onSkipCartoons();                // 跳过所有漫画
+    void onImageReady(const QString& path, const QSize& size, bool ok); // 后台解码完成
 
 private:
     void setupUI();                       // 设置界面
     void setupAudioEffects();             // 设置音效
-    void loadCartoon(const QString& path); // 加载单张漫画
+    void loadCartoon(const QString& path); // 加载单张漫画（先查缓存，未命中时后台解码）
+    void showCartoonError(const QString& path); // 显示无法加载的提示
+    void prefetchNeighbors();             // 预取前后两张漫画
+    QSize cartoonSize() const;            // 漫画缩放的目标尺寸
     void updateNavigationButtons();       // 更新导航按钮状态
     void showCurrentCartoon();            // 显示当前漫画
     QString getCartoonPath(const QString& filename); // 获取漫画完整路径
@@ -73,9 +79,11 @@ private:
     
     // 定时器
     QTimer *m_hintTimer;                  // 提示显示定时器
+    QTimer *m_resizeTimer;                // 尺寸停止变化后才重新缩放
     
     // 常量
     static const int HINT_DELAY = 2000;   // 提示延迟（毫秒）
+    static const int RESIZE_DEBOUNCE = 150; // 尺寸变化合并间隔（毫秒）
 };
 
 #endif // CARTOON_DISPLAY_WINDOW_H 
\ No newline at end of file
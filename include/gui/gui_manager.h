@@ -8,6 +8,7 @@
 class ModeSelectWindow;
 class StoryLevelWindow;
 class StoryDisplayWindow;
+class SnakeGameWindow;
 
 class GUIManager : public QObject
 {
@@ -30,6 +31,13 @@ public:
     
     // 新增：商店相关
     bool isShopRequested() const;       // 是否请求进入商店
+    // 所选关卡需要在ncurses中进行（Qt游戏窗口不支持该关卡的玩法）
+    bool isTerminalLevelRequested() const;
+
+    // 从经典模式或商店回来：清除上次的选择，重新同步进度并显示已有的模式选择窗口
+    void returnToModeSelect();
+    // 从ncurses中的剧情关卡回来：同步进度并回到关卡选择窗口
+    void returnToStoryLevels();
 
 
 private slots:
@@ -46,22 +54,28 @@ private slots:
     void onPrologueCartoonFinished();   // 序章漫画播放完成
     void onLevel5CartoonFinished();     // Level5漫画播放完成
     void onShopRequested();             // 商店请求
+    void onGameLevelCompleted(int level); // Qt游戏窗口中关卡胜利
+    void onGameExited();                // Qt游戏窗口中游戏结束或关闭
 
 private:
     void showModeSelectWindow();        // 显示模式选择窗口
     void showStoryLevelWindow();        // 显示剧情关卡选择窗口
     void showStoryDisplayWindow();      // 显示剧情播放窗口
     void loadLevelProgress();           // 加载关卡进度
+    void startSelectedLevel();          // 在Qt游戏窗口中开始所选关卡
+    void saveLevelCompleted(int level); // 记录通关并解锁下一关
     
     std::unique_ptr<ModeSelectWindow> mModeSelectWindow;
     std::unique_ptr<StoryLevelWindow> mStoryLevelWindow;
     std::unique_ptr<StoryDisplayWindow> mStoryDisplayWindow;
+    std::unique_ptr<SnakeGameWindow> mSnakeGameWindow;
     
     bool mClassicModeSelected;          // 是否选择经典模式
     bool mExitRequested;                // 是否请求退出
     int mSelectedLevel;                 // 选择的关卡
     std::vector<int> mUnlockedLevels;   // 已解锁的关卡
     bool mShopRequested;                // 是否请求进入商店
+    bool mTerminalLevelRequested;       // 所选关卡交给ncurses进行
 };
 
 #endif // GUI_MANAGER_H 
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QPixmap>
+#include <QImage>
+#include <QString>
+#include <QSize>
+#include <QSet>
+#include <QVector>
+
+// 漫画、剧情和背景图片缓存：解码和平滑缩放在QThreadPool中完成，结果按 (路径, 目标尺寸)
+// 放入按字节计的LRU缓存。翻页时先查缓存，命中直接显示；未命中时发起后台解码，
+// 完成后通过 imageReady 通知。窗口在显示当前图时顺带预取前后两张。
+//
+// 每张图第一次用到时在后台解码一次并建好逐级减半的图像金字塔（mip链），之后任何尺寸
+// 都从不小于目标尺寸的最小一级缩放，而不是每次从原图缩放。金字塔和缩放结果共用一个
+// 可配置的预算（环境变量 SNAKE_IMAGE_CACHE_MB 或 setBudgetBytes），金字塔占四分之三。
+// 只在GUI线程中调用；工作线程只做解码和缩放，不碰缓存。
+class ImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kDefaultBudgetBytes = 96 * 1024 * 1024;
+    static const int kMinLevelSide = 64;    // 金字塔最小一级的短边
+
+    // 进程内共用的缓存
+    static ImageCache& shared();
+
+    explicit ImageCache(QObject *parent = nullptr);
+
+    // 已缓存的图片（按 mode 缩放到 size），没有时返回空QPixmap
+    QPixmap lookup(const QString& path, const QSize& size, Qt::AspectRatioMode mode = Qt::KeepAspectRatio);
+    // 没有缓存且不在处理中时提交后台缩放（金字塔还没建好时先建金字塔），完成后发出 imageReady
+    void request(const QString& path, const QSize& size, Qt::AspectRatioMode mode = Qt::KeepAspectRatio);
+    bool isPending(const QString& path, const QSize& size, Qt::AspectRatioMode mode = Qt::KeepAspectRatio) const;
+    // 只在后台建好金字塔，窗口显示前调用，真正请求尺寸时只剩一次小图缩放
+    void preload(const QString& path);
+
+    // 缓存上限（字节），超出时淘汰最久未使用的金字塔或缩放结果；
+    // 单张缩放结果就超出预算时不进缓存，只保留最近的一张用于显示
+    void setBudgetBytes(int bytes);
+    int getBudgetBytes() const;
+
+    int getHitCount() const { return m_nHits; }
+    int getMissCount() const { return m_nMisses; }
+    int getPyramidBuildCount() const { return m_nPyramidBuilds; }
+
+    // 从原图建金字塔：第0级为原图，之后每级宽高减半，直到短边小于 kMinLevelSide
+    static QVector<QImage> buildPyramid(const QImage& source);
+    // 从不小于目标尺寸的最小一级缩放；目标比原图还大时从原图放大
+    static QImage scaleFromPyramid(const QVector<QImage>& levels, const QSize& size, Qt::AspectRatioMode mode);
+
+signals:
+    // ok 为false表示文件无法解码
+    void imageReady(const QString& path, const QSize& size, bool ok);
+
+private slots:
+    // 后台任务完成，在GUI线程中放入缓存
+    void onPyramidBuilt(const QString& path, const QVector<QImage>& levels);
+    void onDecoded(const QString& path, const QSize& size, int mode, const QImage& image);
+
+private:
+    // 等金字塔建好后再缩放的请求
+    struct ScaleRequest
+    {
+        QSize size;
+        Qt::AspectRatioMode mode;
+    };
+
+    struct Pyramid
+    {
+        QVector<QImage> levels;
+    };
+
+    static QString cacheKey(const QString& path, const QSize& size, Qt::AspectRatioMode mode);
+    static int costOf(const QVector<QImage>& levels);
+    void startScale(const QString& path, const QVector<QImage>& levels, const ScaleRequest& scale);
+
+    QCache<QString, QPixmap> m_aCache;          // 缩放结果，代价单位为KB
+    QCache<QString, Pyramid> m_aPyramids;       // 路径 -> 金字塔，代价单位为KB
+    QSet<QString> m_aPending;                   // 正在缩放的 cacheKey
+    QString m_sOversizedKey;                    // 超出缩放结果预算、不进缓存的最近一张图
+    QPixmap m_aOversized;
+    QHash<QString, QList<ScaleRequest>> m_aWaiting; // 正在建金字塔的路径 -> 建好后要缩放的尺寸
+    int m_nHits;
+    int m_nMisses;
+    int m_nPyramidBuilds;
+};
+
+#endif // IMAGE_CACHE_H
@@ -8,9 +8,8 @@
 #include <QHBoxLayout>
 #include <QPixmap>
 #include <QWidget>
-#include <QSoundEffect>
 #include <QUrl>
-#include <QMediaPlayer>
+#include "gui/scaled_image_label.h"
 
 class ModeSelectWindow : public QMainWindow
 {
@@ -40,28 +39,19 @@ protected:
 private:
     void setupUI();                  // 设置界面
     void setupBackgroundImage();     // 设置背景图片
-    void setupAudioEffects();        // 设置音效
-    void setupBackgroundMusic();     // 设置背景音乐
     void playHoverSound();           // 播放悬停音效
     void playClickSound();           // 播放点击音效
     void startBackgroundMusic();     // 开始播放背景音乐
     void stopBackgroundMusic();      // 停止播放背景音乐
     
     QWidget *centralWidget;
-    QLabel *backgroundLabel;
+    ScaledImageLabel *backgroundLabel;
     QPushButton *directionButton;    // Direction按钮（进入剧情模式）
     QPushButton *classicButton;      // Classic按钮（经典模式）
     QPushButton *shopButton;         // Shop按钮（商店）
     QPushButton *exitButton;         // Exit按钮
     QVBoxLayout *mainLayout;
     QHBoxLayout *buttonLayout;
-    
-    // 音效相关
-    QSoundEffect *hoverSound;        // 悬停音效
-    QSoundEffect *clickSound;        // 点击音效
-    
-    // 背景音乐相关
-    QMediaPlayer *backgroundMusic;   // 背景音乐播放器
 };
 
 #endif // MODE_SELECT_WINDOW_H 
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <QWidget>
+#include <QPaintEvent>
+#include "frame_stats.h"
+
+// 性能面板：叠在棋盘左上角的半透明小窗，用 QPainter 直接画出最近若干tick各阶段耗时的
+// p50/p99、帧率、丢帧数和每帧分配次数。不接收鼠标事件，隐藏时不参与绘制。
+class PerfOverlay : public QWidget
+{
+public:
+    explicit PerfOverlay(QWidget *parent = nullptr);
+
+    // 复制一份统计结果并请求重绘
+    void setSummary(const FrameStatsSummary& summary);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static const int kLineCount = 9;
+    static const int kPadding = 6;
+
+    FrameStatsSummary m_aSummary;
+};
+
+#endif // PERF_OVERLAY_H
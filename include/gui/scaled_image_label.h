@@ -0,0 +1,39 @@
+#ifndef SCALED_IMAGE_LABEL_H
+#define SCALED_IMAGE_LABEL_H
+
+#include <QLabel>
+#include <QResizeEvent>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+// 背景图片标签：图片交给 ImageCache 在后台按控件当前尺寸从金字塔缩放，构造窗口时不再
+// 同步解码整张原图。尺寸变化后等 kResizeDebounceMs 内不再变化才重新请求，期间继续显示
+// 旧图。候选路径按顺序尝试，全部失败时保留样式表设置的背景。
+class ScaledImageLabel : public QLabel
+{
+public:
+    static const int kResizeDebounceMs = 150;
+
+    explicit ScaledImageLabel(QWidget *parent = nullptr);
+
+    // 按顺序尝试的图片路径，设置后立即请求当前尺寸
+    void setImagePaths(const QStringList& paths);
+    // 默认拉伸铺满，与原来的 setScaledContents(true) 一致
+    void setAspectRatioMode(Qt::AspectRatioMode mode);
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void requestImage();
+    void onImageReady(const QString& path, const QSize& size, bool ok);
+
+    QStringList m_aPaths;
+    int m_nPathIndex;                   // 当前尝试的路径，等于 m_aPaths.size() 表示全部失败
+    Qt::AspectRatioMode m_eMode;
+    QTimer* m_pResizeTimer;
+};
+
+#endif // SCALED_IMAGE_LABEL_H
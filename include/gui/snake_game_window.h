@@ -6,9 +6,22 @@
 #include <QLabel>
 #include <QKeyEvent>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QQueue>
 #include <QMap>
-#include "game.h"
+#include <QColor>
+#include <QPair>
+#include <memory>
+#include "snake_env.h"
+#include "board_frame.h"
+#include "gui/board_widget.h"
+#include "gui/perf_overlay.h"
+#include "frame_stats.h"
 
+// Qt游戏窗口：在Qt事件循环中直接推进无界面的SnakeEnv，不切换到终端。
+// tick由单次触发的QTimer驱动，每次按绝对截止时间重新计算等待时长，误差不会累积；
+// 按键先进入队列，每个tick取一个交给引擎。
+// F3 切换叠在棋盘上的性能面板，各阶段耗时由引擎和本窗口写入 m_aFrameStats。
 class SnakeGameWindow : public QMainWindow
 {
     Q_OBJECT
@@ -16,8 +29,11 @@ class SnakeGameWindow : public QMainWindow
 public:
     explicit SnakeGameWindow(QWidget *parent = nullptr);
     ~SnakeGameWindow();
-    
-    void startGame(GameMode mode, int level = 0);
+
+    void startClassic();
+    void startLevel(int level);         // 关卡从1开始，只接受 supportsLevel 为true的关卡
+    // 该关卡能否在Qt窗口中进行；其余关卡的玩法只有ncurses一侧的Game实现
+    static bool supportsLevel(int level);
     bool isGameRunning() const { return m_bGameRunning; }
     bool isLevelCompleted() const;
     void showVictoryScreen(int level);
@@ -34,42 +50,66 @@ private slots:
     void updateGame();
 
 private:
+    // 一局的规则：目标分数为0时不设目标（经典模式）
+    struct GameSetup
+    {
+        SnakeEnvConfig config;
+        int targetPoints = 0;
+        int tickMs = 100;
+        int timeLimitSeconds = 0;       // 0 表示不限时
+    };
+
+    static const int kMaxQueuedKeys = 3;        // 最多缓存的转向按键
+    static const int kMaxCatchUpTicks = 3;      // 一次回调最多补跑的tick数
+
     // 游戏逻辑
-    Game m_aGame;
+    std::unique_ptr<SnakeEnv> m_pEnv;
     QTimer* m_aGameTimer;
+    QElapsedTimer m_aClock;
+    qint64 m_nNextTickAt;               // 下一个tick的截止时间（m_aClock的毫秒数）
+    int m_nTickMs;
+    QQueue<int> m_aPendingActions;      // 尚未交给引擎的EnvAction
     bool m_bGameRunning;
-    GameMode m_eCurrentMode;
+    bool m_bPaused;
+    bool m_bLevelCompleted;
+    bool m_bLevelMode;
     int m_nCurrentLevel;
-    int m_nGameBoardWidth;
-    int m_nGameBoardHeight;
-    
+    int m_nTargetPoints;
+    qint64 m_nDeadlineAt;               // 限时关卡的截止时间（m_aClock的毫秒数），0 表示不限时
+    qint64 m_nPausedAt;                 // 暂停时刻，继续时把暂停时长加到截止时间上
+    bool m_bTimeUp;
+
+    // 性能面板
+    FrameStats m_aFrameStats;
+    PerfOverlay* m_pPerfOverlay;
+    double m_dPaintMsMark;              // 上一个tick结束时棋盘的累计绘制耗时
+
     // 界面元素
     QWidget* m_aCentralWidget;
     QGridLayout* m_aGameLayout;
-    QWidget* m_aGameBoardWidget;
-    QGridLayout* m_aGameBoard;
-    QVector<QVector<QLabel*>> m_aCells;
+    BoardWidget* m_aBoardWidget;     // 整个棋盘由一个控件绘制
+    BoardFrame m_aFrame;             // 整帧，只在新开一局时使用
     QLabel* m_aScoreLabel;
     QLabel* m_aLevelLabel;
     QLabel* m_aLivesLabel;
     QLabel* m_aStatusLabel;
-    
-    // 游戏元素颜色样式
-    QString m_sSnakeStyle;
-    QString m_sFoodStyle;
-    QString m_sWallStyle;
-    QString m_sPoisonStyle;
-    QString m_sSpecialFoodStyle;
-    QString m_sRandomItemStyle;
-    QString m_sEmptyStyle;
-    QMap<int, QString> m_aColorMap; // 用于存储不同颜色对应的样式表
-    
+
+    // 蛇皮肤颜色：皮肤编号 -> (填充色, 边框色)，其余格子的颜色由BoardWidget预先建好
+    QMap<int, QPair<QColor, QColor>> m_aColorMap;
+
     // 辅助函数
     void initializeUI();
+    void startGame(const GameSetup& setup);
+    void stepEngine();
+    // 与Game::adjustDelay相同的加速：得分变化且为5的倍数时按难度重新计算tick间隔
+    void adjustTickSpeed(int pointsBefore);
+    void scheduleNextTick();
+    void finishGame();
     void renderGameBoard();
     void updateGameInfo();
-    void processKey(int key);
+    void processKey(int action);
     void setupColorStyles();
+    void applySnakeSkin(int skin);
 };
 
-#endif // SNAKE_GAME_WINDOW_H 
\ No newline at end of file
+#endif // SNAKE_GAME_WINDOW_H
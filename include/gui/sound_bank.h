@@ -0,0 +1,45 @@
+#ifndef SOUND_BANK_H
+#define SOUND_BANK_H
+
+#include <QObject>
+#include <QSoundEffect>
+#include <QMediaPlayer>
+#include <QMediaPlaylist>
+#include <QTimer>
+
+// 进程内共用的音效和背景音乐。每个音效只有一个QSoundEffect，WAV解码一次后PCM常驻内存；
+// 每首背景音乐只有一个循环播放的QMediaPlayer。窗口只持有枚举编号，打开窗口时不再
+// 新建播放器、重新读文件。
+class SoundBank : public QObject
+{
+public:
+    enum class Effect { Hover, Click, Count };
+    enum class Music { ModeSelect, Story, Count };
+
+    static SoundBank& shared();
+
+    // 启动时调用：所有音效开始在后台解码，第一次悬停时已经可以播放
+    void preload();
+
+    // 音效还在加载时忽略这次播放，与原来各窗口的行为一致
+    void play(Effect effect, qreal volume);
+    // 循环播放；同一首已在播放时只调整音量，不从头开始
+    void playMusic(Music music, int volume);
+    // 在下一轮事件循环停止。窗口切换时前一个窗口先停、后一个窗口再播同一首，音乐不会中断
+    void stopMusic(Music music);
+
+private:
+    explicit SoundBank(QObject *parent);
+
+    QSoundEffect* effect(Effect effect);
+    QMediaPlayer* musicPlayer(Music music);
+    void stopPendingMusic();
+
+    QSoundEffect* m_aEffects[static_cast<int>(Effect::Count)];
+    QMediaPlayer* m_aMusic[static_cast<int>(Music::Count)];
+    int m_nCurrentMusic;                // 正在播放的 Music，-1 表示没有
+    int m_nPendingStop;                 // 等待停止的 Music，-1 表示没有
+    QTimer* m_pStopTimer;
+};
+
+#endif // SOUND_BANK_H
@@ -9,8 +9,9 @@
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPixmap>
-#include <QSoundEffect>
-#include <QMediaPlayer>
+#include "gui/scaled_image_label.h"
+#include "gui/typewriter_label.h"
+#include "typewriter.h"
 #include <QTextEdit>
 #include <QScrollArea>
 #include <QPainter>
@@ -46,21 +47,22 @@ protected:
     void hideEvent(QHideEvent *event) override;
 
 private slots:
-    void onTypewriterTimer();           // 打字机效果计时器
+    void onTypewriterTimer();           // 打字机效果每帧更新
     void onNextSegment();               // 显示下一段
     void onSkipAnimation();             // 跳过当前动画
     void onNextCartoon();               // 显示下一张漫画
+    void onCartoonImageReady(const QString& path, const QSize& size, bool ok); // 漫画后台解码完成
 
 private:
     void setupUI();                     // 设置界面
     void setupBackgroundImage();        // 设置背景图片
-    void setupAudioEffects();           // 设置音效
-    void setupBackgroundMusic();        // 设置背景音乐
     void startBackgroundMusic();        // 开始播放背景音乐
     void stopBackgroundMusic();         // 停止播放背景音乐
+    void playClickSound();              // 播放点击音效
+    void playTypewriterSound();         // 播放打字音效
     
-    void loadStoryText();               // 加载剧情文本
-    void parseStorySegments();          // 解析剧情片段
+    void loadStoryText();               // 打开共用的剧情索引
+    void showSection(int section);      // 从头播放一章（见 StoryIndex 的章节编号）
     void startTypewriterEffect();       // 开始打字机效果
     void completeCurrentSegment();      // 完成当前段落显示
     void showNextSegment();             // 显示下一个段落
@@ -68,7 +70,10 @@ private:
     void hideSkipHint();                // 隐藏跳过提示
     
     // 漫画相关方法
-    void showCartoonImage(const QString& path); // 显示漫画图片
+    void showCartoonImage(const QString& path); // 显示漫画图片（先查缓存，未命中时后台解码）
+    void displayCartoonPixmap(const QPixmap& pixmap); // 把缩放好的漫画放进漫画框
+    void showCartoonError(const QString& path); // 显示无法加载的提示
+    QSize cartoonDisplaySize() const;   // 漫画缩放的目标尺寸
     QString getCartoonPath(const QString& filename); // 获取漫画文件路径
     
     // 🎨 艺术效果配置函数
@@ -77,39 +82,32 @@ private:
     // UI组件
     QWidget *m_centralWidget;
     QVBoxLayout *m_mainLayout;
-    QLabel *m_backgroundLabel;
-    QLabel *m_storyTextLabel;
+    ScaledImageLabel *m_backgroundLabel;
+    TypewriterLabel *m_storyTextLabel;
     QLabel *m_cartoonLabel;                     // 专门用于显示漫画的标签
     QLabel *m_skipHintLabel;
     QScrollArea *m_scrollArea;
     
 
     
-    // 音效和音乐
-    QSoundEffect *m_clickSound;
-    QSoundEffect *m_typewriterSound;
-    QMediaPlayer *m_backgroundMusic;
-    
-    // 剧情内容
-    std::vector<std::string> m_storySegments;   // 所有剧情段落
-    QVector<QPair<int, int>> m_levelSegmentRanges; // 每个关卡的段落范围 [start, end)
-    int m_currentSegmentIndex;                  // 当前段落索引
-    int m_currentLevel;                         // 当前关卡
+    // 剧情内容，段落按需从 StoryIndex 读取
+    int m_currentSegmentIndex;                  // 当前章节内的段落索引
+    int m_currentLevel;                         // 当前章节：0 = 序章，1-5 = 关卡，6 = 尾声
     
     // 漫画相关数据
     QStringList m_cartoonPaths;                 // 当前漫画路径列表
     int m_currentCartoonIndex;                  // 当前漫画索引
     bool m_isInCartoonMode;                     // 是否处于漫画模式
     
-    // 打字机效果
+    // 打字机效果：段落排版一次，每帧按经过的时间算出显示到第几个字
     QTimer *m_typewriterTimer;
-    QString m_currentText;
-    QString m_targetText;
-    int m_currentCharIndex;
+    TypewriterClock m_typewriterClock;
+    int m_currentCharIndex;                     // 已显示的字数
     bool m_isTyping;
     
     // 常量
     static const int TYPEWRITER_SPEED = 50; // 打字速度（毫秒）
+    static const int TYPEWRITER_FRAME = 16; // 打字机效果的帧间隔（毫秒）
     static const int SKIP_HINT_DELAY = 3000; // 跳过提示延迟（毫秒）
 };
 
@@ -8,9 +8,8 @@
 #include <QHBoxLayout>
 #include <QPixmap>
 #include <QWidget>
-#include <QSoundEffect>
 #include <QUrl>
-#include <QMediaPlayer>
+#include "gui/scaled_image_label.h"
 #include <vector>
 
 class StoryLevelWindow : public QMainWindow
@@ -44,8 +43,6 @@ private:
     void setupUI();                     // 设置界面
     void setupBackgroundImage();        // 设置背景图片
     void setupLevelButtons();           // 设置关卡按钮
-    void setupAudioEffects();           // 设置音效
-    void setupBackgroundMusic();        // 设置背景音乐
     void updateButtonState(QPushButton* button, bool unlocked, bool completed);  // 更新按钮状态
     void playHoverSound();              // 播放悬停音效
     void playClickSound();              // 播放点击音效
@@ -53,7 +50,7 @@ private:
     void stopBackgroundMusic();         // 停止播放背景音乐
     
     QWidget *centralWidget;
-    QLabel *backgroundLabel;
+    ScaledImageLabel *backgroundLabel;
     QPushButton *level1Button;          // 关卡1按钮
     QPushButton *level2Button;          // 关卡2按钮
     QPushButton *level3Button;          // 关卡3按钮
@@ -62,13 +59,6 @@ private:
     QPushButton *backButton;            // 返回按钮
     
     std::vector<int> mUnlockedLevels;   // 已解锁的关卡列表
-    
-    // 音效相关
-    QSoundEffect *hoverSound;           // 悬停音效
-    QSoundEffect *clickSound;           // 点击音效
-    
-    // 背景音乐相关
-    QMediaPlayer *backgroundMusic;      // 背景音乐播放器
 };
 
 #endif // STORY_LEVEL_WINDOW_H 
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef TYPEWRITER_LABEL_H
+#define TYPEWRITER_LABEL_H
+
+#include <QLabel>
+#include <QPaintEvent>
+#include <QPixmap>
+#include <QRectF>
+#include <QResizeEvent>
+#include <QString>
+#include <QVector>
+
+// 剧情文字标签：整段文字用 QTextLayout 只排版一次，渲染成一张图，并记下每个字形所在的行
+// 和右边缘。逐字显示时只改变显示的字形数，重绘新露出的那一小块，绘制时从渲染好的图中
+// 贴出“已显示的整行”和“当前行已显示的部分”两块，不再每个字 setText 让QLabel重新排版
+// 整段文字。显示进度由调用方按时间给出（见 TypewriterClock）。
+class TypewriterLabel : public QLabel
+{
+public:
+    explicit TypewriterLabel(QWidget *parent = nullptr);
+
+    // 四周留白，应与样式表中的 padding 一致
+    void setTextPadding(int padding);
+
+    // 排版并渲染整段文字，从0个字形开始显示；控件高度按排版结果调整，便于外层滚动
+    void startReveal(const QString& text);
+    // 显示前 count 个字形
+    void setRevealedCount(int count);
+    void revealAll();
+    // 回到普通QLabel的显示方式（如显示错误提示）
+    void stopReveal();
+
+    int getGlyphCount() const { return m_aGlyphLine.size(); }
+    int getRevealedCount() const { return m_nRevealed; }
+    // 最后一个已显示字形所在行的底边（控件坐标），用于滚动跟随
+    int getRevealedBottom() const;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void layoutText();
+    QRectF lineSpan(int firstLine, int lastLine) const;
+
+    QString m_sText;
+    QPixmap m_aRendered;                // 整段文字的渲染结果
+    QVector<QRectF> m_aLineRects;       // 每行占的矩形（横向铺满控件）
+    QVector<int> m_aGlyphLine;          // 第i个字形所在行
+    QVector<qreal> m_aGlyphRight;       // 第i个字形右边缘的x
+    int m_nRevealed;
+    int m_nPadding;
+    int m_nLayoutWidth;                 // 排版时的控件宽度，宽度变化时重新排版
+    bool m_bRevealing;
+};
+
+#endif // TYPEWRITER_LABEL_H
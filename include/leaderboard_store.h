@@ -0,0 +1,108 @@
+#ifndef LEADERBOARD_STORE_H
+#define LEADERBOARD_STORE_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "record_log.h"
+
+// 一条成绩
+struct LeaderboardEntry
+{
+    int32_t score = 0;
+    int32_t length = 0;         // 结束时的蛇长
+    int32_t durationMs = 0;     // 本局用时
+    int64_t timestamp = 0;      // 结束时刻（Unix毫秒）
+    uint64_t replayId = 0;      // 0 表示没有回放
+};
+
+// 榜单按 模式 + 地图 + 关卡 区分，不适用的维度填默认值
+struct LeaderboardKey
+{
+    int mode = 0;
+    std::string map;
+    int level = 0;
+
+    // 用作文件名的榜单名，地图名中的路径分隔符等字符会被替换
+    std::string name() const;
+};
+
+// 多榜单的排行榜存储，目录下的文件：
+//   leaderboard.log     RecordLog 追加日志，每条成绩一条记录（榜单名 | 成绩），写入后fdatasync
+//   <榜单名>.lbi        已排好序的索引：文件头 + 定长记录，按分数从高到低、同分按时间从早到晚
+// 插入只追加日志并放进内存中的待合并列表，攒够一批或 flush 时把每个榜单的待合并成绩归并进新索引，
+// 索引和日志都用 临时文件 -> fsync -> rename 替换。索引头记录已合并的最大日志序号，
+// 崩溃后重放日志时跳过已经合并过的记录，所以任何时刻崩溃都不会丢成绩也不会重复。
+// 查询时索引只读映射，top-K直接读前K条，名次用二分查找，均为 O(log n + 待合并条数)。
+class LeaderboardStore
+{
+public:
+    // 待合并成绩达到这个数时自动合并
+    static const size_t kMergeThreshold = 256;
+
+    explicit LeaderboardStore(const std::string& directory);
+    // 析构时合并所有待合并成绩
+    ~LeaderboardStore();
+
+    LeaderboardStore(const LeaderboardStore&) = delete;
+    LeaderboardStore& operator=(const LeaderboardStore&) = delete;
+
+    // 创建目录并重放日志，日志尾部不完整的记录会被截掉
+    bool open();
+
+    // 写入一条成绩，返回时已经落盘
+    bool insert(const LeaderboardKey& key, const LeaderboardEntry& entry);
+    // 一次写入多条（一次write + 一次fdatasync）
+    bool insert(const std::vector<std::pair<LeaderboardKey, LeaderboardEntry>>& entries);
+    // 把所有待合并成绩归并进索引并清空日志
+    bool flush();
+
+    // 前 k 名，分数从高到低
+    std::vector<LeaderboardEntry> topK(const LeaderboardKey& key, size_t k);
+    // 严格高于 score 的成绩条数，即该分数的名次减一
+    size_t rankOf(const LeaderboardKey& key, int32_t score);
+    size_t size(const LeaderboardKey& key);
+
+    const std::string& getLastError() const;
+
+private:
+    // 只读映射的索引文件
+    struct Index
+    {
+        const uint8_t* data = nullptr;
+        size_t mappedSize = 0;
+        size_t count = 0;
+        uint64_t appliedSeq = 0;
+    };
+
+    struct Board
+    {
+        Index index;
+        std::vector<LeaderboardEntry> pending;   // 已写日志、尚未合并，保持有序
+        uint64_t pendingMaxSeq = 0;
+        bool loaded = false;
+    };
+
+    Board& board(const std::string& name);
+    bool loadIndex(const std::string& name, Index& index);
+    void unmapIndex(Index& index);
+    LeaderboardEntry indexEntry(const Index& index, size_t i) const;
+    bool mergeBoard(const std::string& name, Board& state);
+    void replayRecord(uint64_t seq, const uint8_t* payload, size_t size);
+    bool flushLocked();
+
+    std::string indexPath(const std::string& name) const;
+    std::string logPath() const;
+
+    std::string mDirectory;
+    std::map<std::string, Board> mBoards;
+    std::mutex mMutex;
+    RecordLog mLog;
+    size_t mPendingCount = 0;
+    std::string mLastError;
+};
+
+#endif // LEADERBOARD_STORE_H
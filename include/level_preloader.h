@@ -0,0 +1,58 @@
+#ifndef LEVEL_PRELOADER_H
+#define LEVEL_PRELOADER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include "map.h"
+
+// 关卡预加载：通关叙述播放期间在后台线程读入下一关的地图并建好出生点表，
+// 动画结束后 take 直接拿到准备好的地图，关卡切换时不再同步读文件和扫描。
+// 后台线程只操作自己新建的 Map，take 时 join 之后所有权才交给游戏线程。
+class LevelPreloader
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LevelPreloader();
+    // 等待尚未结束的预加载
+    ~LevelPreloader();
+
+    LevelPreloader(const LevelPreloader&) = delete;
+    LevelPreloader& operator=(const LevelPreloader&) = delete;
+
+    // 开始预加载；上一次没有取走的结果会被丢弃。
+    // spawnSpaces 中的每个安全空间要求都会预先建好出生点表
+    void start(int level, const std::string& mapPath, int width, int height,
+               int snakeLength, const std::vector<int>& spawnSpaces);
+    // 取出预加载的地图，还没加载完时等待。关卡、路径或尺寸不符或没有预加载时返回空，由调用方同步加载
+    std::unique_ptr<Map> take(int level, const std::string& mapPath, int width, int height);
+    // 放弃当前的预加载
+    void cancel();
+
+    // 最近一次 take 等待后台线程的毫秒数，0 表示动画期间已经加载完
+    double getLastWaitMs() const;
+    // 最近一次预加载在后台线程上的耗时
+    double getLastLoadMs() const;
+
+    // 与游戏中同步加载相同：文件存在时读文件，否则使用默认地图
+    static std::unique_ptr<Map> loadLevelMap(const std::string& mapPath, int width, int height);
+
+private:
+    void run(int snakeLength, std::vector<int> spawnSpaces);
+    void join();
+
+    std::thread mThread;
+    int mLevel = 0;
+    std::string mMapPath;
+    int mWidth = 0;
+    int mHeight = 0;
+    std::unique_ptr<Map> mMap;      // 只在后台线程结束后读取
+    double mLoadMs = 0.0;
+    double mLastWaitMs = 0.0;
+    double mLastLoadMs = 0.0;
+};
+
+#endif // LEVEL_PRELOADER_H
@@ -3,9 +3,16 @@
 
 #include <vector>
 #include <string>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
 #include "snake.h"
+#include "bitboard.h"
 
-enum class TileType
+// 按字节存储，编译后的 .smap 地图可以把瓦片数组直接拷进来
+enum class TileType : uint8_t
 {
     Empty = 0,
     Wall = 1,
@@ -20,6 +27,9 @@ enum class InitialDirection
     Down
 };
 
+// 出生点：蛇头位置和初始方向
+using SpawnPosition = std::pair<SnakeBody, InitialDirection>;
+
 class Map
 {
 public:
@@ -28,8 +38,19 @@ public:
 
     void initializeEmptyMap();
     void loadDefaultMap();
+    // 同目录下有不旧于文本文件的 .smap 时优先加载它，失败再回退到文本格式
     bool loadMapFromFile(const std::string& filename);
+    // 文本格式："宽 高" 后跟 宽*高 个瓦片值(0/1/2)；尺寸、瓦片值和瓦片个数不对都算失败
+    bool loadTextMap(const std::string& filename);
     bool saveMapToFile(const std::string& filename);
+
+    // 编译后的二进制地图(.smap)：mmap映射后校验文件头和CRC，瓦片和墙体位图整块拷贝，不做解析
+    bool loadCompiledMap(const std::string& filename);
+    bool saveCompiledMap(const std::string& filename) const;
+    // 文本地图对应的 .smap 路径（扩展名换成 .smap）
+    static std::string compiledMapPath(const std::string& filename);
+    // 最近一次加载失败的原因，文本地图带 "文件:行:列"
+    const std::string& getLastError() const;
     
     TileType getTile(int x, int y) const;
     void setTile(int x, int y, TileType type);
@@ -43,6 +64,15 @@ public:
     // Get all empty positions where food can be placed
     std::vector<SnakeBody> getEmptyPositions(const std::vector<SnakeBody>& snake) const;
     
+    // Count empty positions without building the list (popcount over the free bits)
+    int countEmptyPositions(const std::vector<SnakeBody>& snake) const;
+    
+    // Walls packed as bit rows, kept in sync with the tiles
+    const Bitboard& getWallBits() const;
+    
+    // 内部区域中不是墙的格子数（.smap 中预先算好）
+    int getFreeCellCount() const;
+    
     // Check if a snake can be placed at a specific position with a given direction and length
     bool canPlaceSnake(int startX, int startY, InitialDirection direction, int length) const;
     
@@ -50,14 +80,51 @@ public:
     bool hasEnoughForwardSpace(int x, int y, InitialDirection direction, int minSpace = 5) const;
     
     // Get valid positions where a snake of given length can be placed with enough forward space
-    std::vector<std::pair<SnakeBody, InitialDirection>> getValidSnakePositions(int length, int minSpace = 5) const;
+    // 结果按 (长度, 前方空间) 缓存，只在第一次用到时扫描整张地图，地图改动后重新计算
+    const std::vector<SpawnPosition>& getValidSnakePositions(int length, int minSpace = 5) const;
+    
+    // 复活用：从出生点表中挑一个离 avoid 尽量远、蛇身和前方空间都不碰 occupied 的位置。
+    // 出生点按网格分区，只看常数个分区、每区常数次尝试，与地图大小无关
+    bool pickSpawnFarFrom(int length, int minSpace, const SnakeBody& avoid,
+                          const std::vector<SnakeBody>& occupied, uint32_t seed, SpawnPosition& spawn) const;
 
 private:
+    // 出生点分区为 kSpawnGrid x kSpawnGrid 个矩形
+    static const int kSpawnGrid = 4;
+    static const int kSpawnRegions = kSpawnGrid * kSpawnGrid;
+
+    struct SpawnTable
+    {
+        std::vector<SpawnPosition> positions;
+        // positions 的下标按分区分组：分区 r 占 regionIndex[regionStart[r], regionStart[r + 1])
+        std::vector<int> regionIndex;
+        int regionStart[kSpawnRegions + 1] = {};
+    };
+
     int mWidth;
     int mHeight;
-    std::vector<std::vector<TileType>> mTiles;
+    // 按行优先连续存储
+    std::vector<TileType> mTiles;
+    Bitboard mWallBits;
+    int mFreeCellCount;
+    std::string mLastError;
+    // 出生点表，键为 (长度, 前方空间)；LevelPreloader 在后台线程预建、交接后由游戏线程继续查表补建，查表时加锁
+    mutable std::mutex mSpawnMutex;
+    mutable std::map<std::pair<int, int>, SpawnTable> mSpawnTables;
     
+    TileType& tileAt(int x, int y) { return mTiles[static_cast<size_t>(y) * mWidth + x]; }
+    TileType tileAt(int x, int y) const { return mTiles[static_cast<size_t>(y) * mWidth + x]; }
     
+    // 根据mTiles重建墙体位图和空格数，并清空出生点表
+    void rebuildWallBits();
+    const SpawnTable& spawnTable(int length, int minSpace) const;
+    void buildSpawnTable(int length, int minSpace, SpawnTable& table) const;
+    void clearSpawnTables();
+    // 校验并载入一整块 .smap 数据，校验失败时不改动当前地图
+    bool loadCompiledBuffer(const uint8_t* data, size_t size);
+    // 内部区域(1..W-2, 1..H-2)中既不是墙也不是蛇身的格子
+    void buildFreeBits(const std::vector<SnakeBody>& snake, Bitboard& free) const;
+
 };
 
 #endif 
\ No newline at end of file
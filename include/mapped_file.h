@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// 只读映射整个文件，析构时解除映射。地图加载和剧情索引共用
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 空文件视为失败，error 为 "路径: 原因"
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const uint8_t* data() const { return static_cast<const uint8_t*>(mData); }
+    size_t size() const { return mSize; }
+
+private:
+    void* mData = nullptr;
+    size_t mSize = 0;
+};
+
+#endif // MAPPED_FILE_H
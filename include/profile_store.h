@@ -0,0 +1,105 @@
+#ifndef PROFILE_STORE_H
+#define PROFILE_STORE_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "record_log.h"
+
+// 档案中用到的键，Game 和 GUIManager 共用
+namespace ProfileKeys
+{
+    const char* const kCoins = "coins";
+    const char* const kCurrentSkin = "skin.current";
+    const char* const kOwnedSkinPrefix = "skin.owned.";
+    const char* const kItemPrefix = "item.";
+    const char* const kLevelPrefix = "level.";
+
+    inline std::string ownedSkin(int skin) { return kOwnedSkinPrefix + std::to_string(skin); }
+    inline std::string item(int type) { return kItemPrefix + std::to_string(type); }
+    // 关卡从1开始编号，值为 LevelStatus
+    inline std::string level(int level) { return kLevelPrefix + std::to_string(level); }
+}
+
+// 玩家档案（金币、皮肤、道具、关卡进度）的小型键值存储，值一律是整数。
+//   profile.db    快照：文件头 | 若干条 { 键长 u16 | 键 | 值 i64 }，整体用 临时文件 -> fsync -> rename 替换
+//   profile.wal   RecordLog 预写日志，每个事务一条记录
+// 提交事务时先追加一条日志并fdatasync，再更新内存；日志超过一定大小时写新快照并清空日志。
+// 快照头记录已包含的最大日志序号，打开时只重放比它新的事务，所以崩溃后金币、道具和进度总是某次提交后的状态。
+// 进程内用 shared() 取同一个实例，ncurses 和 Qt 两边读的是同一份内存缓存。
+class ProfileStore
+{
+public:
+    // 一组一起生效的修改
+    class Transaction
+    {
+    public:
+        void set(const std::string& key, int64_t value);
+        void add(const std::string& key, int64_t delta);
+        void erase(const std::string& key);
+        bool empty() const;
+
+    private:
+        friend class ProfileStore;
+        struct Operation
+        {
+            uint8_t type;
+            std::string key;
+            int64_t value;
+        };
+        std::vector<Operation> mOperations;
+    };
+
+    // 日志超过这个大小时做一次快照
+    static const size_t kCheckpointLogSize = 64 * 1024;
+
+    // 进程内共用的实例，第一次调用时打开当前目录下的档案
+    static ProfileStore& shared();
+
+    explicit ProfileStore(const std::string& directory);
+    // 析构时写快照
+    ~ProfileStore();
+
+    ProfileStore(const ProfileStore&) = delete;
+    ProfileStore& operator=(const ProfileStore&) = delete;
+
+    // 读快照并重放日志
+    bool open();
+    bool isOpen() const;
+
+    int64_t get(const std::string& key, int64_t fallback = 0) const;
+    bool contains(const std::string& key) const;
+    // 以 prefix 开头的所有键值，按键排序
+    std::vector<std::pair<std::string, int64_t>> scan(const std::string& prefix) const;
+
+    // 原子提交：日志落盘后才改内存，失败时内存和磁盘都保持原样
+    bool commit(const Transaction& transaction);
+    // 把全部键值写成新快照并清空日志
+    bool checkpoint();
+
+    std::string getLastError() const;
+
+private:
+    static std::vector<uint8_t> encodeTransaction(const Transaction& transaction);
+    bool decodeTransaction(const uint8_t* data, size_t size, Transaction& transaction) const;
+    void applyLocked(const Transaction& transaction);
+    void replayRecord(uint64_t seq, const uint8_t* payload, size_t size);
+    bool loadSnapshot();
+    bool checkpointLocked();
+
+    std::string snapshotPath() const;
+    std::string logPath() const;
+
+    std::string mDirectory;
+    mutable std::mutex mMutex;
+    std::map<std::string, int64_t> mValues;
+    RecordLog mLog;
+    uint64_t mSnapshotSeq = 0;  // 快照已包含的最大日志序号
+    std::string mLastError;
+};
+
+#endif // PROFILE_STORE_H
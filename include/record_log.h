@@ -0,0 +1,57 @@
+#ifndef RECORD_LOG_H
+#define RECORD_LOG_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// 追加式记录日志（预写日志），排行榜和玩家档案共用。文件格式（小端）：
+//   文件头   magic u32 | 版本 u16 | 保留 u16 | 起始序号 u64
+//   记录     长度 u32 | CRC32C u32 | 序号 u64 | 载荷
+// CRC覆盖序号和载荷。每次追加只调用一次write和一次fdatasync，返回时记录已经落盘；
+// 崩溃时写了一半的尾部记录在下次打开时截掉，所以一条记录要么完整生效，要么完全不存在。
+class RecordLog
+{
+public:
+    using RecordCallback = std::function<void(uint64_t seq, const uint8_t* payload, size_t size)>;
+
+    RecordLog();
+    ~RecordLog();
+
+    RecordLog(const RecordLog&) = delete;
+    RecordLog& operator=(const RecordLog&) = delete;
+
+    // 打开日志并按顺序回调每条完整记录；文件不存在时新建，magic不符时失败且不改动文件
+    bool open(const std::string& path, uint32_t magic, const RecordCallback& onRecord);
+    void close();
+
+    // 追加若干条记录，依次分配递增的序号，firstSeq 返回第一条的序号；失败时把文件截回原长度
+    bool append(const std::vector<std::vector<uint8_t>>& payloads, uint64_t* firstSeq = nullptr);
+    // 原子地换成只含文件头的空日志，序号继续递增
+    bool reset();
+    // 保证之后分配的序号不小于 seq。日志文件丢失或被重建时序号会从1重新开始，
+    // 调用方用快照/索引里已应用的最大序号加一来调用，新记录才不会在重放时被当成已应用而跳过
+    void raiseNextSeq(uint64_t seq);
+
+    bool isOpen() const;
+    // 日志里是否有记录
+    bool hasRecords() const;
+    size_t getSize() const;
+    uint64_t getNextSeq() const;
+    const std::string& getLastError() const;
+
+private:
+    bool openForAppend();
+    void setErrno(const std::string& what);
+
+    std::string mPath;
+    uint32_t mMagic = 0;
+    int mFd = -1;
+    size_t mSize = 0;
+    uint64_t mNextSeq = 1;
+    std::string mLastError;
+};
+
+#endif // RECORD_LOG_H
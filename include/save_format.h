@@ -0,0 +1,92 @@
+#ifndef SAVE_FORMAT_H
+#define SAVE_FORMAT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// 存档中的一个坐标
+struct SavedPoint
+{
+    int32_t x = -1;
+    int32_t y = -1;
+};
+
+// 存档快照：只包含纯数据，与Game和ncurses无关，枚举一律按整数保存
+struct GameSnapshot
+{
+    int32_t mode = 0;
+    int32_t level = 1;
+    int32_t points = 0;
+    int32_t points2 = 0;
+    int32_t lives1 = 3;
+    int32_t lives2 = 3;
+
+    bool hasSnake1 = false;
+    int32_t direction1 = 0;
+    std::vector<SavedPoint> snake1;
+    bool hasSnake2 = false;
+    int32_t direction2 = 0;
+    std::vector<SavedPoint> snake2;
+
+    SavedPoint food;
+    bool hasSpecialFood = false;
+    SavedPoint specialFood;
+    int32_t specialFoodType = 0;
+    bool hasPoison = false;
+    SavedPoint poison;
+    bool hasRandomItem = false;
+    SavedPoint randomItem;
+    int32_t randomItemType = 0;
+    std::vector<SavedPoint> corpseFoods;
+
+    std::vector<int32_t> levelStatus;
+
+    int64_t savedAtMs = 0;      // 存档时刻（Unix毫秒），用于在多个存档中挑最新的
+    bool autosave = false;      // 是否为自动存档
+};
+
+// 读档时的取值范围，用于在改动Game状态之前校验快照
+struct SnapshotLimits
+{
+    int boardWidth = 0;
+    int boardHeight = 0;
+    int modeCount = 0;
+    int maxLevel = 0;
+};
+
+// 存档格式（小端）：
+//   文件头   magic "SNKS" | 版本 u16 | 文件头长度 u16 | 段数 u32 | 文件总长 u32 | CRC32C u32 | 保留 u32
+//   段表     每段 { 段编号 u32 | 偏移 u32 | 长度 u32 }
+//   段数据   各段依次排列，坐标列表从版本3起按差值做zigzag变长编码
+// CRC32C覆盖整个文件（计算时CRC字段视为0）。读档时不认识的段直接跳过，便于以后加段。
+// 版本1是旧的裸格式：没有文件头，按saveGame的写入顺序依次排列int/bool。
+class SaveFormat
+{
+public:
+    static const uint32_t kMagic = 0x534B4E53; // "SNKS"
+    static const uint16_t kVersion = 3;
+    static const uint16_t kPackedPointsSinceVersion = 3;
+    static const uint16_t kLegacyVersion = 1;
+
+    // 把快照整体编码到一块连续的缓冲区
+    static void encode(const GameSnapshot& snapshot, std::vector<uint8_t>& buffer);
+    // 解码并校验：文件头、长度、CRC、段边界和各字段取值范围，全部通过才写入 snapshot；
+    // 没有文件头时按旧格式迁移
+    static bool decode(const std::vector<uint8_t>& buffer, const SnapshotLimits& limits,
+                       GameSnapshot& snapshot, std::string& error);
+
+    // 用一次write写出整个缓冲区
+    static bool writeFile(const std::string& path, const std::vector<uint8_t>& buffer);
+    static bool readFile(const std::string& path, std::vector<uint8_t>& buffer);
+
+    static uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+private:
+    static bool decodeLegacy(const std::vector<uint8_t>& buffer, const SnapshotLimits& limits,
+                             GameSnapshot& snapshot, std::string& error);
+    static bool validate(const GameSnapshot& snapshot, const SnapshotLimits& limits, std::string& error);
+};
+
+#endif // SAVE_FORMAT_H
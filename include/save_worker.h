@@ -0,0 +1,74 @@
+#ifndef SAVE_WORKER_H
+#define SAVE_WORKER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "save_format.h"
+
+// 后台存档线程：游戏线程只负责拍快照，编码和写盘都交给这里。
+// 每次写入都走 写临时文件 -> fsync -> rename，任何时刻磁盘上要么是旧存档，要么是完整的新存档
+class SaveWorker
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 一次存档的结果
+    struct Result
+    {
+        uint64_t id = 0;
+        bool ok = false;
+        std::string path;
+        Clock::time_point requested;    // 游戏线程提交的时刻
+        Clock::time_point finished;     // rename完成的时刻
+        double encodeMs = 0.0;          // 在后台线程编码快照的耗时
+        double writeMs = 0.0;           // 写临时文件 + fsync + rename 的耗时
+    };
+
+    SaveWorker();
+    // 析构前会把队列中的存档全部写完
+    ~SaveWorker();
+
+    // 提交一次存档，返回编号。同一路径还没开始写的旧请求会被新的替换掉
+    uint64_t submit(const std::string& path, std::vector<uint8_t> buffer);
+    // 提交快照，由后台线程编码后再写盘
+    uint64_t submit(const std::string& path, GameSnapshot snapshot);
+    // 取出一个已完成的结果，没有时立即返回false
+    bool poll(Result& result);
+    // 阻塞直到队列清空
+    void flush();
+
+    // 原子写入：path.tmp 写完并fsync后rename到 path，再fsync所在目录
+    static bool writeAtomic(const std::string& path, const std::vector<uint8_t>& buffer);
+
+private:
+    struct Job
+    {
+        uint64_t id;
+        std::string path;
+        std::vector<uint8_t> buffer;
+        GameSnapshot snapshot;
+        bool needsEncode;
+        Clock::time_point requested;
+    };
+
+    uint64_t enqueue(Job job);
+    void run();
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mIdle;
+    std::deque<Job> mJobs;
+    std::deque<Result> mResults;
+    uint64_t mNextId = 1;
+    bool mBusy = false;
+    bool mStop = false;
+};
+
+#endif // SAVE_WORKER_H
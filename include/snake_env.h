@@ -0,0 +1,169 @@
+#ifndef SNAKE_ENV_H
+#define SNAKE_ENV_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "snake.h"
+#include "map.h"
+#include "ai.h"
+#include "food_type.h"
+#include "board_frame.h"
+#include "frame_stats.h"
+
+// 观测平面：每个通道一张 H x W 的字节图
+enum class EnvChannel
+{
+    Wall = 0,
+    Head,           // 自己的蛇头
+    Body,           // 自己的蛇身（不含蛇头）
+    OpponentHead,
+    OpponentBody,
+    Food,           // 普通食物
+    SpecialFood,    // 取值为特殊食物的加分（2/3/5）
+    Poison,
+    CorpseFood,
+    RandomItem,
+    Count
+};
+
+// 动作：前四个与Direction一致，最后一个表示保持当前方向
+enum class EnvAction
+{
+    Left = 0,
+    Right,
+    Up,
+    Down,
+    Keep,
+    Count
+};
+
+// 单局环境参数
+struct SnakeEnvConfig
+{
+    std::string mapFile;            // 为空时使用默认地图
+    int width = 62;                 // 默认地图尺寸（与关卡地图一致）
+    int height = 18;
+    int initialLength = 3;
+    int lives = 1;                  // 玩家生命数，用完即结束本局
+    bool opponent = false;          // 是否加入AI对手（对战模式规则）
+    int opponentLives = 1;
+    int maxSteps = 2000;            // 超过后截断本局，<=0 表示不限制
+    int itemDurationTicks = 50;     // 特殊食物/毒药/道具存在的tick数（原规则5秒，按100ms一tick换算）
+    bool randomItems = true;        // 是否生成随机道具；调用方没有道具的使用方式时关掉，免得捡到用不了的道具
+    float rewardDeath = -1.0f;      // 每失去一条命
+    float rewardWin = 1.0f;         // 对手生命耗尽
+    float rewardStep = 0.0f;        // 每步固定奖励
+    unsigned int seed = 1;
+};
+
+// 无界面的单局游戏：复刻Game中食物、特殊食物、毒药、尸体食物和随机道具的规则，
+// 不依赖ncurses和墙钟时间，所有随机数都来自本局自己的随机状态，可复现
+class SnakeEnv
+{
+public:
+    explicit SnakeEnv(const SnakeEnvConfig& config);
+    ~SnakeEnv();
+
+    // 开始新的一局，seed为0时沿用当前随机状态
+    void reset(unsigned int seed = 0);
+    // 推进一步，返回本步奖励；本局结束后 isDone() 为真
+    float step(int action);
+
+    // 把当前局面写入 out，布局为 [通道][行][列]，需要 getObservationSize() 个字节
+    void writeObservation(uint8_t* out) const;
+    // 把当前局面写成显示用的棋盘，每格取最上层的内容（蛇头 > 蛇身 > 道具和食物 > 墙）
+    void writeBoard(BoardFrame& frame) const;
+    // 最近一次 step() 改变的格子，每个位置只出现一次，内容与 writeBoard 的结果一致；
+    // reset() 之后为 full 增量
+    const BoardDelta& getBoardDelta() const;
+
+    int getWidth() const;
+    int getHeight() const;
+    int getObservationSize() const;
+
+    bool isDone() const;
+    // 因步数上限结束（而非死亡或胜负）
+    bool isTruncated() const;
+    int getSteps() const;
+    int getPoints() const;
+    int getOpponentPoints() const;
+    int getLength() const;
+    int getLives() const;
+    // 捡到的道具数量，下标与game.h中的ItemType一致
+    const std::vector<int>& getInventory() const;
+
+    const Map& getMap() const;
+    const Snake& getSnake() const;
+
+    // 设置后 step() 把对手寻路、移动结算和生成三个阶段的耗时计入 stats 的当前帧，
+    // 帧的开始和结束由调用方负责；为空时不计时
+    void setFrameStats(FrameStats* stats);
+
+private:
+    uint32_t nextRandom();
+    int randomInt(int bound);
+
+    bool spawnSnake(Snake& snake, const Snake* other);
+    // 在空格中均匀随机挑一个，排除蛇身、已有食物和尸体食物；没有空格时返回false
+    bool pickEmptyCell(SnakeBody& cell);
+    bool isOccupied(int x, int y) const;
+
+    void createFood();
+    void createSpecialFood();
+    void createPoison();
+    void createRandomItem();
+    void createCorpseFoods(const std::vector<SnakeBody>& body);
+    void senseAll();
+
+    // 记录本步变化的格子，step结束时统一去重并取格子的最终内容
+    void markDirty(const SnakeBody& cell, BoardChange change);
+    void markItemChange(const SnakeBody& before, bool hadBefore, const SnakeBody& after, bool hasAfter);
+    void finishBoardDelta();
+    // 有 mPtrFrameStats 时把上一阶段结束以来的时间计入 phase
+    void endPhase(FramePhase phase);
+    // 格子当前显示的内容，优先级与 writeBoard 相同
+    BoardCell cellAt(int x, int y) const;
+
+    // 吃到普通食物后的连锁生成：特殊食物或毒药，以及10%概率的随机道具
+    void onFoodEaten();
+    // 失去一条命：尸体变食物并重生，返回是否还有剩余生命
+    bool handleDeath(Snake& snake);
+
+    SnakeEnvConfig mConfig;
+    std::unique_ptr<Map> mPtrMap;
+    std::unique_ptr<Snake> mPtrSnake;
+    std::unique_ptr<Snake> mPtrOpponent;
+    std::unique_ptr<AI> mPtrAI;
+    FrameStats* mPtrFrameStats = nullptr;
+    // 合法出生点只与地图和长度有关，由地图缓存，构造时取一次
+    const std::vector<SpawnPosition>* mSpawnPositions = nullptr;
+    int mSpawnSpace = 6;
+    int mFreeCellCount = 0;
+
+    uint32_t mRng = 1;
+    int mSteps = 0;
+    int mPoints = 0;
+    int mOpponentPoints = 0;
+    bool mDone = false;
+    bool mTruncated = false;
+
+    SnakeBody mFood;
+    SnakeBody mSpecialFood;
+    SnakeBody mPoison;
+    SnakeBody mRandomItem;
+    FoodType mCurrentFoodType = FoodType::Normal;
+    bool mHasSpecialFood = false;
+    bool mHasPoison = false;
+    bool mHasRandomItem = false;
+    int mSpecialFoodExpire = 0;
+    int mPoisonExpire = 0;
+    int mRandomItemExpire = 0;
+    int mRandomItemType = 0;
+    std::vector<SnakeBody> mCorpseFoods;
+    std::vector<int> mInventory;
+    BoardDelta mBoardDelta;
+};
+
+#endif // SNAKE_ENV_H
@@ -0,0 +1,85 @@
+#ifndef SNAKE_POPULATION_H
+#define SNAKE_POPULATION_H
+
+#include <vector>
+#include <cstdint>
+#include "snake.h"
+
+// 以结构数组(SoA)方式存放一群蛇，供竞技场和批量模拟使用
+// 蛇头坐标、方向、长度、环形缓冲区偏移分别保存在平行数组中，
+// 所有蛇的身体共用一块格子下标(y * width + x)池
+class SnakePopulation
+{
+public:
+    SnakePopulation();
+
+    // 重置为 count 条死亡的蛇，并设置边界（与Snake的游戏面板宽高含义相同）
+    void reset(int count, int width, int height);
+
+    int size() const;
+    int getWidth() const;
+    int getHeight() const;
+
+    // 放置一条蛇，cells 按蛇头到蛇尾的顺序给出格子下标
+    void place(int id, const int* cells, int count, Direction direction);
+    void kill(int id);
+
+    bool isAlive(int id) const;
+    int getLength(int id) const;
+    Direction getDirection(int id) const;
+    void setDirection(int id, Direction direction);
+    int getHeadX(int id) const;
+    int getHeadY(int id) const;
+    int getHeadCell(int id) const;
+    int getTailCell(int id) const;
+    // 第 k 节身体的格子下标，0 为蛇头
+    int getBodyCell(int id, int k) const;
+
+    // 在蛇头前插入新的一节 / 移除蛇尾
+    void pushHead(int id, int x, int y);
+    void popTail(int id);
+
+    // 批量计算所有蛇沿当前方向前进一格后的蛇头位置，并做边界和墙体检查
+    // walls 为 width * height 的字节数组（非0为墙），末尾至少预留3字节填充
+    // 结果与 Snake::createNewHead + Snake::checkCollision 的边界/墙体部分一致
+    void advanceHeads(const uint8_t* walls);
+    const int32_t* getNextX() const;
+    const int32_t* getNextY() const;
+    // 非0表示下一步会越界或撞墙
+    const uint8_t* getBlocked() const;
+
+    // 是否使用AVX2内核（CPU不支持时自动回退到标量实现）
+    void setUseSimd(bool useSimd);
+    bool isUsingSimd() const;
+    static bool isSimdAvailable();
+
+private:
+    void advanceHeadsScalar(const uint8_t* walls, int begin, int end);
+    void advanceHeadsAvx2(const uint8_t* walls, int end);
+    void growRing(int id);
+
+    int mCount = 0;
+    int mWidth = 0;
+    int mHeight = 0;
+    bool mUseSimd;
+
+    // 每条蛇一项的平行数组
+    std::vector<int32_t> mHeadX;
+    std::vector<int32_t> mHeadY;
+    std::vector<int32_t> mDirection;
+    std::vector<int32_t> mLength;
+    std::vector<int32_t> mRingOffset;    // 在身体池中的起始位置
+    std::vector<int32_t> mRingCapacity;  // 环形缓冲区容量（2的幂）
+    std::vector<int32_t> mRingHead;      // 蛇头在环形缓冲区中的位置
+    std::vector<uint8_t> mAlive;
+
+    // advanceHeads 的输出
+    std::vector<int32_t> mNextX;
+    std::vector<int32_t> mNextY;
+    std::vector<uint8_t> mBlocked;
+
+    // 所有蛇共用的身体池
+    std::vector<int32_t> mBody;
+};
+
+#endif // SNAKE_POPULATION_H
@@ -0,0 +1,65 @@
+#ifndef SNAKE_VEC_ENV_C_H
+#define SNAKE_VEC_ENV_C_H
+
+/*
+ * 批量环境的C接口，供Python等语言通过 ctypes/cffi 绑定。
+ * 所有缓冲区由调用方分配并保持连续：
+ *   observations: num_envs * obs_size 字节，布局为 [局][通道][行][列]
+ *   actions:      num_envs 个 int32，取值 0左 1右 2上 3下 4保持
+ *   rewards:      num_envs 个 float
+ *   dones/truncated: num_envs 个 uint8，truncated 可以传 NULL
+ * 函数出错时返回 -1（或 NULL），成功返回 0。
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SnakeVecEnv SnakeVecEnv;
+
+typedef struct SnakeVecEnvOptions
+{
+    int num_envs;
+    int num_threads;        /* 0 表示使用硬件并发数 */
+    const char* map_file;   /* NULL 或空串表示默认地图 */
+    int width;              /* 默认地图尺寸，加载地图文件时忽略 */
+    int height;
+    int initial_length;
+    int lives;
+    int opponent;           /* 非0时加入AI对手 */
+    int max_steps;
+    int item_duration_ticks;
+    float reward_death;
+    float reward_win;
+    float reward_step;
+    uint32_t seed;
+} SnakeVecEnvOptions;
+
+/* 用默认参数填充 options */
+void snake_vec_env_default_options(SnakeVecEnvOptions* options);
+
+SnakeVecEnv* snake_vec_env_create(const SnakeVecEnvOptions* options);
+void snake_vec_env_destroy(SnakeVecEnv* env);
+
+int snake_vec_env_num_envs(const SnakeVecEnv* env);
+int snake_vec_env_num_channels(const SnakeVecEnv* env);
+int snake_vec_env_width(const SnakeVecEnv* env);
+int snake_vec_env_height(const SnakeVecEnv* env);
+int snake_vec_env_obs_size(const SnakeVecEnv* env);
+
+int snake_vec_env_reset(SnakeVecEnv* env, uint8_t* observations);
+int snake_vec_env_step(SnakeVecEnv* env, const int32_t* actions, uint8_t* observations,
+                       float* rewards, uint8_t* dones, uint8_t* truncated);
+
+/* 第 index 局最近一次结束时的得分/长度/步数 */
+int snake_vec_env_last_episode_points(const SnakeVecEnv* env, int index);
+int snake_vec_env_last_episode_length(const SnakeVecEnv* env, int index);
+int snake_vec_env_last_episode_steps(const SnakeVecEnv* env, int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAKE_VEC_ENV_C_H */
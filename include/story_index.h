@@ -0,0 +1,86 @@
+#ifndef STORY_INDEX_H
+#define STORY_INDEX_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+
+// 剧情文本索引：plot.txt 只映射、扫描一次，记下每一章开场和结尾段落在文件中的偏移，
+// 之后打开剧情界面时只读需要的段落。ncurses 和 Qt 两边通过 shared() 用同一份索引。
+// 章节编号：0 = 序章，1..5 = 各关卡（第五关对应 "Final Level"），6 = 尾声。
+// 段落取自 [Text]: / [Scene]: 之后的文字行，到下一个 [标记] 行或 [标签]: 行为止，
+// [Animation]: / [Final Shot]: 这类舞台说明不算段落；[Item Acquired]: 【物品】 单独成段，显示为 [Item Acquired]: *物品*。
+// [After the level] / [After the boss fight] 之后的段落属于结尾，[If ...] 开始一个分支，[Common ...] 回到公共部分。
+class StoryIndex
+{
+public:
+    enum class Part { Intro, Outro };
+
+    static const int kPrologue = 0;
+    static const int kEpilogue = 6;
+    static const int kSectionCount = 7;
+    static const int kAllBranches = -1;
+
+    // 进程内共用的索引
+    static StoryIndex& shared();
+
+    StoryIndex();
+
+    StoryIndex(const StoryIndex&) = delete;
+    StoryIndex& operator=(const StoryIndex&) = delete;
+
+    // 映射并建立索引；已经打开时直接返回true
+    bool open(const std::string& path);
+    bool isOpen() const;
+    std::string getLastError() const;
+
+    // 章节标题，如 "The Eternal Trial"
+    std::string title(int section) const;
+    // 整章按文件顺序的段落（开场在前，结尾在后，包含所有分支）
+    size_t paragraphCount(int section) const;
+    std::string paragraph(int section, size_t index) const;
+    // 某一部分的段落；branch 为 kAllBranches 时不区分分支，否则只取公共段落和该分支（从1开始）
+    std::vector<std::string> paragraphs(int section, Part part, int branch = kAllBranches) const;
+    // 按显示宽度折好的行，每段一组。同一章节、部分和宽度只在第一次请求时折行，之后直接返回缓存
+    std::vector<std::vector<std::string>> layout(int section, Part part, int branch, int width);
+
+    // 按单词折行，宽度按UTF-8字符计，超长的单词强制断开
+    static std::vector<std::string> wrapText(const std::string& text, int width);
+
+private:
+    struct Paragraph
+    {
+        uint32_t offset;
+        uint32_t length;
+        Part part;
+        int branch;     // 0 = 公共段落
+        bool item;      // [Item Acquired] 段落，offset/length 只指向物品名
+    };
+
+    struct Section
+    {
+        uint32_t titleOffset = 0;
+        uint32_t titleLength = 0;
+        std::vector<Paragraph> paragraphs;
+    };
+
+    void buildIndex();
+    bool selected(const Paragraph& paragraph, Part part, int branch) const;
+    std::string text(uint32_t offset, uint32_t length) const;
+    std::string paragraphText(const Paragraph& paragraph) const;
+
+    mutable std::mutex mMutex;
+    MappedFile mFile;
+    std::vector<Section> mSections;
+    // (章节, 部分, 分支, 宽度) -> 折好的行
+    std::map<std::tuple<int, int, int, int>, std::vector<std::vector<std::string>>> mLayouts;
+    std::string mLastError;
+};
+
+#endif // STORY_INDEX_H
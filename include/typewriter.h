@@ -0,0 +1,57 @@
+#ifndef TYPEWRITER_H
+#define TYPEWRITER_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 打字机效果：一页文字只排版一次，每个字形的位置算好存下；显示进度按经过的时间计算，
+// 而不是每个字符睡眠一次。界面每帧只画上一帧之后新出现的字形，再刷新一次，
+// 每帧的开销与整段文字的长度无关，卡顿一帧也只是下一帧多画几个字，总时长不会被拉长。
+
+// 排好的一页文字中的一个字形（字符界面中就是一个格子）
+struct TypewriterGlyph
+{
+    int row;
+    int col;
+    char ch;
+};
+
+class TypewriterPage
+{
+public:
+    // 每行水平居中（左边距至少 minCol），从 firstRow 开始逐行向下
+    void layoutCentered(const std::vector<std::string>& lines, int firstRow, int width, int minCol);
+
+    size_t getGlyphCount() const { return mGlyphs.size(); }
+    const TypewriterGlyph& getGlyph(size_t index) const { return mGlyphs[index]; }
+
+private:
+    std::vector<TypewriterGlyph> mGlyphs;
+};
+
+// 按经过的时间给出应该显示的字形数
+class TypewriterClock
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TypewriterClock(int msPerGlyph);
+
+    void start(size_t glyphCount, Clock::time_point now = Clock::now());
+    // 直接显示全部（跳过动画）
+    void finish();
+    // now 时刻应显示的字形数，不超过总数
+    size_t revealedAt(Clock::time_point now = Clock::now()) const;
+    bool isFinished(Clock::time_point now = Clock::now()) const;
+    size_t getGlyphCount() const { return mGlyphCount; }
+
+private:
+    std::chrono::microseconds mPerGlyph;
+    size_t mGlyphCount = 0;
+    Clock::time_point mStart;
+    bool mFinished = true;
+};
+
+#endif // TYPEWRITER_H
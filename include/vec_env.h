@@ -0,0 +1,84 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "snake_env.h"
+
+// 批量环境参数
+struct VecEnvConfig
+{
+    int numEnvs = 8;            // 同时推进的局数
+    int numThreads = 0;         // 工作线程数，0 表示使用硬件并发数，1 表示单线程
+    SnakeEnvConfig env;         // 每一局的参数，第 i 局的随机种子由 env.seed 和 i 派生
+};
+
+// 批量环境：B 局互相独立的游戏按同一节拍推进，分摊到常驻线程上。
+// 观测直接写入调用方提供的连续缓冲区，布局为 [局][通道][行][列]，每格一个字节，
+// 第 i 局的观测从 i * getObservationSize() 开始；每局结束后自动重开，
+// 该步返回的观测已经是新一局的开局局面
+class VecEnv
+{
+public:
+    explicit VecEnv(const VecEnvConfig& config);
+    ~VecEnv();
+
+    // 重开所有局，observations 可以为空
+    void reset(uint8_t* observations);
+    // 推进一步。actions 长度为 B，取值见 EnvAction；rewards/dones 长度为 B，
+    // truncated 可以为空，dones 中因步数上限结束的局同时在 truncated 中置1
+    void step(const int* actions, uint8_t* observations, float* rewards, uint8_t* dones, uint8_t* truncated = nullptr);
+
+    int getNumEnvs() const;
+    int getThreadCount() const;
+    int getChannelCount() const;
+    int getWidth() const;
+    int getHeight() const;
+    // 单局观测的字节数
+    int getObservationSize() const;
+
+    // 最近一局结束时的得分、长度和步数（自动重开前记录）
+    int getLastEpisodePoints(int index) const;
+    int getLastEpisodeLength(int index) const;
+    int getLastEpisodeSteps(int index) const;
+
+    const SnakeEnv& getEnv(int index) const;
+
+private:
+    void runRange(int begin, int end);
+    void runAll();
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(int index);
+
+    VecEnvConfig mConfig;
+    std::vector<std::unique_ptr<SnakeEnv>> mEnvs;
+    std::vector<int> mLastPoints;
+    std::vector<int> mLastLength;
+    std::vector<int> mLastSteps;
+
+    // 当前这一批任务的参数，由主线程在唤醒工作线程前写好
+    bool mJobReset = false;
+    const int* mJobActions = nullptr;
+    uint8_t* mJobObservations = nullptr;
+    float* mJobRewards = nullptr;
+    uint8_t* mJobDones = nullptr;
+    uint8_t* mJobTruncated = nullptr;
+
+    // 常驻工作线程，避免每步创建线程
+    std::vector<std::thread> mWorkers;
+    std::mutex mPoolMutex;
+    std::condition_variable mPoolStart;
+    std::condition_variable mPoolDone;
+    int mThreadCount = 1;
+    long long mPoolGeneration = 0;
+    int mPoolPending = 0;
+    bool mPoolStop = false;
+};
+
+#endif // VEC_ENV_H
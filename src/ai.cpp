@@ -17,6 +17,8 @@ Direction AI::findNextMove(const Map& map, const Snake& playerSnake, const Snake
     int headX = aiSnake.getSnake().front().getX();
     int headY = aiSnake.getSnake().front().getY();
 
+    buildFreeCells(map, playerSnake, aiSnake);
+
     struct Target {
         int x, y, value;
         bool isPoison;
@@ -203,15 +205,7 @@ float AI::calculatePlayerSnakePenalty(const Snake& playerSnake, int targetX, int
 
 bool AI::isDeadEnd(const Map& map, const Snake& playerSnake, const Snake& aiSnake, int x, int y) const {
     // 简单判定：周围安全格子数<=1视为死路
-    int safeCount = 0;
-    for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            if (std::abs(dx) + std::abs(dy) != 1) continue;
-            int nx = x + dx, ny = y + dy;
-            if (isSafePosition(map, playerSnake, aiSnake, nx, ny)) safeCount++;
-        }
-    }
-    return safeCount <= 1;
+    return mFreeCells.countNeighbours(x, y) <= 1;
 }
 
 Direction AI::avoidPoison(const Map& map, const Snake& playerSnake, const Snake& aiSnake, 
@@ -323,7 +317,7 @@ Direction AI::findSafePathToTarget(const Map& map, const Snake& playerSnake, con
     // 标记障碍物（包括玩家蛇）
     for (int y = 0; y < mGameBoardHeight; ++y) {
         for (int x = 0; x < mGameBoardWidth; ++x) {
-            if (map.isWall(x, y) || playerSnake.isPartOfSnake(x, y) || aiSnake.isPartOfSnake(x, y)) {
+            if (!mFreeCells.test(x, y)) {
                 visited[y][x] = true;
             }
         }
@@ -494,27 +488,34 @@ int AI::calculateDistance(int x1, int y1, int x2, int y2) const {
 }
 
 bool AI::isSafePosition(const Map& map, const Snake& playerSnake, const Snake& aiSnake, int x, int y) const {
-    // 检查边界
-    if (x < 0 || x >= mGameBoardWidth || y < 0 || y >= mGameBoardHeight) {
-        return false;
-    }
-    
-    // 检查墙壁
-    if (map.isWall(x, y)) {
-        return false;
+    // 边界、墙壁和两条蛇的身体都已经在 buildFreeCells 中合并进位图
+    return mFreeCells.test(x, y);
+}
+
+void AI::buildFreeCells(const Map& map, const Snake& playerSnake, const Snake& aiSnake) const {
+    mFreeCells.resize(mGameBoardWidth, mGameBoardHeight);
+
+    // 面板内且在地图范围内的格子，按字取墙体位图的反码；地图之外一律视为墙
+    const Bitboard& walls = map.getWallBits();
+    const int rows = std::min(mGameBoardHeight, map.getHeight());
+    const int columns = std::min(mGameBoardWidth, map.getWidth());
+    const int words = (columns + 63) / 64;
+    for (int y = 0; y < rows; ++y) {
+        uint64_t* row = mFreeCells.row(y);
+        const uint64_t* wallRow = walls.row(y);
+        for (int w = 0; w < words; ++w) {
+            int used = std::min(64, columns - w * 64);
+            uint64_t mask = (used == 64) ? ~0ULL : ((1ULL << used) - 1);
+            row[w] = ~wallRow[w] & mask;
+        }
     }
-    
-    // 检查是否与玩家蛇身重叠
-    if (playerSnake.isPartOfSnake(x, y)) {
-        return false;
+
+    for (const auto& part : playerSnake.getSnake()) {
+        mFreeCells.reset(part.getX(), part.getY());
     }
-    
-    // 检查是否与AI蛇身重叠
-    if (aiSnake.isPartOfSnake(x, y)) {
-        return false;
+    for (const auto& part : aiSnake.getSnake()) {
+        mFreeCells.reset(part.getX(), part.getY());
     }
-    
-    return true;
 }
 
 bool AI::isDirectionSafe(const Map& map, const Snake& playerSnake, const Snake& aiSnake, 
@@ -0,0 +1,94 @@
+#include "frame_stats.h"
+#include <cstdlib>
+#include <new>
+
+// 替换全局 operator new/delete，每次分配只多一次原子加法，供性能面板统计每帧的分配次数。
+// 只链接进游戏本体，环境库和基准程序仍使用标准库的实现。
+
+namespace
+{
+    void* allocate(std::size_t size)
+    {
+        gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (size == 0)
+        {
+            size = 1;
+        }
+        while (true)
+        {
+            void* ptr = std::malloc(size);
+            if (ptr)
+            {
+                return ptr;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void* allocateNoThrow(std::size_t size) noexcept
+    {
+        try
+        {
+            return allocate(size);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,333 @@
+#include "app_controller.h"
+#include "gui/gui_manager.h"
+#include <QApplication>
+#include <QTimer>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+// ncurses的宏（clear、refresh等）会和Qt的同名成员冲突，放在Qt头文件之后
+#include "game.h"
+
+namespace
+{
+    // 检查是否支持GUI环境
+    bool isGUIAvailable()
+    {
+        const char* display = std::getenv("DISPLAY");
+        return display && std::strlen(display) > 0;
+    }
+}
+
+AppController::AppController(int& argc, char** argv)
+    : mArgc(argc)
+    , mArgv(argv)
+{
+}
+
+AppController::~AppController()
+{
+    // Game 的析构会保存档案并删除ncurses窗口，需要在endwin之前
+    mGame.reset();
+    if (mCursesActive)
+    {
+        endwin();
+    }
+    mGuiManager.reset();
+    mApp.reset();
+}
+
+int AppController::run()
+{
+    mTransitionStart = Clock::now();
+    mTransitionPending = true;
+    Scene scene = Scene::ModeSelect;
+    while (scene != Scene::Exit)
+    {
+        switch (scene)
+        {
+        case Scene::ModeSelect:
+            scene = runModeSelect();
+            break;
+        case Scene::Classic:
+            scene = runClassic();
+            break;
+        case Scene::Shop:
+            scene = runShop();
+            break;
+        case Scene::StoryLevel:
+            scene = runStoryLevel();
+            break;
+        case Scene::Exit:
+            break;
+        }
+    }
+    if (mCursesActive)
+    {
+        leaveCurses();
+    }
+    writeTransitionLog();
+    return 0;
+}
+
+AppController::Scene AppController::runModeSelect()
+{
+    if (!ensureGui())
+    {
+        // 没有图形环境时回退到ncurses，由经典模式自己的菜单选择玩法
+        return Scene::Classic;
+    }
+
+    if (mGuiStarted && mResumeStoryLevels)
+    {
+        mResumeStoryLevels = false;
+        mGuiManager->returnToStoryLevels();
+    }
+    else if (mGuiStarted)
+    {
+        mGuiManager->returnToModeSelect();
+    }
+    else
+    {
+        // 同步关卡进度（确保显示最新的解锁状态）
+        mGuiManager->syncLevelProgress();
+        mGuiManager->start();
+        mGuiStarted = true;
+    }
+    // 窗口已经show，事件循环第一次空闲时即可交互
+    QTimer::singleShot(0, [this]() { finishTransition(Scene::ModeSelect); });
+    mApp->exec();
+
+    beginTransition(Scene::ModeSelect);
+    if (mGuiManager->isExitRequested())
+    {
+        return Scene::Exit;
+    }
+    if (mGuiManager->isClassicModeSelected())
+    {
+        return Scene::Classic;
+    }
+    if (mGuiManager->isShopRequested())
+    {
+        return Scene::Shop;
+    }
+    if (mGuiManager->isTerminalLevelRequested())
+    {
+        return Scene::StoryLevel;
+    }
+    // 第一、二关在GUI的事件循环中直接进行，其余情况（如关闭所有窗口）视为退出
+    return Scene::Exit;
+}
+
+AppController::Scene AppController::runClassic()
+{
+    enterCurses();
+    Game& classic = game();
+    finishTransition(Scene::Classic);
+
+    // 经典模式：进入游戏循环，允许用户选择模式并退回模式选择
+    bool exitGame = false;
+    while (!exitGame)
+    {
+        // 如果用户选择退出，则结束游戏
+        if (!classic.selectLevel())
+        {
+            break;
+        }
+        classic.startGame();
+        // 如果用户没有选择返回模式选择，则退出游戏
+        if (!classic.shouldReturnToModeSelect())
+        {
+            exitGame = true;
+        }
+        // 刷新屏幕并清除所有输入缓冲
+        clear();
+        refresh();
+        flushinp();
+    }
+    return Scene::Exit;
+}
+
+AppController::Scene AppController::runShop()
+{
+    enterCurses();
+    Game& shop = game();
+    shop.loadPlayerProfile();  // 加载玩家数据
+    shop.loadItemInventory();  // 加载道具数据
+    finishTransition(Scene::Shop);
+    shop.showShopMenu();
+
+    // 商店结束后回到同一个QApplication的模式选择界面
+    beginTransition(Scene::Shop);
+    leaveCurses();
+    return mGuiFailed ? Scene::Exit : Scene::ModeSelect;
+}
+
+AppController::Scene AppController::runStoryLevel()
+{
+    enterCurses();
+    Game& story = game();
+    finishTransition(Scene::StoryLevel);
+    // 第三关起的玩法（模式选择、音乐关、Boss战）只有Game实现，通关后可以在终端里继续下一关
+    story.startLevelDirectly(mGuiManager->getSelectedLevel());
+
+    beginTransition(Scene::StoryLevel);
+    leaveCurses();
+    if (!story.shouldReturnToModeSelect())
+    {
+        // 玩家在终端的菜单中选择了退出游戏
+        return Scene::Exit;
+    }
+    mResumeStoryLevels = true;
+    return Scene::ModeSelect;
+}
+
+bool AppController::ensureGui()
+{
+    if (mApp)
+    {
+        return true;
+    }
+    if (mGuiFailed || !isGUIAvailable())
+    {
+        mGuiFailed = true;
+        return false;
+    }
+    try
+    {
+        mApp.reset(new QApplication(mArgc, mArgv));
+        mGuiManager.reset(new GUIManager());
+    }
+    catch (...)
+    {
+        // GUI启动失败，回退到ncurses模式
+        mGuiManager.reset();
+        mApp.reset();
+        mGuiFailed = true;
+        return false;
+    }
+    return true;
+}
+
+void AppController::enterCurses()
+{
+    if (mCursesActive)
+    {
+        return;
+    }
+    if (!mCursesStarted)
+    {
+        initscr();
+        // 不显示用户输入字符
+        noecho();
+        // 启用功能键
+        keypad(stdscr, TRUE);
+        // 不等待输入
+        nodelay(stdscr, TRUE);
+        // 隐藏光标
+        curs_set(0);
+        // 启用并初始化颜色: 1=蛇1(青色), 2=蛇2(黄色), 3=食物(红色)，其余供商店使用
+        if (has_colors())
+        {
+            start_color();
+            init_pair(1, COLOR_CYAN, COLOR_BLACK);
+            init_pair(2, COLOR_YELLOW, COLOR_BLACK);
+            init_pair(3, COLOR_RED, COLOR_BLACK);
+            init_pair(4, COLOR_RED, COLOR_BLACK);
+            init_pair(5, COLOR_BLUE, COLOR_BLACK);
+            init_pair(6, COLOR_GREEN, COLOR_BLACK);
+        }
+        mCursesStarted = true;
+    }
+    else
+    {
+        // 恢复挂起前的终端模式，窗口和颜色都还在
+        reset_prog_mode();
+    }
+    mCursesActive = true;
+    clear();
+    refresh();
+    // 清空所有键盘输入缓冲
+    flushinp();
+}
+
+void AppController::leaveCurses()
+{
+    if (!mCursesActive)
+    {
+        return;
+    }
+    def_prog_mode();
+    endwin();
+    mCursesActive = false;
+}
+
+Game& AppController::game()
+{
+    // Game 的构造读取屏幕尺寸，必须在 initscr 之后
+    if (!mGame)
+    {
+        mGame.reset(new Game());
+    }
+    return *mGame;
+}
+
+void AppController::beginTransition(Scene from)
+{
+    mTransitionFrom = from;
+    mTransitionStart = Clock::now();
+    mTransitionPending = true;
+}
+
+void AppController::finishTransition(Scene to)
+{
+    if (!mTransitionPending)
+    {
+        return;
+    }
+    mTransitionPending = false;
+    Transition transition;
+    transition.from = mTransitionFrom;
+    transition.to = to;
+    transition.ms = std::chrono::duration<double, std::milli>(Clock::now() - mTransitionStart).count();
+    transition.cold = !mVisited[static_cast<int>(to)];
+    mVisited[static_cast<int>(to)] = true;
+    mTransitions.push_back(transition);
+}
+
+void AppController::writeTransitionLog() const
+{
+    const char* path = std::getenv("SNAKE_TRANSITION_LOG");
+    if (!path || mTransitions.empty())
+    {
+        return;
+    }
+    std::FILE* file = std::fopen(path, "a");
+    if (!file)
+    {
+        return;
+    }
+    for (const Transition& transition : mTransitions)
+    {
+        std::fprintf(file, "%s -> %s: %.1f ms (%s)\n", sceneName(transition.from), sceneName(transition.to),
+                     transition.ms, transition.cold ? "cold" : "warm");
+    }
+    std::fclose(file);
+}
+
+const char* AppController::sceneName(Scene scene)
+{
+    switch (scene)
+    {
+    case Scene::ModeSelect:
+        return "ModeSelect";
+    case Scene::Classic:
+        return "Classic";
+    case Scene::Shop:
+        return "Shop";
+    case Scene::StoryLevel:
+        return "StoryLevel";
+    case Scene::Exit:
+        break;
+    }
+    return "Start";
+}
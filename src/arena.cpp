@@ -0,0 +1,588 @@
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include "arena.h"
+
+namespace
+{
+    // xorshift32，足够快，也便于每条蛇独立持有随机状态
+    uint32_t nextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    bool isOpposite(Direction a, Direction b)
+    {
+        return (a == Direction::Up && b == Direction::Down) ||
+               (a == Direction::Down && b == Direction::Up) ||
+               (a == Direction::Left && b == Direction::Right) ||
+               (a == Direction::Right && b == Direction::Left);
+    }
+
+    const Direction kDirections[4] = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
+}
+
+Arena::Arena(const Map& map, const ArenaConfig& config)
+    : mWidth(map.getWidth()), mHeight(map.getHeight()), mConfig(config)
+{
+    mSpawnRng = config.seed != 0 ? config.seed : 1;
+
+    mWalls.assign(mWidth * mHeight, kEmpty);
+    mWallMask.assign(mWidth * mHeight + 4, 0);
+    for (int y = 0; y < mHeight; y++)
+    {
+        for (int x = 0; x < mWidth; x++)
+        {
+            if (map.isWall(x, y))
+            {
+                mWalls[y * mWidth + x] = kWall;
+                mWallMask[y * mWidth + x] = 1;
+            }
+        }
+    }
+
+    mClaimTick.assign(mWidth * mHeight, -1);
+    mClaimOwner.assign(mWidth * mHeight, -1);
+
+    if (mConfig.numFoods <= 0)
+    {
+        mConfig.numFoods = mConfig.numSnakes;
+    }
+
+    reset();
+
+    if (mConfig.parallel)
+    {
+        startWorkers();
+    }
+}
+
+Arena::~Arena()
+{
+    stopWorkers();
+}
+
+void Arena::reset()
+{
+    mGrid = mWalls;
+    mTick = 0;
+    mAliveCount = 0;
+    std::fill(mClaimTick.begin(), mClaimTick.end(), -1);
+
+    const int count = mConfig.numSnakes;
+    mPopulation.reset(count, mWidth, mHeight);
+    mEating.assign(count, 0);
+    mTarget.assign(count, -1);
+    mScore.assign(count, 0);
+    mRespawnTick.assign(count, 0);
+    mDead.assign(count, 0);
+    mRng.resize(count);
+    for (int id = 0; id < count; id++)
+    {
+        mRng[id] = (mConfig.seed + 1) * 2654435761u + static_cast<uint32_t>(id) * 40503u;
+        if (mRng[id] == 0)
+        {
+            mRng[id] = 1;
+        }
+        spawnSnake(id);
+    }
+
+    mFoods.assign(mConfig.numFoods, -1);
+    refillFoods();
+}
+
+void Arena::setParallel(bool parallel)
+{
+    if (parallel == mConfig.parallel)
+    {
+        return;
+    }
+    mConfig.parallel = parallel;
+    if (parallel)
+    {
+        startWorkers();
+    }
+    else
+    {
+        stopWorkers();
+    }
+}
+
+bool Arena::isParallel() const
+{
+    return mConfig.parallel && !mWorkers.empty();
+}
+
+int Arena::getWidth() const
+{
+    return mWidth;
+}
+
+int Arena::getHeight() const
+{
+    return mHeight;
+}
+
+int Arena::getCell(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return kWall;
+    }
+    return mGrid[y * mWidth + x];
+}
+
+int Arena::getSnakeCount() const
+{
+    return mPopulation.size();
+}
+
+int Arena::getAliveCount() const
+{
+    return mAliveCount;
+}
+
+bool Arena::isAlive(int id) const
+{
+    return mPopulation.isAlive(id);
+}
+
+int Arena::getSnakeLength(int id) const
+{
+    return mPopulation.getLength(id);
+}
+
+int Arena::getSnakeScore(int id) const
+{
+    return mScore[id];
+}
+
+SnakeBody Arena::getSnakeHead(int id) const
+{
+    if (!mPopulation.isAlive(id))
+    {
+        return SnakeBody(-1, -1);
+    }
+    return SnakeBody(mPopulation.getHeadX(id), mPopulation.getHeadY(id));
+}
+
+long long Arena::getTickCount() const
+{
+    return mTick;
+}
+
+const SnakePopulation& Arena::getPopulation() const
+{
+    return mPopulation;
+}
+
+int Arena::randomEmptyCell(uint32_t& rng) const
+{
+    // 大地图上空格远多于占用格，拒绝采样的期望次数接近1
+    const int total = mWidth * mHeight;
+    for (int attempt = 0; attempt < 64; attempt++)
+    {
+        int cell = static_cast<int>(nextRandom(rng) % total);
+        if (mGrid[cell] == kEmpty)
+        {
+            return cell;
+        }
+    }
+    return -1;
+}
+
+bool Arena::spawnSnake(int id)
+{
+    const int length = std::max(1, mConfig.initialLength);
+
+    for (int attempt = 0; attempt < 32; attempt++)
+    {
+        int headCell = randomEmptyCell(mSpawnRng);
+        if (headCell < 0)
+        {
+            continue;
+        }
+        Direction direction = kDirections[nextRandom(mSpawnRng) & 3];
+
+        // 与Snake::initializeSnake一致：身体向移动方向的反方向延伸
+        Direction backward = direction;
+        switch (direction)
+        {
+            case Direction::Up: backward = Direction::Down; break;
+            case Direction::Down: backward = Direction::Up; break;
+            case Direction::Left: backward = Direction::Right; break;
+            case Direction::Right: backward = Direction::Left; break;
+        }
+
+        int cells[64];
+        int count = std::min(length, 64);
+        bool fits = true;
+        cells[0] = headCell;
+        for (int k = 1; k < count && fits; k++)
+        {
+            cells[k] = moveCell(cells[k - 1], backward);
+            fits = cells[k] >= 0 && mGrid[cells[k]] == kEmpty;
+        }
+        // 蛇头前方至少留一格，避免出生即撞墙
+        int ahead = moveCell(headCell, direction);
+        if (!fits || ahead < 0 || mGrid[ahead] != kEmpty)
+        {
+            continue;
+        }
+
+        mPopulation.place(id, cells, count, direction);
+        for (int k = 0; k < count; k++)
+        {
+            mGrid[cells[k]] = id;
+        }
+        mEating[id] = 0;
+        mTarget[id] = -1;
+        mAliveCount++;
+        return true;
+    }
+
+    mRespawnTick[id] = mTick + std::max(1, mConfig.respawnDelay);
+    return false;
+}
+
+void Arena::killSnake(int id)
+{
+    const int leftover = mConfig.corpseFood ? kFood : kEmpty;
+    const int length = mPopulation.getLength(id);
+    for (int k = 0; k < length; k++)
+    {
+        mGrid[mPopulation.getBodyCell(id, k)] = leftover;
+    }
+    mPopulation.kill(id);
+    mRespawnTick[id] = mTick + mConfig.respawnDelay;
+    mAliveCount--;
+}
+
+void Arena::refillFoods()
+{
+    for (int& food : mFoods)
+    {
+        if (food >= 0 && mGrid[food] == kFood)
+        {
+            continue;
+        }
+        food = randomEmptyCell(mSpawnRng);
+        if (food >= 0)
+        {
+            mGrid[food] = kFood;
+        }
+    }
+}
+
+int Arena::moveCell(int cell, Direction direction) const
+{
+    int x = cell % mWidth;
+    int y = cell / mWidth;
+    switch (direction)
+    {
+        case Direction::Up: y--; break;
+        case Direction::Down: y++; break;
+        case Direction::Left: x--; break;
+        case Direction::Right: x++; break;
+    }
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return -1;
+    }
+    return y * mWidth + x;
+}
+
+bool Arena::isFreeCell(int cell) const
+{
+    return cell >= 0 && (mGrid[cell] == kEmpty || mGrid[cell] == kFood);
+}
+
+void Arena::decide(int id)
+{
+    // 决策阶段只改变方向，蛇头的实际推进由 SnakePopulation::advanceHeads 批量完成
+    const int headCell = mPopulation.getHeadCell(id);
+    const Direction current = mPopulation.getDirection(id);
+    uint32_t& rng = mRng[id];
+
+    if (mConfig.policy == ArenaPolicy::Scripted)
+    {
+        // 直行为主，前方受阻或者随机触发时尝试左右转
+        Direction direction = current;
+        if (!isFreeCell(moveCell(headCell, direction)) || (nextRandom(rng) & 15) == 0)
+        {
+            Direction turns[2];
+            if (direction == Direction::Up || direction == Direction::Down)
+            {
+                turns[0] = Direction::Left;
+                turns[1] = Direction::Right;
+            }
+            else
+            {
+                turns[0] = Direction::Up;
+                turns[1] = Direction::Down;
+            }
+            if (nextRandom(rng) & 1)
+            {
+                std::swap(turns[0], turns[1]);
+            }
+            for (Direction turn : turns)
+            {
+                if (isFreeCell(moveCell(headCell, turn)))
+                {
+                    direction = turn;
+                    break;
+                }
+            }
+        }
+        mPopulation.setDirection(id, direction);
+        return;
+    }
+
+    // 贪心策略：目标被吃掉后，从几个随机食物里挑最近的一个作为新目标
+    const int headX = headCell % mWidth;
+    const int headY = headCell / mWidth;
+    int& target = mTarget[id];
+    if (target < 0 || mGrid[target] != kFood)
+    {
+        target = -1;
+        int bestDistance = INT_MAX;
+        for (int sample = 0; sample < 4 && !mFoods.empty(); sample++)
+        {
+            int food = mFoods[nextRandom(rng) % mFoods.size()];
+            if (food < 0 || mGrid[food] != kFood)
+            {
+                continue;
+            }
+            int distance = std::abs(food % mWidth - headX) + std::abs(food / mWidth - headY);
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                target = food;
+            }
+        }
+    }
+
+    // 当前方向优先参与比较，距离相同时不转弯
+    Direction best = current;
+    int bestScore = INT_MAX;
+    int candidate = moveCell(headCell, current);
+    if (isFreeCell(candidate))
+    {
+        bestScore = target < 0 ? 0 :
+            std::abs(target % mWidth - candidate % mWidth) + std::abs(target / mWidth - candidate / mWidth);
+    }
+    for (Direction direction : kDirections)
+    {
+        if (direction == current || isOpposite(direction, current))
+        {
+            continue;
+        }
+        candidate = moveCell(headCell, direction);
+        if (!isFreeCell(candidate))
+        {
+            continue;
+        }
+        int score = target < 0 ? 1 :
+            std::abs(target % mWidth - candidate % mWidth) + std::abs(target / mWidth - candidate / mWidth);
+        if (score < bestScore)
+        {
+            bestScore = score;
+            best = direction;
+        }
+    }
+
+    mPopulation.setDirection(id, best);
+}
+
+void Arena::decideRange(int begin, int end)
+{
+    for (int id = begin; id < end; id++)
+    {
+        if (mPopulation.isAlive(id))
+        {
+            decide(id);
+        }
+    }
+}
+
+void Arena::resolveMoves()
+{
+    const int count = mPopulation.size();
+
+    // 批量推进所有蛇头：方向位移、边界检查和墙体查询在同一个循环里完成
+    mPopulation.advanceHeads(mWallMask.data());
+    const int32_t* nextX = mPopulation.getNextX();
+    const int32_t* nextY = mPopulation.getNextY();
+    const uint8_t* blocked = mPopulation.getBlocked();
+
+    // 第一步：不进食的蛇先让出尾巴，与Snake::moveFoward先弹出尾部再检查碰撞的顺序一致
+    for (int id = 0; id < count; id++)
+    {
+        if (!mPopulation.isAlive(id))
+        {
+            continue;
+        }
+        mEating[id] = !blocked[id] && mGrid[nextY[id] * mWidth + nextX[id]] == kFood;
+        if (!mEating[id])
+        {
+            mGrid[mPopulation.getTailCell(id)] = kEmpty;
+            mPopulation.popTail(id);
+        }
+    }
+
+    // 第二步：一次遍历所有蛇头。撞墙、撞身体直接死亡；
+    // 两个蛇头进入同一格时，通过认领表发现并让双方都死亡
+    std::fill(mDead.begin(), mDead.end(), 0);
+    for (int id = 0; id < count; id++)
+    {
+        if (!mPopulation.isAlive(id))
+        {
+            continue;
+        }
+        if (blocked[id])
+        {
+            mDead[id] = 1;
+            continue;
+        }
+        int cell = nextY[id] * mWidth + nextX[id];
+        if (mGrid[cell] >= 0)
+        {
+            mDead[id] = 1;
+        }
+        else if (mClaimTick[cell] == mTick)
+        {
+            mDead[id] = 1;
+            mDead[mClaimOwner[cell]] = 1;
+        }
+        else
+        {
+            mClaimTick[cell] = mTick;
+            mClaimOwner[cell] = id;
+        }
+    }
+
+    // 第三步：提交存活的蛇头，清理死亡的蛇
+    for (int id = 0; id < count; id++)
+    {
+        if (!mPopulation.isAlive(id))
+        {
+            continue;
+        }
+        if (mDead[id])
+        {
+            killSnake(id);
+            continue;
+        }
+        mPopulation.pushHead(id, nextX[id], nextY[id]);
+        mGrid[nextY[id] * mWidth + nextX[id]] = id;
+        if (mEating[id])
+        {
+            mScore[id]++;
+        }
+    }
+}
+
+void Arena::step()
+{
+    mTick++;
+
+    const int count = mPopulation.size();
+    if (isParallel())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mPoolMutex);
+            mPoolPending = static_cast<int>(mWorkers.size());
+            mPoolGeneration++;
+        }
+        mPoolStart.notify_all();
+
+        // 主线程负责第0段
+        decideRange(0, count / mThreadCount);
+
+        std::unique_lock<std::mutex> lock(mPoolMutex);
+        mPoolDone.wait(lock, [this] { return mPoolPending == 0; });
+    }
+    else
+    {
+        decideRange(0, count);
+    }
+
+    resolveMoves();
+
+    if (mConfig.respawnDelay >= 0)
+    {
+        for (int id = 0; id < count; id++)
+        {
+            if (!mPopulation.isAlive(id) && mRespawnTick[id] <= mTick)
+            {
+                spawnSnake(id);
+            }
+        }
+    }
+
+    refillFoods();
+}
+
+void Arena::startWorkers()
+{
+    stopWorkers();
+
+    int threads = mConfig.numThreads;
+    if (threads <= 0)
+    {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    mThreadCount = std::max(1, threads);
+
+    mPoolStop = false;
+    mPoolGeneration = 0;
+    for (int i = 1; i < mThreadCount; i++)
+    {
+        mWorkers.emplace_back(&Arena::workerLoop, this, i);
+    }
+}
+
+void Arena::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mPoolMutex);
+        mPoolStop = true;
+    }
+    mPoolStart.notify_all();
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+    mWorkers.clear();
+    mThreadCount = 1;
+}
+
+void Arena::workerLoop(int index)
+{
+    long long seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mPoolMutex);
+            mPoolStart.wait(lock, [this, seen] { return mPoolStop || mPoolGeneration != seen; });
+            if (mPoolStop)
+            {
+                return;
+            }
+            seen = mPoolGeneration;
+        }
+
+        // 决策阶段只读网格、只写自己负责的蛇，分段之间互不干扰
+        const int count = mPopulation.size();
+        decideRange(count * index / mThreadCount, count * (index + 1) / mThreadCount);
+
+        std::lock_guard<std::mutex> lock(mPoolMutex);
+        if (--mPoolPending == 0)
+        {
+            mPoolDone.notify_one();
+        }
+    }
+}
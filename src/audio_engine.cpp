@@ -0,0 +1,792 @@
+#include "audio_engine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef SNAKE_HAVE_MPG123
+#include <mpg123.h>
+#endif
+#ifdef SNAKE_HAVE_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+namespace
+{
+    const size_t kDecodeFrames = 2048;      // 解码器每次读入的帧数
+
+    bool hasExtension(const std::string& path, const char* extension)
+    {
+        const size_t length = std::strlen(extension);
+        if (path.size() < length)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < length; i++)
+        {
+            if (std::tolower(static_cast<unsigned char>(path[path.size() - length + i])) != extension[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t readLe32(const unsigned char* bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    uint16_t readLe16(const unsigned char* bytes)
+    {
+        return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    void writeLe32(std::FILE* file, uint32_t value)
+    {
+        const unsigned char bytes[4] = {
+            static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+            static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+        std::fwrite(bytes, 1, 4, file);
+    }
+
+    void writeLe16(std::FILE* file, uint16_t value)
+    {
+        const unsigned char bytes[2] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8)};
+        std::fwrite(bytes, 1, 2, file);
+    }
+
+    // RIFF/WAVE 整数PCM，按块从文件读取并转换成16位
+    class WavDecoder : public AudioDecoder
+    {
+    public:
+        ~WavDecoder() override
+        {
+            if (mFile)
+            {
+                std::fclose(mFile);
+            }
+        }
+
+        bool open(const std::string& path)
+        {
+            mFile = std::fopen(path.c_str(), "rb");
+            if (!mFile)
+            {
+                return false;
+            }
+            unsigned char header[12];
+            if (std::fread(header, 1, 12, mFile) != 12 || std::memcmp(header, "RIFF", 4) != 0 ||
+                std::memcmp(header + 8, "WAVE", 4) != 0)
+            {
+                return false;
+            }
+            bool haveFormat = false;
+            unsigned char chunk[8];
+            while (std::fread(chunk, 1, 8, mFile) == 8)
+            {
+                const uint32_t size = readLe32(chunk + 4);
+                if (std::memcmp(chunk, "fmt ", 4) == 0)
+                {
+                    unsigned char format[16];
+                    if (size < 16 || std::fread(format, 1, 16, mFile) != 16)
+                    {
+                        return false;
+                    }
+                    const uint16_t tag = readLe16(format);
+                    mChannels = readLe16(format + 2);
+                    mSampleRate = static_cast<int>(readLe32(format + 4));
+                    mBytesPerSample = readLe16(format + 14) / 8;
+                    // 1 为PCM，0xFFFE 为扩展格式，这里只当整数PCM处理
+                    if ((tag != 1 && tag != 0xFFFE) || mChannels < 1 || mSampleRate <= 0 ||
+                        mBytesPerSample < 1 || mBytesPerSample > 4)
+                    {
+                        return false;
+                    }
+                    haveFormat = true;
+                    std::fseek(mFile, static_cast<long>(size - 16 + (size & 1)), SEEK_CUR);
+                }
+                else if (std::memcmp(chunk, "data", 4) == 0)
+                {
+                    if (!haveFormat)
+                    {
+                        return false;
+                    }
+                    mDataOffset = std::ftell(mFile);
+                    mDataBytes = size;
+                    mRemainingBytes = size;
+                    return true;
+                }
+                else
+                {
+                    // 块按偶数字节对齐
+                    std::fseek(mFile, static_cast<long>(size + (size & 1)), SEEK_CUR);
+                }
+            }
+            return false;
+        }
+
+        int getSampleRate() const override { return mSampleRate; }
+        int getChannels() const override { return mChannels; }
+
+        size_t read(int16_t* out, size_t frames) override
+        {
+            const size_t frameBytes = static_cast<size_t>(mChannels) * mBytesPerSample;
+            frames = std::min(frames, static_cast<size_t>(mRemainingBytes / frameBytes));
+            if (frames == 0)
+            {
+                return 0;
+            }
+            mBuffer.resize(frames * frameBytes);
+            frames = std::fread(mBuffer.data(), frameBytes, frames, mFile);
+            mRemainingBytes -= frames * frameBytes;
+
+            const size_t samples = frames * mChannels;
+            const unsigned char* in = mBuffer.data();
+            for (size_t i = 0; i < samples; i++, in += mBytesPerSample)
+            {
+                switch (mBytesPerSample)
+                {
+                case 1:
+                    out[i] = static_cast<int16_t>((in[0] - 128) << 8);
+                    break;
+                default:
+                    // 16/24/32位都取最高的两个字节
+                    out[i] = static_cast<int16_t>(in[mBytesPerSample - 2] | (in[mBytesPerSample - 1] << 8));
+                    break;
+                }
+            }
+            return frames;
+        }
+
+        bool rewind() override
+        {
+            mRemainingBytes = mDataBytes;
+            return std::fseek(mFile, mDataOffset, SEEK_SET) == 0;
+        }
+
+    private:
+        std::FILE* mFile = nullptr;
+        int mSampleRate = 0;
+        int mChannels = 0;
+        int mBytesPerSample = 0;
+        long mDataOffset = 0;
+        uint32_t mDataBytes = 0;
+        uint32_t mRemainingBytes = 0;
+        std::vector<unsigned char> mBuffer;
+    };
+
+#ifdef SNAKE_HAVE_MPG123
+    // mp3 由 libmpg123 流式解码，输出固定为16位
+    class Mpg123Decoder : public AudioDecoder
+    {
+    public:
+        ~Mpg123Decoder() override
+        {
+            if (mHandle)
+            {
+                mpg123_close(mHandle);
+                mpg123_delete(mHandle);
+            }
+        }
+
+        bool open(const std::string& path)
+        {
+            static std::once_flag initialized;
+            std::call_once(initialized, []() { mpg123_init(); });
+
+            int error = MPG123_OK;
+            mHandle = mpg123_new(nullptr, &error);
+            if (!mHandle || mpg123_open(mHandle, path.c_str()) != MPG123_OK)
+            {
+                return false;
+            }
+            long rate = 0;
+            int channels = 0;
+            int encoding = 0;
+            if (mpg123_getformat(mHandle, &rate, &channels, &encoding) != MPG123_OK)
+            {
+                return false;
+            }
+            // 固定输出格式，避免流中途换格式
+            mpg123_format_none(mHandle);
+            if (mpg123_format(mHandle, rate, channels, MPG123_ENC_SIGNED_16) != MPG123_OK)
+            {
+                return false;
+            }
+            mSampleRate = static_cast<int>(rate);
+            mChannels = channels;
+            return true;
+        }
+
+        int getSampleRate() const override { return mSampleRate; }
+        int getChannels() const override { return mChannels; }
+
+        size_t read(int16_t* out, size_t frames) override
+        {
+            const size_t frameBytes = static_cast<size_t>(mChannels) * sizeof(int16_t);
+            size_t total = 0;
+            while (total < frames)
+            {
+                size_t done = 0;
+                const int result = mpg123_read(mHandle, reinterpret_cast<unsigned char*>(out + total * mChannels),
+                                               (frames - total) * frameBytes, &done);
+                total += done / frameBytes;
+                if (result == MPG123_NEW_FORMAT)
+                {
+                    continue;
+                }
+                if (result != MPG123_OK || done == 0)
+                {
+                    break;
+                }
+            }
+            return total;
+        }
+
+        bool rewind() override
+        {
+            return mpg123_seek(mHandle, 0, SEEK_SET) >= 0;
+        }
+
+    private:
+        mpg123_handle* mHandle = nullptr;
+        int mSampleRate = 0;
+        int mChannels = 0;
+    };
+#endif
+
+#ifdef SNAKE_HAVE_ALSA
+    class AlsaAudioOutput : public AudioOutput
+    {
+    public:
+        ~AlsaAudioOutput() override
+        {
+            close();
+        }
+
+        bool open(const AudioFormat& format) override
+        {
+            if (snd_pcm_open(&mPcm, "default", SND_PCM_STREAM_PLAYBACK, 0) < 0)
+            {
+                mPcm = nullptr;
+                return false;
+            }
+            // 100ms的设备缓冲，停止音乐时最多还会听到这么长
+            if (snd_pcm_set_params(mPcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED,
+                                   format.channels, format.sampleRate, 1, 100000) < 0)
+            {
+                close();
+                return false;
+            }
+            mChannels = format.channels;
+            return true;
+        }
+
+        bool write(const int16_t* samples, size_t frames) override
+        {
+            while (frames > 0)
+            {
+                snd_pcm_sframes_t written = snd_pcm_writei(mPcm, samples, frames);
+                if (written < 0)
+                {
+                    // 欠载后恢复，恢复不了就放弃这个设备
+                    if (snd_pcm_recover(mPcm, static_cast<int>(written), 1) < 0)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                samples += written * mChannels;
+                frames -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        void close() override
+        {
+            if (mPcm)
+            {
+                snd_pcm_drop(mPcm);
+                snd_pcm_close(mPcm);
+                mPcm = nullptr;
+            }
+        }
+
+        const char* getName() const override { return "alsa"; }
+
+    private:
+        snd_pcm_t* mPcm = nullptr;
+        int mChannels = 2;
+    };
+#endif
+}
+
+std::unique_ptr<AudioDecoder> AudioDecoder::open(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        return nullptr;
+    }
+    unsigned char header[12] = {0};
+    const size_t length = std::fread(header, 1, sizeof(header), file);
+    std::fclose(file);
+
+    if (length == sizeof(header) && std::memcmp(header, "RIFF", 4) == 0 && std::memcmp(header + 8, "WAVE", 4) == 0)
+    {
+        std::unique_ptr<WavDecoder> decoder(new WavDecoder());
+        if (decoder->open(path))
+        {
+            return decoder;
+        }
+        return nullptr;
+    }
+#ifdef SNAKE_HAVE_MPG123
+    // ID3标签或MPEG帧同步字
+    if (length >= 3 && (std::memcmp(header, "ID3", 3) == 0 || (header[0] == 0xFF && (header[1] & 0xE0) == 0xE0)))
+    {
+        std::unique_ptr<Mpg123Decoder> decoder(new Mpg123Decoder());
+        if (decoder->open(path))
+        {
+            return decoder;
+        }
+    }
+#endif
+    return nullptr;
+}
+
+bool AudioDecoder::isSupported(const std::string& path)
+{
+#ifdef SNAKE_HAVE_MPG123
+    if (hasExtension(path, ".mp3"))
+    {
+        return true;
+    }
+#endif
+    return hasExtension(path, ".wav");
+}
+
+NullAudioOutput::NullAudioOutput(bool realtime)
+    : mRealtime(realtime)
+{
+}
+
+bool NullAudioOutput::open(const AudioFormat& format)
+{
+    mFormat = format;
+    mWrittenFrames = 0;
+    mStart = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool NullAudioOutput::write(const int16_t* samples, size_t frames)
+{
+    (void)samples;
+    mWrittenFrames += frames;
+    if (mRealtime)
+    {
+        // 按已写出的时长等待，和声卡一样给混音线程定节奏
+        const auto due = mStart + std::chrono::microseconds(mWrittenFrames * 1000000 / mFormat.sampleRate);
+        std::this_thread::sleep_until(due);
+    }
+    return true;
+}
+
+void NullAudioOutput::close()
+{
+}
+
+WavFileAudioOutput::WavFileAudioOutput(const std::string& path, bool realtime)
+    : mPath(path)
+    , mPacer(realtime)
+{
+}
+
+WavFileAudioOutput::~WavFileAudioOutput()
+{
+    close();
+}
+
+bool WavFileAudioOutput::open(const AudioFormat& format)
+{
+    close();
+    mFile = std::fopen(mPath.c_str(), "wb");
+    if (!mFile)
+    {
+        return false;
+    }
+    mFormat = format;
+    mDataBytes = 0;
+    // 长度先写0，close 时补上
+    std::fwrite("RIFF", 1, 4, mFile);
+    writeLe32(mFile, 0);
+    std::fwrite("WAVEfmt ", 1, 8, mFile);
+    writeLe32(mFile, 16);
+    writeLe16(mFile, 1);
+    writeLe16(mFile, static_cast<uint16_t>(format.channels));
+    writeLe32(mFile, static_cast<uint32_t>(format.sampleRate));
+    writeLe32(mFile, static_cast<uint32_t>(format.sampleRate * format.channels * 2));
+    writeLe16(mFile, static_cast<uint16_t>(format.channels * 2));
+    writeLe16(mFile, 16);
+    std::fwrite("data", 1, 4, mFile);
+    writeLe32(mFile, 0);
+    return mPacer.open(format);
+}
+
+bool WavFileAudioOutput::write(const int16_t* samples, size_t frames)
+{
+    if (!mFile)
+    {
+        return false;
+    }
+    // WAV为小端，这里假定运行在小端机器上
+    const size_t samplesCount = frames * mFormat.channels;
+    if (std::fwrite(samples, sizeof(int16_t), samplesCount, mFile) != samplesCount)
+    {
+        return false;
+    }
+    mDataBytes += samplesCount * sizeof(int16_t);
+    return mPacer.write(samples, frames);
+}
+
+void WavFileAudioOutput::close()
+{
+    if (!mFile)
+    {
+        return;
+    }
+    std::fseek(mFile, 4, SEEK_SET);
+    writeLe32(mFile, static_cast<uint32_t>(36 + mDataBytes));
+    std::fseek(mFile, 40, SEEK_SET);
+    writeLe32(mFile, static_cast<uint32_t>(mDataBytes));
+    std::fclose(mFile);
+    mFile = nullptr;
+}
+
+std::unique_ptr<AudioOutput> createAudioOutput()
+{
+    const char* choice = std::getenv("SNAKE_AUDIO_OUTPUT");
+    if (choice && std::strncmp(choice, "wav:", 4) == 0 && choice[4] != '\0')
+    {
+        return std::unique_ptr<AudioOutput>(new WavFileAudioOutput(choice + 4));
+    }
+    if (choice && std::strcmp(choice, "null") == 0)
+    {
+        return std::unique_ptr<AudioOutput>(new NullAudioOutput());
+    }
+#ifdef SNAKE_HAVE_ALSA
+    return std::unique_ptr<AudioOutput>(new AlsaAudioOutput());
+#else
+    return std::unique_ptr<AudioOutput>(new NullAudioOutput());
+#endif
+}
+
+// 一个正在播放的声音，带线性插值重采样和声道转换
+struct AudioEngine::Voice
+{
+    std::unique_ptr<AudioDecoder> decoder;
+    bool music = false;
+    bool loop = false;
+    float volume = 1.0f;
+    int channels = 1;
+    double step = 1.0;                  // 每输出一帧前进的源帧数
+    double position = 0.0;              // 在 source 中的读位置
+    std::vector<int16_t> source;
+    size_t sourceFrames = 0;
+
+    // 保证 position 和下一帧都在 source 中，解码结束且不循环时返回false
+    bool ensure()
+    {
+        while (position + 1.0 >= static_cast<double>(sourceFrames))
+        {
+            // 上一块的最后一帧留作插值的起点
+            size_t keep = 0;
+            if (sourceFrames > 0)
+            {
+                std::copy(source.begin() + (sourceFrames - 1) * channels, source.begin() + sourceFrames * channels,
+                          source.begin());
+                position -= static_cast<double>(sourceFrames - 1);
+                keep = 1;
+            }
+            size_t frames = decoder->read(source.data() + keep * channels, kDecodeFrames);
+            if (frames == 0 && loop && decoder->rewind())
+            {
+                frames = decoder->read(source.data() + keep * channels, kDecodeFrames);
+            }
+            if (frames == 0)
+            {
+                return false;
+            }
+            sourceFrames = keep + frames;
+        }
+        return true;
+    }
+
+    float sample(size_t frame, int outChannel, int outChannels) const
+    {
+        const int16_t* in = source.data() + frame * channels;
+        if (channels == 1)
+        {
+            return in[0];
+        }
+        if (outChannels == 1)
+        {
+            return (static_cast<float>(in[0]) + in[1]) * 0.5f;
+        }
+        return in[std::min(outChannel, channels - 1)];
+    }
+};
+
+AudioEngine::AudioEngine(std::unique_ptr<AudioOutput> output, AudioFormat format)
+    : mOutput(std::move(output))
+    , mFormat(format)
+{
+    mThread = std::thread(&AudioEngine::run, this);
+}
+
+AudioEngine::~AudioEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_one();
+    mThread.join();
+}
+
+bool AudioEngine::playMusic(const std::string& path, bool loop, float volume)
+{
+    if (!AudioDecoder::isSupported(path))
+    {
+        return false;
+    }
+    Command command;
+    command.type = CommandType::PlayMusic;
+    command.path = path;
+    command.loop = loop;
+    command.volume = volume;
+    mMusicPlaying = true;
+    submit(std::move(command));
+    return true;
+}
+
+void AudioEngine::stopMusic()
+{
+    Command command;
+    command.type = CommandType::StopMusic;
+    mMusicPlaying = false;
+    submit(std::move(command));
+}
+
+bool AudioEngine::playEffect(const std::string& path, float volume)
+{
+    if (!AudioDecoder::isSupported(path))
+    {
+        return false;
+    }
+    Command command;
+    command.type = CommandType::PlayEffect;
+    command.path = path;
+    command.volume = volume;
+    submit(std::move(command));
+    return true;
+}
+
+void AudioEngine::stopAll()
+{
+    Command command;
+    command.type = CommandType::StopAll;
+    mMusicPlaying = false;
+    submit(std::move(command));
+}
+
+bool AudioEngine::isMusicPlaying() const
+{
+    return mMusicPlaying;
+}
+
+const char* AudioEngine::getOutputName() const
+{
+    return mOutput->getName();
+}
+
+uint64_t AudioEngine::getMixedFrames() const
+{
+    return mMixedFrames;
+}
+
+double AudioEngine::getLastCommandLatencyMs() const
+{
+    return mLastLatencyUs / 1000.0;
+}
+
+void AudioEngine::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this]() { return mCommands.empty() && !mActive; });
+}
+
+void AudioEngine::submit(Command command)
+{
+    command.submitted = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCommands.push_back(std::move(command));
+    }
+    mWake.notify_one();
+}
+
+void AudioEngine::run()
+{
+    std::vector<int32_t> accumulator(kBlockFrames * mFormat.channels);
+    std::vector<int16_t> block(kBlockFrames * mFormat.channels);
+    while (true)
+    {
+        std::deque<Command> commands;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStop || !mCommands.empty() || !mVoices.empty(); });
+            if (mStop)
+            {
+                break;
+            }
+            commands.swap(mCommands);
+            if (!commands.empty())
+            {
+                mActive = true;
+            }
+        }
+        applyCommands(commands);
+
+        if (!mVoices.empty() && !mOutputOpen)
+        {
+            mOutputOpen = mOutput->open(mFormat);
+            if (!mOutputOpen)
+            {
+                // 没有可用的设备，丢掉这次的声音
+                mVoices.clear();
+                mMusicPlaying = false;
+            }
+        }
+        if (!mVoices.empty())
+        {
+            mixBlock(accumulator, block);
+            if (!mOutput->write(block.data(), kBlockFrames))
+            {
+                mOutput->close();
+                mOutputOpen = false;
+                mVoices.clear();
+                mMusicPlaying = false;
+            }
+            mMixedFrames += kBlockFrames;
+        }
+        if (mVoices.empty())
+        {
+            // 没有声音时关闭输出，设备不必一直播放静音
+            if (mOutputOpen)
+            {
+                mOutput->close();
+                mOutputOpen = false;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mActive = false;
+            }
+            mIdle.notify_all();
+        }
+    }
+    mVoices.clear();
+    if (mOutputOpen)
+    {
+        mOutput->close();
+        mOutputOpen = false;
+    }
+}
+
+void AudioEngine::applyCommands(std::deque<Command>& commands)
+{
+    for (Command& command : commands)
+    {
+        if (command.type == CommandType::StopMusic || command.type == CommandType::PlayMusic)
+        {
+            mVoices.erase(std::remove_if(mVoices.begin(), mVoices.end(),
+                                         [](const std::unique_ptr<Voice>& voice) { return voice->music; }),
+                          mVoices.end());
+        }
+        else if (command.type == CommandType::StopAll)
+        {
+            mVoices.clear();
+        }
+
+        if (command.type == CommandType::PlayMusic || command.type == CommandType::PlayEffect)
+        {
+            std::unique_ptr<Voice> voice(new Voice());
+            voice->decoder = AudioDecoder::open(command.path);
+            if (voice->decoder)
+            {
+                voice->music = command.type == CommandType::PlayMusic;
+                voice->loop = command.loop;
+                voice->volume = command.volume;
+                voice->channels = voice->decoder->getChannels();
+                voice->step = static_cast<double>(voice->decoder->getSampleRate()) / mFormat.sampleRate;
+                voice->source.resize((kDecodeFrames + 1) * voice->channels);
+                mVoices.push_back(std::move(voice));
+            }
+            else if (command.type == CommandType::PlayMusic)
+            {
+                mMusicPlaying = false;
+            }
+        }
+        mLastLatencyUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - command.submitted).count();
+    }
+}
+
+void AudioEngine::mixBlock(std::vector<int32_t>& accumulator, std::vector<int16_t>& block)
+{
+    const int outChannels = mFormat.channels;
+    std::fill(accumulator.begin(), accumulator.end(), 0);
+    for (std::unique_ptr<Voice>& voice : mVoices)
+    {
+        for (size_t i = 0; i < kBlockFrames; i++)
+        {
+            if (!voice->ensure())
+            {
+                voice->decoder.reset();
+                break;
+            }
+            const size_t frame = static_cast<size_t>(voice->position);
+            const float fraction = static_cast<float>(voice->position - frame);
+            for (int channel = 0; channel < outChannels; channel++)
+            {
+                const float a = voice->sample(frame, channel, outChannels);
+                const float b = voice->sample(frame + 1, channel, outChannels);
+                accumulator[i * outChannels + channel] += static_cast<int32_t>((a + (b - a) * fraction) * voice->volume);
+            }
+            voice->position += voice->step;
+        }
+    }
+    // 播完的声部在这里移除
+    bool musicEnded = false;
+    mVoices.erase(std::remove_if(mVoices.begin(), mVoices.end(),
+                                 [&musicEnded](const std::unique_ptr<Voice>& voice)
+                                 {
+                                     if (voice->decoder)
+                                     {
+                                         return false;
+                                     }
+                                     musicEnded = musicEnded || voice->music;
+                                     return true;
+                                 }),
+                  mVoices.end());
+    if (musicEnded)
+    {
+        mMusicPlaying = false;
+    }
+    for (size_t i = 0; i < accumulator.size(); i++)
+    {
+        block[i] = static_cast<int16_t>(std::max(-32768, std::min(32767, accumulator[i])));
+    }
+}
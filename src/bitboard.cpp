@@ -0,0 +1,208 @@
+#include <algorithm>
+#include "bitboard.h"
+
+namespace
+{
+    uint64_t reverseBits(uint64_t x)
+    {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        return __builtin_bswap64(x);
+    }
+
+    // 把种子沿着可通行位的连续区间向高位扩展：
+    // free + seed 的进位会从最低的种子一路穿过这段连续的1
+    uint64_t fillUpward(uint64_t seed, uint64_t free)
+    {
+        return (((free + seed) ^ free) & free) | seed;
+    }
+
+    // 在一行内把种子扩展到它所在的整段可通行区间，跨字时通过进位衔接
+    void fillRow(uint64_t* region, const uint64_t* free, int words)
+    {
+        uint64_t carry = 0;
+        for (int w = 0; w < words; w++)
+        {
+            uint64_t seed = region[w] | (carry & free[w] & 1ULL);
+            region[w] = fillUpward(seed, free[w]);
+            carry = region[w] >> 63;
+        }
+
+        // 向低位方向：反转位序后复用同样的加法技巧
+        carry = 0;
+        for (int w = words - 1; w >= 0; w--)
+        {
+            uint64_t reversedFree = reverseBits(free[w]);
+            uint64_t seed = reverseBits(region[w]) | (carry & reversedFree & 1ULL);
+            uint64_t filled = fillUpward(seed, reversedFree);
+            region[w] = reverseBits(filled);
+            carry = filled >> 63;
+        }
+    }
+}
+
+Bitboard::Bitboard() : mWidth(0), mHeight(0), mWordsPerRow(0)
+{
+}
+
+Bitboard::Bitboard(int width, int height)
+{
+    resize(width, height);
+}
+
+void Bitboard::resize(int width, int height)
+{
+    mWidth = width > 0 ? width : 0;
+    mHeight = height > 0 ? height : 0;
+    mWordsPerRow = (mWidth + 63) / 64;
+    mWords.assign(static_cast<size_t>(mWordsPerRow) * mHeight, 0);
+}
+
+void Bitboard::clear()
+{
+    std::fill(mWords.begin(), mWords.end(), 0);
+}
+
+void Bitboard::fill()
+{
+    std::fill(mWords.begin(), mWords.end(), ~0ULL);
+    const uint64_t mask = tailMask();
+    for (int y = 0; y < mHeight && mWordsPerRow > 0; y++)
+    {
+        row(y)[mWordsPerRow - 1] &= mask;
+    }
+}
+
+int Bitboard::getWidth() const
+{
+    return mWidth;
+}
+
+int Bitboard::getHeight() const
+{
+    return mHeight;
+}
+
+int Bitboard::getWordsPerRow() const
+{
+    return mWordsPerRow;
+}
+
+bool Bitboard::test(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return false;
+    }
+    return (row(y)[x >> 6] >> (x & 63)) & 1ULL;
+}
+
+void Bitboard::set(int x, int y)
+{
+    if (x >= 0 && y >= 0 && x < mWidth && y < mHeight)
+    {
+        row(y)[x >> 6] |= 1ULL << (x & 63);
+    }
+}
+
+void Bitboard::reset(int x, int y)
+{
+    if (x >= 0 && y >= 0 && x < mWidth && y < mHeight)
+    {
+        row(y)[x >> 6] &= ~(1ULL << (x & 63));
+    }
+}
+
+uint64_t* Bitboard::row(int y)
+{
+    return &mWords[static_cast<size_t>(y) * mWordsPerRow];
+}
+
+const uint64_t* Bitboard::row(int y) const
+{
+    return &mWords[static_cast<size_t>(y) * mWordsPerRow];
+}
+
+int Bitboard::count() const
+{
+    int total = 0;
+    for (uint64_t word : mWords)
+    {
+        total += __builtin_popcountll(word);
+    }
+    return total;
+}
+
+int Bitboard::countNeighbours(int x, int y) const
+{
+    return test(x, y - 1) + test(x, y + 1) + test(x - 1, y) + test(x + 1, y);
+}
+
+int Bitboard::floodFill(int x, int y, Bitboard& region) const
+{
+    region.resize(mWidth, mHeight);
+    if (!test(x, y))
+    {
+        return 0;
+    }
+    region.set(x, y);
+
+    // 交替自上而下、自下而上扫描：每行先接收相邻行扩散下来的位，再在行内扩展整段区间，
+    // 直到一次完整的往返都没有新增格子为止
+    std::vector<uint64_t> before(mWordsPerRow);
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const bool downward = (pass == 0);
+            for (int i = 0; i < mHeight; i++)
+            {
+                const int ry = downward ? i : mHeight - 1 - i;
+                const int fromY = downward ? ry - 1 : ry + 1;
+                uint64_t* target = region.row(ry);
+                const uint64_t* free = row(ry);
+
+                bool hasBits = false;
+                for (int w = 0; w < mWordsPerRow; w++)
+                {
+                    before[w] = target[w];
+                    if (fromY >= 0 && fromY < mHeight)
+                    {
+                        target[w] |= region.row(fromY)[w] & free[w];
+                    }
+                    hasBits = hasBits || target[w] != 0;
+                }
+                if (!hasBits)
+                {
+                    continue;
+                }
+
+                fillRow(target, free, mWordsPerRow);
+                for (int w = 0; w < mWordsPerRow; w++)
+                {
+                    if (target[w] != before[w])
+                    {
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    return region.count();
+}
+
+int Bitboard::countReachable(int x, int y) const
+{
+    Bitboard region;
+    return floodFill(x, y, region);
+}
+
+uint64_t Bitboard::tailMask() const
+{
+    const int used = mWidth & 63;
+    return used == 0 ? ~0ULL : ((1ULL << used) - 1);
+}
@@ -0,0 +1,176 @@
+#include "frame_stats.h"
+#include <algorithm>
+
+std::atomic<uint64_t> gAllocationCount{0};
+
+FrameStats::FrameStats()
+    : mCurrent()
+    , mWindow()
+{
+    mScratch.reserve(kWindow);
+}
+
+uint64_t FrameStats::getAllocationCount()
+{
+    return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+uint32_t FrameStats::toMicros(Clock::duration duration)
+{
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (us <= 0)
+    {
+        return 0;
+    }
+    return us > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(us);
+}
+
+void FrameStats::beginFrame(int targetIntervalMs)
+{
+    const Clock::time_point now = Clock::now();
+    mCurrent = FrameSample();
+    if (mHasLastFrame)
+    {
+        mCurrent.intervalUs = toMicros(now - mLastFrameStart);
+        if (targetIntervalMs > 0)
+        {
+            // 间隔超过目标的1.5倍时，按四舍五入算出中间错过了几帧
+            const uint32_t targetUs = static_cast<uint32_t>(targetIntervalMs) * 1000;
+            if (mCurrent.intervalUs * 2 > targetUs * 3)
+            {
+                mPendingDropped += (mCurrent.intervalUs + targetUs / 2) / targetUs - 1;
+            }
+        }
+    }
+    mLastFrameStart = now;
+    mHasLastFrame = true;
+    mFrameStart = now;
+    mPhaseStart = now;
+    mIdle = Clock::duration::zero();
+    mAllocationsAtStart = getAllocationCount();
+}
+
+void FrameStats::endPhase(FramePhase phase)
+{
+    const Clock::time_point now = Clock::now();
+    mCurrent.phaseUs[static_cast<size_t>(phase)] += toMicros(now - mPhaseStart);
+    mPhaseStart = now;
+}
+
+void FrameStats::idle()
+{
+    const Clock::time_point now = Clock::now();
+    mIdle += now - mPhaseStart;
+    mPhaseStart = now;
+}
+
+void FrameStats::addPhaseTime(FramePhase phase, Clock::duration duration)
+{
+    mCurrent.phaseUs[static_cast<size_t>(phase)] += toMicros(duration);
+}
+
+void FrameStats::addDropped(int frames)
+{
+    if (frames > 0)
+    {
+        mPendingDropped += static_cast<uint32_t>(frames);
+    }
+}
+
+void FrameStats::endFrame()
+{
+    mCurrent.frameUs = toMicros(Clock::now() - mFrameStart - mIdle);
+    mCurrent.allocations = static_cast<uint32_t>(getAllocationCount() - mAllocationsAtStart);
+    mCurrent.dropped = mPendingDropped;
+    if (mRing.push(mCurrent))
+    {
+        mPendingDropped = 0;
+    }
+    else
+    {
+        // 丢帧数留到下一个能写进去的样本里，不会因为面板关闭而丢失
+        mOverflowed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameStatsSummary::Percentiles FrameStats::percentiles(std::vector<uint32_t>& values)
+{
+    FrameStatsSummary::Percentiles result;
+    if (values.empty())
+    {
+        return result;
+    }
+    // 最近邻秩，窗口只有一百多个值，nth_element 足够快
+    const size_t p50 = (values.size() - 1) / 2;
+    const size_t p99 = (values.size() * 99 + 99) / 100 - 1;
+    std::nth_element(values.begin(), values.begin() + p50, values.end());
+    result.p50 = values[p50] / 1000.0;
+    std::nth_element(values.begin(), values.begin() + p99, values.end());
+    result.p99 = values[p99] / 1000.0;
+    return result;
+}
+
+void FrameStats::restartWindow()
+{
+    // 面板关闭期间环里积压的是最早的样本，直接丢掉，只保留累计丢帧数
+    FrameSample sample;
+    while (mRing.pop(sample))
+    {
+        mTotalDropped += sample.dropped;
+    }
+    mWindowCount = 0;
+    mWindowNext = 0;
+    mSummary = FrameStatsSummary();
+}
+
+const FrameStatsSummary& FrameStats::summarize()
+{
+    FrameSample sample;
+    while (mRing.pop(sample))
+    {
+        mTotalDropped += sample.dropped;
+        mWindow[mWindowNext] = sample;
+        mWindowNext = (mWindowNext + 1) % kWindow;
+        if (mWindowCount < kWindow)
+        {
+            mWindowCount++;
+        }
+    }
+
+    mSummary.samples = mWindowCount;
+    mSummary.dropped = mTotalDropped;
+    mSummary.overflowed = mOverflowed.load(std::memory_order_relaxed);
+    if (mWindowCount == 0)
+    {
+        return mSummary;
+    }
+
+    for (size_t phase = 0; phase < static_cast<size_t>(FramePhase::Count); phase++)
+    {
+        mScratch.clear();
+        for (size_t i = 0; i < mWindowCount; i++)
+        {
+            mScratch.push_back(mWindow[i].phaseUs[phase]);
+        }
+        mSummary.phases[phase] = percentiles(mScratch);
+    }
+
+    mScratch.clear();
+    uint64_t intervalUs = 0;
+    size_t intervals = 0;
+    uint64_t allocations = 0;
+    for (size_t i = 0; i < mWindowCount; i++)
+    {
+        mScratch.push_back(mWindow[i].frameUs);
+        if (mWindow[i].intervalUs > 0)
+        {
+            intervalUs += mWindow[i].intervalUs;
+            intervals++;
+        }
+        allocations += mWindow[i].allocations;
+    }
+    mSummary.frame = percentiles(mScratch);
+    mSummary.fps = intervalUs > 0 ? intervals * 1000000.0 / intervalUs : 0.0;
+    mSummary.allocationsPerFrame = static_cast<double>(allocations) / mWindowCount;
+    return mSummary;
+}
@@ -1,6 +1,10 @@
 #include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <cmath>
+#include <ctime>
 
 // For terminal delay
 #include <chrono>
@@ -13,6 +17,15 @@
 #include "game.h"
 #include "map.h"
 #include "ai.h"
+#include "arena.h"
+#include "save_format.h"
+#include "save_worker.h"
+#include "leaderboard_store.h"
+#include "profile_store.h"
+#include "level_preloader.h"
+#include "story_index.h"
+#include "audio_engine.h"
+#include "typewriter.h"
 
 Game::Game()
 {
@@ -21,6 +34,9 @@ Game::Game()
     
     // 获取屏幕尺寸
     getmaxyx(stdscr, this->mScreenHeight, this->mScreenWidth);
+    this->mPtrSaveWorker.reset(new SaveWorker());
+    this->mPtrLevelPreloader.reset(new LevelPreloader());
+    this->mLastAutosaveTime = std::chrono::steady_clock::now();
     this->mGameBoardWidth = this->mScreenWidth - this->mInstructionWidth;
     this->mGameBoardHeight = this->mScreenHeight - this->mInformationHeight;
 
@@ -30,6 +46,11 @@ Game::Game()
 
     // Initialize the leader board to be all zeros
     this->mLeaderBoard.assign(this->mNumLeaders, 0);
+    this->mPtrLeaderboard.reset(new LeaderboardStore(this->mLeaderboardDirectory));
+    if (this->mPtrLeaderboard->open())
+    {
+        this->migrateLegacyLeaderBoard();
+    }
     
     // 初始化关卡状态列表
     this->mLevelStatus.assign(this->mMaxLevel, LevelStatus::Locked);
@@ -38,6 +59,7 @@ Game::Game()
     // 第四五关也解锁，用于测试，待修改
     this->mLevelStatus[3] = LevelStatus::Unlocked;
     this->mLevelStatus[4] = LevelStatus::Unlocked;
+    this->migrateLegacyProfile();
     // 加载已保存的关卡进度
     this->loadLevelProgress();
     
@@ -270,10 +292,92 @@ void Game::renderInstructionBoard() const
         }
         mvwprintw(this->mWindows[2], row++, 2, "%s: %d", itemName.c_str(), count);
     }
+    // 侧边栏被清空过，面板打开时一起重画
+    if (mShowPerfHud) {
+        this->renderPerfHud();
+    }
     // 最后一行显示保存提示
     wrefresh(this->mWindows[2]);
 }
 
+void Game::togglePerfHud()
+{
+    mShowPerfHud = !mShowPerfHud;
+    if (mShowPerfHud) {
+        mFrameStats.restartWindow();
+    }
+    this->renderPerfHud();
+    mLastPerfHudDraw = std::chrono::steady_clock::now();
+}
+
+void Game::updatePerfHud()
+{
+    if (!mShowPerfHud) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - mLastPerfHudDraw < std::chrono::milliseconds(250)) {
+        return;
+    }
+    mLastPerfHudDraw = now;
+    this->renderPerfHud();
+}
+
+void Game::renderPerfHud() const
+{
+    // 道具列表下方、排行榜上方的9行
+    const int firstRow = 19;
+    const int rowCount = 9;
+    WINDOW* win = this->mWindows[2];
+    const int endRow = std::min(firstRow + rowCount, getmaxy(win) - 1);
+    const int textWidth = this->mInstructionWidth - 2;
+    char line[32];
+    int row = firstRow;
+    auto print = [&](const char* text) {
+        if (row < endRow) {
+            mvwprintw(win, row, 1, "%-*.*s", textWidth, textWidth, text);
+        }
+        row++;
+    };
+
+    if (!mShowPerfHud) {
+        while (row < endRow) {
+            print("");
+        }
+        wrefresh(win);
+        return;
+    }
+
+    // 面板只在这里取样本，summarize 会顺带清空环形缓冲区
+    const FrameStatsSummary& stats = const_cast<Game*>(this)->mFrameStats.summarize();
+    const char* phaseNames[] = {"in", "ai", "sim", "spw", "rnd"};
+    print("Perf p50/p99 ms");
+    for (size_t i = 0; i < static_cast<size_t>(FramePhase::Count); i++) {
+        std::snprintf(line, sizeof(line), "%-3s %5.2f/%5.2f", phaseNames[i], stats.phases[i].p50, stats.phases[i].p99);
+        print(line);
+    }
+    std::snprintf(line, sizeof(line), "frm %5.2f/%5.2f", stats.frame.p50, stats.frame.p99);
+    print(line);
+    std::snprintf(line, sizeof(line), "fps %4.1f drp %llu", stats.fps, static_cast<unsigned long long>(stats.dropped));
+    print(line);
+    std::snprintf(line, sizeof(line), "alloc/f %.1f", stats.allocationsPerFrame);
+    print(line);
+    wrefresh(win);
+}
+
+void Game::appendPerfLog(const char* text) const
+{
+    const char* path = std::getenv("SNAKE_PERF_LOG");
+    if (!path) {
+        return;
+    }
+    std::FILE* file = std::fopen(path, "a");
+    if (!file) {
+        return;
+    }
+    std::fprintf(file, "%s\n", text);
+    std::fclose(file);
+}
 
 void Game::renderLeaderBoard() const
 {
@@ -579,6 +683,8 @@ bool Game::selectMap()
     // 创建地图
     mPtrMap = std::make_unique<Map>(mGameBoardWidth, mGameBoardHeight);
     
+    mCurrentMapName = menuItems[index];
+
     // 如果选择默认地图
     if (index == 0) {
         mPtrMap->loadDefaultMap();
@@ -651,6 +757,8 @@ void Game::initializeGame()
 {
     // 先选择地图
     this->selectMap();
+    this->mRoundStartTime = std::chrono::steady_clock::now();
+    this->readLeaderBoard();
     
     // 然后创建蛇
     this->mPtrSnake.reset(new Snake(this->mGameBoardWidth, this->mGameBoardHeight, this->mInitialSnakeLength));
@@ -662,7 +770,7 @@ void Game::initializeGame()
     bool snakeInitialized = false;
     
     // 首先尝试最理想的空间要求 (6格)
-    std::vector<std::pair<SnakeBody, InitialDirection>> validPositions =
+    const auto& validPositions =
         this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 6);
     
     if (!validPositions.empty()) {
@@ -674,11 +782,11 @@ void Game::initializeGame()
     
     // 如果没有找到理想的位置，尝试降低空间要求（3格）
     if (!snakeInitialized) {
-        validPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 3);
+        const auto& fallbackPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 3);
         
-        if (!validPositions.empty()) {
-            int idx = std::rand() % validPositions.size();
-            auto [startPos, direction] = validPositions[idx];
+        if (!fallbackPositions.empty()) {
+            int idx = std::rand() % fallbackPositions.size();
+            auto [startPos, direction] = fallbackPositions[idx];
             this->mPtrSnake->initializeSnake(startPos.getX(), startPos.getY(), direction);
             snakeInitialized = true;
         }
@@ -686,11 +794,11 @@ void Game::initializeGame()
     
     // 如果仍然没有找到合适位置，再降低要求（2格）
     if (!snakeInitialized) {
-        validPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 2);
+        const auto& fallbackPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 2);
         
-        if (!validPositions.empty()) {
-            int idx = std::rand() % validPositions.size();
-            auto [startPos, direction] = validPositions[idx];
+        if (!fallbackPositions.empty()) {
+            int idx = std::rand() % fallbackPositions.size();
+            auto [startPos, direction] = fallbackPositions[idx];
             this->mPtrSnake->initializeSnake(startPos.getX(), startPos.getY(), direction);
             snakeInitialized = true;
         }
@@ -698,11 +806,11 @@ void Game::initializeGame()
     
     // 如果实在找不到任何合适位置，使用最小要求（1格）
     if (!snakeInitialized) {
-        validPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 1);
+        const auto& fallbackPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 1);
         
-        if (!validPositions.empty()) {
-            int idx = std::rand() % validPositions.size();
-            auto [startPos, direction] = validPositions[idx];
+        if (!fallbackPositions.empty()) {
+            int idx = std::rand() % fallbackPositions.size();
+            auto [startPos, direction] = fallbackPositions[idx];
             this->mPtrSnake->initializeSnake(startPos.getX(), startPos.getY(), direction);
             snakeInitialized = true;
         }
@@ -1213,6 +1321,9 @@ void Game::renderSnake() const
 
 void Game::controlSnake() const
 {
+    // 每帧检查一次后台存档的结果
+    const_cast<Game*>(this)->updateSaveToast();
+
     // 设置为非阻塞模式
     nodelay(stdscr, TRUE);
     
@@ -1228,16 +1339,15 @@ void Game::controlSnake() const
     if(key == 27) {  // 27是ESC键的ASCII值
         return;
     }
-    // 处理存档功能
+    // F3：显示或隐藏性能面板
+    if (key == KEY_F(3)) {
+        const_cast<Game*>(this)->togglePerfHud();
+        return;
+    }
+    // 处理存档功能：提交给后台线程，完成后在信息栏提示，不暂停游戏
     if (key == 'f' || key == 'F') {
         const_cast<Game*>(this)->saveGame();
-        // 显示保存成功信息
-        WINDOW* saveWin = newwin(3, 30, mGameBoardHeight/2 + mInformationHeight, mGameBoardWidth/2 - 15);
-        box(saveWin, 0, 0);
-        mvwprintw(saveWin, 1, 1, "Game Saved!");
-        wrefresh(saveWin);
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        delwin(saveWin);
+        const_cast<Game*>(this)->showSaveToast("Saving...", 2000);
         return;
     }
     
@@ -1393,9 +1503,13 @@ void Game::runGame()
         delwin(countdownWin);
     }
     
+    int frameDelay = 0;    // 上一帧的目标间隔，用于判断丢帧
     while (true)
     {
+        mFrameStats.beginFrame(frameDelay);
         this->controlSnake();
+        this->maybeAutosave();
+        mFrameStats.endPhase(FramePhase::Input);
         werase(this->mWindows[1]);
         box(this->mWindows[1], 0, 0);
         
@@ -1404,6 +1518,7 @@ void Game::runGame()
         
         // 渲染地图
         this->renderMap();
+        mFrameStats.endPhase(FramePhase::Render);
         
         bool eatFood = this->mPtrSnake->moveFoward();
         bool eatPoison = this->mPtrSnake->touchPoison();
@@ -1440,7 +1555,9 @@ void Game::runGame()
                 }
             }
         }
+        mFrameStats.endPhase(FramePhase::Sim);
         this->renderSnake();
+        mFrameStats.endPhase(FramePhase::Render);
         if (eatFood == true)
         {
             // 处理普通食物效果
@@ -1468,6 +1585,7 @@ void Game::runGame()
             } else {
                 mHasRandomItem = false;
             }
+            mFrameStats.endPhase(FramePhase::Spawn);
             if (this->isLevelCompleted())
             {
                 // 如果达到目标分数，关卡通过
@@ -1521,6 +1639,7 @@ void Game::runGame()
             addItem(mCurrentRandomItemType, 1); // 添加到库存
             mHasRandomItem = false; // 随机道具消失
         }
+        mFrameStats.endPhase(FramePhase::Sim);
         this->renderFood();
         this->renderPoison();
         this->renderSpecialFood();
@@ -1528,12 +1647,17 @@ void Game::runGame()
         this->renderRandomItem();
         // 即使在普通模式下，也显示当前为第1关
         this->renderLevel();
+        mFrameStats.endPhase(FramePhase::Render);
 
         // 根据加速状态调整延迟
         int currentDelay = mAccelerating ? mAccelerateDelay : this->mDelay;
         std::this_thread::sleep_for(std::chrono::milliseconds(currentDelay));
+        mFrameStats.idle();
+        frameDelay = currentDelay;
 
         refresh();
+        this->updatePerfHud();
+        mFrameStats.endPhase(FramePhase::Render);
 
         // 检查特殊食物/毒药/道具是否超时消失
         auto now = std::chrono::steady_clock::now();
@@ -1546,6 +1670,8 @@ void Game::runGame()
         if (mHasRandomItem && std::chrono::duration_cast<std::chrono::seconds>(now - mRandomItemSpawnTime).count() > mRandomItemDuration) {
             mHasRandomItem = false;
         }
+        mFrameStats.endPhase(FramePhase::Spawn);
+        mFrameStats.endFrame();
     }
 }
 
@@ -1578,9 +1704,10 @@ void Game::startGame()
                         runTimeAttack();
                     }
                     updateLeaderBoard();
-                    writeLeaderBoard();
                     // 游戏结束时自动保存
                     saveGame();
+                    // 正常结束，不再需要崩溃恢复用的自动存档
+                    clearAutosave();
                     playAgain = renderRestartMenu();
                     break;
                 }
@@ -1599,6 +1726,7 @@ void Game::startGame()
                 while (true) {
                 // 初始化并运行当前关卡
                     this->initializeLevel(mCurrentLevel);
+                    this->autosaveNow(); // 关卡开始时的检查点
                     this->runLevel();
             
                     // 检查是否通过当前关卡
@@ -1606,6 +1734,8 @@ void Game::startGame()
                                             // 标记当前关卡为已完成
                         this->mLevelStatus[mCurrentLevel - 1] = LevelStatus::Completed;
                 
+                        // 叙述播放期间在后台准备下一关
+                        this->preloadLevel(mCurrentLevel + 1);
                         // 显示通关后的文字叙述
                         this->displayLevelCompletion(mCurrentLevel);
                 
@@ -1616,6 +1746,7 @@ void Game::startGame()
                 
                         // 保存关卡进度
                         this->saveLevelProgress();
+                        this->autosaveNow(); // 通关检查点
                 
                         // 显示通关信息
                         WINDOW* levelCompleteWin;
@@ -1709,9 +1840,10 @@ void Game::startGame()
                     } else {
                         // 关卡失败，显示游戏结束信息
                         this->updateLeaderBoard();
-                        this->writeLeaderBoard();
                         // 游戏结束时自动保存
                         this->saveGame();
+                        // 正常结束，不再需要崩溃恢复用的自动存档
+                        clearAutosave();
                         WINDOW * menu;
                         int width = this->mGameBoardWidth * 0.5;
                         int height = this->mGameBoardHeight * 0.5;
@@ -1816,6 +1948,8 @@ void Game::startGame()
                     runBattle();
                     // 游戏结束时自动保存
                     saveGame();
+                    // 正常结束，不再需要崩溃恢复用的自动存档
+                    clearAutosave();
                     // 传入 true，让菜单显示 "Battle Over!"
                     playAgain = renderRestartMenu(true);
                     break;
@@ -1825,6 +1959,13 @@ void Game::startGame()
                     playAgain = false; // 从商店返回后不重新开始游戏
                     break;
                 }
+                case GameMode::Arena: {
+                    initializeArena();
+                    renderBoards();
+                    runArena();
+                    playAgain = renderRestartMenu();
+                    break;
+                }
 
             }
             
@@ -1834,60 +1975,88 @@ void Game::startGame()
     
 }
 
-// https://en.cppreference.com/w/cpp/io/basic_fstream
-bool Game::readLeaderBoard()
+LeaderboardKey Game::currentLeaderboardKey() const
 {
-    std::fstream fhand(this->mRecordBoardFilePath, fhand.binary | fhand.in);
-    if (!fhand.is_open())
+    LeaderboardKey key;
+    key.mode = static_cast<int>(this->mCurrentMode);
+    if (this->mCurrentMode == GameMode::Classic || this->mCurrentMode == GameMode::Timed)
     {
-        return false;
+        key.map = this->mCurrentMapName;
     }
-    int temp;
-    int i = 0;
-    while ((!fhand.eof()) && (i < mNumLeaders))
+    if (this->mCurrentMode == GameMode::Level)
     {
-        fhand.read(reinterpret_cast<char*>(&temp), sizeof(temp));
-        this->mLeaderBoard[i] = temp;
-        i ++;
+        key.level = this->mCurrentLevel;
     }
-    fhand.close();
-    return true;
+    return key;
 }
 
-bool Game::updateLeaderBoard()
+// 旧版 record.dat 只有所有模式混在一起的5个分数，整体迁入经典模式默认地图的榜单
+void Game::migrateLegacyLeaderBoard()
 {
-    bool updated = false;
-    int newScore = this->mPoints;
-    for (int i = 0; i < this->mNumLeaders; i ++)
+    std::fstream fhand(this->mRecordBoardFilePath, fhand.binary | fhand.in);
+    if (!fhand.is_open())
+    {
+        return;
+    }
+    LeaderboardKey key;
+    key.mode = static_cast<int>(GameMode::Classic);
+    key.map = this->mDefaultMapName;
+    std::vector<std::pair<LeaderboardKey, LeaderboardEntry>> entries;
+    int temp;
+    while (static_cast<int>(entries.size()) < this->mNumLeaders &&
+           fhand.read(reinterpret_cast<char*>(&temp), sizeof(temp)))
     {
-        if (this->mLeaderBoard[i] >= this->mPoints)
+        if (temp > 0)
         {
-            continue;
+            LeaderboardEntry entry;
+            entry.score = temp;
+            entries.emplace_back(key, entry);
         }
-        int oldScore = this->mLeaderBoard[i];
-        this->mLeaderBoard[i] = newScore;
-        newScore = oldScore;
-        updated = true;
     }
-    return updated;
+    fhand.close();
+    if (entries.empty() || this->mPtrLeaderboard->insert(entries))
+    {
+        std::rename(this->mRecordBoardFilePath.c_str(), (this->mRecordBoardFilePath + ".migrated").c_str());
+    }
 }
 
-bool Game::writeLeaderBoard()
+bool Game::readLeaderBoard()
 {
-    // trunc: clear the data file
-    std::fstream fhand(this->mRecordBoardFilePath, fhand.binary | fhand.trunc | fhand.out);
-    if (!fhand.is_open())
+    this->mLeaderBoard.assign(this->mNumLeaders, 0);
+    if (!this->mPtrLeaderboard)
     {
         return false;
     }
-    for (int i = 0; i < this->mNumLeaders; i ++)
+    std::vector<LeaderboardEntry> top = this->mPtrLeaderboard->topK(this->currentLeaderboardKey(), this->mNumLeaders);
+    for (size_t i = 0; i < top.size(); i ++)
     {
-        fhand.write(reinterpret_cast<char*>(&this->mLeaderBoard[i]), sizeof(this->mLeaderBoard[i]));;
+        this->mLeaderBoard[i] = top[i].score;
     }
-    fhand.close();
     return true;
 }
 
+bool Game::updateLeaderBoard()
+{
+    if (!this->mPtrLeaderboard)
+    {
+        return false;
+    }
+    LeaderboardEntry entry;
+    entry.score = this->mPoints;
+    entry.length = this->mPtrSnake ? static_cast<int32_t>(this->mPtrSnake->getSnake().size()) : 0;
+    entry.durationMs = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - this->mRoundStartTime).count());
+    entry.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // 插入返回时成绩已经写入日志，合并进索引由存储按批处理
+    const LeaderboardKey key = this->currentLeaderboardKey();
+    bool updated = this->mPtrLeaderboard->insert(key, entry) &&
+                   this->mPtrLeaderboard->rankOf(key, this->mPoints) < static_cast<size_t>(this->mNumLeaders);
+    this->readLeaderBoard();
+    return updated;
+}
+
 bool Game::selectLevel()
 {
     while (true) { // 用循环包裹，方便从Shop返回后重新显示菜单
@@ -1909,6 +2078,7 @@ bool Game::selectLevel()
             "Timed Mode",
             "Battle Mode",
             "Shop",
+            "Arena Mode",
             "Load Game",
             "Exit Game"
         };
@@ -1967,12 +2137,12 @@ bool Game::selectLevel()
         }
         delwin(menu);
 
-        if (index == 6) { // Exit Game
+        if (index == 7) { // Exit Game
             return false;
         } else if (index == 4) { // Shop
             showShopMenu(); // 这里调用你的商店界面函数
             continue; // 回到主菜单
-        } else if (index == 5) { // Load Game
+        } else if (index == 6) { // Load Game
             if (hasSaveFile()) {
                 if (loadGame()) {
                     mReturnToModeSelect = false;
@@ -1982,7 +2152,8 @@ bool Game::selectLevel()
                     WINDOW* errorWin = newwin(5, 40, startY + height/2, startX + width/2 - 20);
                     box(errorWin, 0, 0);
                     mvwprintw(errorWin, 1, 1, "Failed to load save file!");
-                    mvwprintw(errorWin, 2, 1, "Press any key to continue...");
+                    mvwprintw(errorWin, 2, 1, "%.38s", mSaveError.c_str());
+                    mvwprintw(errorWin, 3, 1, "Press any key to continue...");
                     wrefresh(errorWin);
                     getch();
                     delwin(errorWin);
@@ -2007,6 +2178,82 @@ bool Game::selectLevel()
     }
 }
 
+std::vector<std::vector<std::string>> Game::levelStoryPages(int level, StoryIndex::Part part, int width)
+{
+    std::vector<std::vector<std::string>> pages;
+    StoryIndex& story = StoryIndex::shared();
+    if (level < 1 || level > mMaxLevel || !story.open(mStoryFilePath)) {
+        return pages;
+    }
+    int branch = StoryIndex::kAllBranches;
+    int section = level;
+    if (part == StoryIndex::Part::Intro) {
+        // 章节标题作为第一页
+        pages.push_back(StoryIndex::wrapText(story.title(level), width));
+        pages.push_back({});
+        // 第一关没有单独的开场，沿用序章
+        if (story.paragraphs(level, part).empty()) {
+            section = StoryIndex::kPrologue;
+        }
+    } else if (level == 3) {
+        // 分支从1开始：1 = 独自面对，2 = 与同伴协作
+        branch = mLevel3ModeChoice + 1;
+    }
+    std::vector<std::vector<std::string>> paragraphs = story.layout(section, part, branch, width);
+    if (paragraphs.empty()) {
+        return std::vector<std::vector<std::string>>();
+    }
+    pages.insert(pages.end(), paragraphs.begin(), paragraphs.end());
+
+    // 剧本里没有的玩法目标
+    std::string objective;
+    if (part == StoryIndex::Part::Intro && level == 1) {
+        objective = "OBJECTIVE: Collect 100 pieces of food to learn to survive in eternal loneliness!";
+    } else if (part == StoryIndex::Part::Intro && level == 2) {
+        objective = "OBJECTIVE: Collect 5 pieces of food within 30 seconds!";
+    }
+    if (!objective.empty()) {
+        pages.push_back({});
+        pages.push_back(StoryIndex::wrapText(objective, width));
+    }
+    return pages;
+}
+
+bool Game::typewriteLines(WINDOW* win, const std::vector<std::string>& lines, int firstRow, int width)
+{
+    const int glyphMs = 30;     // 每个字符出现的间隔（毫秒）
+    const int frameMs = 16;     // 每帧间隔（毫秒），约60帧
+    
+    TypewriterPage page;
+    page.layoutCentered(lines, firstRow, width, 2);
+    TypewriterClock clock(glyphMs);
+    clock.start(page.getGlyphCount());
+    
+    size_t shown = 0;
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (shown < page.getGlyphCount()) {
+        // 每帧检查一次是否按下ESC键
+        if (getch() == 27) {
+            return false;
+        }
+        
+        // 只画上一帧之后新出现的字符，有变化时刷新一次
+        const size_t target = clock.revealedAt();
+        if (target > shown) {
+            for (; shown < target; shown++) {
+                const TypewriterGlyph& glyph = page.getGlyph(shown);
+                mvwaddch(win, glyph.row, glyph.col, glyph.ch);
+            }
+            wrefresh(win);
+        }
+        
+        // 按固定的帧节奏等待，绘制本身的耗时不会累积到总时长里
+        nextFrame += std::chrono::milliseconds(frameMs);
+        std::this_thread::sleep_until(nextFrame);
+    }
+    return true;
+}
+
 void Game::displayLevelIntroduction(int level)
 {
     // 确保所有面板都被绘制
@@ -2031,140 +2278,19 @@ void Game::displayLevelIntroduction(int level)
     std::string title = "LEVEL " + std::to_string(level);
     mvwprintw(introWin, 1, (width - title.length()) / 2, "%s", title.c_str());
     
-    // 根据关卡显示不同的开场文字
-    std::vector<std::string> introText;
-    
-    switch (level) {
-        case 1:
-            introText = {
-                " The Eternal Trial",
-                "",
-                "The world is falling apart before your eyes.",
-                "The warmth of the nest, the gentle kiss of parents, the melody of a lullaby... everything becomes a distant and vague echo.",
-                "You are thrown into the end of time, a cage called the Stasis Ruins.",
-                "Sadness and fear wrap around you like ice, but in this dead silence, your parents' last words ignite a faint spark in your mind:",
-                "My child, before you embark on your journey, you must learn to survive in eternal loneliness.",
-                "This is their first teaching and your only guidepost.",
-                "Stay alive.",
-                "In order to feel the warmth again, in order to find out the truth, in order to... no longer be alone.",
-                "This is your first adventure in this barren land.",
-                "You must find enough food to survive.",
-                "",
-                "OBJECTIVE: Collect 100 pieces of food to learn to survive in eternal loneliness!"
-            };
-            break;
-        case 2:
-            introText = {
-                "The Arrow of Time",
-                "",
-                "You have entered the \"realm of flowing light\".",
-                "This is the time and space eroded by the remaining power of the \"Mechanical Master\", turning time into the most deadly weapon.",
-                "Here, a moment of hesitation will be left behind by the torrent of time.",
-                "The second lesson from parents sounded at the right time, like a warning bell:",
-                "Remember, time is both your enemy and your weapon. You have to learn to harness it instead of being swallowed up by it.",
-                "You take a deep breath and sink the power of \"Tough Heart\" into the depths of your consciousness.",
-                "Now you have to be faster than time.",
-                "",
-                "OBJECTIVE: Collect 5 pieces of food within 30 seconds!"
-            };
-            break;
-        case 3:
-            introText = {
-                "The Heart of Twin Shadows",
-                "Your longing has awakened a spiritual imprint sleeping here.",
-                "A gentle yet powerful voice, the combined voice of your parents, echoes from the water:",
-                "\"We never left you, child. Feel our presence. You are never fighting alone.\"",
-                "In the center of the pool, light gathers, forming a 'Soul Shadow' made of pure energy. It is both a trial and a guardian.",
-                "Now, how will you face this memory?",
-                ""
-            };
-            break;
-        case 4:
-            introText = {
-                " The Melody of Life",
-                "You have arrived at the Echoing Canyon.",
-                "Everything here moves to an unseen rhythm. The power of the three shards allows you to \"hear\" this cosmic symphony.",
-                "The Mechanos, on the other hand, represents absolute silence—the static that would erase all melody.",
-                "Your parents' final lesson, the ultimate truth, now resonates within you:",
-                "\"The world has its own heartbeat, a rhythm the machines can never understand. Listen to it, resonate with it. That is the most fundamental power of life.\"",
-                "Forget mere movement. Let your body become a note in this symphony of life.",
-                
-            };
-            break;
-        case 5:
-            introText = {
-                " The Core Cleansing",
-                "You have finally reached it.",
-                "Hatred may have been your starting point, but a far greater power drives you now.",
-                "Fortitude, Celerity, Bonds, Harmony.",
-                "Your parents' legacy is now fully part of your soul. You are no longer an orphan seeking revenge, but the new guardian, embodying all the best qualities of life.",
-                "The four shards form a halo of light above you. Their final words send you off as a blessing:",
-                "\"Go, child. Use everything you have learned to end the old destiny and forge a new future.\"",
-                "The final battle begins now.",
-            };
-            break;
-        default:
-            introText = {
-                "UNKNOWN ADVENTURE",
-                "",
-                "A new challenge awaits you ahead...",
-                "",
-                "Are you ready?"
-            };
-    }
-    
-    // 实现每行文字单独显示，并自动换行的效果
-    const int displayTime = 2000; // 每行显示时间（毫秒）
+    // 开场文字取自剧情索引，按窗口宽度折好的行直接从缓存拿，每段一组
+    const int displayTime = 2000; // 每段显示时间（毫秒）
     const int maxDisplayWidth = width - 6; // 可显示的最大宽度（留边距）
-    
-    // 辅助函数：将长文本按单词分割成适合宽度的多行
-    auto wrapText = [maxDisplayWidth](const std::string& text) -> std::vector<std::string> {
-        std::vector<std::string> wrappedLines;
-        if (text.empty()) {
-            wrappedLines.push_back("");
-            return wrappedLines;
-        }
-        
-        std::istringstream wordStream(text);
-        std::string word;
-        std::string currentLine;
-        
-        while (wordStream >> word) {
-            // 如果加上这个词会超出宽度，且当前行不为空，则另起一行
-            if (currentLine.length() + word.length() + 1 > static_cast<size_t>(maxDisplayWidth) && !currentLine.empty()) {
-                wrappedLines.push_back(currentLine);
-                currentLine = word;
-            }
-            // 如果是第一个词或者可以加入当前行
-            else {
-                if (!currentLine.empty()) {
-                    currentLine += " ";
-                }
-                currentLine += word;
-            }
-        }
-        
-        if (!currentLine.empty()) {
-            wrappedLines.push_back(currentLine);
-        }
-        
-        // 如果没有成功分行（可能是因为单词太长），强制按字符分割
-        if (wrappedLines.empty()) {
-            std::string line;
-            for (char c : text) {
-                if (line.length() >= static_cast<size_t>(maxDisplayWidth)) {
-                    wrappedLines.push_back(line);
-                    line.clear();
-                }
-                line += c;
-            }
-            if (!line.empty()) {
-                wrappedLines.push_back(line);
-            }
-        }
-        
-        return wrappedLines;
-    };
+    std::vector<std::vector<std::string>> introText = this->levelStoryPages(level, StoryIndex::Part::Intro, maxDisplayWidth);
+    if (introText.empty()) {
+        introText = {
+            {"UNKNOWN ADVENTURE"},
+            {},
+            {"A new challenge awaits you ahead..."},
+            {},
+            {"Are you ready?"}
+        };
+    }
     
     // 设置getch为非阻塞模式，以便检测按键
     nodelay(stdscr, TRUE);
@@ -2184,10 +2310,10 @@ void Game::displayLevelIntroduction(int level)
             break;
         }
         
-        const std::string& originalLine = introText[i];
+        const std::vector<std::string>& wrappedLines = introText[i];
         
         // 如果是空行，只显示很短的时间
-        if (originalLine.empty()) {
+        if (wrappedLines.empty()) {
             // 清除显示区域
             for (int y = 3; y < height - 3; y++) {
                 wmove(introWin, y, 2);
@@ -2213,9 +2339,6 @@ void Game::displayLevelIntroduction(int level)
             continue;
         }
         
-        // 将原始行按需换行
-        std::vector<std::string> wrappedLines = wrapText(originalLine);
-        
         // 清除显示区域
         for (int y = 3; y < height - 3; y++) {
             wmove(introWin, y, 2);
@@ -2228,29 +2351,9 @@ void Game::displayLevelIntroduction(int level)
         int startLine = (height - wrappedLines.size()) / 2;
         if (startLine < 3) startLine = 3;
         
-        // 逐行显示包装后的文本
-        for (size_t lineIdx = 0; lineIdx < wrappedLines.size(); lineIdx++) {
-            const std::string& line = wrappedLines[lineIdx];
-            
-            // 计算当前行的水平居中位置
-            int startX = (width - line.length()) / 2;
-            if (startX < 2) startX = 2;
-            
-            // 逐个字符显示当前行
-            for (size_t j = 0; j < line.length(); j++) {
-                mvwaddch(introWin, startLine + static_cast<int>(lineIdx), startX + static_cast<int>(j), line[j]);
-                wrefresh(introWin);
-                
-                // 每个字符显示后短暂暂停，同时检查是否按下ESC键
-                ch = getch();
-                if (ch == 27) {
-                    skip = true;
-                    break;
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(30));
-            }
-            
-            if (skip) break;
+        // 整页只排版一次，按经过的时间逐帧显示新出现的字符
+        if (!this->typewriteLines(introWin, wrappedLines, startLine, width)) {
+            skip = true;
         }
         
         if (skip) break;
@@ -2280,19 +2383,16 @@ void Game::displayLevelIntroduction(int level)
             }
         }
         
-        // 找到最后一个非空行
-        std::string lastLine;
+        // 找到最后一个非空段落（已经折好行）
+        std::vector<std::string> wrappedLines;
         for (auto it = introText.rbegin(); it != introText.rend(); ++it) {
             if (!it->empty()) {
-                lastLine = *it;
+                wrappedLines = *it;
                 break;
             }
         }
         
-        if (!lastLine.empty()) {
-            // 将最后一行按需换行
-            std::vector<std::string> wrappedLines = wrapText(lastLine);
-            
+        if (!wrappedLines.empty()) {
             // 计算起始行，使文本垂直居中
             int startLine = (height - wrappedLines.size()) / 2;
             if (startLine < 3) startLine = 3;
@@ -2644,6 +2744,11 @@ void Game::displayLevelIntroduction(int level)
 void Game::initializeLevel(int level)
 {
     mCurrentLevel = level;
+    mRoundStartTime = std::chrono::steady_clock::now();
+    // 从这里到 runLevel 开始计为关卡的启动耗时（不含开场介绍）
+    mLevelTransitionStart = mRoundStartTime;
+    mLevelStartupPending = true;
+    readLeaderBoard();
     
     // 重新绘制界面
     this->renderBoards();
@@ -2668,9 +2773,7 @@ void Game::initializeLevel(int level)
             // 初始化第四关特殊设置
             this->initializeLevel4();
             // 显示开场介绍（除非是重试）
-            if (!mIsLevelRetry) {
-                this->displayLevelIntroduction(level);
-            }
+            this->showLevelIntroduction(level);
             return; // 第四关有特殊初始化，直接返回
         case 5:
             mCurrentLevelType = LevelType::Custom2;
@@ -2678,9 +2781,7 @@ void Game::initializeLevel(int level)
             // 初始化第五关特殊设置
             this->initializeLevel5();
             // 显示开场介绍（除非是重试）
-            if (!mIsLevelRetry) {
-                this->displayLevelIntroduction(level);
-            }
+            this->showLevelIntroduction(level);
             return; // 第五关有特殊初始化，直接返回
         default:
             mCurrentLevelType = LevelType::Normal;
@@ -2688,26 +2789,8 @@ void Game::initializeLevel(int level)
             break;
     }
     
-    // 加载关卡对应的地图
-    std::string mapFilePath;
-    if (level >= 1 && level <= mMaxLevel) {
-        mapFilePath = mLevelMapFiles[level - 1];
-    } else {
-        mapFilePath = mLevelMapFiles[0];
-    }
-    
-    // 创建地图
-    mPtrMap = std::make_unique<Map>(mGameBoardWidth, mGameBoardHeight);
-    
-    // 检查地图文件是否存在
-    std::ifstream mapFile(mapFilePath);
-    if (mapFile.good()) {
-        mapFile.close();
-        mPtrMap->loadMapFromFile(mapFilePath);
-    } else {
-        // 如果地图文件不存在，加载默认地图
-        mPtrMap->loadDefaultMap();
-    }
+    // 加载关卡对应的地图，通关叙述期间已经预加载过时直接取用
+    mPtrMap = this->acquireLevelMap(level);
     
     // 创建蛇
     this->mPtrSnake.reset(new Snake(this->mGameBoardWidth, this->mGameBoardHeight, this->mInitialSnakeLength));
@@ -2717,7 +2800,7 @@ void Game::initializeLevel(int level)
     bool snakeInitialized = false;
     
     // 首先尝试找到一个有非常大的安全空间的位置 (10格)
-    std::vector<std::pair<SnakeBody, InitialDirection>> validPositions =
+    const auto& validPositions =
         this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 10);
     
     if (!validPositions.empty()) {
@@ -2728,7 +2811,7 @@ void Game::initializeLevel(int level)
         int minDist = this->mGameBoardWidth + this->mGameBoardHeight; // 初始最大距离
         
         for (size_t i = 0; i < validPositions.size(); i++) {
-            auto [pos, dir] = validPositions[i];
+            const auto& [pos, dir] = validPositions[i];
             int dx = pos.getX() - centerX;
             int dy = pos.getY() - centerY;
             int dist = std::abs(dx) + std::abs(dy); // 曼哈顿距离
@@ -2746,11 +2829,11 @@ void Game::initializeLevel(int level)
     
     // 如果没有找到理想的位置，尝试降低空间要求
     if (!snakeInitialized) {
-        validPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 6);
+        const auto& fallbackPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 6);
         
-        if (!validPositions.empty()) {
-            int idx = std::rand() % validPositions.size();
-            auto [startPos, direction] = validPositions[idx];
+        if (!fallbackPositions.empty()) {
+            int idx = std::rand() % fallbackPositions.size();
+            auto [startPos, direction] = fallbackPositions[idx];
             this->mPtrSnake->initializeSnake(startPos.getX(), startPos.getY(), direction);
             snakeInitialized = true;
         }
@@ -2758,11 +2841,11 @@ void Game::initializeLevel(int level)
     
     // 如果还是没有找到合适的位置，再降低要求
     if (!snakeInitialized) {
-        validPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 3);
+        const auto& fallbackPositions = this->mPtrMap->getValidSnakePositions(this->mInitialSnakeLength, 3);
         
-        if (!validPositions.empty()) {
-            int idx = std::rand() % validPositions.size();
-            auto [startPos, direction] = validPositions[idx];
+        if (!fallbackPositions.empty()) {
+            int idx = std::rand() % fallbackPositions.size();
+            auto [startPos, direction] = fallbackPositions[idx];
             this->mPtrSnake->initializeSnake(startPos.getX(), startPos.getY(), direction);
             snakeInitialized = true;
         }
@@ -2820,27 +2903,14 @@ void Game::initializeLevel(int level)
     }
     
     // 显示开场介绍（除非是重试）
-    if (!mIsLevelRetry) {
-        this->displayLevelIntroduction(level);
-    }
+    this->showLevelIntroduction(level);
 }
 
 // 初始化第四关特殊设置
 void Game::initializeLevel4()
 {
-    // 加载地图
-    std::string mapFilePath = mLevelMapFiles[3]; // level4.txt
-    mPtrMap = std::make_unique<Map>(mGameBoardWidth, mGameBoardHeight);
-    
-    // 检查地图文件是否存在
-    std::ifstream mapFile(mapFilePath);
-    if (mapFile.good()) {
-        mapFile.close();
-        mPtrMap->loadMapFromFile(mapFilePath);
-    } else {
-        // 如果地图文件不存在，加载默认地图
-        mPtrMap->loadDefaultMap();
-    }
+    // 加载地图（level4.txt）
+    mPtrMap = this->acquireLevelMap(4);
     
     // 创建蛇
     this->mPtrSnake.reset(new Snake(this->mGameBoardWidth, this->mGameBoardHeight, this->mInitialSnakeLength));
@@ -2910,7 +2980,7 @@ void Game::controlSnakeLevel4() const
 // 运行第四关特殊逻辑
 void Game::runLevel4()
 {
-    // 播放背景音乐 (Linux系统)
+    // 播放背景音乐
     std::string musicPath = "assets/music/level4music.mp3";
     // 检查音乐文件是否存在
     std::ifstream checkMusic(musicPath);
@@ -2928,50 +2998,24 @@ void Game::runLevel4()
     checkMusic.close();
     
     if (!musicPath.empty()) {
-        // 尝试多种音乐播放器，按优先级排列
-        std::vector<std::string> players = {
-            "mpg123 -q -l 0",
-            "ffplay -nodisp -loop 0",
-            "mplayer -loop 0 -really-quiet",
-            "cvlc --play-and-exit --loop",
-            "aplay",  // 仅支持wav
-            "paplay"  // 仅支持wav
-        };
-        
-        bool musicStarted = false;
-        for (const auto& player : players) {
-            // 检查播放器是否安装
-            std::string checkCmd = "which " + player.substr(0, player.find(' ')) + " 2>/dev/null";
-            FILE* checkPlayer = popen(checkCmd.c_str(), "r");
-            bool playerInstalled = false;
-            
-            if (checkPlayer != NULL) {
-                char buffer[128];
-                if (fgets(buffer, sizeof(buffer), checkPlayer) != NULL) {
-                    playerInstalled = true;
-                }
-                pclose(checkPlayer);
+        if (!AudioDecoder::isSupported(musicPath)) {
+            // mp3解码依赖可选的libmpg123，构建时没有找到就如实提示，不假装在播放
+            mvwprintw(this->mWindows[0], 4, 1, "提示: 音乐不可用 (未编译mp3支持)");
+        } else {
+            // 混音线程在后台打开和解码文件，这里只提交命令，不再查找和启动外部播放器
+            if (!this->mPtrAudioEngine) {
+                this->mPtrAudioEngine.reset(new AudioEngine(createAudioOutput()));
             }
-            
-            if (playerInstalled) {
-                std::string musicCmd = player + " \"" + musicPath + "\" >/dev/null 2>&1 &";
-                try {
-                    system(musicCmd.c_str());
-                    mvwprintw(this->mWindows[0], 4, 1, "音乐已启动 (使用%s)", 
-                              player.substr(0, player.find(' ')).c_str());
-                    wrefresh(this->mWindows[0]);
-                    musicStarted = true;
-                    break;
-                } catch (...) {
-                    continue; // 尝试下一个播放器
-                }
+            if (std::strcmp(this->mPtrAudioEngine->getOutputName(), "null") == 0) {
+                // 没有ALSA时退回空输出，播放了也听不到
+                mvwprintw(this->mWindows[0], 4, 1, "提示: 音乐不可用 (无音频输出)");
+            } else if (this->mPtrAudioEngine->playMusic(musicPath, true)) {
+                mvwprintw(this->mWindows[0], 4, 1, "音乐已启动 (输出: %s)", this->mPtrAudioEngine->getOutputName());
+            } else {
+                mvwprintw(this->mWindows[0], 4, 1, "提示: 不支持的音乐格式");
             }
         }
-        
-        if (!musicStarted) {
-            mvwprintw(this->mWindows[0], 4, 1, "提示: 未找到可用的音频播放器");
-            wrefresh(this->mWindows[0]);
-        }
+        wrefresh(this->mWindows[0]);
     }
     
     // 更新信息面板，显示关卡提示
@@ -3034,17 +3078,73 @@ void Game::runLevel4()
         refresh();
     }
     
-    // 停止背景音乐 (Linux系统) - 尝试停止各种可能的音频播放器
-    try {
-        system("pkill -f mpg123 >/dev/null 2>&1");
-        system("pkill -f ffplay >/dev/null 2>&1");
-        system("pkill -f mplayer >/dev/null 2>&1");
-        system("pkill -f vlc >/dev/null 2>&1");
-        system("pkill -f aplay >/dev/null 2>&1");
-        system("pkill -f paplay >/dev/null 2>&1");
-    } catch (...) {
-        // 忽略停止音乐时的错误
+    // 停止背景音乐：只停本进程的声音，在下一个混音块生效
+    if (this->mPtrAudioEngine) {
+        this->mPtrAudioEngine->stopMusic();
+    }
+}
+
+std::string Game::levelMapPath(int level) const
+{
+    if (level >= 1 && level <= mMaxLevel) {
+        return mLevelMapFiles[level - 1];
+    }
+    return mLevelMapFiles[0];
+}
+
+void Game::preloadLevel(int level)
+{
+    if (level < 1 || level > mMaxLevel) {
+        return;
+    }
+    // 前三关在 initializeLevel 中按 10/6/3 格安全空间依次找出生点，第四五关固定出生点
+    std::vector<int> spawnSpaces;
+    if (level <= 3) {
+        spawnSpaces = {10, 6, 3};
+    }
+    mPtrLevelPreloader->start(level, levelMapPath(level), mGameBoardWidth, mGameBoardHeight,
+                              mInitialSnakeLength, spawnSpaces);
+}
+
+std::unique_ptr<Map> Game::acquireLevelMap(int level)
+{
+    const std::string mapFilePath = levelMapPath(level);
+    std::unique_ptr<Map> map = mPtrLevelPreloader->take(level, mapFilePath, mGameBoardWidth, mGameBoardHeight);
+    mLevelMapPreloaded = (map != nullptr);
+    if (!map) {
+        map = LevelPreloader::loadLevelMap(mapFilePath, mGameBoardWidth, mGameBoardHeight);
+    }
+    return map;
+}
+
+void Game::showLevelIntroduction(int level)
+{
+    if (mIsLevelRetry) {
+        return;
     }
+    // 开场介绍是给玩家看的，不计入启动耗时
+    auto introStart = std::chrono::steady_clock::now();
+    this->displayLevelIntroduction(level);
+    mLevelTransitionStart += std::chrono::steady_clock::now() - introStart;
+}
+
+void Game::reportLevelStartup()
+{
+    if (!mLevelStartupPending) {
+        return;
+    }
+    mLevelStartupPending = false;
+    mLastLevelStartupMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - mLevelTransitionStart).count();
+    // 启动耗时是开发用数据，不打扰玩家，只写性能日志
+    char text[96];
+    if (mLevelMapPreloaded) {
+        std::snprintf(text, sizeof(text), "level %d ready: %.1f ms (preloaded, waited %.1f ms)",
+                      mCurrentLevel, mLastLevelStartupMs, mPtrLevelPreloader->getLastWaitMs());
+    } else {
+        std::snprintf(text, sizeof(text), "level %d ready: %.1f ms", mCurrentLevel, mLastLevelStartupMs);
+    }
+    appendPerfLog(text);
 }
 
 void Game::loadNextLevel()
@@ -3068,6 +3168,8 @@ bool Game::isLevelCompleted()
 
 void Game::runLevel()
 {
+    this->reportLevelStartup();
+
     // 确保初始化时侧边栏正确显示
     this->renderInstructionBoard();
     this->renderPoints();
@@ -3146,6 +3248,7 @@ void Game::runLevel()
     while (true)
     {
         this->controlSnake();
+        this->maybeAutosave();
         werase(this->mWindows[1]);
         box(this->mWindows[1], 0, 0);
         
@@ -3495,48 +3598,87 @@ void Game::unlockLevel(int level)
 
 bool Game::saveLevelProgress()
 {
-    std::fstream fhand(this->mLevelProgressFilePath, std::ios::binary | std::ios::trunc | std::ios::out);
-    if (!fhand.is_open())
-    {
-        return false;
-    }
-    
-    // 保存所有关卡状态
+    // 所有关卡状态在一个事务里提交
+    ProfileStore::Transaction transaction;
     for (int i = 0; i < mMaxLevel; i++)
     {
-        int status = static_cast<int>(mLevelStatus[i]);
-        fhand.write(reinterpret_cast<char*>(&status), sizeof(status));
+        transaction.set(ProfileKeys::level(i + 1), static_cast<int>(mLevelStatus[i]));
     }
-    
-    fhand.close();
-    return true;
+    return ProfileStore::shared().commit(transaction);
 }
 
 bool Game::loadLevelProgress()
 {
-    std::fstream fhand(this->mLevelProgressFilePath, std::ios::binary | std::ios::in);
-    if (!fhand.is_open())
+    const ProfileStore& profile = ProfileStore::shared();
+    if (!profile.contains(ProfileKeys::level(1)))
     {
-        // 如果文件不存在，第一关默认解锁
+        // 还没有保存过进度，第一关默认解锁
         this->mLevelStatus[0] = LevelStatus::Unlocked;
         return false;
     }
-    
-    int status;
-    int i = 0;
-    while ((!fhand.eof()) && (i < mMaxLevel))
+
+    for (int i = 0; i < mMaxLevel; i++)
     {
-        fhand.read(reinterpret_cast<char*>(&status), sizeof(status));
-        if (!fhand.eof()) {
-            this->mLevelStatus[i] = static_cast<LevelStatus>(status);
-        }
-        i++;
+        int64_t status = profile.get(ProfileKeys::level(i + 1), static_cast<int>(this->mLevelStatus[i]));
+        this->mLevelStatus[i] = static_cast<LevelStatus>(status);
     }
-    
-    fhand.close();
     return true;
 }
 
+void Game::migrateLegacyProfile()
+{
+    // 三个旧文件的内容放进同一个事务，要么全部导入，要么都不导入
+    ProfileStore::Transaction transaction;
+    std::vector<std::string> migrated;
+
+    std::ifstream profileFile("player_profile.dat", std::ios::binary);
+    if (profileFile) {
+        int coins = 0, skin = 0, ownedCount = 0;
+        if (profileFile.read(reinterpret_cast<char*>(&coins), sizeof(coins)) &&
+            profileFile.read(reinterpret_cast<char*>(&skin), sizeof(skin))) {
+            transaction.set(ProfileKeys::kCoins, coins);
+            transaction.set(ProfileKeys::kCurrentSkin, skin);
+            profileFile.read(reinterpret_cast<char*>(&ownedCount), sizeof(ownedCount));
+            for (int i = 0; i < ownedCount; ++i) {
+                int sval = 0;
+                if (!profileFile.read(reinterpret_cast<char*>(&sval), sizeof(sval))) break;
+                transaction.set(ProfileKeys::ownedSkin(sval), 1);
+            }
+        }
+        migrated.push_back("player_profile.dat");
+    }
+
+    std::ifstream itemFile("item_inventory.dat", std::ios::binary);
+    if (itemFile) {
+        int itemCount = 0;
+        itemFile.read(reinterpret_cast<char*>(&itemCount), sizeof(itemCount));
+        for (int i = 0; i < itemCount; ++i) {
+            int item = 0, count = 0;
+            if (!itemFile.read(reinterpret_cast<char*>(&item), sizeof(item)) ||
+                !itemFile.read(reinterpret_cast<char*>(&count), sizeof(count))) break;
+            transaction.set(ProfileKeys::item(item), count);
+        }
+        migrated.push_back("item_inventory.dat");
+    }
+
+    std::ifstream levelFile(this->mLevelProgressFilePath, std::ios::binary);
+    if (levelFile) {
+        int status = 0;
+        for (int level = 1; level <= mMaxLevel &&
+             levelFile.read(reinterpret_cast<char*>(&status), sizeof(status)); level++) {
+            transaction.set(ProfileKeys::level(level), status);
+        }
+        migrated.push_back(this->mLevelProgressFilePath);
+    }
+
+    if (migrated.empty() || !ProfileStore::shared().commit(transaction)) {
+        return;
+    }
+    for (const std::string& path : migrated) {
+        std::rename(path.c_str(), (path + ".migrated").c_str());
+    }
+}
+
 
 
 void Game::initializeTimeAttack()
@@ -3579,6 +3721,7 @@ void Game::runTimeAttack()
 
         // 游戏循环核心
         this->controlSnake();
+        this->maybeAutosave();
         werase(this->mWindows[1]);
         box(this->mWindows[1], 0, 0);
         
@@ -3614,19 +3757,8 @@ void Game::runTimeAttack()
 // 添加第五关初始化函数
 void Game::initializeLevel5()
 {
-    // 加载地图
-    std::string mapFilePath = mLevelMapFiles[4]; // level5.txt
-    mPtrMap = std::make_unique<Map>(mGameBoardWidth, mGameBoardHeight);
-    
-    // 检查地图文件是否存在
-    std::ifstream mapFile(mapFilePath);
-    if (mapFile.good()) {
-        mapFile.close();
-        mPtrMap->loadMapFromFile(mapFilePath);
-    } else {
-        // 如果地图文件不存在，加载默认地图
-        mPtrMap->loadDefaultMap();
-    }
+    // 加载地图（level5.txt）
+    mPtrMap = this->acquireLevelMap(5);
     
     // 创建蛇（固定长度）
     this->mPtrSnake.reset(new Snake(this->mGameBoardWidth, this->mGameBoardHeight, this->mInitialSnakeLength));
@@ -3709,6 +3841,7 @@ void Game::runLevel5()
     {
         // 控制蛇的移动
         this->controlSnake();
+        this->maybeAutosave();
         
         werase(this->mWindows[1]);
         box(this->mWindows[1], 0, 0);
@@ -4198,6 +4331,20 @@ bool Game::selectBattleType() {
 }
 
 
+void Game::respawnBattleSnake(Snake& snake, const Snake& opponent, int fallbackX, int fallbackY,
+                              InitialDirection fallbackDirection) {
+    std::vector<SnakeBody> occupied = opponent.getSnake();
+    occupied.insert(occupied.end(), mCorpseFoods.begin(), mCorpseFoods.end());
+
+    SpawnPosition spawn;
+    if (mPtrMap->pickSpawnFarFrom(mInitialSnakeLength, mBattleSpawnSpace, opponent.getSnake().front(),
+                                  occupied, static_cast<uint32_t>(std::rand()), spawn)) {
+        snake.initializeSnake(spawn.first.getX(), spawn.first.getY(), spawn.second);
+    } else {
+        snake.initializeSnake(fallbackX, fallbackY, fallbackDirection);
+    }
+}
+
 void Game::initializeBattle(BattleType type) {
     mPtrMap = std::make_unique<Map>(mGameBoardWidth, mGameBoardHeight);
     mPtrMap->initializeEmptyMap(); // 对战使用简单的开放地图
@@ -4216,6 +4363,9 @@ void Game::initializeBattle(BattleType type) {
     mPtrSnake->setMap(mPtrMap.get());
     mPtrSnake2->setMap(mPtrMap.get());
 
+    // 提前建好出生点表，对局中复活只需查表
+    mPtrMap->getValidSnakePositions(mInitialSnakeLength, mBattleSpawnSpace);
+
     // 同步尸体食物信息（初始为空）
     mPtrSnake->senseCorpseFoods(mCorpseFoods);
     mPtrSnake2->senseCorpseFoods(mCorpseFoods);
@@ -4262,11 +4412,17 @@ void Game::runBattle() {
     std::string winner = "";
     nodelay(stdscr, TRUE); // Set getch() to be non-blocking
     
+    int frameDelay = 0;    // 上一帧的目标间隔，用于判断丢帧
     while (winner.empty()) {
+        mFrameStats.beginFrame(frameDelay);
         int key = getch();
-        if (key != ERR) {
+        if (key == KEY_F(3)) {
+            togglePerfHud(); // F3：显示或隐藏性能面板
+        } else if (key != ERR) {
              controlSnakes(key); // 处理玩家输入
         }
+        maybeAutosave();
+        mFrameStats.endPhase(FramePhase::Input);
 
         // 如果是 AI 对战模式，获取 AI 的下一步移动方向
         if (mCurrentBattleType == BattleType::PlayerVsAI) {
@@ -4275,6 +4431,7 @@ void Game::runBattle() {
                                                    mCurrentFoodType, mHasSpecialFood, mHasPoison, mHasRandomItem);
             mPtrSnake2->changeDirection(ai_dir);
         }
+        mFrameStats.endPhase(FramePhase::AI);
 
         // 更新作弊模式状态
         updateCheatMode();
@@ -4290,6 +4447,7 @@ void Game::runBattle() {
         renderSpecialFood();
         renderCorpseFoods();
         renderBattleStatus();
+        mFrameStats.endPhase(FramePhase::Render);
 
         // 同步食物信息并移动两条蛇
         mPtrSnake->senseFood(mFood);
@@ -4331,6 +4489,8 @@ void Game::runBattle() {
             break; // 如果有胜负，跳出循环
         }
         
+        mFrameStats.endPhase(FramePhase::Sim);
+
         // 处理碰撞后的重置（如果蛇还活着但发生了碰撞）
         if (mPtrSnake->checkCollision() || mPtrSnake2->isPartOfSnake(mPtrSnake->getSnake().front().getX(), mPtrSnake->getSnake().front().getY())) {
             if (mPtrSnake->isAlive()) {
@@ -4341,7 +4501,7 @@ void Game::runBattle() {
                 this->mPtrSnake2->senseCorpseFoods(this->mCorpseFoods);
                 
                 // 重置玩家1蛇的位置
-                mPtrSnake->initializeSnake(5, 5, InitialDirection::Right);
+                respawnBattleSnake(*mPtrSnake, *mPtrSnake2, 5, 5, InitialDirection::Right);
                 mPtrSnake->setLives(mPtrSnake->getLives()); // 保持当前生命值
             }
         }
@@ -4355,7 +4515,7 @@ void Game::runBattle() {
                 this->mPtrSnake2->senseCorpseFoods(this->mCorpseFoods);
                 
                 // 重置玩家2/AI蛇的位置
-                mPtrSnake2->initializeSnake(mGameBoardWidth - 10, mGameBoardHeight - 10, InitialDirection::Right);
+                respawnBattleSnake(*mPtrSnake2, *mPtrSnake, mGameBoardWidth - 10, mGameBoardHeight - 10, InitialDirection::Right);
                 mPtrSnake2->setLives(mPtrSnake2->getLives()); // 保持当前生命值
             }
         }
@@ -4394,6 +4554,7 @@ void Game::runBattle() {
                 mHasRandomItem = false;
             }
         }
+        mFrameStats.endPhase(FramePhase::Spawn);
         
         // 处理特殊食物效果（蛇长度变化后调整延迟）
         if (p1_ate_special && mHasSpecialFood) {
@@ -4533,6 +4694,8 @@ void Game::runBattle() {
             mHasRandomItem = false;
         }
         
+        mFrameStats.endPhase(FramePhase::Sim);
+        
         // 检查特殊食物/毒药/道具是否超时消失
         auto now = std::chrono::steady_clock::now();
         if (mHasSpecialFood && std::chrono::duration_cast<std::chrono::seconds>(now - mSpecialFoodSpawnTime).count() > mSpecialFoodDuration) {
@@ -4551,8 +4714,14 @@ void Game::runBattle() {
             // 对战模式加速：基础延迟的40%
             currentDelay = static_cast<long>(mBattleBaseDelay * 0.4);
         }
+        mFrameStats.endPhase(FramePhase::Spawn);
         std::this_thread::sleep_for(std::chrono::milliseconds(currentDelay));
+        mFrameStats.idle();
+        frameDelay = static_cast<int>(currentDelay);
         wrefresh(mWindows[1]);
+        updatePerfHud();
+        mFrameStats.endPhase(FramePhase::Render);
+        mFrameStats.endFrame();
     }
     nodelay(stdscr, FALSE);
     renderWinnerText(winner); // 显示胜利者
@@ -4732,114 +4901,18 @@ void Game::displayLevelCompletion(int level)
     std::string title = "LEVEL " + std::to_string(level) + " COMPLETED";
     mvwprintw(completeWin, 1, (width - title.length()) / 2, "%s", title.c_str());
     
-    // 根据关卡显示不同的通关文字
-    std::vector<std::string> completionText;
-    
-    switch (level) {
-        case 1:
-            completionText = {
-                "An eternity could have passed.",
-                "In this endless solitude, you were not consumed.",
-                "You forged your sorrow into sustenance and your confusion into strength. Every bite was a declaration of your will to live; every inch of growth was an answer to your parents' lesson.",
-                "You are no longer the frightened hatchling cowering in the dark. Your spirit has been tempered, as hard and unbreakable as a diamond.",
-                "",
-                "[Item Acquired]: *Memory Shard - The Heart of Fortitude*",
-                "",
-                "This is the first gift your parents left you—the \"Heart of Fortitude.\"",
-                "As it appears, the stagnant space around you begins to tremble. Like a compass, the shard points you toward a new direction, toward a rift engulfed in a chaotic temporal storm.",
-                "You understand now. The trial... has only just begun.",
-            };
-            break;
-        case 2:
-            completionText = {
-                "You succeeded.",
-                "In this race against the clock, you learned to maintain focus and precision under extreme pressure.",
-                "You no longer fear the fleeting moments; instead, you have come to understand their rhythm. You now grasp the cold, efficient terror of The Mechanos—and have found a way to navigate its laws.",
-                "",
-                "[Item Acquired]: *Memory Shard - The Heart of Celerity*",
-                "",
-                "The two shards circle you, their powers beginning to resonate.",
-                "No longer pointing to a random rift, they now work in concert to open a new gateway—a path to the deepest corner of your heart, to the hallowed ground where memory and longing reside.",
-            };
-            break;
-        case 3:
-            completionText = {
-                "[Item Acquired]: *Memory Shard - The Heart of Bonds*",
-                "Fortitude, Celerity, Bonds.",
-                "The three hearts orbit you. Their combined power allows you to perceive something greater, a law more fundamental and profound—a concept The Mechanos could never comprehend: the very heartbeat of life itself.",
-                
-            };
-            break;
-        case 4:
-            completionText = {
-                "You are no longer just following the beat; you have become a part of it.",
-                "You have learned that the power of life lies not in conquest, but in harmonious resonance. This fluid, ever-changing, beautiful rhythm is the ultimate counter to the cold, rigid, and repetitive order of The Mechanos.",
-                "Your very existence is now a hymn to life.",
-                "[Animation]: The fourth and final shard is born from the resonance of the world's melody. It is iridescent, seeming to contain all the beauty and vitality of the universe.",
-                "[Item Acquired]: *Memory Shard - The Heart of Harmony*",
-                "The four shards are finally complete!",
-                "They unite before you, sending a pillar of light into the sky. It tears through the veil of spacetime, forging a road that leads directly to the eye of the storm.",
-                "At the end of that road lies the core of The Mechanos: the Zero Throne.",
-            };
-            break;
-        case 5:
-            completionText = {
-                "It is over.",
-                "The spinning lasers die down, the cold laws collapse.",
-                "You have answered the silence of machines with the resonance of life. You have shattered eternal stillness with a harmonious melody.",
-                "Now, it is time for this imprisoned world to be reborn.",
-                "You watch the new world before you, where all things are reborn and thrive.",
-                "You can almost see the proud smiles of your parents. They are not gone; they have become every blade of grass, every gust of wind that brushes against your scales.",
-                "The hatred has long since faded, replaced by the weight of love and responsibility.",
-                "You are no longer an echo of the past, but the prelude to the future.",
-            };
-            break;
-        default:
-            completionText = {
-                "CHALLENGE COMPLETE",
-                "",
-                "You have overcome this trial, but the journey continues...",
-                "",
-                "What awaits in the next challenge?"
-            };
-    }
-    
-    // 实现文本自动换行的显示效果
+    // 通关文字取自剧情索引；第三关按选择的模式显示对应分支
     const int maxDisplayWidth = width - 6; // 可显示的最大宽度（留边距）
-    
-    // 辅助函数：将长文本按单词分割成适合宽度的多行
-    auto wrapText = [maxDisplayWidth](const std::string& text) -> std::vector<std::string> {
-        std::vector<std::string> wrappedLines;
-        if (text.empty()) {
-            wrappedLines.push_back("");
-            return wrappedLines;
-        }
-        
-        std::istringstream wordStream(text);
-        std::string word;
-        std::string currentLine;
-        
-        while (wordStream >> word) {
-            // 如果加上这个词会超出宽度，且当前行不为空，则另起一行
-            if (currentLine.length() + word.length() + 1 > static_cast<size_t>(maxDisplayWidth) && !currentLine.empty()) {
-                wrappedLines.push_back(currentLine);
-                currentLine = word;
-            }
-            // 如果是第一个词或者可以加入当前行
-            else {
-                if (!currentLine.empty()) {
-                    currentLine += " ";
-                }
-                currentLine += word;
-            }
-        }
-        
-        if (!currentLine.empty()) {
-            wrappedLines.push_back(currentLine);
-        }
-        
-        return wrappedLines;
-    };
+    std::vector<std::vector<std::string>> completionText = this->levelStoryPages(level, StoryIndex::Part::Outro, maxDisplayWidth);
+    if (completionText.empty()) {
+        completionText = {
+            {"CHALLENGE COMPLETE"},
+            {},
+            {"You have overcome this trial, but the journey continues..."},
+            {},
+            {"What awaits in the next challenge?"}
+        };
+    }
     
     // 设置getch为非阻塞模式，以便检测按键
     nodelay(stdscr, TRUE);
@@ -4859,10 +4932,10 @@ void Game::displayLevelCompletion(int level)
             break;
         }
         
-        const std::string& originalLine = completionText[i];
+        const std::vector<std::string>& wrappedLines = completionText[i];
         
         // 如果是空行，只显示很短的时间
-        if (originalLine.empty()) {
+        if (wrappedLines.empty()) {
             // 清除显示区域
             for (int y = 3; y < height - 3; y++) {
                 wmove(completeWin, y, 2);
@@ -4888,9 +4961,6 @@ void Game::displayLevelCompletion(int level)
             continue;
         }
         
-        // 将原始行按需换行
-        std::vector<std::string> wrappedLines = wrapText(originalLine);
-        
         // 清除显示区域
         for (int y = 3; y < height - 3; y++) {
             wmove(completeWin, y, 2);
@@ -4903,29 +4973,9 @@ void Game::displayLevelCompletion(int level)
         int startLine = (height - wrappedLines.size()) / 2;
         if (startLine < 3) startLine = 3;
         
-        // 逐行显示包装后的文本
-        for (size_t lineIdx = 0; lineIdx < wrappedLines.size(); lineIdx++) {
-            const std::string& line = wrappedLines[lineIdx];
-            
-            // 计算当前行的水平居中位置
-            int startPos = (width - line.length()) / 2;
-            if (startPos < 2) startPos = 2;
-            
-            // 逐个字符显示当前行
-            for (size_t j = 0; j < line.length(); j++) {
-                mvwaddch(completeWin, startLine + static_cast<int>(lineIdx), startPos + static_cast<int>(j), line[j]);
-                wrefresh(completeWin);
-                
-                // 每个字符显示后短暂暂停，同时检查是否按下ESC键
-                ch = getch();
-                if (ch == 27) {
-                    skip = true;
-                    break;
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(30));
-            }
-            
-            if (skip) break;
+        // 整页只排版一次，按经过的时间逐帧显示新出现的字符
+        if (!this->typewriteLines(completeWin, wrappedLines, startLine, width)) {
+            skip = true;
         }
         
         if (skip) break;
@@ -4955,19 +5005,16 @@ void Game::displayLevelCompletion(int level)
             }
         }
         
-        // 找到最后一个非空行
-        std::string lastLine;
+        // 找到最后一个非空段落（已经折好行）
+        std::vector<std::string> wrappedLines;
         for (auto it = completionText.rbegin(); it != completionText.rend(); ++it) {
             if (!it->empty()) {
-                lastLine = *it;
+                wrappedLines = *it;
                 break;
             }
         }
         
-        if (!lastLine.empty()) {
-            // 将最后一行按需换行
-            std::vector<std::string> wrappedLines = wrapText(lastLine);
-            
+        if (!wrappedLines.empty()) {
             // 计算起始行，使文本垂直居中
             int startLine = (height - wrappedLines.size()) / 2;
             if (startLine < 3) startLine = 3;
@@ -5131,6 +5178,7 @@ void Game::runLevel3Mode1()
     {
         // 处理玩家输入
         this->controlSnake();
+        this->maybeAutosave();
         
         // 清除游戏区域
         werase(this->mWindows[1]);
@@ -5412,29 +5460,9 @@ void Game::runLevel3Mode2()
             int startLine = (height - wrappedLines.size()) / 2;
             if (startLine < 3) startLine = 3;
             
-            // 逐行显示包装后的文本
-            for (size_t lineIdx = 0; lineIdx < wrappedLines.size(); lineIdx++) {
-                const std::string& line = wrappedLines[lineIdx];
-                
-                // 计算当前行的水平居中位置
-                int startPos = (width - line.length()) / 2;
-                if (startPos < 2) startPos = 2;
-                
-                // 逐个字符显示当前行
-                for (size_t j = 0; j < line.length(); j++) {
-                    mvwaddch(introWin, startLine + static_cast<int>(lineIdx), startPos + static_cast<int>(j), line[j]);
-                    wrefresh(introWin);
-                    
-                    // 每个字符显示后短暂暂停，同时检查是否按下ESC键
-                    ch = getch();
-                    if (ch == 27) {
-                        skip = true;
-                        break;
-                    }
-                    std::this_thread::sleep_for(std::chrono::milliseconds(30));
-                }
-                
-                if (skip) break;
+            // 整页只排版一次，按经过的时间逐帧显示新出现的字符
+            if (!this->typewriteLines(introWin, wrappedLines, startLine, width)) {
+                skip = true;
             }
             
             if (skip) break;
@@ -5750,50 +5778,189 @@ void Game::updateViewport()
     }
 }
 // ====== 商店和皮肤持久化 ======
-const std::string PLAYER_PROFILE_FILE = "player_profile.dat";
+// ========== 竞技场模式 ==========
+
+void Game::initializeArena()
+{
+    // 优先使用自定义竞技场地图，否则生成一张 1000x1000 的默认地图
+    mPtrArenaMap.reset(new Map(mArenaMapSize, mArenaMapSize));
+    if (!mPtrArenaMap->loadMapFromFile(mArenaMapFile)) {
+        mPtrArenaMap->loadDefaultMap();
+    }
+
+    ArenaConfig config;
+    config.numSnakes = mArenaSnakeCount;
+    config.initialLength = mInitialSnakeLength;
+    config.seed = static_cast<unsigned int>(std::time(nullptr));
+    mPtrArena.reset(new Arena(*mPtrArenaMap, config));
+
+    mArenaFollowId = 0;
+    mArenaTicksPerFrame = 1;
+    mArenaTickMs = 0.0;
+    mPoints = 0;
+    mDelay = mBaseDelay;
+}
+
+void Game::renderArena() const
+{
+    // 只绘制视窗范围内的格子，渲染开销与竞技场规模无关
+    SnakeBody followHead = mPtrArena->getSnakeHead(mArenaFollowId);
+    for (int y = 1; y < mGameBoardHeight - 1; y++) {
+        for (int x = 1; x < mGameBoardWidth - 1; x++) {
+            int mapX = x + mViewOffsetX;
+            int mapY = y + mViewOffsetY;
+            int cell = mPtrArena->getCell(mapX, mapY);
+            if (cell == Arena::kWall) {
+                mvwaddch(mWindows[1], y, x, mWallSymbol);
+            } else if (cell == Arena::kFood) {
+                mvwaddch(mWindows[1], y, x, mFoodSymbol);
+            } else if (cell >= 0) {
+                SnakeBody head = mPtrArena->getSnakeHead(cell);
+                char symbol = (head.getX() == mapX && head.getY() == mapY) ? mSnakeSymbol : 'o';
+                if (cell == mArenaFollowId) {
+                    wattron(mWindows[1], COLOR_PAIR(1));
+                    mvwaddch(mWindows[1], y, x, symbol);
+                    wattroff(mWindows[1], COLOR_PAIR(1));
+                } else {
+                    mvwaddch(mWindows[1], y, x, symbol);
+                }
+            }
+        }
+    }
+    if (followHead.getX() < 0) {
+        mvwprintw(mWindows[1], 1, 1, "Snake #%d is respawning...", mArenaFollowId);
+    }
+}
+
+void Game::renderArenaStatus() const
+{
+    werase(mWindows[2]);
+    int row = 1;
+    mvwprintw(mWindows[2], row++, 1, "Arena");
+    mvwprintw(mWindows[2], row++, 2, "N: Next snake");
+    mvwprintw(mWindows[2], row++, 2, "P: Parallel");
+    mvwprintw(mWindows[2], row++, 2, "F: Fast x10");
+    mvwprintw(mWindows[2], row++, 2, "Q: Quit");
+    row++;
+    mvwprintw(mWindows[2], row++, 1, "Alive");
+    mvwprintw(mWindows[2], row++, 2, "%d/%d", mPtrArena->getAliveCount(), mPtrArena->getSnakeCount());
+    mvwprintw(mWindows[2], row++, 1, "Tick");
+    mvwprintw(mWindows[2], row++, 2, "%lld", mPtrArena->getTickCount());
+    mvwprintw(mWindows[2], row++, 1, "Tick cost");
+    mvwprintw(mWindows[2], row++, 2, "%.3f ms", mArenaTickMs);
+    mvwprintw(mWindows[2], row++, 1, "Parallel");
+    mvwprintw(mWindows[2], row++, 2, "%s", mPtrArena->isParallel() ? "on" : "off");
+    mvwprintw(mWindows[2], row++, 1, "Following");
+    mvwprintw(mWindows[2], row++, 2, "#%d len %d", mArenaFollowId, mPtrArena->getSnakeLength(mArenaFollowId));
+    mvwprintw(mWindows[2], row++, 1, "Score");
+    mvwprintw(mWindows[2], row++, 2, "%d", mPtrArena->getSnakeScore(mArenaFollowId));
+    box(mWindows[2], 0, 0);
+    wrefresh(mWindows[2]);
+}
+
+void Game::runArena()
+{
+    while (true)
+    {
+        int key = getch();
+        if (key == 'q' || key == 'Q' || key == 27) {
+            break;
+        } else if (key == 'n' || key == 'N') {
+            // 切换到下一条存活的蛇
+            int count = mPtrArena->getSnakeCount();
+            for (int i = 1; i <= count; i++) {
+                int id = (mArenaFollowId + i) % count;
+                if (mPtrArena->isAlive(id)) {
+                    mArenaFollowId = id;
+                    break;
+                }
+            }
+        } else if (key == 'p' || key == 'P') {
+            mPtrArena->setParallel(!mPtrArena->isParallel());
+        } else if (key == 'f' || key == 'F') {
+            mArenaTicksPerFrame = (mArenaTicksPerFrame == 1) ? 10 : 1;
+        }
+
+        auto tickStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < mArenaTicksPerFrame; i++) {
+            mPtrArena->step();
+        }
+        auto tickEnd = std::chrono::steady_clock::now();
+        mArenaTickMs = std::chrono::duration<double, std::milli>(tickEnd - tickStart).count() / mArenaTicksPerFrame;
+
+        // 视窗跟随当前观察的蛇
+        SnakeBody head = mPtrArena->getSnakeHead(mArenaFollowId);
+        if (head.getX() >= 0) {
+            int maxOffsetX = std::max(0, mPtrArena->getWidth() - mGameBoardWidth);
+            int maxOffsetY = std::max(0, mPtrArena->getHeight() - mGameBoardHeight);
+            mViewOffsetX = std::max(0, std::min(head.getX() - mGameBoardWidth / 2, maxOffsetX));
+            mViewOffsetY = std::max(0, std::min(head.getY() - mGameBoardHeight / 2, maxOffsetY));
+        }
+
+        // 记录所有蛇中的最高分作为本局成绩
+        for (int id = 0; id < mPtrArena->getSnakeCount(); id++) {
+            mPoints = std::max(mPoints, mPtrArena->getSnakeScore(id));
+        }
+
+        werase(mWindows[1]);
+        box(mWindows[1], 0, 0);
+        renderArena();
+        wrefresh(mWindows[1]);
+        renderArenaStatus();
 
+        std::this_thread::sleep_for(std::chrono::milliseconds(mDelay));
+        refresh();
+    }
+
+    mPtrArena.reset();
+    mPtrArenaMap.reset();
+}
+
+// 局内获得的金币先记在内存里，保存档案或购买时一起提交
 void Game::savePlayerProfile() const {
-    std::ofstream ofs(PLAYER_PROFILE_FILE, std::ios::binary);
-    if (!ofs) return;
-    ofs.write(reinterpret_cast<const char*>(&mCoins), sizeof(mCoins));
-    int skin = static_cast<int>(mCurrentSkin);
-    ofs.write(reinterpret_cast<const char*>(&skin), sizeof(skin));
-    int ownedCount = mOwnedSkins.size();
-    ofs.write(reinterpret_cast<const char*>(&ownedCount), sizeof(ownedCount));
+    ProfileStore::Transaction transaction;
+    transaction.set(ProfileKeys::kCoins, mCoins);
+    transaction.set(ProfileKeys::kCurrentSkin, static_cast<int>(mCurrentSkin));
     for (auto s : mOwnedSkins) {
-        int sval = static_cast<int>(s);
-        ofs.write(reinterpret_cast<const char*>(&sval), sizeof(sval));
+        transaction.set(ProfileKeys::ownedSkin(static_cast<int>(s)), 1);
     }
-    ofs.close();
+    ProfileStore::shared().commit(transaction);
 }
 
 void Game::loadPlayerProfile() {
-    std::ifstream ifs(PLAYER_PROFILE_FILE, std::ios::binary);
-    if (!ifs) return;
+    const ProfileStore& profile = ProfileStore::shared();
+    if (!profile.contains(ProfileKeys::kCoins)) return;
     mOwnedSkins.clear();
-    ifs.read(reinterpret_cast<char*>(&mCoins), sizeof(mCoins));
-    int skin = 0;
-    ifs.read(reinterpret_cast<char*>(&skin), sizeof(skin));
-    mCurrentSkin = static_cast<SnakeSkin>(skin);
-    int ownedCount = 0;
-    ifs.read(reinterpret_cast<char*>(&ownedCount), sizeof(ownedCount));
-    for (int i = 0; i < ownedCount; ++i) {
-        int sval = 0;
-        ifs.read(reinterpret_cast<char*>(&sval), sizeof(sval));
-        mOwnedSkins.insert(static_cast<SnakeSkin>(sval));
-    }
-    ifs.close();
+    mCoins = static_cast<int>(profile.get(ProfileKeys::kCoins));
+    mCurrentSkin = static_cast<SnakeSkin>(profile.get(ProfileKeys::kCurrentSkin));
+    const std::string prefix = ProfileKeys::kOwnedSkinPrefix;
+    for (const auto& kv : profile.scan(prefix)) {
+        if (kv.second > 0) {
+            mOwnedSkins.insert(static_cast<SnakeSkin>(std::stoi(kv.first.substr(prefix.size()))));
+        }
+    }
     // 确保基础皮肤一定拥有
     mOwnedSkins.insert(SnakeSkin::Default);
 }
 
-void Game::setSnakeSkin(SnakeSkin skin) { mCurrentSkin = skin; }
+void Game::setSnakeSkin(SnakeSkin skin) {
+    ProfileStore::Transaction transaction;
+    transaction.set(ProfileKeys::kCurrentSkin, static_cast<int>(skin));
+    if (ProfileStore::shared().commit(transaction)) {
+        mCurrentSkin = skin;
+    }
+}
 SnakeSkin Game::getSnakeSkin() const { return mCurrentSkin; }
 int Game::getCoins() const { return mCoins; }
 void Game::addCoins(int amount) { mCoins += amount; }
 bool Game::buySkin(SnakeSkin skin, int price) {
     if (mOwnedSkins.count(skin)) return false;
     if (mCoins < price) return false;
+    // 扣金币和获得皮肤是同一条日志记录，先落盘再改内存
+    ProfileStore::Transaction transaction;
+    transaction.set(ProfileKeys::kCoins, mCoins - price);
+    transaction.set(ProfileKeys::ownedSkin(static_cast<int>(skin)), 1);
+    if (!ProfileStore::shared().commit(transaction)) return false;
     mCoins -= price;
     mOwnedSkins.insert(skin);
     return true;
@@ -6078,39 +6245,30 @@ void Game::showShopMenu_Item() {
 }
 
 // ====== 道具持久化 ======
-const std::string ITEM_INVENTORY_FILE = "item_inventory.dat";
-
+// 局内拾取和消耗的道具先记在内存里，保存时一起提交
 void Game::saveItemInventory() const {
-    std::ofstream ofs(ITEM_INVENTORY_FILE, std::ios::binary);
-    if (!ofs) return;
-    int itemCount = mItemInventory.size();
-    ofs.write(reinterpret_cast<const char*>(&itemCount), sizeof(itemCount));
+    ProfileStore::Transaction transaction;
     for (const auto& kv : mItemInventory) {
-        int item = static_cast<int>(kv.first);
-        int count = kv.second;
-        ofs.write(reinterpret_cast<const char*>(&item), sizeof(item));
-        ofs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        transaction.set(ProfileKeys::item(static_cast<int>(kv.first)), kv.second);
     }
-    ofs.close();
+    ProfileStore::shared().commit(transaction);
 }
 
 void Game::loadItemInventory() {
-    std::ifstream ifs(ITEM_INVENTORY_FILE, std::ios::binary);
-    if (!ifs) return;
+    const std::string prefix = ProfileKeys::kItemPrefix;
     mItemInventory.clear();
-    int itemCount = 0;
-    ifs.read(reinterpret_cast<char*>(&itemCount), sizeof(itemCount));
-    for (int i = 0; i < itemCount; ++i) {
-        int item = 0, count = 0;
-        ifs.read(reinterpret_cast<char*>(&item), sizeof(item));
-        ifs.read(reinterpret_cast<char*>(&count), sizeof(count));
-        mItemInventory[static_cast<ItemType>(item)] = count;
+    for (const auto& kv : ProfileStore::shared().scan(prefix)) {
+        mItemInventory[static_cast<ItemType>(std::stoi(kv.first.substr(prefix.size())))] = static_cast<int>(kv.second);
     }
-    ifs.close();
 }
 
 bool Game::buyItem(ItemType item, int price) {
     if (mCoins < price) return false;
+    // 扣金币和道具加一是同一条日志记录，崩溃后不会出现只扣钱不给道具
+    ProfileStore::Transaction transaction;
+    transaction.set(ProfileKeys::kCoins, mCoins - price);
+    transaction.set(ProfileKeys::item(static_cast<int>(item)), getItemCount(item) + 1);
+    if (!ProfileStore::shared().commit(transaction)) return false;
     mCoins -= price;
     mItemInventory[item]++;
     return true;
@@ -6365,278 +6523,251 @@ void Game::handleFoodEffect(FoodType foodType) {
 
 // ====== 存档功能实现 ======
 
-void Game::saveGame() const {
-    std::ofstream ofs(mSaveFilePath, std::ios::binary);
-    if (!ofs) {
-        return;
-    }
-    
-    // 保存游戏模式
-    int currentMode = static_cast<int>(mCurrentMode);
-    ofs.write(reinterpret_cast<const char*>(&currentMode), sizeof(currentMode));
-    
-    // 保存当前关卡
-    ofs.write(reinterpret_cast<const char*>(&mCurrentLevel), sizeof(mCurrentLevel));
-    
-    // 保存分数
-    ofs.write(reinterpret_cast<const char*>(&mPoints), sizeof(mPoints));
-    ofs.write(reinterpret_cast<const char*>(&mPoints2), sizeof(mPoints2));
-    
-    // 保存生命值
-    int lives1 = mPtrSnake ? mPtrSnake->getLives() : mPlayerLives;
-    int lives2 = mPtrSnake2 ? mPtrSnake2->getLives() : mPlayer2Lives;
-    ofs.write(reinterpret_cast<const char*>(&lives1), sizeof(lives1));
-    ofs.write(reinterpret_cast<const char*>(&lives2), sizeof(lives2));
-    
-    // 保存蛇的状态
-    if (mPtrSnake) {
-        const auto& snake1 = mPtrSnake->getSnake();
-        int size1 = snake1.size();
-        ofs.write(reinterpret_cast<const char*>(&size1), sizeof(size1));
-        for (const auto& body : snake1) {
-            int x = body.getX();
-            int y = body.getY();
-            ofs.write(reinterpret_cast<const char*>(&x), sizeof(x));
-            ofs.write(reinterpret_cast<const char*>(&y), sizeof(y));
+void Game::captureSnapshot(GameSnapshot& snapshot) const {
+    auto toPoint = [](const SnakeBody& body) {
+        SavedPoint point;
+        point.x = body.getX();
+        point.y = body.getY();
+        return point;
+    };
+    auto toPoints = [&toPoint](const std::vector<SnakeBody>& bodies) {
+        std::vector<SavedPoint> points;
+        points.reserve(bodies.size());
+        for (const auto& body : bodies) {
+            points.push_back(toPoint(body));
         }
-        int dir1 = static_cast<int>(mPtrSnake->getDirection());
-        ofs.write(reinterpret_cast<const char*>(&dir1), sizeof(dir1));
+        return points;
+    };
+
+    snapshot.mode = static_cast<int32_t>(mCurrentMode);
+    snapshot.level = mCurrentLevel;
+    snapshot.points = mPoints;
+    snapshot.points2 = mPoints2;
+    snapshot.lives1 = mPtrSnake ? mPtrSnake->getLives() : mPlayerLives;
+    snapshot.lives2 = mPtrSnake2 ? mPtrSnake2->getLives() : mPlayer2Lives;
+
+    snapshot.hasSnake1 = mPtrSnake != nullptr;
+    if (mPtrSnake) {
+        snapshot.snake1 = toPoints(mPtrSnake->getSnake());
+        snapshot.direction1 = static_cast<int32_t>(mPtrSnake->getDirection());
     }
-    
+    snapshot.hasSnake2 = mPtrSnake2 != nullptr;
     if (mPtrSnake2) {
-        const auto& snake2 = mPtrSnake2->getSnake();
-        int size2 = snake2.size();
-        ofs.write(reinterpret_cast<const char*>(&size2), sizeof(size2));
-        for (const auto& body : snake2) {
-            int x = body.getX();
-            int y = body.getY();
-            ofs.write(reinterpret_cast<const char*>(&x), sizeof(x));
-            ofs.write(reinterpret_cast<const char*>(&y), sizeof(y));
-        }
-        int dir2 = static_cast<int>(mPtrSnake2->getDirection());
-        ofs.write(reinterpret_cast<const char*>(&dir2), sizeof(dir2));
-    }
-    
-    // 保存食物位置
-    int foodX = mFood.getX();
-    int foodY = mFood.getY();
-    ofs.write(reinterpret_cast<const char*>(&foodX), sizeof(foodX));
-    ofs.write(reinterpret_cast<const char*>(&foodY), sizeof(foodY));
-    
-    // 保存特殊食物状态
-    ofs.write(reinterpret_cast<const char*>(&mHasSpecialFood), sizeof(mHasSpecialFood));
+        snapshot.snake2 = toPoints(mPtrSnake2->getSnake());
+        snapshot.direction2 = static_cast<int32_t>(mPtrSnake2->getDirection());
+    }
+
+    snapshot.food = toPoint(mFood);
+    snapshot.hasSpecialFood = mHasSpecialFood;
+    snapshot.specialFood = toPoint(mSpecialFood);
+    snapshot.specialFoodType = static_cast<int32_t>(mCurrentFoodType);
+    snapshot.hasPoison = mHasPoison;
+    snapshot.poison = toPoint(mPoison);
+    snapshot.hasRandomItem = mHasRandomItem;
+    snapshot.randomItem = toPoint(mRandomItem);
+    snapshot.randomItemType = static_cast<int32_t>(mCurrentRandomItemType);
+    snapshot.corpseFoods = toPoints(mCorpseFoods);
+
+    snapshot.levelStatus.clear();
+    for (const auto& status : mLevelStatus) {
+        snapshot.levelStatus.push_back(static_cast<int32_t>(status));
+    }
+
+    snapshot.savedAtMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    snapshot.autosave = false;
+}
+
+void Game::applySnapshot(const GameSnapshot& snapshot) {
+    auto toBodies = [](const std::vector<SavedPoint>& points) {
+        std::vector<SnakeBody> bodies;
+        bodies.reserve(points.size());
+        for (const auto& point : points) {
+            bodies.push_back(SnakeBody(point.x, point.y));
+        }
+        return bodies;
+    };
+
+    mCurrentMode = static_cast<GameMode>(snapshot.mode);
+    mCurrentLevel = snapshot.level;
+    mPoints = snapshot.points;
+    mPoints2 = snapshot.points2;
+    mPlayerLives = snapshot.lives1;
+    mPlayer2Lives = snapshot.lives2;
+
+    // 与旧的读档逻辑一致：只恢复当前已经存在的蛇
+    if (mPtrSnake && snapshot.hasSnake1) {
+        mPtrSnake->getSnake() = toBodies(snapshot.snake1);
+        mPtrSnake->changeDirection(static_cast<Direction>(snapshot.direction1));
+        mPtrSnake->setLives(snapshot.lives1);
+    }
+    if (mPtrSnake2 && snapshot.hasSnake2) {
+        mPtrSnake2->getSnake() = toBodies(snapshot.snake2);
+        mPtrSnake2->changeDirection(static_cast<Direction>(snapshot.direction2));
+        mPtrSnake2->setLives(snapshot.lives2);
+    }
+
+    mFood = SnakeBody(snapshot.food.x, snapshot.food.y);
+    mHasSpecialFood = snapshot.hasSpecialFood;
     if (mHasSpecialFood) {
-        int specialX = mSpecialFood.getX();
-        int specialY = mSpecialFood.getY();
-        ofs.write(reinterpret_cast<const char*>(&specialX), sizeof(specialX));
-        ofs.write(reinterpret_cast<const char*>(&specialY), sizeof(specialY));
-        int foodType = static_cast<int>(mCurrentFoodType);
-        ofs.write(reinterpret_cast<const char*>(&foodType), sizeof(foodType));
+        mSpecialFood = SnakeBody(snapshot.specialFood.x, snapshot.specialFood.y);
+        mCurrentFoodType = static_cast<FoodType>(snapshot.specialFoodType);
     }
-    
-    // 保存毒药状态
-    ofs.write(reinterpret_cast<const char*>(&mHasPoison), sizeof(mHasPoison));
+    mHasPoison = snapshot.hasPoison;
     if (mHasPoison) {
-        int poisonX = mPoison.getX();
-        int poisonY = mPoison.getY();
-        ofs.write(reinterpret_cast<const char*>(&poisonX), sizeof(poisonX));
-        ofs.write(reinterpret_cast<const char*>(&poisonY), sizeof(poisonY));
+        mPoison = SnakeBody(snapshot.poison.x, snapshot.poison.y);
     }
-    
-    // 保存尸体食物
-    int corpseCount = mCorpseFoods.size();
-    ofs.write(reinterpret_cast<const char*>(&corpseCount), sizeof(corpseCount));
-    for (const auto& corpse : mCorpseFoods) {
-        int x = corpse.getX();
-        int y = corpse.getY();
-        ofs.write(reinterpret_cast<const char*>(&x), sizeof(x));
-        ofs.write(reinterpret_cast<const char*>(&y), sizeof(y));
-    }
-    
-    // 保存随机道具状态
-    ofs.write(reinterpret_cast<const char*>(&mHasRandomItem), sizeof(mHasRandomItem));
+    mCorpseFoods = toBodies(snapshot.corpseFoods);
+    mHasRandomItem = snapshot.hasRandomItem;
     if (mHasRandomItem) {
-        int itemX = mRandomItem.getX();
-        int itemY = mRandomItem.getY();
-        ofs.write(reinterpret_cast<const char*>(&itemX), sizeof(itemX));
-        ofs.write(reinterpret_cast<const char*>(&itemY), sizeof(itemY));
-        int itemType = static_cast<int>(mCurrentRandomItemType);
-        ofs.write(reinterpret_cast<const char*>(&itemType), sizeof(itemType));
+        mRandomItem = SnakeBody(snapshot.randomItem.x, snapshot.randomItem.y);
+        mCurrentRandomItemType = static_cast<ItemType>(snapshot.randomItemType);
     }
-    
-    // 保存关卡状态
-    int levelStatusSize = mLevelStatus.size();
-    ofs.write(reinterpret_cast<const char*>(&levelStatusSize), sizeof(levelStatusSize));
-    for (const auto& status : mLevelStatus) {
-        int statusVal = static_cast<int>(status);
-        ofs.write(reinterpret_cast<const char*>(&statusVal), sizeof(statusVal));
+
+    mLevelStatus.clear();
+    for (int32_t status : snapshot.levelStatus) {
+        mLevelStatus.push_back(static_cast<LevelStatus>(status));
+    }
+
+    // 同步食物信息给蛇
+    if (mPtrSnake) {
+        mPtrSnake->senseFood(mFood);
+        mPtrSnake->senseSpecialFood(mSpecialFood);
+        mPtrSnake->sensePoison(mPoison);
+        mPtrSnake->senseCorpseFoods(mCorpseFoods);
+        mPtrSnake->senseRandomItem(mRandomItem);
+    }
+    if (mPtrSnake2) {
+        mPtrSnake2->senseFood(mFood);
+        mPtrSnake2->senseSpecialFood(mSpecialFood);
+        mPtrSnake2->sensePoison(mPoison);
+        mPtrSnake2->senseCorpseFoods(mCorpseFoods);
+        mPtrSnake2->senseRandomItem(mRandomItem);
     }
-    
-    ofs.close();
 }
 
-bool Game::loadGame() {
-    std::ifstream ifs(mSaveFilePath, std::ios::binary);
-    if (!ifs) {
-        return false;
+void Game::saveGame() const {
+    // 游戏线程只拍快照，编码（带版本、段表和CRC32C）、写临时文件、fsync和rename都在后台线程完成
+    GameSnapshot snapshot;
+    captureSnapshot(snapshot);
+    mPtrSaveWorker->submit(mSaveFilePath, std::move(snapshot));
+}
+
+void Game::maybeAutosave() {
+    // 每帧只比较一次时间，真正拍快照的间隔是秒级
+    auto now = std::chrono::steady_clock::now();
+    if (now - mLastAutosaveTime < std::chrono::seconds(mAutosaveIntervalSeconds)) {
+        return;
     }
-    
-    try {
-        // 加载游戏模式
-        int currentMode;
-        ifs.read(reinterpret_cast<char*>(&currentMode), sizeof(currentMode));
-        mCurrentMode = static_cast<GameMode>(currentMode);
-        
-        // 加载当前关卡
-        ifs.read(reinterpret_cast<char*>(&mCurrentLevel), sizeof(mCurrentLevel));
-        
-        // 验证关卡值的有效性
-        if (mCurrentLevel < 1 || mCurrentLevel > mMaxLevel) {
-            mCurrentLevel = 1; // 如果关卡值无效，重置为1
-        }
-        
-        // 加载分数
-        ifs.read(reinterpret_cast<char*>(&mPoints), sizeof(mPoints));
-        ifs.read(reinterpret_cast<char*>(&mPoints2), sizeof(mPoints2));
-        
-        // 加载生命值
-        int lives1, lives2;
-        ifs.read(reinterpret_cast<char*>(&lives1), sizeof(lives1));
-        ifs.read(reinterpret_cast<char*>(&lives2), sizeof(lives2));
-        mPlayerLives = lives1;
-        mPlayer2Lives = lives2;
-        
-        // 加载蛇1的状态
-        if (mPtrSnake) {
-            int size1;
-            ifs.read(reinterpret_cast<char*>(&size1), sizeof(size1));
-            std::vector<SnakeBody> snake1;
-            for (int i = 0; i < size1; i++) {
-                int x, y;
-                ifs.read(reinterpret_cast<char*>(&x), sizeof(x));
-                ifs.read(reinterpret_cast<char*>(&y), sizeof(y));
-                snake1.push_back(SnakeBody(x, y));
-            }
-            mPtrSnake->getSnake() = snake1;
-            
-            int dir1;
-            ifs.read(reinterpret_cast<char*>(&dir1), sizeof(dir1));
-            mPtrSnake->changeDirection(static_cast<Direction>(dir1));
-            mPtrSnake->setLives(lives1);
-        }
-        
-        // 加载蛇2的状态
-        if (mPtrSnake2) {
-            int size2;
-            ifs.read(reinterpret_cast<char*>(&size2), sizeof(size2));
-            std::vector<SnakeBody> snake2;
-            for (int i = 0; i < size2; i++) {
-                int x, y;
-                ifs.read(reinterpret_cast<char*>(&x), sizeof(x));
-                ifs.read(reinterpret_cast<char*>(&y), sizeof(y));
-                snake2.push_back(SnakeBody(x, y));
-            }
-            mPtrSnake2->getSnake() = snake2;
-            
-            int dir2;
-            ifs.read(reinterpret_cast<char*>(&dir2), sizeof(dir2));
-            mPtrSnake2->changeDirection(static_cast<Direction>(dir2));
-            mPtrSnake2->setLives(lives2);
-        }
-        
-        // 加载食物位置
-        int foodX, foodY;
-        ifs.read(reinterpret_cast<char*>(&foodX), sizeof(foodX));
-        ifs.read(reinterpret_cast<char*>(&foodY), sizeof(foodY));
-        mFood = SnakeBody(foodX, foodY);
-        
-        // 加载特殊食物状态
-        ifs.read(reinterpret_cast<char*>(&mHasSpecialFood), sizeof(mHasSpecialFood));
-        if (mHasSpecialFood) {
-            int specialX, specialY;
-            ifs.read(reinterpret_cast<char*>(&specialX), sizeof(specialX));
-            ifs.read(reinterpret_cast<char*>(&specialY), sizeof(specialY));
-            mSpecialFood = SnakeBody(specialX, specialY);
-            
-            int foodType;
-            ifs.read(reinterpret_cast<char*>(&foodType), sizeof(foodType));
-            mCurrentFoodType = static_cast<FoodType>(foodType);
-        }
-        
-        // 加载毒药状态
-        ifs.read(reinterpret_cast<char*>(&mHasPoison), sizeof(mHasPoison));
-        if (mHasPoison) {
-            int poisonX, poisonY;
-            ifs.read(reinterpret_cast<char*>(&poisonX), sizeof(poisonX));
-            ifs.read(reinterpret_cast<char*>(&poisonY), sizeof(poisonY));
-            mPoison = SnakeBody(poisonX, poisonY);
-        }
-        
-        // 加载尸体食物
-        int corpseCount;
-        ifs.read(reinterpret_cast<char*>(&corpseCount), sizeof(corpseCount));
-        mCorpseFoods.clear();
-        for (int i = 0; i < corpseCount; i++) {
-            int x, y;
-            ifs.read(reinterpret_cast<char*>(&x), sizeof(x));
-            ifs.read(reinterpret_cast<char*>(&y), sizeof(y));
-            mCorpseFoods.push_back(SnakeBody(x, y));
-        }
-        
-        // 加载随机道具状态
-        ifs.read(reinterpret_cast<char*>(&mHasRandomItem), sizeof(mHasRandomItem));
-        if (mHasRandomItem) {
-            int itemX, itemY;
-            ifs.read(reinterpret_cast<char*>(&itemX), sizeof(itemX));
-            ifs.read(reinterpret_cast<char*>(&itemY), sizeof(itemY));
-            mRandomItem = SnakeBody(itemX, itemY);
-            
-            int itemType;
-            ifs.read(reinterpret_cast<char*>(&itemType), sizeof(itemType));
-            mCurrentRandomItemType = static_cast<ItemType>(itemType);
+    autosaveNow();
+}
+
+void Game::autosaveNow() {
+    GameSnapshot snapshot;
+    captureSnapshot(snapshot);
+    snapshot.autosave = true;
+    mPtrSaveWorker->submit(mAutosaveFilePath, std::move(snapshot));
+    mLastAutosaveTime = std::chrono::steady_clock::now();
+}
+
+void Game::clearAutosave() {
+    // 等排队中的自动存档写完再删，避免删除之后又被写回来
+    mPtrSaveWorker->flush();
+    std::remove(mAutosaveFilePath.c_str());
+    mLastAutosaveTime = std::chrono::steady_clock::now();
+}
+
+void Game::showSaveToast(const std::string& text, int durationMs) {
+    // 固定宽度，覆盖上一条提示的残留字符
+    const int toastWidth = 40;
+    std::string padded = text.substr(0, toastWidth);
+    padded.resize(toastWidth, ' ');
+    mvwprintw(mWindows[0], 4, 30, "%s", padded.c_str());
+    wrefresh(mWindows[0]);
+
+    mSaveToastText = text;
+    mSaveToastVisible = true;
+    mSaveToastExpire = std::chrono::steady_clock::now() + std::chrono::milliseconds(durationMs);
+}
+
+void Game::updateSaveToast() {
+    SaveWorker::Result result;
+    while (mPtrSaveWorker->poll(result)) {
+        if (result.path == mAutosaveFilePath) {
+            // 自动存档不打扰玩家
+            continue;
         }
-        
-        // 加载关卡状态
-        int levelStatusSize;
-        ifs.read(reinterpret_cast<char*>(&levelStatusSize), sizeof(levelStatusSize));
-        mLevelStatus.clear();
-        for (int i = 0; i < levelStatusSize; i++) {
-            int statusVal;
-            ifs.read(reinterpret_cast<char*>(&statusVal), sizeof(statusVal));
-            mLevelStatus.push_back(static_cast<LevelStatus>(statusVal));
+        showSaveToast(result.ok ? "Game Saved!" : "Save failed!", 2000);
+        // 两个耗时分开统计：落盘耗时来自后台线程，提示耗时从提交一直算到提示画出
+        mLastSaveWriteMs = result.writeMs;
+        mLastSaveVisibleMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - result.requested).count();
+        char text[96];
+        std::snprintf(text, sizeof(text), "save %s: disk %.1f ms, shown %.1f ms", result.ok ? "ok" : "failed",
+                      mLastSaveWriteMs, mLastSaveVisibleMs);
+        appendPerfLog(text);
+    }
+
+    if (mSaveToastVisible && std::chrono::steady_clock::now() >= mSaveToastExpire) {
+        mvwprintw(mWindows[0], 4, 30, "%40s", "");
+        wrefresh(mWindows[0]);
+        mSaveToastVisible = false;
+    }
+}
+
+bool Game::loadGame() {
+    // 先等还在排队的存档写完，读到的才是最新的
+    mPtrSaveWorker->flush();
+
+    SnapshotLimits limits;
+    limits.boardWidth = mGameBoardWidth;
+    limits.boardHeight = mGameBoardHeight;
+    limits.modeCount = static_cast<int>(GameMode::Arena) + 1;
+    limits.maxLevel = mMaxLevel;
+
+    // 手动存档和自动存档都先完整解码并校验，取其中较新的一个；
+    // 全部通过后才修改游戏状态，旧的裸格式在解码时迁移
+    const std::string paths[2] = {mSaveFilePath, mAutosaveFilePath};
+    GameSnapshot best;
+    bool found = false;
+    std::string error = "no save file";
+    for (const std::string& path : paths) {
+        std::vector<uint8_t> buffer;
+        if (!SaveFormat::readFile(path, buffer)) {
+            continue;
         }
-        
-        // 同步食物信息给蛇
-        if (mPtrSnake) {
-            mPtrSnake->senseFood(mFood);
-            mPtrSnake->senseSpecialFood(mSpecialFood);
-            mPtrSnake->sensePoison(mPoison);
-            mPtrSnake->senseCorpseFoods(mCorpseFoods);
-            mPtrSnake->senseRandomItem(mRandomItem);
+        GameSnapshot snapshot;
+        std::string decodeError;
+        if (!SaveFormat::decode(buffer, limits, snapshot, decodeError)) {
+            error = decodeError;
+            continue;
         }
-        if (mPtrSnake2) {
-            mPtrSnake2->senseFood(mFood);
-            mPtrSnake2->senseSpecialFood(mSpecialFood);
-            mPtrSnake2->sensePoison(mPoison);
-            mPtrSnake2->senseCorpseFoods(mCorpseFoods);
-            mPtrSnake2->senseRandomItem(mRandomItem);
+        if (!found || snapshot.savedAtMs > best.savedAtMs) {
+            best = std::move(snapshot);
+            found = true;
         }
-        
-        ifs.close();
-        return true;
-    } catch (...) {
-        ifs.close();
+    }
+    if (!found) {
+        mSaveError = error;
         return false;
     }
+
+    applySnapshot(best);
+    mSaveError.clear();
+    return true;
 }
 
 bool Game::hasSaveFile() const {
+    mPtrSaveWorker->flush();
     std::ifstream ifs(mSaveFilePath, std::ios::binary);
-    return ifs.good();
+    std::ifstream autosave(mAutosaveFilePath, std::ios::binary);
+    return ifs.good() || autosave.good();
 }
 
 void Game::deleteSaveFile() const {
+    mPtrSaveWorker->flush();
     std::remove(mSaveFilePath.c_str());
+    std::remove(mAutosaveFilePath.c_str());
 }
 
 // 新增：设置游戏模式
@@ -6649,6 +6780,9 @@ void Game::startLevelDirectly(int level) {
     // 设置关卡模式
     mCurrentMode = GameMode::Level;
     mCurrentLevel = level;
+    mReturnToModeSelect = false;
+    // Qt一侧可能已经通关并解锁了关卡，以档案中的进度为准
+    this->loadLevelProgress();
     
     // 初始化ncurses环境
     nodelay(stdscr, TRUE);
@@ -6662,6 +6796,7 @@ void Game::startLevelDirectly(int level) {
     while (true) {
         // 初始化并运行当前关卡
         this->initializeLevel(mCurrentLevel);
+        this->autosaveNow(); // 关卡开始时的检查点
         this->runLevel();
         
         // 检查是否通过当前关卡
@@ -6669,6 +6804,8 @@ void Game::startLevelDirectly(int level) {
             // 标记当前关卡为已完成
             this->mLevelStatus[mCurrentLevel - 1] = LevelStatus::Completed;
             
+            // 叙述播放期间在后台准备下一关
+            this->preloadLevel(mCurrentLevel + 1);
             // 显示通关后的文字叙述
             this->displayLevelCompletion(mCurrentLevel);
             
@@ -6679,6 +6816,7 @@ void Game::startLevelDirectly(int level) {
             
             // 保存关卡进度
             this->saveLevelProgress();
+            this->autosaveNow(); // 通关检查点
             
             // 显示通关信息和选择菜单
             WINDOW* levelCompleteWin;
@@ -0,0 +1,467 @@
+#include "leaderboard_store.h"
+#include "save_format.h"
+#include "save_worker.h"
+
+#include <algorithm>
+#include <functional>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    // 索引文件头和记录、日志文件头都按主机字节序（小端）直接写入
+    struct IndexHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t count;
+        uint32_t crc;           // 覆盖全部记录
+        uint64_t appliedSeq;    // 已合并进本索引的最大日志序号
+        uint64_t reserved;
+    };
+    static_assert(sizeof(IndexHeader) == 32, "IndexHeader must stay 32 bytes");
+
+    struct IndexRecord
+    {
+        int32_t score;
+        int32_t length;
+        int32_t durationMs;
+        uint32_t reserved;
+        int64_t timestamp;
+        uint64_t replayId;
+    };
+    static_assert(sizeof(IndexRecord) == 32, "IndexRecord must stay 32 bytes");
+
+    const uint32_t kIndexMagic = 0x5849424C; // "LBIX"
+    const uint32_t kLogMagic = 0x474C424C;   // "LBLG"
+    const uint16_t kFormatVersion = 1;
+    const size_t kMaxNameLength = 255;
+
+    // 分数高的在前，同分时先达成的在前
+    bool ranksBefore(const LeaderboardEntry& a, const LeaderboardEntry& b)
+    {
+        if (a.score != b.score)
+        {
+            return a.score > b.score;
+        }
+        return a.timestamp < b.timestamp;
+    }
+
+    IndexRecord toRecord(const LeaderboardEntry& entry)
+    {
+        IndexRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.score = entry.score;
+        record.length = entry.length;
+        record.durationMs = entry.durationMs;
+        record.timestamp = entry.timestamp;
+        record.replayId = entry.replayId;
+        return record;
+    }
+
+    LeaderboardEntry fromRecord(const IndexRecord& record)
+    {
+        LeaderboardEntry entry;
+        entry.score = record.score;
+        entry.length = record.length;
+        entry.durationMs = record.durationMs;
+        entry.timestamp = record.timestamp;
+        entry.replayId = record.replayId;
+        return entry;
+    }
+
+    template <typename T>
+    void appendPod(std::vector<uint8_t>& buffer, const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    // 日志载荷：名字长度 u16 | 榜单名 | IndexRecord
+    std::vector<uint8_t> encodeLogPayload(const std::string& name, const LeaderboardEntry& entry)
+    {
+        std::vector<uint8_t> payload;
+        payload.reserve(sizeof(uint16_t) + name.size() + sizeof(IndexRecord));
+        appendPod(payload, static_cast<uint16_t>(name.size()));
+        payload.insert(payload.end(), name.begin(), name.end());
+        appendPod(payload, toRecord(entry));
+        return payload;
+    }
+}
+
+std::string LeaderboardKey::name() const
+{
+    std::string safeMap = map.empty() ? std::string("default") : map;
+    for (char& c : safeMap)
+    {
+        const bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                          c == '.' || c == '-' || c == '_';
+        if (!keep)
+        {
+            c = '_';
+        }
+    }
+    std::string result = "m" + std::to_string(mode) + "_" + safeMap + "_l" + std::to_string(level);
+    if (result.size() > kMaxNameLength)
+    {
+        result.resize(kMaxNameLength);
+    }
+    return result;
+}
+
+LeaderboardStore::LeaderboardStore(const std::string& directory) : mDirectory(directory)
+{
+}
+
+LeaderboardStore::~LeaderboardStore()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLog.isOpen())
+    {
+        flushLocked();
+        mLog.close();
+    }
+    for (auto& item : mBoards)
+    {
+        unmapIndex(item.second.index);
+    }
+}
+
+bool LeaderboardStore::open()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::error_code error;
+    std::filesystem::create_directories(mDirectory, error);
+    if (error)
+    {
+        mLastError = mDirectory + ": " + error.message();
+        return false;
+    }
+    using namespace std::placeholders;
+    if (!mLog.open(logPath(), kLogMagic, std::bind(&LeaderboardStore::replayRecord, this, _1, _2, _3)))
+    {
+        mLastError = mLog.getLastError();
+        return false;
+    }
+    // 日志丢失或被重建时序号会从头开始，要接在所有索引已合并的序号之后，
+    // 否则新成绩的序号不大于某个索引的 appliedSeq，下次打开时重放会把它当成已合并而丢掉
+    uint64_t appliedSeq = 0;
+    for (const auto& item : std::filesystem::directory_iterator(mDirectory, error))
+    {
+        if (item.path().extension() == ".lbi")
+        {
+            appliedSeq = std::max(appliedSeq, board(item.path().stem().string()).index.appliedSeq);
+        }
+    }
+    mLog.raiseNextSeq(appliedSeq + 1);
+    return true;
+}
+
+bool LeaderboardStore::insert(const LeaderboardKey& key, const LeaderboardEntry& entry)
+{
+    return insert(std::vector<std::pair<LeaderboardKey, LeaderboardEntry>>{{key, entry}});
+}
+
+bool LeaderboardStore::insert(const std::vector<std::pair<LeaderboardKey, LeaderboardEntry>>& entries)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<std::string> names;
+    std::vector<std::vector<uint8_t>> payloads;
+    names.reserve(entries.size());
+    payloads.reserve(entries.size());
+    for (const auto& item : entries)
+    {
+        names.push_back(item.first.name());
+        payloads.push_back(encodeLogPayload(names.back(), item.second));
+    }
+    // 先落盘再进入内存，失败时内存状态不变
+    uint64_t seq = 0;
+    if (!mLog.append(payloads, &seq))
+    {
+        mLastError = mLog.getLastError();
+        return false;
+    }
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        Board& state = board(names[i]);
+        const LeaderboardEntry& entry = entries[i].second;
+        state.pending.insert(std::upper_bound(state.pending.begin(), state.pending.end(), entry, ranksBefore), entry);
+        state.pendingMaxSeq = seq++;
+        mPendingCount++;
+    }
+    if (mPendingCount >= kMergeThreshold)
+    {
+        return flushLocked();
+    }
+    return true;
+}
+
+bool LeaderboardStore::flush()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return flushLocked();
+}
+
+std::vector<LeaderboardEntry> LeaderboardStore::topK(const LeaderboardKey& key, size_t k)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Board& state = board(key.name());
+
+    // 索引和待合并列表都已排好序，只需归并各自的前k条
+    std::vector<LeaderboardEntry> result;
+    result.reserve(std::min(k, state.index.count + state.pending.size()));
+    size_t i = 0;
+    size_t j = 0;
+    while (result.size() < k && (i < state.index.count || j < state.pending.size()))
+    {
+        if (j >= state.pending.size())
+        {
+            result.push_back(indexEntry(state.index, i++));
+            continue;
+        }
+        if (i < state.index.count)
+        {
+            LeaderboardEntry fromIndex = indexEntry(state.index, i);
+            if (!ranksBefore(state.pending[j], fromIndex))
+            {
+                result.push_back(fromIndex);
+                i++;
+                continue;
+            }
+        }
+        result.push_back(state.pending[j++]);
+    }
+    return result;
+}
+
+size_t LeaderboardStore::rankOf(const LeaderboardKey& key, int32_t score)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Board& state = board(key.name());
+
+    // 索引按分数降序，二分找到第一条分数不高于 score 的记录
+    size_t low = 0;
+    size_t high = state.index.count;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if (indexEntry(state.index, middle).score > score)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    auto pendingEnd = std::partition_point(state.pending.begin(), state.pending.end(),
+                                           [score](const LeaderboardEntry& entry) { return entry.score > score; });
+    return low + static_cast<size_t>(pendingEnd - state.pending.begin());
+}
+
+size_t LeaderboardStore::size(const LeaderboardKey& key)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Board& state = board(key.name());
+    return state.index.count + state.pending.size();
+}
+
+const std::string& LeaderboardStore::getLastError() const
+{
+    return mLastError;
+}
+
+LeaderboardStore::Board& LeaderboardStore::board(const std::string& name)
+{
+    Board& state = mBoards[name];
+    if (!state.loaded)
+    {
+        loadIndex(name, state.index);
+        state.loaded = true;
+    }
+    return state;
+}
+
+bool LeaderboardStore::loadIndex(const std::string& name, Index& index)
+{
+    const std::string path = indexPath(name);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        // 还没有合并过的榜单没有索引文件
+        return errno == ENOENT;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(IndexHeader)))
+    {
+        ::close(fd);
+        mLastError = path + ": truncated index";
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        mLastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+    IndexHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const bool valid = header.magic == kIndexMagic && header.version == kFormatVersion &&
+                       header.recordSize == sizeof(IndexRecord) &&
+                       size == sizeof(IndexHeader) + static_cast<size_t>(header.count) * sizeof(IndexRecord) &&
+                       SaveFormat::crc32c(data + sizeof(IndexHeader), size - sizeof(IndexHeader)) == header.crc;
+    if (!valid)
+    {
+        ::munmap(mapped, size);
+        mLastError = path + ": corrupt index";
+        return false;
+    }
+
+    index.data = data;
+    index.mappedSize = size;
+    index.count = header.count;
+    index.appliedSeq = header.appliedSeq;
+    return true;
+}
+
+void LeaderboardStore::unmapIndex(Index& index)
+{
+    if (index.data != nullptr)
+    {
+        ::munmap(const_cast<uint8_t*>(index.data), index.mappedSize);
+    }
+    index = Index();
+}
+
+LeaderboardEntry LeaderboardStore::indexEntry(const Index& index, size_t i) const
+{
+    IndexRecord record;
+    std::memcpy(&record, index.data + sizeof(IndexHeader) + i * sizeof(IndexRecord), sizeof(record));
+    return fromRecord(record);
+}
+
+bool LeaderboardStore::mergeBoard(const std::string& name, Board& state)
+{
+    const size_t total = state.index.count + state.pending.size();
+    std::vector<uint8_t> buffer(sizeof(IndexHeader));
+    buffer.reserve(sizeof(IndexHeader) + total * sizeof(IndexRecord));
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < state.index.count || j < state.pending.size())
+    {
+        if (j < state.pending.size() &&
+            (i >= state.index.count || ranksBefore(state.pending[j], indexEntry(state.index, i))))
+        {
+            appendPod(buffer, toRecord(state.pending[j++]));
+        }
+        else
+        {
+            appendPod(buffer, toRecord(indexEntry(state.index, i++)));
+        }
+    }
+
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kIndexMagic;
+    header.version = kFormatVersion;
+    header.recordSize = sizeof(IndexRecord);
+    header.count = static_cast<uint32_t>(total);
+    header.crc = SaveFormat::crc32c(buffer.data() + sizeof(IndexHeader), buffer.size() - sizeof(IndexHeader));
+    header.appliedSeq = std::max(state.index.appliedSeq, state.pendingMaxSeq);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    if (!SaveWorker::writeAtomic(indexPath(name), buffer))
+    {
+        mLastError = indexPath(name) + ": write failed";
+        return false;
+    }
+    unmapIndex(state.index);
+    if (!loadIndex(name, state.index))
+    {
+        return false;
+    }
+    mPendingCount -= state.pending.size();
+    state.pending.clear();
+    state.pendingMaxSeq = 0;
+    return true;
+}
+
+bool LeaderboardStore::flushLocked()
+{
+    if (!mLog.isOpen())
+    {
+        return false;
+    }
+    if (mPendingCount == 0 && !mLog.hasRecords())
+    {
+        return true;
+    }
+    bool ok = true;
+    for (auto& item : mBoards)
+    {
+        if (!item.second.pending.empty())
+        {
+            ok = mergeBoard(item.first, item.second) && ok;
+        }
+    }
+    // 有榜单没合并成功时保留日志，下次打开时重放
+    if (ok && !mLog.reset())
+    {
+        mLastError = mLog.getLastError();
+        return false;
+    }
+    return ok;
+}
+
+void LeaderboardStore::replayRecord(uint64_t seq, const uint8_t* payload, size_t size)
+{
+    uint16_t nameLength = 0;
+    if (size < sizeof(nameLength) + sizeof(IndexRecord))
+    {
+        return;
+    }
+    std::memcpy(&nameLength, payload, sizeof(nameLength));
+    if (size != sizeof(nameLength) + nameLength + sizeof(IndexRecord))
+    {
+        return;
+    }
+    const std::string name(reinterpret_cast<const char*>(payload + sizeof(nameLength)), nameLength);
+    if (name.empty() || name.find('/') != std::string::npos || name[0] == '.')
+    {
+        return;
+    }
+    IndexRecord record;
+    std::memcpy(&record, payload + sizeof(nameLength) + nameLength, sizeof(record));
+
+    // 已经合并进索引的记录跳过
+    Board& state = board(name);
+    if (seq > state.index.appliedSeq)
+    {
+        const LeaderboardEntry entry = fromRecord(record);
+        state.pending.insert(std::upper_bound(state.pending.begin(), state.pending.end(), entry, ranksBefore), entry);
+        state.pendingMaxSeq = std::max(state.pendingMaxSeq, seq);
+        mPendingCount++;
+    }
+}
+
+std::string LeaderboardStore::indexPath(const std::string& name) const
+{
+    return mDirectory + "/" + name + ".lbi";
+}
+
+std::string LeaderboardStore::logPath() const
+{
+    return mDirectory + "/leaderboard.log";
+}
@@ -0,0 +1,99 @@
+#include "level_preloader.h"
+
+#include <fstream>
+
+LevelPreloader::LevelPreloader()
+{
+}
+
+LevelPreloader::~LevelPreloader()
+{
+    join();
+}
+
+void LevelPreloader::start(int level, const std::string& mapPath, int width, int height,
+                           int snakeLength, const std::vector<int>& spawnSpaces)
+{
+    cancel();
+    mLevel = level;
+    mMapPath = mapPath;
+    mWidth = width;
+    mHeight = height;
+    mThread = std::thread(&LevelPreloader::run, this, snakeLength, spawnSpaces);
+}
+
+std::unique_ptr<Map> LevelPreloader::take(int level, const std::string& mapPath, int width, int height)
+{
+    mLastWaitMs = 0.0;
+    if (mLevel == 0)
+    {
+        return nullptr;
+    }
+    Clock::time_point waitStart = Clock::now();
+    join();
+    mLastWaitMs = std::chrono::duration<double, std::milli>(Clock::now() - waitStart).count();
+
+    std::unique_ptr<Map> map;
+    if (level == mLevel && mapPath == mMapPath && width == mWidth && height == mHeight)
+    {
+        map = std::move(mMap);
+        mLastLoadMs = mLoadMs;
+    }
+    cancel();
+    return map;
+}
+
+void LevelPreloader::cancel()
+{
+    join();
+    mMap.reset();
+    mLevel = 0;
+    mMapPath.clear();
+}
+
+double LevelPreloader::getLastWaitMs() const
+{
+    return mLastWaitMs;
+}
+
+double LevelPreloader::getLastLoadMs() const
+{
+    return mLastLoadMs;
+}
+
+std::unique_ptr<Map> LevelPreloader::loadLevelMap(const std::string& mapPath, int width, int height)
+{
+    std::unique_ptr<Map> map(new Map(width, height));
+    std::ifstream mapFile(mapPath);
+    if (mapFile.good())
+    {
+        mapFile.close();
+        map->loadMapFromFile(mapPath);
+    }
+    else
+    {
+        map->loadDefaultMap();
+    }
+    return map;
+}
+
+void LevelPreloader::run(int snakeLength, std::vector<int> spawnSpaces)
+{
+    Clock::time_point start = Clock::now();
+    std::unique_ptr<Map> map = loadLevelMap(mMapPath, mWidth, mHeight);
+    // 出生点表缓存在 Map 里，游戏线程初始化蛇时直接命中
+    for (int space : spawnSpaces)
+    {
+        map->getValidSnakePositions(snakeLength, space);
+    }
+    mMap = std::move(map);
+    mLoadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void LevelPreloader::join()
+{
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
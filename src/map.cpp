@@ -1,7 +1,170 @@
 #include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
 #include "map.h"
+#include "mapped_file.h"
+#include "save_format.h"
 
-Map::Map(int width, int height) : mWidth(width), mHeight(height)
+namespace
+{
+    // .smap 文件布局（主机字节序，即小端）：
+    //   文件头   固定64字节，见下
+    //   瓦片     W*H 个字节，行优先，取值同 TileType
+    //   墙体位图 按8字节对齐，每行 (W+63)/64 个64位字，与 Bitboard 的内存布局一致
+    // CRC32C覆盖整个文件（计算时CRC字段视为0）
+    struct CompiledMapHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t totalSize;
+        uint32_t crc;
+        uint32_t width;
+        uint32_t height;
+        uint32_t tilesOffset;
+        uint32_t tilesSize;
+        uint32_t wallBitsOffset;
+        uint32_t wallBitsSize;
+        uint32_t wallCount;         // 墙格总数
+        uint32_t freeCellCount;     // 内部区域中的非墙格子数
+        uint32_t reserved[4];
+    };
+    static_assert(sizeof(CompiledMapHeader) == 64, "CompiledMapHeader must stay 64 bytes");
+
+    const uint32_t kCompiledMapMagic = 0x50414D53; // "SMAP"
+    const uint16_t kCompiledMapVersion = 1;
+    const int kMaxMapSide = 1000;
+
+    // 文本地图扫描器：直接在映射的缓冲区上用from_chars读整数，只有出错时才回头数行列号
+    class TextMapScanner
+    {
+    public:
+        TextMapScanner(const char* begin, const char* end) : mBegin(begin), mPos(begin), mEnd(end), mToken(begin)
+        {
+        }
+
+        // 跳过空白后读一个整数，失败时 error 为 "行:列: 原因"
+        bool readInt(int& value, const char* what, std::string& error)
+        {
+            skipWhitespace();
+            mToken = mPos;
+            if (mPos == mEnd)
+            {
+                error = location() + ": unexpected end of file, expected " + what;
+                return false;
+            }
+            // 瓦片几乎都是单个数字，先走快路径
+            if (isDigit(*mPos) && (mPos + 1 == mEnd || isWhitespace(mPos[1])))
+            {
+                value = *mPos - '0';
+                mPos++;
+                return true;
+            }
+            const std::from_chars_result result = std::from_chars(mPos, mEnd, value);
+            if (result.ec == std::errc::result_out_of_range)
+            {
+                error = location() + ": " + what + " out of range";
+                return false;
+            }
+            if (result.ec != std::errc() || (result.ptr != mEnd && !isWhitespace(*result.ptr)))
+            {
+                error = location() + ": expected " + what + ", found '" + tokenText() + "'";
+                return false;
+            }
+            mPos = result.ptr;
+            return true;
+        }
+
+        // 只剩空白
+        bool atEnd()
+        {
+            skipWhitespace();
+            mToken = mPos;
+            return mPos == mEnd;
+        }
+
+        // 当前记号的位置，行列号从1开始
+        std::string location() const
+        {
+            int line = 1;
+            const char* lineStart = mBegin;
+            for (const char* p = mBegin; p < mToken; p++)
+            {
+                if (*p == '\n')
+                {
+                    line++;
+                    lineStart = p + 1;
+                }
+            }
+            return std::to_string(line) + ":" + std::to_string(mToken - lineStart + 1);
+        }
+
+    private:
+        static bool isDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static bool isWhitespace(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        void skipWhitespace()
+        {
+            while (mPos < mEnd && isWhitespace(*mPos))
+            {
+                mPos++;
+            }
+        }
+
+        std::string tokenText() const
+        {
+            const char* end = mToken;
+            while (end < mEnd && !isWhitespace(*end) && end - mToken < 16)
+            {
+                end++;
+            }
+            return std::string(mToken, end);
+        }
+
+        const char* mBegin;
+        const char* mPos;
+        const char* mEnd;
+        const char* mToken;     // 最近一次读取的记号起点，用于报错
+    };
+
+    bool endsWith(const std::string& text, const std::string& suffix)
+    {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // .smap 存在且不旧于文本文件（文本文件不存在也算）
+    bool isCompiledMapFresh(const std::string& compiled, const std::string& source)
+    {
+        struct stat compiledStat;
+        if (::stat(compiled.c_str(), &compiledStat) != 0)
+        {
+            return false;
+        }
+        struct stat sourceStat;
+        if (::stat(source.c_str(), &sourceStat) != 0)
+        {
+            return true;
+        }
+        if (compiledStat.st_mtim.tv_sec != sourceStat.st_mtim.tv_sec)
+        {
+            return compiledStat.st_mtim.tv_sec > sourceStat.st_mtim.tv_sec;
+        }
+        return compiledStat.st_mtim.tv_nsec >= sourceStat.st_mtim.tv_nsec;
+    }
+}
+
+Map::Map(int width, int height) : mWidth(width), mHeight(height), mFreeCellCount(0)
 {
     initializeEmptyMap();
 }
@@ -12,25 +175,25 @@ Map::~Map()
 
 void Map::initializeEmptyMap()
 {
-    mTiles.resize(mHeight);
+    mTiles.assign(static_cast<size_t>(mWidth) * mHeight, TileType::Empty);
     for (int y = 0; y < mHeight; y++)
     {
-        mTiles[y].resize(mWidth, TileType::Empty);
-        
         // Set borders as walls
         if (y == 0 || y == mHeight - 1)
         {
             for (int x = 0; x < mWidth; x++)
             {
-                mTiles[y][x] = TileType::Wall;
+                tileAt(x, y) = TileType::Wall;
             }
         }
         else
         {
-            mTiles[y][0] = TileType::Wall;
-            mTiles[y][mWidth - 1] = TileType::Wall;
+            tileAt(0, y) = TileType::Wall;
+            tileAt(mWidth - 1, y) = TileType::Wall;
         }
     }
+    
+    rebuildWallBits();
 }
 
 void Map::loadDefaultMap()
@@ -48,7 +211,7 @@ void Map::loadDefaultMap()
         int y = centerY - 5;
         if (x > 0 && x < mWidth - 1 && y > 0 && y < mHeight - 1)
         {
-            mTiles[y][x] = TileType::Wall;
+            tileAt(x, y) = TileType::Wall;
         }
     }
     
@@ -59,43 +222,83 @@ void Map::loadDefaultMap()
         int y = centerY + 5;
         if (x > 0 && x < mWidth - 1 && y > 0 && y < mHeight - 1)
         {
-            mTiles[y][x] = TileType::Wall;
+            tileAt(x, y) = TileType::Wall;
         }
     }
+    
+    rebuildWallBits();
 }
 
 bool Map::loadMapFromFile(const std::string& filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    const std::string compiled = compiledMapPath(filename);
+    if (compiled == filename)
+    {
+        return loadCompiledMap(filename);
+    }
+    if (isCompiledMapFresh(compiled, filename) && loadCompiledMap(compiled))
+    {
+        return true;
+    }
+    return loadTextMap(filename);
+}
+
+bool Map::loadTextMap(const std::string& filename)
+{
+    MappedFile file;
+    if (!file.open(filename, mLastError))
     {
         return false;
     }
-    
-    int width, height;
-    file >> width >> height;
-    
-    if (width <= 0 || height <= 0 || width > 1000 || height > 1000)
+
+    const char* begin = reinterpret_cast<const char*>(file.data());
+    TextMapScanner scanner(begin, begin + file.size());
+    int width = 0;
+    int height = 0;
+    if (!scanner.readInt(width, "map width", mLastError) ||
+        !scanner.readInt(height, "map height", mLastError))
     {
+        mLastError = filename + ":" + mLastError;
         return false;
     }
-    
-    mWidth = width;
-    mHeight = height;
-    
-    mTiles.resize(mHeight);
-    for (int y = 0; y < mHeight; y++)
+    if (width <= 0 || height <= 0 || width > kMaxMapSide || height > kMaxMapSide)
     {
-        mTiles[y].resize(mWidth);
-        for (int x = 0; x < mWidth; x++)
+        mLastError = filename + ":1:1: map size " + std::to_string(width) + "x" + std::to_string(height) +
+                     " out of range (1.." + std::to_string(kMaxMapSide) + ")";
+        return false;
+    }
+
+    // 先解析到临时数组，全部合法后才替换当前地图
+    std::vector<TileType> tiles(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < tiles.size(); i++)
+    {
+        int tileValue = 0;
+        if (!scanner.readInt(tileValue, "tile value", mLastError))
         {
-            int tileValue;
-            file >> tileValue;
-            mTiles[y][x] = static_cast<TileType>(tileValue);
+            mLastError = filename + ":" + mLastError + " (tile " + std::to_string(i) + " of " +
+                         std::to_string(tiles.size()) + ")";
+            return false;
+        }
+        if (tileValue < static_cast<int>(TileType::Empty) || tileValue > static_cast<int>(TileType::Food))
+        {
+            mLastError = filename + ":" + scanner.location() + ": invalid tile value " +
+                         std::to_string(tileValue) + " (expected 0, 1 or 2)";
+            return false;
         }
+        tiles[i] = static_cast<TileType>(tileValue);
     }
-    
-    file.close();
+    if (!scanner.atEnd())
+    {
+        mLastError = filename + ":" + scanner.location() + ": unexpected data after " +
+                     std::to_string(tiles.size()) + " tiles";
+        return false;
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mTiles.swap(tiles);
+    rebuildWallBits();
+    mLastError.clear();
     return true;
 }
 
@@ -113,7 +316,7 @@ bool Map::saveMapToFile(const std::string& filename)
     {
         for (int x = 0; x < mWidth; x++)
         {
-            file << static_cast<int>(mTiles[y][x]) << " ";
+            file << static_cast<int>(tileAt(x, y)) << " ";
         }
         file << std::endl;
     }
@@ -122,20 +325,154 @@ bool Map::saveMapToFile(const std::string& filename)
     return true;
 }
 
+bool Map::loadCompiledMap(const std::string& filename)
+{
+    MappedFile file;
+    if (!file.open(filename, mLastError))
+    {
+        return false;
+    }
+    if (!loadCompiledBuffer(file.data(), file.size()))
+    {
+        mLastError = filename + ": not a valid compiled map (bad header, size or checksum)";
+        return false;
+    }
+    mLastError.clear();
+    return true;
+}
+
+bool Map::loadCompiledBuffer(const uint8_t* data, size_t size)
+{
+    if (size < sizeof(CompiledMapHeader))
+    {
+        return false;
+    }
+    CompiledMapHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kCompiledMapMagic || header.version != kCompiledMapVersion ||
+        header.headerSize != sizeof(CompiledMapHeader) || header.totalSize != size)
+    {
+        return false;
+    }
+    if (header.width == 0 || header.height == 0 ||
+        header.width > static_cast<uint32_t>(kMaxMapSide) || header.height > static_cast<uint32_t>(kMaxMapSide))
+    {
+        return false;
+    }
+
+    const size_t width = header.width;
+    const size_t height = header.height;
+    const size_t wordsPerRow = (width + 63) / 64;
+    if (header.tilesSize != width * height || header.wallBitsSize != wordsPerRow * height * sizeof(uint64_t) ||
+        header.tilesOffset < header.headerSize || header.wallBitsOffset % sizeof(uint64_t) != 0 ||
+        static_cast<size_t>(header.tilesOffset) + header.tilesSize > size ||
+        static_cast<size_t>(header.wallBitsOffset) + header.wallBitsSize > size ||
+        header.wallCount > width * height || header.freeCellCount > width * height)
+    {
+        return false;
+    }
+
+    CompiledMapHeader crcHeader = header;
+    crcHeader.crc = 0;
+    uint32_t crc = SaveFormat::crc32c(reinterpret_cast<const uint8_t*>(&crcHeader), sizeof(crcHeader));
+    crc = SaveFormat::crc32c(data + sizeof(header), size - sizeof(header), crc);
+    if (crc != header.crc)
+    {
+        return false;
+    }
+
+    // 校验全部通过后才改动地图
+    mWidth = static_cast<int>(width);
+    mHeight = static_cast<int>(height);
+    mTiles.resize(width * height);
+    std::memcpy(mTiles.data(), data + header.tilesOffset, header.tilesSize);
+    mWallBits.resize(mWidth, mHeight);
+    std::memcpy(mWallBits.row(0), data + header.wallBitsOffset, header.wallBitsSize);
+    mFreeCellCount = static_cast<int>(header.freeCellCount);
+    clearSpawnTables();
+    return true;
+}
+
+bool Map::saveCompiledMap(const std::string& filename) const
+{
+    const size_t tilesSize = mTiles.size();
+    const size_t wallBitsSize = static_cast<size_t>(mWallBits.getWordsPerRow()) * mHeight * sizeof(uint64_t);
+    const size_t tilesOffset = sizeof(CompiledMapHeader);
+    const size_t wallBitsOffset = (tilesOffset + tilesSize + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+    const size_t totalSize = wallBitsOffset + wallBitsSize;
+
+    CompiledMapHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kCompiledMapMagic;
+    header.version = kCompiledMapVersion;
+    header.headerSize = sizeof(CompiledMapHeader);
+    header.totalSize = static_cast<uint32_t>(totalSize);
+    header.width = static_cast<uint32_t>(mWidth);
+    header.height = static_cast<uint32_t>(mHeight);
+    header.tilesOffset = static_cast<uint32_t>(tilesOffset);
+    header.tilesSize = static_cast<uint32_t>(tilesSize);
+    header.wallBitsOffset = static_cast<uint32_t>(wallBitsOffset);
+    header.wallBitsSize = static_cast<uint32_t>(wallBitsSize);
+    header.wallCount = static_cast<uint32_t>(mWallBits.count());
+    header.freeCellCount = static_cast<uint32_t>(mFreeCellCount);
+
+    std::vector<uint8_t> buffer(totalSize, 0);
+    std::memcpy(buffer.data() + tilesOffset, mTiles.data(), tilesSize);
+    std::memcpy(buffer.data() + wallBitsOffset, mWallBits.row(0), wallBitsSize);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    header.crc = SaveFormat::crc32c(buffer.data(), buffer.size());
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    return SaveFormat::writeFile(filename, buffer);
+}
+
+std::string Map::compiledMapPath(const std::string& filename)
+{
+    if (endsWith(filename, ".smap"))
+    {
+        return filename;
+    }
+    const size_t slash = filename.find_last_of('/');
+    const size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return filename + ".smap";
+    }
+    return filename.substr(0, dot) + ".smap";
+}
+
 TileType Map::getTile(int x, int y) const
 {
     if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
     {
         return TileType::Wall;
     }
-    return mTiles[y][x];
+    return tileAt(x, y);
 }
 
 void Map::setTile(int x, int y, TileType type)
 {
     if (x >= 0 && y >= 0 && x < mWidth && y < mHeight)
     {
-        mTiles[y][x] = type;
+        const bool wasWall = tileAt(x, y) == TileType::Wall;
+        const bool isWallNow = type == TileType::Wall;
+        tileAt(x, y) = type;
+        if (isWallNow)
+        {
+            mWallBits.set(x, y);
+        }
+        else
+        {
+            mWallBits.reset(x, y);
+        }
+        if (wasWall != isWallNow)
+        {
+            if (x > 0 && y > 0 && x < mWidth - 1 && y < mHeight - 1)
+            {
+                mFreeCellCount += isWallNow ? -1 : 1;
+            }
+            clearSpawnTables();
+        }
     }
 }
 
@@ -155,61 +492,110 @@ bool Map::isWall(int x, int y) const
     {
         return true; // 边界外全部视为墙
     }
-    return mTiles[y][x] == TileType::Wall;
+    return tileAt(x, y) == TileType::Wall;
 }
 
 std::vector<SnakeBody> Map::getEmptyPositions(const std::vector<SnakeBody>& snake) const
 {
+    Bitboard free;
+    buildFreeBits(snake, free);
+    
+    // 按行优先顺序取出所有空位，顺序与逐格扫描一致
     std::vector<SnakeBody> emptyPositions;
+    emptyPositions.reserve(free.count());
+    free.forEachSet([&emptyPositions](int x, int y) {
+        emptyPositions.push_back(SnakeBody(x, y));
+    });
     
+    return emptyPositions;
+}
+
+int Map::countEmptyPositions(const std::vector<SnakeBody>& snake) const
+{
+    Bitboard free;
+    buildFreeBits(snake, free);
+    return free.count();
+}
+
+const std::string& Map::getLastError() const
+{
+    return mLastError;
+}
+
+const Bitboard& Map::getWallBits() const
+{
+    return mWallBits;
+}
+
+int Map::getFreeCellCount() const
+{
+    return mFreeCellCount;
+}
+
+void Map::rebuildWallBits()
+{
+    mWallBits.resize(mWidth, mHeight);
+    for (int y = 0; y < mHeight; y++)
+    {
+        uint64_t* words = mWallBits.row(y);
+        const TileType* tiles = &mTiles[static_cast<size_t>(y) * mWidth];
+        for (int x = 0; x < mWidth; x++)
+        {
+            words[x >> 6] |= static_cast<uint64_t>(tiles[x] == TileType::Wall) << (x & 63);
+        }
+    }
+    mFreeCellCount = countEmptyPositions(std::vector<SnakeBody>());
+    clearSpawnTables();
+}
+
+void Map::buildFreeBits(const std::vector<SnakeBody>& snake, Bitboard& free) const
+{
+    // 先把内部区域全部置位，再按字去掉墙体，最后逐节去掉蛇身
+    free.resize(mWidth, mHeight);
+    const int words = free.getWordsPerRow();
     for (int y = 1; y < mHeight - 1; y++)
     {
-        for (int x = 1; x < mWidth - 1; x++)
+        uint64_t* row = free.row(y);
+        const uint64_t* walls = mWallBits.row(y);
+        for (int w = 0; w < words; w++)
         {
-            // 只考虑非墙壁位置
-            if (mTiles[y][x] != TileType::Wall)
+            // 第 1 到 mWidth-2 列
+            int lo = std::max(1, w * 64);
+            int hi = std::min(mWidth - 2, w * 64 + 63);
+            if (lo > hi)
             {
-                bool isSnakePart = false;
-                
-                // 检查是否是蛇身体的一部分
-                for (const auto& part : snake)
-                {
-                    if (part.getX() == x && part.getY() == y)
-                    {
-                        isSnakePart = true;
-                        break;
-                    }
-                }
-                
-                if (!isSnakePart)
-                {
-                    emptyPositions.push_back(SnakeBody(x, y));
-                }
+                continue;
             }
+            int loBit = lo - w * 64;
+            int hiBit = hi - w * 64;
+            uint64_t mask = (hiBit == 63 ? ~0ULL : ((1ULL << (hiBit + 1)) - 1)) & ~((1ULL << loBit) - 1);
+            row[w] = mask & ~walls[w];
         }
     }
-    
-    return emptyPositions;
-} 
+    for (const auto& part : snake)
+    {
+        free.reset(part.getX(), part.getY());
+    }
+}
 
 bool Map::canPlaceSnake(int startX, int startY, InitialDirection direction, int length) const
 {
     int dx = 0, dy = 0;
     
-    // 根据方向设置增量
+    // 与 Snake::initializeSnake 一致：蛇身从蛇头向移动方向的反方向展开
     switch (direction)
     {
         case InitialDirection::Up:
-            dy = -1;
+            dy = 1;
             break;
         case InitialDirection::Down:
-            dy = 1;
+            dy = -1;
             break;
         case InitialDirection::Left:
-            dx = -1;
+            dx = 1;
             break;
         case InitialDirection::Right:
-            dx = 1;
+            dx = -1;
             break;
     }
     
@@ -220,7 +606,7 @@ bool Map::canPlaceSnake(int startX, int startY, InitialDirection direction, int
         int y = startY + i * dy;
         
         // 检查位置是否在地图内且不是墙
-        if (x < 0 || y < 0 || x >= mWidth || y >= mHeight || mTiles[y][x] == TileType::Wall)
+        if (x < 0 || y < 0 || x >= mWidth || y >= mHeight || tileAt(x, y) == TileType::Wall)
         {
             return false;
         }
@@ -265,7 +651,7 @@ bool Map::hasEnoughForwardSpace(int x, int y, InitialDirection direction, int mi
         
         // 如果超出地图边界或碰到墙，则停止计数并标记找到障碍物
         if (checkX <= 0 || checkY <= 0 || checkX >= mWidth - 1 || checkY >= mHeight - 1 || 
-            mTiles[checkY][checkX] == TileType::Wall)
+            tileAt(checkX, checkY) == TileType::Wall)
         {
             foundObstacle = true;
         }
@@ -285,9 +671,32 @@ bool Map::hasEnoughForwardSpace(int x, int y, InitialDirection direction, int mi
     return (emptyCount >= 2) || ((double)emptyCount / totalChecked >= 0.4);
 }
 
-std::vector<std::pair<SnakeBody, InitialDirection>> Map::getValidSnakePositions(int length, int minSpace) const
+const std::vector<SpawnPosition>& Map::getValidSnakePositions(int length, int minSpace) const
+{
+    return spawnTable(length, minSpace).positions;
+}
+
+const Map::SpawnTable& Map::spawnTable(int length, int minSpace) const
 {
-    std::vector<std::pair<SnakeBody, InitialDirection>> validPositions;
+    std::lock_guard<std::mutex> lock(mSpawnMutex);
+    auto found = mSpawnTables.find(std::make_pair(length, minSpace));
+    if (found == mSpawnTables.end())
+    {
+        found = mSpawnTables.emplace(std::make_pair(length, minSpace), SpawnTable()).first;
+        buildSpawnTable(length, minSpace, found->second);
+    }
+    return found->second;
+}
+
+void Map::clearSpawnTables()
+{
+    std::lock_guard<std::mutex> lock(mSpawnMutex);
+    mSpawnTables.clear();
+}
+
+void Map::buildSpawnTable(int length, int minSpace, SpawnTable& table) const
+{
+    std::vector<SpawnPosition>& validPositions = table.positions;
     
     // 遍历所有可能的起始位置
     for (int y = 1; y < mHeight - 1; y++)
@@ -295,7 +704,7 @@ std::vector<std::pair<SnakeBody, InitialDirection>> Map::getValidSnakePositions(
         for (int x = 1; x < mWidth - 1; x++)
         {
             // 跳过墙壁位置
-            if (mTiles[y][x] == TileType::Wall)
+            if (tileAt(x, y) == TileType::Wall)
             {
                 continue;
             }
@@ -318,5 +727,96 @@ std::vector<std::pair<SnakeBody, InitialDirection>> Map::getValidSnakePositions(
         }
     }
     
-    return validPositions;
-} 
\ No newline at end of file
+    // 按分区做计数排序，分区内保持扫描顺序
+    int counts[kSpawnRegions] = {};
+    std::vector<int> regions(validPositions.size());
+    for (size_t i = 0; i < validPositions.size(); i++)
+    {
+        const SnakeBody& head = validPositions[i].first;
+        regions[i] = (head.getY() * kSpawnGrid / mHeight) * kSpawnGrid + head.getX() * kSpawnGrid / mWidth;
+        counts[regions[i]]++;
+    }
+    table.regionStart[0] = 0;
+    for (int r = 0; r < kSpawnRegions; r++)
+    {
+        table.regionStart[r + 1] = table.regionStart[r] + counts[r];
+    }
+    int next[kSpawnRegions];
+    std::copy(table.regionStart, table.regionStart + kSpawnRegions, next);
+    table.regionIndex.resize(validPositions.size());
+    for (size_t i = 0; i < validPositions.size(); i++)
+    {
+        table.regionIndex[next[regions[i]]++] = static_cast<int>(i);
+    }
+}
+
+bool Map::pickSpawnFarFrom(int length, int minSpace, const SnakeBody& avoid,
+                           const std::vector<SnakeBody>& occupied, uint32_t seed, SpawnPosition& spawn) const
+{
+    const SpawnTable& table = spawnTable(length, minSpace);
+    if (table.positions.empty())
+    {
+        return false;
+    }
+
+    // 分区中心离 avoid 越远越先尝试
+    int order[kSpawnRegions];
+    int distance[kSpawnRegions];
+    for (int r = 0; r < kSpawnRegions; r++)
+    {
+        const int centerX = (2 * (r % kSpawnGrid) + 1) * mWidth / (2 * kSpawnGrid);
+        const int centerY = (2 * (r / kSpawnGrid) + 1) * mHeight / (2 * kSpawnGrid);
+        distance[r] = std::abs(centerX - avoid.getX()) + std::abs(centerY - avoid.getY());
+        order[r] = r;
+    }
+    std::stable_sort(order, order + kSpawnRegions, [&distance](int a, int b) { return distance[a] > distance[b]; });
+
+    // 蛇身（从蛇头向反方向展开）和前方 minSpace 格都不能碰到 occupied
+    auto isClear = [this, length, minSpace, &occupied](const SpawnPosition& candidate)
+    {
+        int dx = 0, dy = 0;
+        switch (candidate.second)
+        {
+            case InitialDirection::Up:    dy = -1; break;
+            case InitialDirection::Down:  dy = 1;  break;
+            case InitialDirection::Left:  dx = -1; break;
+            case InitialDirection::Right: dx = 1;  break;
+        }
+        const int headX = candidate.first.getX();
+        const int headY = candidate.first.getY();
+        for (const SnakeBody& cell : occupied)
+        {
+            const int offX = cell.getX() - headX;
+            const int offY = cell.getY() - headY;
+            // 沿移动方向的坐标：前方为正，蛇身为 0 到 -(length-1)
+            const int along = offX * dx + offY * dy;
+            const int across = offX * dy - offY * dx;
+            if (across == 0 && along > -length && along <= minSpace)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const int kAttemptsPerRegion = 8;
+    uint32_t rng = seed != 0 ? seed : 1;
+    for (int r : order)
+    {
+        const int begin = table.regionStart[r];
+        const int count = table.regionStart[r + 1] - begin;
+        for (int attempt = 0; attempt < kAttemptsPerRegion && count > 0; attempt++)
+        {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            const SpawnPosition& candidate = table.positions[table.regionIndex[begin + rng % count]];
+            if (isClear(candidate))
+            {
+                spawn = candidate;
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path, std::string& error)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        error = path + ": empty or unreadable file";
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+    mData = mapped;
+    mSize = size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData != nullptr)
+    {
+        ::munmap(mData, mSize);
+        mData = nullptr;
+        mSize = 0;
+    }
+}
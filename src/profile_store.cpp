@@ -0,0 +1,363 @@
+#include "profile_store.h"
+#include "save_format.h"
+#include "save_worker.h"
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+    // 快照文件头，按主机字节序（小端）直接写入
+    struct SnapshotHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t count;
+        uint32_t crc;           // 覆盖文件头之后的全部数据
+        uint64_t appliedSeq;
+    };
+    static_assert(sizeof(SnapshotHeader) == 24, "SnapshotHeader must stay 24 bytes");
+
+    const uint32_t kSnapshotMagic = 0x42445250; // "PRDB"
+    const uint32_t kLogMagic = 0x4C575250;      // "PRWL"
+    const uint16_t kSnapshotVersion = 1;
+    const size_t kMaxKeyLength = 255;
+
+    enum OperationType : uint8_t
+    {
+        OpSet = 1,
+        OpAdd = 2,
+        OpErase = 3
+    };
+
+    template <typename T>
+    void appendPod(std::vector<uint8_t>& buffer, const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void appendKeyValue(std::vector<uint8_t>& buffer, const std::string& key, int64_t value)
+    {
+        appendPod(buffer, static_cast<uint16_t>(key.size()));
+        buffer.insert(buffer.end(), key.begin(), key.end());
+        appendPod(buffer, value);
+    }
+
+    // 读取 键长 u16 | 键 | 值 i64，越界时返回false
+    bool readKeyValue(const uint8_t* data, size_t size, size_t& offset, std::string& key, int64_t& value)
+    {
+        uint16_t length = 0;
+        if (offset + sizeof(length) > size)
+        {
+            return false;
+        }
+        std::memcpy(&length, data + offset, sizeof(length));
+        offset += sizeof(length);
+        if (length > kMaxKeyLength || offset + length + sizeof(value) > size)
+        {
+            return false;
+        }
+        key.assign(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        std::memcpy(&value, data + offset, sizeof(value));
+        offset += sizeof(value);
+        return true;
+    }
+}
+
+void ProfileStore::Transaction::set(const std::string& key, int64_t value)
+{
+    mOperations.push_back(Operation{OpSet, key, value});
+}
+
+void ProfileStore::Transaction::add(const std::string& key, int64_t delta)
+{
+    mOperations.push_back(Operation{OpAdd, key, delta});
+}
+
+void ProfileStore::Transaction::erase(const std::string& key)
+{
+    mOperations.push_back(Operation{OpErase, key, 0});
+}
+
+bool ProfileStore::Transaction::empty() const
+{
+    return mOperations.empty();
+}
+
+ProfileStore& ProfileStore::shared()
+{
+    static ProfileStore store(".");
+    static std::once_flag opened;
+    std::call_once(opened, []() { store.open(); });
+    return store;
+}
+
+ProfileStore::ProfileStore(const std::string& directory) : mDirectory(directory)
+{
+}
+
+ProfileStore::~ProfileStore()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mLog.isOpen() && mLog.hasRecords())
+    {
+        checkpointLocked();
+    }
+}
+
+bool ProfileStore::open()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mValues.clear();
+    mSnapshotSeq = 0;
+    if (!loadSnapshot())
+    {
+        return false;
+    }
+    using namespace std::placeholders;
+    if (!mLog.open(logPath(), kLogMagic, std::bind(&ProfileStore::replayRecord, this, _1, _2, _3)))
+    {
+        mLastError = mLog.getLastError();
+        return false;
+    }
+    // profile.wal 丢失或被重建时序号会从1开始，新事务要排在快照之后，否则下次打开时被当成已应用而跳过
+    mLog.raiseNextSeq(mSnapshotSeq + 1);
+    return true;
+}
+
+bool ProfileStore::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLog.isOpen();
+}
+
+int64_t ProfileStore::get(const std::string& key, int64_t fallback) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto found = mValues.find(key);
+    return found != mValues.end() ? found->second : fallback;
+}
+
+bool ProfileStore::contains(const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mValues.count(key) != 0;
+}
+
+std::vector<std::pair<std::string, int64_t>> ProfileStore::scan(const std::string& prefix) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<std::pair<std::string, int64_t>> result;
+    for (auto it = mValues.lower_bound(prefix); it != mValues.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        result.emplace_back(it->first, it->second);
+    }
+    return result;
+}
+
+bool ProfileStore::commit(const Transaction& transaction)
+{
+    if (transaction.empty())
+    {
+        return true;
+    }
+    for (const Transaction::Operation& operation : transaction.mOperations)
+    {
+        if (operation.key.empty() || operation.key.size() > kMaxKeyLength)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mLastError = "invalid profile key '" + operation.key + "'";
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mLog.append({encodeTransaction(transaction)}))
+    {
+        mLastError = mLog.getLastError();
+        return false;
+    }
+    applyLocked(transaction);
+    if (mLog.getSize() >= kCheckpointLogSize)
+    {
+        // 快照失败不影响本次提交，日志里已经有这条事务
+        checkpointLocked();
+    }
+    return true;
+}
+
+bool ProfileStore::checkpoint()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return checkpointLocked();
+}
+
+std::string ProfileStore::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastError;
+}
+
+std::vector<uint8_t> ProfileStore::encodeTransaction(const Transaction& transaction)
+{
+    // 操作数 u32 | 每个操作 { 类型 u8 | 键长 u16 | 键 | 值 i64 }
+    std::vector<uint8_t> buffer;
+    appendPod(buffer, static_cast<uint32_t>(transaction.mOperations.size()));
+    for (const Transaction::Operation& operation : transaction.mOperations)
+    {
+        appendPod(buffer, operation.type);
+        appendKeyValue(buffer, operation.key, operation.value);
+    }
+    return buffer;
+}
+
+bool ProfileStore::decodeTransaction(const uint8_t* data, size_t size, Transaction& transaction) const
+{
+    uint32_t count = 0;
+    if (size < sizeof(count))
+    {
+        return false;
+    }
+    std::memcpy(&count, data, sizeof(count));
+    size_t offset = sizeof(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (offset >= size)
+        {
+            return false;
+        }
+        Transaction::Operation operation;
+        operation.type = data[offset++];
+        if (operation.type < OpSet || operation.type > OpErase ||
+            !readKeyValue(data, size, offset, operation.key, operation.value))
+        {
+            return false;
+        }
+        transaction.mOperations.push_back(operation);
+    }
+    return offset == size;
+}
+
+void ProfileStore::applyLocked(const Transaction& transaction)
+{
+    for (const Transaction::Operation& operation : transaction.mOperations)
+    {
+        switch (operation.type)
+        {
+            case OpSet:
+                mValues[operation.key] = operation.value;
+                break;
+            case OpAdd:
+                mValues[operation.key] += operation.value;
+                break;
+            case OpErase:
+                mValues.erase(operation.key);
+                break;
+        }
+    }
+}
+
+void ProfileStore::replayRecord(uint64_t seq, const uint8_t* payload, size_t size)
+{
+    // 已经写进快照的事务跳过；解不开的记录（CRC正确时不应出现）整条忽略
+    Transaction transaction;
+    if (seq > mSnapshotSeq && decodeTransaction(payload, size, transaction))
+    {
+        applyLocked(transaction);
+    }
+}
+
+bool ProfileStore::loadSnapshot()
+{
+    std::vector<uint8_t> buffer;
+    if (!SaveFormat::readFile(snapshotPath(), buffer))
+    {
+        if (errno == ENOENT)
+        {
+            return true;
+        }
+        mLastError = snapshotPath() + ": " + std::strerror(errno);
+        return false;
+    }
+
+    SnapshotHeader header;
+    if (buffer.size() < sizeof(header))
+    {
+        mLastError = snapshotPath() + ": truncated snapshot";
+        return false;
+    }
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion ||
+        SaveFormat::crc32c(buffer.data() + sizeof(header), buffer.size() - sizeof(header)) != header.crc)
+    {
+        mLastError = snapshotPath() + ": corrupt snapshot";
+        return false;
+    }
+
+    std::map<std::string, int64_t> values;
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.count; i++)
+    {
+        std::string key;
+        int64_t value = 0;
+        if (!readKeyValue(buffer.data(), buffer.size(), offset, key, value))
+        {
+            mLastError = snapshotPath() + ": corrupt snapshot";
+            return false;
+        }
+        values[key] = value;
+    }
+    mValues.swap(values);
+    mSnapshotSeq = header.appliedSeq;
+    return true;
+}
+
+bool ProfileStore::checkpointLocked()
+{
+    if (!mLog.isOpen())
+    {
+        return false;
+    }
+    std::vector<uint8_t> buffer(sizeof(SnapshotHeader));
+    for (const auto& item : mValues)
+    {
+        appendKeyValue(buffer, item.first, item.second);
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kSnapshotMagic;
+    header.version = kSnapshotVersion;
+    header.count = static_cast<uint32_t>(mValues.size());
+    header.crc = SaveFormat::crc32c(buffer.data() + sizeof(header), buffer.size() - sizeof(header));
+    header.appliedSeq = mLog.getNextSeq() - 1;
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // 先换快照再清日志，两步之间崩溃时重放会跳过快照里已有的事务
+    if (!SaveWorker::writeAtomic(snapshotPath(), buffer))
+    {
+        mLastError = snapshotPath() + ": write failed";
+        return false;
+    }
+    mSnapshotSeq = header.appliedSeq;
+    if (!mLog.reset())
+    {
+        mLastError = mLog.getLastError();
+        return false;
+    }
+    return true;
+}
+
+std::string ProfileStore::snapshotPath() const
+{
+    return mDirectory + "/profile.db";
+}
+
+std::string ProfileStore::logPath() const
+{
+    return mDirectory + "/profile.wal";
+}
@@ -0,0 +1,253 @@
+#include "record_log.h"
+#include "save_format.h"
+#include "save_worker.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    struct LogHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        uint64_t baseSeq;       // 本日志第一条记录可用的序号
+    };
+    static_assert(sizeof(LogHeader) == 16, "LogHeader must stay 16 bytes");
+
+    const uint16_t kLogVersion = 1;
+    // 长度 u32 | CRC32C u32，其后是 序号 u64 | 载荷
+    const size_t kRecordPrefix = 2 * sizeof(uint32_t);
+    const size_t kMaxRecordSize = 1 << 20;
+
+    std::vector<uint8_t> encodeHeader(uint32_t magic, uint64_t baseSeq)
+    {
+        LogHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = magic;
+        header.version = kLogVersion;
+        header.baseSeq = baseSeq;
+        std::vector<uint8_t> buffer(sizeof(header));
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        return buffer;
+    }
+}
+
+RecordLog::RecordLog()
+{
+}
+
+RecordLog::~RecordLog()
+{
+    close();
+}
+
+bool RecordLog::open(const std::string& path, uint32_t magic, const RecordCallback& onRecord)
+{
+    close();
+    mPath = path;
+    mMagic = magic;
+    mNextSeq = 1;
+
+    std::vector<uint8_t> buffer;
+    if (!SaveFormat::readFile(path, buffer))
+    {
+        if (errno != ENOENT)
+        {
+            setErrno("read");
+            return false;
+        }
+        return reset();
+    }
+    if (buffer.size() < sizeof(LogHeader))
+    {
+        // 只可能是创建日志时崩溃留下的残缺文件头
+        return reset();
+    }
+
+    LogHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != magic || header.version != kLogVersion)
+    {
+        mLastError = path + ": unrecognized log";
+        return false;
+    }
+    mNextSeq = std::max<uint64_t>(1, header.baseSeq);
+
+    size_t offset = sizeof(LogHeader);
+    while (offset + kRecordPrefix + sizeof(uint64_t) <= buffer.size())
+    {
+        uint32_t size = 0;
+        uint32_t crc = 0;
+        std::memcpy(&size, buffer.data() + offset, sizeof(size));
+        std::memcpy(&crc, buffer.data() + offset + sizeof(size), sizeof(crc));
+        if (size < sizeof(uint64_t) || size > kMaxRecordSize || offset + kRecordPrefix + size > buffer.size())
+        {
+            break;
+        }
+        const uint8_t* body = buffer.data() + offset + kRecordPrefix;
+        if (SaveFormat::crc32c(body, size) != crc)
+        {
+            break;
+        }
+        uint64_t seq = 0;
+        std::memcpy(&seq, body, sizeof(seq));
+        if (seq < mNextSeq)
+        {
+            break;
+        }
+        onRecord(seq, body + sizeof(seq), size - sizeof(seq));
+        mNextSeq = seq + 1;
+        offset += kRecordPrefix + size;
+    }
+
+    if (!openForAppend())
+    {
+        return false;
+    }
+    // 截掉不完整的尾部，后续追加紧跟在最后一条完整记录之后
+    if (offset < buffer.size() && ::ftruncate(mFd, static_cast<off_t>(offset)) != 0)
+    {
+        setErrno("truncate");
+        close();
+        return false;
+    }
+    mSize = offset;
+    return true;
+}
+
+void RecordLog::close()
+{
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+        mFd = -1;
+    }
+}
+
+bool RecordLog::append(const std::vector<std::vector<uint8_t>>& payloads, uint64_t* firstSeq)
+{
+    if (mFd < 0)
+    {
+        mLastError = mPath + ": log is not open";
+        return false;
+    }
+
+    std::vector<uint8_t> buffer;
+    uint64_t seq = mNextSeq;
+    for (const std::vector<uint8_t>& payload : payloads)
+    {
+        const uint32_t size = static_cast<uint32_t>(sizeof(seq) + payload.size());
+        const size_t start = buffer.size();
+        buffer.resize(start + kRecordPrefix + size);
+        std::memcpy(buffer.data() + start, &size, sizeof(size));
+        std::memcpy(buffer.data() + start + kRecordPrefix, &seq, sizeof(seq));
+        if (!payload.empty())
+        {
+            std::memcpy(buffer.data() + start + kRecordPrefix + sizeof(seq), payload.data(), payload.size());
+        }
+        const uint32_t crc = SaveFormat::crc32c(buffer.data() + start + kRecordPrefix, size);
+        std::memcpy(buffer.data() + start + sizeof(size), &crc, sizeof(crc));
+        seq++;
+    }
+
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t result = ::write(mFd, buffer.data() + written, buffer.size() - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result < 0)
+        {
+            break;
+        }
+        written += static_cast<size_t>(result);
+    }
+    if (written < buffer.size() || ::fdatasync(mFd) != 0)
+    {
+        setErrno("append");
+        // 截回原长度，避免半条记录挡住之后追加的记录
+        if (::ftruncate(mFd, static_cast<off_t>(mSize)) != 0)
+        {
+            mLastError += " (rollback failed)";
+        }
+        return false;
+    }
+
+    if (firstSeq != nullptr)
+    {
+        *firstSeq = mNextSeq;
+    }
+    mNextSeq = seq;
+    mSize += buffer.size();
+    return true;
+}
+
+bool RecordLog::reset()
+{
+    if (!SaveWorker::writeAtomic(mPath, encodeHeader(mMagic, mNextSeq)))
+    {
+        setErrno("reset");
+        return false;
+    }
+    close();
+    if (!openForAppend())
+    {
+        return false;
+    }
+    mSize = sizeof(LogHeader);
+    return true;
+}
+
+void RecordLog::raiseNextSeq(uint64_t seq)
+{
+    // 只在内存里抬高；文件头的起始序号在下次 reset 时写入，之前崩溃的话打开时会再抬一次
+    mNextSeq = std::max(mNextSeq, seq);
+}
+
+bool RecordLog::isOpen() const
+{
+    return mFd >= 0;
+}
+
+bool RecordLog::hasRecords() const
+{
+    return mSize > sizeof(LogHeader);
+}
+
+size_t RecordLog::getSize() const
+{
+    return mSize;
+}
+
+uint64_t RecordLog::getNextSeq() const
+{
+    return mNextSeq;
+}
+
+const std::string& RecordLog::getLastError() const
+{
+    return mLastError;
+}
+
+bool RecordLog::openForAppend()
+{
+    mFd = ::open(mPath.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (mFd < 0)
+    {
+        setErrno("open");
+        return false;
+    }
+    return true;
+}
+
+void RecordLog::setErrno(const std::string& what)
+{
+    mLastError = mPath + ": " + what + " failed: " + std::strerror(errno);
+}
@@ -0,0 +1,750 @@
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "save_format.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SAVE_FORMAT_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+namespace
+{
+    enum SectionId : uint32_t
+    {
+        kSectionMeta = 1,
+        kSectionSnake1 = 2,
+        kSectionSnake2 = 3,
+        kSectionFoods = 4,
+        kSectionCorpses = 5,
+        kSectionLevels = 6,
+        kSectionInfo = 7
+    };
+
+    const size_t kHeaderSize = 24;
+    const size_t kSectionEntrySize = 12;
+    const size_t kCrcOffset = 16;
+    // 防止损坏的长度字段导致巨量分配
+    const uint32_t kMaxListLength = 1 << 20;
+
+    // 按小端顺序追加字段
+    class ByteWriter
+    {
+    public:
+        explicit ByteWriter(std::vector<uint8_t>& out) : mOut(out) {}
+
+        void u8(uint8_t value) { mOut.push_back(value); }
+        void u16(uint16_t value)
+        {
+            mOut.push_back(static_cast<uint8_t>(value));
+            mOut.push_back(static_cast<uint8_t>(value >> 8));
+        }
+        void u32(uint32_t value)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                mOut.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+        void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+        void point(const SavedPoint& p)
+        {
+            i32(p.x);
+            i32(p.y);
+        }
+        void varint(uint32_t value)
+        {
+            while (value >= 0x80)
+            {
+                mOut.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            mOut.push_back(static_cast<uint8_t>(value));
+        }
+        // zigzag：小的负数也只占一个字节
+        void svarint(int32_t value)
+        {
+            varint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+        }
+        // 坐标列表按与前一个点的差值编码，蛇身相邻两节的差值只有±1，每个坐标一个字节
+        void points(const std::vector<SavedPoint>& list)
+        {
+            varint(static_cast<uint32_t>(list.size()));
+            SavedPoint previous;
+            previous.x = 0;
+            previous.y = 0;
+            for (const SavedPoint& p : list)
+            {
+                svarint(p.x - previous.x);
+                svarint(p.y - previous.y);
+                previous = p;
+            }
+        }
+        size_t size() const { return mOut.size(); }
+        void patch32(size_t offset, uint32_t value)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                mOut[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+
+    private:
+        std::vector<uint8_t>& mOut;
+    };
+
+    // 带边界检查的读取，任何越界都会让 ok() 变为false，之后的读取返回0
+    class ByteReader
+    {
+    public:
+        ByteReader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+        uint8_t u8()
+        {
+            if (!need(1))
+            {
+                return 0;
+            }
+            return mData[mPos++];
+        }
+        uint16_t u16()
+        {
+            if (!need(2))
+            {
+                return 0;
+            }
+            uint16_t value = static_cast<uint16_t>(mData[mPos] | (mData[mPos + 1] << 8));
+            mPos += 2;
+            return value;
+        }
+        uint32_t u32()
+        {
+            if (!need(4))
+            {
+                return 0;
+            }
+            uint32_t value = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                value |= static_cast<uint32_t>(mData[mPos + i]) << (8 * i);
+            }
+            mPos += 4;
+            return value;
+        }
+        int32_t i32() { return static_cast<int32_t>(u32()); }
+        bool flag() { return u8() != 0; }
+        SavedPoint point()
+        {
+            SavedPoint p;
+            p.x = i32();
+            p.y = i32();
+            return p;
+        }
+        uint32_t varint()
+        {
+            uint32_t value = 0;
+            for (int shift = 0; shift < 35; shift += 7)
+            {
+                uint8_t byte = u8();
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            mOk = false;
+            return 0;
+        }
+        int32_t svarint()
+        {
+            uint32_t value = varint();
+            return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+        }
+        // 差值编码的坐标列表（版本3）
+        bool points(std::vector<SavedPoint>& list)
+        {
+            uint32_t count = varint();
+            // 每个坐标至少2字节
+            if (!mOk || count > kMaxListLength || count > (mSize - mPos) / 2)
+            {
+                mOk = false;
+                return false;
+            }
+            list.resize(count);
+            SavedPoint previous;
+            previous.x = 0;
+            previous.y = 0;
+            for (SavedPoint& p : list)
+            {
+                p.x = previous.x + svarint();
+                p.y = previous.y + svarint();
+                previous = p;
+            }
+            return mOk;
+        }
+        // 定长坐标列表（版本2和旧格式）
+        bool fixedPoints(std::vector<SavedPoint>& list)
+        {
+            uint32_t count = u32();
+            // 每个坐标8字节，数量不可能超过剩余字节
+            if (!mOk || count > kMaxListLength || count > (mSize - mPos) / 8)
+            {
+                mOk = false;
+                return false;
+            }
+            list.resize(count);
+            for (SavedPoint& p : list)
+            {
+                p = point();
+            }
+            return mOk;
+        }
+        bool ok() const { return mOk; }
+        bool atEnd() const { return mPos == mSize; }
+        size_t position() const { return mPos; }
+
+    private:
+        bool need(size_t bytes)
+        {
+            if (!mOk || mSize - mPos < bytes)
+            {
+                mOk = false;
+                return false;
+            }
+            return true;
+        }
+
+        const uint8_t* mData;
+        size_t mSize;
+        size_t mPos = 0;
+        bool mOk = true;
+    };
+
+    struct CrcTable
+    {
+        uint32_t entries[256];
+
+        CrcTable()
+        {
+            // Castagnoli多项式（反射形式）
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t crc = i;
+                for (int k = 0; k < 8; k++)
+                {
+                    crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78u : 0);
+                }
+                entries[i] = crc;
+            }
+        }
+    };
+
+    uint32_t crc32cTable(const uint8_t* data, size_t size, uint32_t crc)
+    {
+        static const CrcTable table;
+        for (size_t i = 0; i < size; i++)
+        {
+            crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#ifdef SAVE_FORMAT_SSE42
+    // SSE4.2的crc32指令计算的正是CRC32C
+    __attribute__((target("sse4.2")))
+    uint32_t crc32cHardware(const uint8_t* data, size_t size, uint32_t crc)
+    {
+        size_t i = 0;
+#if defined(__x86_64__)
+        uint64_t crc64 = crc;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t chunk;
+            std::memcpy(&chunk, data + i, sizeof(chunk));
+            crc64 = _mm_crc32_u64(crc64, chunk);
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+        for (; i < size; i++)
+        {
+            crc = _mm_crc32_u8(crc, data[i]);
+        }
+        return crc;
+    }
+#endif
+
+    void encodeSnake(ByteWriter& writer, int32_t direction, const std::vector<SavedPoint>& body)
+    {
+        writer.i32(direction);
+        writer.points(body);
+    }
+
+    bool isInsideBoard(const SavedPoint& p, const SnapshotLimits& limits, int margin = 0)
+    {
+        return p.x >= -margin && p.y >= -margin &&
+               p.x < limits.boardWidth + margin && p.y < limits.boardHeight + margin;
+    }
+
+    bool allInsideBoard(const std::vector<SavedPoint>& list, const SnapshotLimits& limits, int margin = 0)
+    {
+        for (const SavedPoint& p : list)
+        {
+            if (!isInsideBoard(p, limits, margin))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+uint32_t SaveFormat::crc32c(const uint8_t* data, size_t size, uint32_t crc)
+{
+    crc = ~crc;
+#ifdef SAVE_FORMAT_SSE42
+    static const bool hasSse42 = __builtin_cpu_supports("sse4.2");
+    crc = hasSse42 ? crc32cHardware(data, size, crc) : crc32cTable(data, size, crc);
+#else
+    crc = crc32cTable(data, size, crc);
+#endif
+    return ~crc;
+}
+
+void SaveFormat::encode(const GameSnapshot& snapshot, std::vector<uint8_t>& buffer)
+{
+    buffer.clear();
+    buffer.reserve(256 + 8 * (snapshot.snake1.size() + snapshot.snake2.size() + snapshot.corpseFoods.size()));
+
+    std::vector<uint32_t> sections = {kSectionMeta};
+    if (snapshot.hasSnake1)
+    {
+        sections.push_back(kSectionSnake1);
+    }
+    if (snapshot.hasSnake2)
+    {
+        sections.push_back(kSectionSnake2);
+    }
+    sections.push_back(kSectionFoods);
+    sections.push_back(kSectionCorpses);
+    sections.push_back(kSectionLevels);
+    sections.push_back(kSectionInfo);
+
+    ByteWriter writer(buffer);
+    writer.u32(kMagic);
+    writer.u16(kVersion);
+    writer.u16(static_cast<uint16_t>(kHeaderSize));
+    writer.u32(static_cast<uint32_t>(sections.size()));
+    writer.u32(0); // 文件总长，最后回填
+    writer.u32(0); // CRC，最后回填
+    writer.u32(0);
+
+    // 段表先占位，写完各段后回填偏移和长度
+    const size_t tableOffset = writer.size();
+    for (uint32_t id : sections)
+    {
+        writer.u32(id);
+        writer.u32(0);
+        writer.u32(0);
+    }
+
+    for (size_t i = 0; i < sections.size(); i++)
+    {
+        const size_t begin = writer.size();
+        switch (sections[i])
+        {
+            case kSectionMeta:
+                writer.i32(snapshot.mode);
+                writer.i32(snapshot.level);
+                writer.i32(snapshot.points);
+                writer.i32(snapshot.points2);
+                writer.i32(snapshot.lives1);
+                writer.i32(snapshot.lives2);
+                break;
+            case kSectionSnake1:
+                encodeSnake(writer, snapshot.direction1, snapshot.snake1);
+                break;
+            case kSectionSnake2:
+                encodeSnake(writer, snapshot.direction2, snapshot.snake2);
+                break;
+            case kSectionFoods:
+                writer.point(snapshot.food);
+                writer.u8(snapshot.hasSpecialFood ? 1 : 0);
+                writer.point(snapshot.specialFood);
+                writer.i32(snapshot.specialFoodType);
+                writer.u8(snapshot.hasPoison ? 1 : 0);
+                writer.point(snapshot.poison);
+                writer.u8(snapshot.hasRandomItem ? 1 : 0);
+                writer.point(snapshot.randomItem);
+                writer.i32(snapshot.randomItemType);
+                break;
+            case kSectionCorpses:
+                writer.points(snapshot.corpseFoods);
+                break;
+            case kSectionLevels:
+                writer.u32(static_cast<uint32_t>(snapshot.levelStatus.size()));
+                for (int32_t status : snapshot.levelStatus)
+                {
+                    writer.i32(status);
+                }
+                break;
+            case kSectionInfo:
+                writer.u32(static_cast<uint32_t>(static_cast<uint64_t>(snapshot.savedAtMs)));
+                writer.u32(static_cast<uint32_t>(static_cast<uint64_t>(snapshot.savedAtMs) >> 32));
+                writer.u8(snapshot.autosave ? 1 : 0);
+                break;
+        }
+        const size_t entry = tableOffset + i * kSectionEntrySize;
+        writer.patch32(entry + 4, static_cast<uint32_t>(begin));
+        writer.patch32(entry + 8, static_cast<uint32_t>(writer.size() - begin));
+    }
+
+    writer.patch32(12, static_cast<uint32_t>(writer.size()));
+    writer.patch32(kCrcOffset, crc32c(buffer.data(), buffer.size()));
+}
+
+bool SaveFormat::decode(const std::vector<uint8_t>& buffer, const SnapshotLimits& limits,
+                        GameSnapshot& snapshot, std::string& error)
+{
+    ByteReader header(buffer.data(), buffer.size());
+    if (header.u32() != kMagic)
+    {
+        return decodeLegacy(buffer, limits, snapshot, error);
+    }
+
+    const uint16_t version = header.u16();
+    const uint16_t headerSize = header.u16();
+    const uint32_t sectionCount = header.u32();
+    const uint32_t totalSize = header.u32();
+    const uint32_t storedCrc = header.u32();
+    if (!header.ok() || headerSize < kHeaderSize)
+    {
+        error = "truncated header";
+        return false;
+    }
+    // 版本2起才有文件头；比当前程序新的版本无法保证读对，直接拒绝
+    if (version < 2 || version > kVersion)
+    {
+        error = "unsupported save version " + std::to_string(version);
+        return false;
+    }
+    if (totalSize != buffer.size())
+    {
+        error = "size mismatch (partial write?)";
+        return false;
+    }
+
+    // CRC按CRC字段为0计算
+    uint32_t crc = crc32c(buffer.data(), kCrcOffset);
+    const uint8_t zeros[4] = {0, 0, 0, 0};
+    crc = crc32c(zeros, sizeof(zeros), crc);
+    crc = crc32c(buffer.data() + kCrcOffset + 4, buffer.size() - kCrcOffset - 4, crc);
+    if (crc != storedCrc)
+    {
+        error = "checksum mismatch";
+        return false;
+    }
+
+    if (sectionCount > (buffer.size() - headerSize) / kSectionEntrySize)
+    {
+        error = "bad section table";
+        return false;
+    }
+
+    // 版本2的坐标列表是定长的，版本3起改为差值编码
+    const bool packed = version >= kPackedPointsSinceVersion;
+    auto readPoints = [packed](ByteReader& reader, std::vector<SavedPoint>& list)
+    {
+        return packed ? reader.points(list) : reader.fixedPoints(list);
+    };
+
+    GameSnapshot decoded;
+    bool hasMeta = false;
+    bool hasFoods = false;
+    ByteReader table(buffer.data() + headerSize, sectionCount * kSectionEntrySize);
+    for (uint32_t i = 0; i < sectionCount; i++)
+    {
+        const uint32_t id = table.u32();
+        const uint32_t offset = table.u32();
+        const uint32_t size = table.u32();
+        if (offset > buffer.size() || size > buffer.size() - offset)
+        {
+            error = "section out of bounds";
+            return false;
+        }
+
+        ByteReader reader(buffer.data() + offset, size);
+        switch (id)
+        {
+            case kSectionMeta:
+                decoded.mode = reader.i32();
+                decoded.level = reader.i32();
+                decoded.points = reader.i32();
+                decoded.points2 = reader.i32();
+                decoded.lives1 = reader.i32();
+                decoded.lives2 = reader.i32();
+                hasMeta = true;
+                break;
+            case kSectionSnake1:
+                decoded.hasSnake1 = true;
+                decoded.direction1 = reader.i32();
+                readPoints(reader, decoded.snake1);
+                break;
+            case kSectionSnake2:
+                decoded.hasSnake2 = true;
+                decoded.direction2 = reader.i32();
+                readPoints(reader, decoded.snake2);
+                break;
+            case kSectionFoods:
+                decoded.food = reader.point();
+                decoded.hasSpecialFood = reader.flag();
+                decoded.specialFood = reader.point();
+                decoded.specialFoodType = reader.i32();
+                decoded.hasPoison = reader.flag();
+                decoded.poison = reader.point();
+                decoded.hasRandomItem = reader.flag();
+                decoded.randomItem = reader.point();
+                decoded.randomItemType = reader.i32();
+                hasFoods = true;
+                break;
+            case kSectionCorpses:
+                readPoints(reader, decoded.corpseFoods);
+                break;
+            case kSectionInfo:
+            {
+                uint64_t low = reader.u32();
+                uint64_t high = reader.u32();
+                decoded.savedAtMs = static_cast<int64_t>(low | (high << 32));
+                decoded.autosave = reader.flag();
+                break;
+            }
+            case kSectionLevels:
+            {
+                uint32_t count = reader.u32();
+                if (count > size / 4)
+                {
+                    error = "bad level table";
+                    return false;
+                }
+                decoded.levelStatus.resize(count);
+                for (int32_t& status : decoded.levelStatus)
+                {
+                    status = reader.i32();
+                }
+                break;
+            }
+            default:
+                // 新版本加入的段，旧程序忽略
+                break;
+        }
+        if (!reader.ok())
+        {
+            error = "truncated section " + std::to_string(id);
+            return false;
+        }
+    }
+
+    if (!hasMeta || !hasFoods)
+    {
+        error = "missing required section";
+        return false;
+    }
+    if (!validate(decoded, limits, error))
+    {
+        return false;
+    }
+    snapshot = std::move(decoded);
+    return true;
+}
+
+bool SaveFormat::decodeLegacy(const std::vector<uint8_t>& buffer, const SnapshotLimits& limits,
+                              GameSnapshot& snapshot, std::string& error)
+{
+    // 旧格式里蛇是否存在取决于存档时的模式，文件本身没有记录；
+    // 依次尝试各种组合，只接受恰好读完整个文件且取值合法的那一种
+    const bool layouts[4][2] = {{true, false}, {true, true}, {false, false}, {false, true}};
+    for (const auto& layout : layouts)
+    {
+        ByteReader reader(buffer.data(), buffer.size());
+        GameSnapshot decoded;
+        decoded.mode = reader.i32();
+        decoded.level = reader.i32();
+        decoded.points = reader.i32();
+        decoded.points2 = reader.i32();
+        decoded.lives1 = reader.i32();
+        decoded.lives2 = reader.i32();
+
+        decoded.hasSnake1 = layout[0];
+        if (decoded.hasSnake1)
+        {
+            reader.fixedPoints(decoded.snake1);
+            decoded.direction1 = reader.i32();
+        }
+        decoded.hasSnake2 = layout[1];
+        if (decoded.hasSnake2)
+        {
+            reader.fixedPoints(decoded.snake2);
+            decoded.direction2 = reader.i32();
+        }
+
+        decoded.food = reader.point();
+        decoded.hasSpecialFood = reader.flag();
+        if (decoded.hasSpecialFood)
+        {
+            decoded.specialFood = reader.point();
+            decoded.specialFoodType = reader.i32();
+        }
+        decoded.hasPoison = reader.flag();
+        if (decoded.hasPoison)
+        {
+            decoded.poison = reader.point();
+        }
+        reader.fixedPoints(decoded.corpseFoods);
+        decoded.hasRandomItem = reader.flag();
+        if (decoded.hasRandomItem)
+        {
+            decoded.randomItem = reader.point();
+            decoded.randomItemType = reader.i32();
+        }
+        uint32_t levelCount = reader.u32();
+        if (reader.ok() && levelCount <= buffer.size() / 4)
+        {
+            decoded.levelStatus.resize(levelCount);
+            for (int32_t& status : decoded.levelStatus)
+            {
+                status = reader.i32();
+            }
+        }
+
+        std::string ignored;
+        if (reader.ok() && reader.atEnd() && validate(decoded, limits, ignored))
+        {
+            snapshot = std::move(decoded);
+            return true;
+        }
+    }
+
+    error = "unrecognised or corrupted save file";
+    return false;
+}
+
+bool SaveFormat::validate(const GameSnapshot& snapshot, const SnapshotLimits& limits, std::string& error)
+{
+    if (snapshot.mode < 0 || snapshot.mode >= limits.modeCount)
+    {
+        error = "invalid game mode";
+        return false;
+    }
+    if (snapshot.level < 1 || snapshot.level > limits.maxLevel)
+    {
+        error = "invalid level";
+        return false;
+    }
+    if (snapshot.lives1 < 0 || snapshot.lives2 < 0)
+    {
+        error = "invalid lives";
+        return false;
+    }
+    if ((snapshot.hasSnake1 && (snapshot.snake1.empty() || snapshot.direction1 < 0 || snapshot.direction1 > 3)) ||
+        (snapshot.hasSnake2 && (snapshot.snake2.empty() || snapshot.direction2 < 0 || snapshot.direction2 > 3)))
+    {
+        error = "invalid snake";
+        return false;
+    }
+    // 游戏结束时的存档里蛇头可能已经越过边界一格（第四关还允许越过底边），
+    // 蛇身只限制在面板外留两格的范围内，用来挡住明显损坏的坐标
+    if (!allInsideBoard(snapshot.snake1, limits, 2) || !allInsideBoard(snapshot.snake2, limits, 2) ||
+        !allInsideBoard(snapshot.corpseFoods, limits))
+    {
+        error = "coordinates out of board";
+        return false;
+    }
+    if ((snapshot.hasSpecialFood && (!isInsideBoard(snapshot.specialFood, limits) ||
+                                     snapshot.specialFoodType < 0 || snapshot.specialFoodType > 4)) ||
+        (snapshot.hasPoison && !isInsideBoard(snapshot.poison, limits)) ||
+        (snapshot.hasRandomItem && (!isInsideBoard(snapshot.randomItem, limits) ||
+                                    snapshot.randomItemType < 0 || snapshot.randomItemType > 5)))
+    {
+        error = "invalid food or item";
+        return false;
+    }
+    if (static_cast<int>(snapshot.levelStatus.size()) > limits.maxLevel)
+    {
+        error = "invalid level table";
+        return false;
+    }
+    for (int32_t status : snapshot.levelStatus)
+    {
+        if (status < 0 || status > 2)
+        {
+            error = "invalid level status";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SaveFormat::writeFile(const std::string& path, const std::vector<uint8_t>& buffer)
+{
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // 整个存档一次写出；只有被信号打断或磁盘写满时才可能写不全，此时继续写剩余部分
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t result = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            // 写入0字节说明设备已经写不进去了（通常是磁盘已满），再循环也不会有进展；
+            // 文件已被 O_TRUNC 截断，删掉半截存档，免得下次读到残缺内容
+            int savedErrno = result == 0 ? ENOSPC : errno;
+            ::close(fd);
+            ::unlink(path.c_str());
+            errno = savedErrno;
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return ::close(fd) == 0;
+}
+
+bool SaveFormat::readFile(const std::string& path, std::vector<uint8_t>& buffer)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(info.st_size));
+    size_t done = 0;
+    while (done < buffer.size())
+    {
+        ssize_t result = ::read(fd, buffer.data() + done, buffer.size() - done);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            break;
+        }
+        done += static_cast<size_t>(result);
+    }
+    ::close(fd);
+    buffer.resize(done);
+    return true;
+}
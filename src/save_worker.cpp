@@ -0,0 +1,185 @@
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "save_worker.h"
+
+SaveWorker::SaveWorker()
+{
+    mThread = std::thread(&SaveWorker::run, this);
+}
+
+SaveWorker::~SaveWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_one();
+    mThread.join();
+}
+
+uint64_t SaveWorker::submit(const std::string& path, std::vector<uint8_t> buffer)
+{
+    Job job;
+    job.path = path;
+    job.buffer = std::move(buffer);
+    job.needsEncode = false;
+    return enqueue(std::move(job));
+}
+
+uint64_t SaveWorker::submit(const std::string& path, GameSnapshot snapshot)
+{
+    Job job;
+    job.path = path;
+    job.snapshot = std::move(snapshot);
+    job.needsEncode = true;
+    return enqueue(std::move(job));
+}
+
+uint64_t SaveWorker::enqueue(Job job)
+{
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        id = mNextId++;
+        job.id = id;
+        job.requested = Clock::now();
+        // 同一个文件只需要写最新的一份
+        bool replaced = false;
+        for (Job& pending : mJobs)
+        {
+            if (pending.path == job.path)
+            {
+                pending = std::move(job);
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced)
+        {
+            mJobs.push_back(std::move(job));
+        }
+    }
+    mWake.notify_one();
+    return id;
+}
+
+bool SaveWorker::poll(Result& result)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mResults.empty())
+    {
+        return false;
+    }
+    result = mResults.front();
+    mResults.pop_front();
+    return true;
+}
+
+void SaveWorker::flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return mJobs.empty() && !mBusy; });
+}
+
+void SaveWorker::run()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this] { return mStop || !mJobs.empty(); });
+            if (mJobs.empty())
+            {
+                // 只有在队列清空后才退出，保证退出前提交的存档都已落盘
+                return;
+            }
+            job = std::move(mJobs.front());
+            mJobs.pop_front();
+            mBusy = true;
+        }
+
+        Result result;
+        result.id = job.id;
+        result.path = job.path;
+        result.requested = job.requested;
+        Clock::time_point start = Clock::now();
+        if (job.needsEncode)
+        {
+            SaveFormat::encode(job.snapshot, job.buffer);
+            Clock::time_point encoded = Clock::now();
+            result.encodeMs = std::chrono::duration<double, std::milli>(encoded - start).count();
+            start = encoded;
+        }
+        result.ok = writeAtomic(job.path, job.buffer);
+        result.finished = Clock::now();
+        result.writeMs = std::chrono::duration<double, std::milli>(result.finished - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mResults.push_back(result);
+            // 没人取结果时不无限堆积
+            while (mResults.size() > 16)
+            {
+                mResults.pop_front();
+            }
+            mBusy = false;
+        }
+        mIdle.notify_all();
+    }
+}
+
+bool SaveWorker::writeAtomic(const std::string& path, const std::vector<uint8_t>& buffer)
+{
+    const std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t result = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if (result == 0)
+        {
+            // 一个字节都写不进去（通常是磁盘已满），再循环也不会有进展
+            errno = ENOSPC;
+            break;
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    bool ok = written == buffer.size() && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || ::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+
+    // rename本身也要落盘，否则掉电后目录项可能还指向旧文件
+    std::string directory = ".";
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos)
+    {
+        directory = slash == 0 ? "/" : path.substr(0, slash);
+    }
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0)
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
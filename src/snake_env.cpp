@@ -0,0 +1,892 @@
+#include <algorithm>
+#include <cstring>
+#include "snake_env.h"
+
+namespace
+{
+    // 与Game::getFoodEffect一致
+    int foodEffect(FoodType type)
+    {
+        switch (type)
+        {
+            case FoodType::Normal:   return 1;
+            case FoodType::Special1: return 2;
+            case FoodType::Special2: return 3;
+            case FoodType::Special3: return 5;
+            case FoodType::Poison:   return -1;
+        }
+        return 0;
+    }
+
+    // 与game.h中ItemType的取值一致
+    const int kItemPortal = 0;
+    const int kItemCheat = 2;
+    const int kItemAttack = 3;
+    const int kItemShield = 4;
+    const int kItemPoison = 5;
+    const int kItemTypeCount = 6;
+
+    void growTail(Snake& snake, int amount)
+    {
+        auto& body = snake.getSnake();
+        for (int i = 0; i < amount && !body.empty(); i++)
+        {
+            body.push_back(body.back()); // 复制尾部增加长度
+        }
+    }
+
+    bool isInside(const SnakeBody& cell, int width, int height)
+    {
+        return cell.getX() >= 0 && cell.getY() >= 0 && cell.getX() < width && cell.getY() < height;
+    }
+}
+
+SnakeEnv::SnakeEnv(const SnakeEnvConfig& config) : mConfig(config)
+{
+    mPtrMap.reset(new Map(mConfig.width, mConfig.height));
+    if (mConfig.mapFile.empty() || !mPtrMap->loadMapFromFile(mConfig.mapFile))
+    {
+        mPtrMap->loadDefaultMap();
+    }
+    mConfig.width = mPtrMap->getWidth();
+    mConfig.height = mPtrMap->getHeight();
+
+    mPtrSnake.reset(new Snake(mConfig.width, mConfig.height, mConfig.initialLength));
+    mPtrSnake->setMap(mPtrMap.get());
+    if (mConfig.opponent)
+    {
+        mPtrOpponent.reset(new Snake(mConfig.width, mConfig.height, mConfig.initialLength));
+        mPtrOpponent->setMap(mPtrMap.get());
+        mPtrAI.reset(new AI(mConfig.width, mConfig.height));
+    }
+
+    mSpawnSpace = 6;
+    if (mPtrMap->getValidSnakePositions(mConfig.initialLength, mSpawnSpace).empty())
+    {
+        mSpawnSpace = 1;
+    }
+    mSpawnPositions = &mPtrMap->getValidSnakePositions(mConfig.initialLength, mSpawnSpace);
+    mFreeCellCount = mPtrMap->getFreeCellCount();
+
+    mRng = mConfig.seed != 0 ? mConfig.seed : 1;
+    reset();
+}
+
+SnakeEnv::~SnakeEnv()
+{
+}
+
+uint32_t SnakeEnv::nextRandom()
+{
+    // xorshift32
+    mRng ^= mRng << 13;
+    mRng ^= mRng >> 17;
+    mRng ^= mRng << 5;
+    return mRng;
+}
+
+int SnakeEnv::randomInt(int bound)
+{
+    return bound > 0 ? static_cast<int>(nextRandom() % static_cast<uint32_t>(bound)) : 0;
+}
+
+void SnakeEnv::reset(unsigned int seed)
+{
+    if (seed != 0)
+    {
+        mRng = seed;
+    }
+
+    mSteps = 0;
+    mPoints = 0;
+    mOpponentPoints = 0;
+    mDone = false;
+    mTruncated = false;
+    mHasSpecialFood = false;
+    mHasPoison = false;
+    mHasRandomItem = false;
+    mCurrentFoodType = FoodType::Normal;
+    mFood = SnakeBody(-1, -1);
+    mSpecialFood = SnakeBody(-1, -1);
+    mPoison = SnakeBody(-1, -1);
+    mRandomItem = SnakeBody(-1, -1);
+    mCorpseFoods.clear();
+    mInventory.assign(kItemTypeCount, 0);
+
+    mPtrSnake->setLives(mConfig.lives);
+    spawnSnake(*mPtrSnake, nullptr);
+    if (mPtrOpponent)
+    {
+        mPtrOpponent->setLives(mConfig.opponentLives);
+        spawnSnake(*mPtrOpponent, mPtrSnake.get());
+    }
+
+    createFood();
+    senseAll();
+    mBoardDelta.clear();
+    mBoardDelta.full = true;
+}
+
+bool SnakeEnv::spawnSnake(Snake& snake, const Snake* other)
+{
+    // 出生点表按初始方向向前检查空间，蛇身则向反方向展开，这里再逐节确认一次
+    auto fits = [this, &snake, other](const SpawnPosition& spawn)
+    {
+        snake.initializeSnake(spawn.first.getX(), spawn.first.getY(), spawn.second);
+        for (const SnakeBody& part : snake.getSnake())
+        {
+            if (mPtrMap->isWall(part.getX(), part.getY()))
+            {
+                return false;
+            }
+            if (other != nullptr && other->isPartOfSnake(part.getX(), part.getY()))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // 有对手时与对战模式一致：在离对手尽量远、不压住对手和尸体食物的位置出生
+    if (other != nullptr)
+    {
+        std::vector<SnakeBody> occupied = other->getSnake();
+        occupied.insert(occupied.end(), mCorpseFoods.begin(), mCorpseFoods.end());
+        SpawnPosition spawn;
+        if (mPtrMap->pickSpawnFarFrom(mConfig.initialLength, mSpawnSpace, other->getSnake().front(),
+                                      occupied, nextRandom(), spawn) && fits(spawn))
+        {
+            return true;
+        }
+    }
+
+    const std::vector<SpawnPosition>& positions = *mSpawnPositions;
+    const int count = static_cast<int>(positions.size());
+    for (int attempt = 0; attempt < 32 && count > 0; attempt++)
+    {
+        if (fits(positions[randomInt(count)]))
+        {
+            return true;
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (fits(positions[i]))
+        {
+            return true;
+        }
+    }
+
+    // 实在没有合法位置时放在地图中央
+    snake.initializeSnake();
+    return false;
+}
+
+bool SnakeEnv::isOccupied(int x, int y) const
+{
+    if (mPtrMap->isWall(x, y))
+    {
+        return true;
+    }
+    if (mPtrSnake->isPartOfSnake(x, y) || (mPtrOpponent && mPtrOpponent->isPartOfSnake(x, y)))
+    {
+        return true;
+    }
+    const SnakeBody cell(x, y);
+    if (cell == mFood || (mHasSpecialFood && cell == mSpecialFood) ||
+        (mHasPoison && cell == mPoison) || (mHasRandomItem && cell == mRandomItem))
+    {
+        return true;
+    }
+    return std::find(mCorpseFoods.begin(), mCorpseFoods.end(), cell) != mCorpseFoods.end();
+}
+
+bool SnakeEnv::pickEmptyCell(SnakeBody& cell)
+{
+    const int innerWidth = mConfig.width - 2;
+    const int innerHeight = mConfig.height - 2;
+    if (innerWidth <= 0 || innerHeight <= 0 || mFreeCellCount <= 0)
+    {
+        return false;
+    }
+
+    // 空格多时直接在内部区域拒绝采样，结果与从空格列表中均匀挑选同分布；
+    // 连续失败说明空格很少，退回到完整的空格列表
+    for (int attempt = 0; attempt < 64; attempt++)
+    {
+        int x = 1 + randomInt(innerWidth);
+        int y = 1 + randomInt(innerHeight);
+        if (!isOccupied(x, y))
+        {
+            cell = SnakeBody(x, y);
+            return true;
+        }
+    }
+
+    std::vector<SnakeBody> candidates;
+    for (const SnakeBody& pos : mPtrMap->getEmptyPositions(std::vector<SnakeBody>()))
+    {
+        if (!isOccupied(pos.getX(), pos.getY()))
+        {
+            candidates.push_back(pos);
+        }
+    }
+    if (candidates.empty())
+    {
+        return false;
+    }
+    cell = candidates[randomInt(static_cast<int>(candidates.size()))];
+    return true;
+}
+
+void SnakeEnv::createFood()
+{
+    mFood = SnakeBody(-1, -1);
+    SnakeBody cell;
+    if (pickEmptyCell(cell))
+    {
+        mFood = cell;
+    }
+    else
+    {
+        // 棋盘已满，本局结束
+        mDone = true;
+    }
+}
+
+void SnakeEnv::createSpecialFood()
+{
+    SnakeBody cell;
+    if (!pickEmptyCell(cell))
+    {
+        mHasSpecialFood = false;
+        return;
+    }
+    // 特殊食物1 50%，特殊食物2 30%，特殊食物3 20%
+    int roll = randomInt(100);
+    if (roll < 50)
+    {
+        mCurrentFoodType = FoodType::Special1;
+    }
+    else if (roll < 80)
+    {
+        mCurrentFoodType = FoodType::Special2;
+    }
+    else
+    {
+        mCurrentFoodType = FoodType::Special3;
+    }
+    mSpecialFood = cell;
+    mHasSpecialFood = true;
+    mSpecialFoodExpire = mSteps + mConfig.itemDurationTicks;
+}
+
+void SnakeEnv::createPoison()
+{
+    SnakeBody cell;
+    if (!pickEmptyCell(cell))
+    {
+        mHasPoison = false;
+        return;
+    }
+    mPoison = cell;
+    mHasPoison = true;
+    mPoisonExpire = mSteps + mConfig.itemDurationTicks;
+}
+
+void SnakeEnv::createRandomItem()
+{
+    SnakeBody cell;
+    if (!pickEmptyCell(cell))
+    {
+        mHasRandomItem = false;
+        return;
+    }
+    // 传送门35%，护盾20%，作弊20%，攻击15%，毒药10%
+    int roll = randomInt(100);
+    if (roll < 35)
+    {
+        mRandomItemType = kItemPortal;
+    }
+    else if (roll < 55)
+    {
+        mRandomItemType = kItemShield;
+    }
+    else if (roll < 75)
+    {
+        mRandomItemType = kItemCheat;
+    }
+    else if (roll < 90)
+    {
+        mRandomItemType = kItemAttack;
+    }
+    else
+    {
+        mRandomItemType = kItemPoison;
+    }
+    mRandomItem = cell;
+    mHasRandomItem = true;
+    mRandomItemExpire = mSteps + mConfig.itemDurationTicks;
+}
+
+void SnakeEnv::createCorpseFoods(const std::vector<SnakeBody>& body)
+{
+    // 与Game::createCorpseFoods一致：替换旧的尸体食物，排除墙上和界外的部分
+    for (const SnakeBody& corpse : mCorpseFoods)
+    {
+        markDirty(corpse, BoardChange::Despawned);
+    }
+    mCorpseFoods.clear();
+    for (const SnakeBody& part : body)
+    {
+        if (isInside(part, mConfig.width, mConfig.height) && !mPtrMap->isWall(part.getX(), part.getY()) &&
+            std::find(mCorpseFoods.begin(), mCorpseFoods.end(), part) == mCorpseFoods.end())
+        {
+            mCorpseFoods.push_back(part);
+            markDirty(part, BoardChange::Spawned);
+        }
+    }
+}
+
+void SnakeEnv::senseAll()
+{
+    Snake* snakes[2] = {mPtrSnake.get(), mPtrOpponent.get()};
+    for (Snake* snake : snakes)
+    {
+        if (snake == nullptr)
+        {
+            continue;
+        }
+        snake->senseFood(mFood);
+        snake->senseSpecialFood(mHasSpecialFood ? mSpecialFood : SnakeBody(-1, -1));
+        snake->sensePoison(mHasPoison ? mPoison : SnakeBody(-1, -1));
+        snake->senseRandomItem(mHasRandomItem ? mRandomItem : SnakeBody(-1, -1));
+        snake->senseCorpseFoods(mCorpseFoods);
+    }
+}
+
+void SnakeEnv::onFoodEaten()
+{
+    createFood();
+    // 70%生成特殊食物，否则生成毒药
+    if (randomInt(100) < 70)
+    {
+        createSpecialFood();
+    }
+    else
+    {
+        createPoison();
+    }
+    // 10%概率生成随机道具，否则当前道具消失
+    if (mConfig.randomItems && randomInt(100) < 10)
+    {
+        createRandomItem();
+    }
+    else
+    {
+        mHasRandomItem = false;
+    }
+}
+
+bool SnakeEnv::handleDeath(Snake& snake)
+{
+    const std::vector<SnakeBody> body = snake.getSnake();
+    for (const SnakeBody& part : body)
+    {
+        markDirty(part, BoardChange::Despawned);
+    }
+    if (!snake.loseLife())
+    {
+        return false;
+    }
+    createCorpseFoods(body);
+    spawnSnake(snake, &snake == mPtrSnake.get() ? mPtrOpponent.get() : mPtrSnake.get());
+    for (const SnakeBody& part : snake.getSnake())
+    {
+        markDirty(part, BoardChange::Spawned);
+    }
+    return true;
+}
+
+float SnakeEnv::step(int action)
+{
+    mBoardDelta.clear();
+    if (mDone)
+    {
+        return 0.0f;
+    }
+    mSteps++;
+    float reward = mConfig.rewardStep;
+    const int pointsBefore = mPoints;
+
+    if (action >= 0 && action < static_cast<int>(EnvAction::Keep))
+    {
+        mPtrSnake->changeDirection(static_cast<Direction>(action));
+    }
+    if (mPtrOpponent)
+    {
+        Direction aiDirection = mPtrAI->findNextMove(*mPtrMap, *mPtrSnake, *mPtrOpponent,
+                                                     mFood, mSpecialFood, mPoison, mRandomItem,
+                                                     mCurrentFoodType, mHasSpecialFood, mHasPoison, mHasRandomItem);
+        mPtrOpponent->changeDirection(aiDirection);
+    }
+    endPhase(FramePhase::AI);
+
+    // 移动前判断下一格，与moveFoward内部的判断一致
+    Snake* snakes[2] = {mPtrSnake.get(), mPtrOpponent.get()};
+    bool ateFood[2] = {false, false};
+    bool ateCorpse[2] = {false, false};
+    SnakeBody eatenCorpse[2];
+    for (int i = 0; i < 2; i++)
+    {
+        if (snakes[i] == nullptr)
+        {
+            continue;
+        }
+        ateFood[i] = snakes[i]->touchFood();
+        ateCorpse[i] = !ateFood[i] && snakes[i]->touchCorpseFood();
+        eatenCorpse[i] = snakes[i]->getEatenCorpseFood();
+    }
+    // 本步开始时的食物和道具，结束时与新状态比较得出出现和消失的格子
+    const SnakeBody foodBefore = mFood;
+    const SnakeBody specialFoodBefore = mSpecialFood;
+    const SnakeBody poisonBefore = mPoison;
+    const SnakeBody randomItemBefore = mRandomItem;
+    const bool hadSpecialFood = mHasSpecialFood;
+    const bool hadPoison = mHasPoison;
+    const bool hadRandomItem = mHasRandomItem;
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (snakes[i] != nullptr)
+        {
+            // 原蛇头变成蛇身，原蛇尾离开（增长时蛇尾原地复制，finishBoardDelta会得出仍是蛇身）
+            markDirty(snakes[i]->getSnake().front(), BoardChange::Head);
+            markDirty(snakes[i]->getSnake().back(), BoardChange::TailCleared);
+            snakes[i]->moveFoward();
+            markDirty(snakes[i]->getSnake().front(), BoardChange::Head);
+        }
+    }
+
+    // 碰撞：撞墙、撞自己、撞对方身体；头对头双方都算
+    bool collided[2] = {false, false};
+    collided[0] = mPtrSnake->checkCollision();
+    if (mPtrOpponent)
+    {
+        const SnakeBody head = mPtrSnake->getSnake().front();
+        const SnakeBody opponentHead = mPtrOpponent->getSnake().front();
+        collided[0] = collided[0] || mPtrOpponent->isPartOfSnake(head.getX(), head.getY());
+        collided[1] = mPtrOpponent->checkCollision() || mPtrSnake->isPartOfSnake(opponentHead.getX(), opponentHead.getY());
+        if (head == opponentHead)
+        {
+            collided[0] = true;
+            collided[1] = true;
+        }
+    }
+
+    // 道具按蛇头进入的格子结算，只对本步存活的蛇生效
+    bool foodConsumed = false;
+    for (int i = 0; i < 2; i++)
+    {
+        Snake* snake = snakes[i];
+        if (snake == nullptr || collided[i])
+        {
+            continue;
+        }
+        int& points = (i == 0) ? mPoints : mOpponentPoints;
+        const SnakeBody head = snake->getSnake().front();
+
+        if (ateFood[i])
+        {
+            // 两条蛇同时吃到时都在moveFoward中增长，各记一分
+            points++;
+            foodConsumed = true;
+        }
+        if (ateCorpse[i])
+        {
+            growTail(*snake, foodEffect(FoodType::Normal));
+            points += foodEffect(FoodType::Normal);
+            mCorpseFoods.erase(std::remove(mCorpseFoods.begin(), mCorpseFoods.end(), eatenCorpse[i]), mCorpseFoods.end());
+            markDirty(eatenCorpse[i], BoardChange::Despawned);
+        }
+        if (mHasSpecialFood && head == mSpecialFood)
+        {
+            int effect = foodEffect(mCurrentFoodType);
+            growTail(*snake, effect);
+            points += effect;
+            mHasSpecialFood = false;
+        }
+        if (mHasPoison && head == mPoison)
+        {
+            auto& body = snake->getSnake();
+            for (int k = 0; k < -foodEffect(FoodType::Poison) && body.size() > 1; k++)
+            {
+                markDirty(body.back(), BoardChange::TailCleared);
+                body.pop_back();
+            }
+            if (i == 0)
+            {
+                reward += static_cast<float>(foodEffect(FoodType::Poison));
+            }
+            mHasPoison = false;
+        }
+        if (mHasRandomItem && head == mRandomItem)
+        {
+            // 对手捡到的道具直接消失
+            if (i == 0)
+            {
+                mInventory[mRandomItemType]++;
+            }
+            mHasRandomItem = false;
+        }
+    }
+    reward += static_cast<float>(mPoints - pointsBefore);
+    endPhase(FramePhase::Sim);
+
+    // 结算死亡（重生）
+    bool playerOut = false;
+    bool opponentOut = false;
+    if (collided[0])
+    {
+        reward += mConfig.rewardDeath;
+        playerOut = !handleDeath(*mPtrSnake);
+    }
+    if (collided[1])
+    {
+        opponentOut = !handleDeath(*mPtrOpponent);
+        if (opponentOut && !playerOut)
+        {
+            reward += mConfig.rewardWin;
+        }
+    }
+
+    if (foodConsumed)
+    {
+        onFoodEaten();
+    }
+
+    // 特殊食物、毒药和道具超时消失
+    if (mHasSpecialFood && mSteps >= mSpecialFoodExpire)
+    {
+        mHasSpecialFood = false;
+    }
+    if (mHasPoison && mSteps >= mPoisonExpire)
+    {
+        mHasPoison = false;
+    }
+    if (mHasRandomItem && mSteps >= mRandomItemExpire)
+    {
+        mHasRandomItem = false;
+    }
+    endPhase(FramePhase::Spawn);
+
+    markItemChange(foodBefore, true, mFood, true);
+    markItemChange(specialFoodBefore, hadSpecialFood, mSpecialFood, mHasSpecialFood);
+    markItemChange(poisonBefore, hadPoison, mPoison, mHasPoison);
+    markItemChange(randomItemBefore, hadRandomItem, mRandomItem, mHasRandomItem);
+    finishBoardDelta();
+
+    senseAll();
+    endPhase(FramePhase::Sim);
+
+    if (playerOut || opponentOut)
+    {
+        mDone = true;
+    }
+    else if (!mDone && mConfig.maxSteps > 0 && mSteps >= mConfig.maxSteps)
+    {
+        mDone = true;
+        mTruncated = true;
+    }
+    return reward;
+}
+
+void SnakeEnv::writeObservation(uint8_t* out) const
+{
+    const int width = mConfig.width;
+    const int height = mConfig.height;
+    const size_t plane = static_cast<size_t>(width) * height;
+    std::memset(out, 0, plane * static_cast<size_t>(EnvChannel::Count));
+
+    auto mark = [out, plane, width, height](EnvChannel channel, const SnakeBody& cell, uint8_t value)
+    {
+        if (isInside(cell, width, height))
+        {
+            out[plane * static_cast<size_t>(channel) + static_cast<size_t>(cell.getY()) * width + cell.getX()] = value;
+        }
+    };
+
+    const Bitboard& walls = mPtrMap->getWallBits();
+    uint8_t* wallPlane = out + plane * static_cast<size_t>(EnvChannel::Wall);
+    walls.forEachSet([wallPlane, width](int x, int y) {
+        wallPlane[static_cast<size_t>(y) * width + x] = 1;
+    });
+
+    const Snake* snakes[2] = {mPtrSnake.get(), mPtrOpponent.get()};
+    const EnvChannel headChannel[2] = {EnvChannel::Head, EnvChannel::OpponentHead};
+    const EnvChannel bodyChannel[2] = {EnvChannel::Body, EnvChannel::OpponentBody};
+    for (int i = 0; i < 2; i++)
+    {
+        if (snakes[i] == nullptr || !snakes[i]->isAlive())
+        {
+            continue;
+        }
+        const std::vector<SnakeBody>& body = snakes[i]->getSnake();
+        for (size_t k = 1; k < body.size(); k++)
+        {
+            mark(bodyChannel[i], body[k], 1);
+        }
+        if (!body.empty())
+        {
+            mark(headChannel[i], body.front(), 1);
+        }
+    }
+
+    mark(EnvChannel::Food, mFood, 1);
+    if (mHasSpecialFood)
+    {
+        mark(EnvChannel::SpecialFood, mSpecialFood, static_cast<uint8_t>(foodEffect(mCurrentFoodType)));
+    }
+    if (mHasPoison)
+    {
+        mark(EnvChannel::Poison, mPoison, 1);
+    }
+    for (const SnakeBody& corpse : mCorpseFoods)
+    {
+        mark(EnvChannel::CorpseFood, corpse, 1);
+    }
+    if (mHasRandomItem)
+    {
+        mark(EnvChannel::RandomItem, mRandomItem, static_cast<uint8_t>(mRandomItemType + 1));
+    }
+}
+
+void SnakeEnv::writeBoard(BoardFrame& frame) const
+{
+    if (frame.width != mConfig.width || frame.height != mConfig.height)
+    {
+        frame.resize(mConfig.width, mConfig.height);
+    }
+    else
+    {
+        frame.clear();
+    }
+
+    mPtrMap->getWallBits().forEachSet([&frame](int x, int y) {
+        frame.set(x, y, BoardCell::Wall);
+    });
+    for (const SnakeBody& corpse : mCorpseFoods)
+    {
+        frame.set(corpse.getX(), corpse.getY(), BoardCell::CorpseFood);
+    }
+    frame.set(mFood.getX(), mFood.getY(), BoardCell::Food);
+    if (mHasSpecialFood)
+    {
+        frame.set(mSpecialFood.getX(), mSpecialFood.getY(), BoardCell::SpecialFood);
+    }
+    if (mHasPoison)
+    {
+        frame.set(mPoison.getX(), mPoison.getY(), BoardCell::Poison);
+    }
+    if (mHasRandomItem)
+    {
+        frame.set(mRandomItem.getX(), mRandomItem.getY(), BoardCell::RandomItem);
+    }
+
+    const Snake* snakes[2] = {mPtrSnake.get(), mPtrOpponent.get()};
+    const BoardCell headCell[2] = {BoardCell::Head, BoardCell::OpponentHead};
+    const BoardCell bodyCell[2] = {BoardCell::Body, BoardCell::OpponentBody};
+    for (int i = 0; i < 2; i++)
+    {
+        if (snakes[i] == nullptr || !snakes[i]->isAlive())
+        {
+            continue;
+        }
+        const std::vector<SnakeBody>& body = snakes[i]->getSnake();
+        for (size_t k = 1; k < body.size(); k++)
+        {
+            frame.set(body[k].getX(), body[k].getY(), bodyCell[i]);
+        }
+        if (!body.empty())
+        {
+            frame.set(body.front().getX(), body.front().getY(), headCell[i]);
+        }
+    }
+}
+
+const BoardDelta& SnakeEnv::getBoardDelta() const
+{
+    return mBoardDelta;
+}
+
+void SnakeEnv::markDirty(const SnakeBody& cell, BoardChange change)
+{
+    if (isInside(cell, mConfig.width, mConfig.height))
+    {
+        BoardDeltaCell dirty;
+        dirty.x = static_cast<int16_t>(cell.getX());
+        dirty.y = static_cast<int16_t>(cell.getY());
+        dirty.cell = BoardCell::Empty;
+        dirty.change = change;
+        mBoardDelta.cells.push_back(dirty);
+    }
+}
+
+void SnakeEnv::markItemChange(const SnakeBody& before, bool hadBefore, const SnakeBody& after, bool hasAfter)
+{
+    const bool moved = !(before == after);
+    if (hadBefore && (!hasAfter || moved))
+    {
+        markDirty(before, BoardChange::Despawned);
+    }
+    if (hasAfter && (!hadBefore || moved))
+    {
+        markDirty(after, BoardChange::Spawned);
+    }
+}
+
+void SnakeEnv::finishBoardDelta()
+{
+    std::vector<BoardDeltaCell>& cells = mBoardDelta.cells;
+    // 同一格子被记录多次时保留最后一次的变化原因
+    std::stable_sort(cells.begin(), cells.end(), [](const BoardDeltaCell& a, const BoardDeltaCell& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+    size_t count = 0;
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (i + 1 < cells.size() && cells[i + 1].x == cells[i].x && cells[i + 1].y == cells[i].y)
+        {
+            continue;
+        }
+        cells[count] = cells[i];
+        cells[count].cell = cellAt(cells[count].x, cells[count].y);
+        count++;
+    }
+    cells.resize(count);
+}
+
+BoardCell SnakeEnv::cellAt(int x, int y) const
+{
+    // 后画的在上层：对手蛇头 > 对手蛇身 > 玩家蛇头 > 玩家蛇身 > 道具和食物 > 墙
+    const Snake* snakes[2] = {mPtrOpponent.get(), mPtrSnake.get()};
+    const BoardCell headCell[2] = {BoardCell::OpponentHead, BoardCell::Head};
+    const BoardCell bodyCell[2] = {BoardCell::OpponentBody, BoardCell::Body};
+    for (int i = 0; i < 2; i++)
+    {
+        if (snakes[i] == nullptr || !snakes[i]->isAlive() || snakes[i]->getSnake().empty())
+        {
+            continue;
+        }
+        const SnakeBody& head = snakes[i]->getSnake().front();
+        if (head.getX() == x && head.getY() == y)
+        {
+            return headCell[i];
+        }
+        if (snakes[i]->isPartOfSnake(x, y))
+        {
+            return bodyCell[i];
+        }
+    }
+
+    const SnakeBody cell(x, y);
+    if (mHasRandomItem && cell == mRandomItem)
+    {
+        return BoardCell::RandomItem;
+    }
+    if (mHasPoison && cell == mPoison)
+    {
+        return BoardCell::Poison;
+    }
+    if (mHasSpecialFood && cell == mSpecialFood)
+    {
+        return BoardCell::SpecialFood;
+    }
+    if (cell == mFood)
+    {
+        return BoardCell::Food;
+    }
+    if (std::find(mCorpseFoods.begin(), mCorpseFoods.end(), cell) != mCorpseFoods.end())
+    {
+        return BoardCell::CorpseFood;
+    }
+    return mPtrMap->isWall(x, y) ? BoardCell::Wall : BoardCell::Empty;
+}
+
+int SnakeEnv::getWidth() const
+{
+    return mConfig.width;
+}
+
+int SnakeEnv::getHeight() const
+{
+    return mConfig.height;
+}
+
+int SnakeEnv::getObservationSize() const
+{
+    return mConfig.width * mConfig.height * static_cast<int>(EnvChannel::Count);
+}
+
+bool SnakeEnv::isDone() const
+{
+    return mDone;
+}
+
+bool SnakeEnv::isTruncated() const
+{
+    return mTruncated;
+}
+
+int SnakeEnv::getSteps() const
+{
+    return mSteps;
+}
+
+int SnakeEnv::getPoints() const
+{
+    return mPoints;
+}
+
+int SnakeEnv::getOpponentPoints() const
+{
+    return mOpponentPoints;
+}
+
+int SnakeEnv::getLength() const
+{
+    return mPtrSnake->getLength();
+}
+
+int SnakeEnv::getLives() const
+{
+    return mPtrSnake->getLives();
+}
+
+const std::vector<int>& SnakeEnv::getInventory() const
+{
+    return mInventory;
+}
+
+const Map& SnakeEnv::getMap() const
+{
+    return *mPtrMap;
+}
+
+const Snake& SnakeEnv::getSnake() const
+{
+    return *mPtrSnake;
+}
+
+void SnakeEnv::setFrameStats(FrameStats* stats)
+{
+    mPtrFrameStats = stats;
+}
+
+void SnakeEnv::endPhase(FramePhase phase)
+{
+    if (mPtrFrameStats != nullptr)
+    {
+        mPtrFrameStats->endPhase(phase);
+    }
+}
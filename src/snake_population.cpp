@@ -0,0 +1,286 @@
+#include <algorithm>
+#include "snake_population.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SNAKE_POPULATION_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // 按Direction枚举顺序：Left, Right, Up, Down，与Snake::createNewHead一致
+    const int32_t kDeltaX[4] = {-1, 1, 0, 0};
+    const int32_t kDeltaY[4] = {0, 0, -1, 1};
+    const int32_t kInitialCapacity = 16;
+}
+
+SnakePopulation::SnakePopulation() : mUseSimd(isSimdAvailable())
+{
+}
+
+void SnakePopulation::reset(int count, int width, int height)
+{
+    mCount = count;
+    mWidth = width;
+    mHeight = height;
+
+    mHeadX.assign(count, 0);
+    mHeadY.assign(count, 0);
+    mDirection.assign(count, static_cast<int32_t>(Direction::Right));
+    mLength.assign(count, 0);
+    mRingCapacity.assign(count, kInitialCapacity);
+    mRingHead.assign(count, 0);
+    mAlive.assign(count, 0);
+
+    mRingOffset.resize(count);
+    for (int id = 0; id < count; id++)
+    {
+        mRingOffset[id] = id * kInitialCapacity;
+    }
+    mBody.assign(static_cast<size_t>(count) * kInitialCapacity, -1);
+
+    mNextX.assign(count, 0);
+    mNextY.assign(count, 0);
+    mBlocked.assign(count, 0);
+}
+
+int SnakePopulation::size() const
+{
+    return mCount;
+}
+
+int SnakePopulation::getWidth() const
+{
+    return mWidth;
+}
+
+int SnakePopulation::getHeight() const
+{
+    return mHeight;
+}
+
+void SnakePopulation::place(int id, const int* cells, int count, Direction direction)
+{
+    // 容量不够时在身体池末尾分配新的区域
+    int capacity = mRingCapacity[id];
+    if (count > capacity)
+    {
+        while (capacity < count)
+        {
+            capacity *= 2;
+        }
+        mRingOffset[id] = static_cast<int32_t>(mBody.size());
+        mRingCapacity[id] = capacity;
+        mBody.resize(mBody.size() + capacity, -1);
+    }
+
+    int32_t* ring = &mBody[mRingOffset[id]];
+    for (int k = 0; k < count; k++)
+    {
+        ring[k] = cells[k];
+    }
+    mRingHead[id] = 0;
+    mLength[id] = count;
+    mHeadX[id] = cells[0] % mWidth;
+    mHeadY[id] = cells[0] / mWidth;
+    mDirection[id] = static_cast<int32_t>(direction);
+    mAlive[id] = 1;
+}
+
+void SnakePopulation::kill(int id)
+{
+    mAlive[id] = 0;
+    mLength[id] = 0;
+}
+
+bool SnakePopulation::isAlive(int id) const
+{
+    return mAlive[id] != 0;
+}
+
+int SnakePopulation::getLength(int id) const
+{
+    return mLength[id];
+}
+
+Direction SnakePopulation::getDirection(int id) const
+{
+    return static_cast<Direction>(mDirection[id]);
+}
+
+void SnakePopulation::setDirection(int id, Direction direction)
+{
+    mDirection[id] = static_cast<int32_t>(direction);
+}
+
+int SnakePopulation::getHeadX(int id) const
+{
+    return mHeadX[id];
+}
+
+int SnakePopulation::getHeadY(int id) const
+{
+    return mHeadY[id];
+}
+
+int SnakePopulation::getHeadCell(int id) const
+{
+    return mHeadY[id] * mWidth + mHeadX[id];
+}
+
+int SnakePopulation::getTailCell(int id) const
+{
+    return getBodyCell(id, mLength[id] - 1);
+}
+
+int SnakePopulation::getBodyCell(int id, int k) const
+{
+    return mBody[mRingOffset[id] + ((mRingHead[id] + k) & (mRingCapacity[id] - 1))];
+}
+
+void SnakePopulation::growRing(int id)
+{
+    // 搬到两倍大小的新区域，按蛇头到蛇尾的顺序重新排列
+    const int32_t capacity = mRingCapacity[id];
+    const int32_t offset = static_cast<int32_t>(mBody.size());
+    mBody.resize(mBody.size() + capacity * 2, -1);
+    for (int k = 0; k < mLength[id]; k++)
+    {
+        mBody[offset + k] = mBody[mRingOffset[id] + ((mRingHead[id] + k) & (capacity - 1))];
+    }
+    mRingOffset[id] = offset;
+    mRingCapacity[id] = capacity * 2;
+    mRingHead[id] = 0;
+}
+
+void SnakePopulation::pushHead(int id, int x, int y)
+{
+    if (mLength[id] == mRingCapacity[id])
+    {
+        growRing(id);
+    }
+    mRingHead[id] = (mRingHead[id] - 1) & (mRingCapacity[id] - 1);
+    mBody[mRingOffset[id] + mRingHead[id]] = y * mWidth + x;
+    mLength[id]++;
+    mHeadX[id] = x;
+    mHeadY[id] = y;
+}
+
+void SnakePopulation::popTail(int id)
+{
+    mLength[id]--;
+}
+
+void SnakePopulation::advanceHeads(const uint8_t* walls)
+{
+#ifdef SNAKE_POPULATION_AVX2
+    if (mUseSimd)
+    {
+        advanceHeadsAvx2(walls, mCount);
+        return;
+    }
+#endif
+    advanceHeadsScalar(walls, 0, mCount);
+}
+
+void SnakePopulation::advanceHeadsScalar(const uint8_t* walls, int begin, int end)
+{
+    const int32_t maxX = mWidth - 1;
+    const int32_t maxY = mHeight - 1;
+    for (int i = begin; i < end; i++)
+    {
+        const int32_t direction = mDirection[i];
+        const int32_t x = mHeadX[i] + kDeltaX[direction];
+        const int32_t y = mHeadY[i] + kDeltaY[direction];
+        const bool outside = x < 0 || x > maxX || y < 0 || y > maxY;
+        mNextX[i] = x;
+        mNextY[i] = y;
+        mBlocked[i] = outside || walls[y * mWidth + x] != 0;
+    }
+}
+
+#ifdef SNAKE_POPULATION_AVX2
+__attribute__((target("avx2")))
+void SnakePopulation::advanceHeadsAvx2(const uint8_t* walls, int end)
+{
+    const __m256i deltaX = _mm256_setr_epi32(-1, 1, 0, 0, 0, 0, 0, 0);
+    const __m256i deltaY = _mm256_setr_epi32(0, 0, -1, 1, 0, 0, 0, 0);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i maxX = _mm256_set1_epi32(mWidth - 1);
+    const __m256i maxY = _mm256_set1_epi32(mHeight - 1);
+    const __m256i width = _mm256_set1_epi32(mWidth);
+
+    int i = 0;
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256i direction = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&mDirection[i]));
+        const __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&mHeadX[i])),
+                                           _mm256_permutevar8x32_epi32(deltaX, direction));
+        const __m256i y = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&mHeadY[i])),
+                                           _mm256_permutevar8x32_epi32(deltaY, direction));
+
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(zero, x), _mm256_cmpgt_epi32(x, maxX));
+        outside = _mm256_or_si256(outside, _mm256_cmpgt_epi32(zero, y));
+        outside = _mm256_or_si256(outside, _mm256_cmpgt_epi32(y, maxY));
+
+        // 越界的通道不做读取；gather一次读4字节，因此walls末尾需要3字节填充
+        const __m256i index = _mm256_andnot_si256(outside, _mm256_add_epi32(_mm256_mullo_epi32(y, width), x));
+        const __m256i inside = _mm256_xor_si256(outside, allOnes);
+        __m256i tile = _mm256_mask_i32gather_epi32(zero, reinterpret_cast<const int*>(walls), index, inside, 1);
+        tile = _mm256_and_si256(tile, byteMask);
+        const __m256i isWall = _mm256_xor_si256(_mm256_cmpeq_epi32(tile, zero), allOnes);
+        const __m256i blocked = _mm256_or_si256(outside, isWall);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&mNextX[i]), x);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&mNextY[i]), y);
+        const int bits = _mm256_movemask_ps(_mm256_castsi256_ps(blocked));
+        for (int k = 0; k < 8; k++)
+        {
+            mBlocked[i + k] = (bits >> k) & 1;
+        }
+    }
+
+    advanceHeadsScalar(walls, i, end);
+}
+#else
+void SnakePopulation::advanceHeadsAvx2(const uint8_t* walls, int end)
+{
+    advanceHeadsScalar(walls, 0, end);
+}
+#endif
+
+const int32_t* SnakePopulation::getNextX() const
+{
+    return mNextX.data();
+}
+
+const int32_t* SnakePopulation::getNextY() const
+{
+    return mNextY.data();
+}
+
+const uint8_t* SnakePopulation::getBlocked() const
+{
+    return mBlocked.data();
+}
+
+void SnakePopulation::setUseSimd(bool useSimd)
+{
+    mUseSimd = useSimd && isSimdAvailable();
+}
+
+bool SnakePopulation::isUsingSimd() const
+{
+    return mUseSimd;
+}
+
+bool SnakePopulation::isSimdAvailable()
+{
+#ifdef SNAKE_POPULATION_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
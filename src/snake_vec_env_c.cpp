@@ -0,0 +1,147 @@
+#include "snake_vec_env_c.h"
+#include "vec_env.h"
+#include <memory>
+
+struct SnakeVecEnv
+{
+    VecEnv* vecEnv;
+};
+
+namespace
+{
+    bool isValidIndex(const SnakeVecEnv* env, int index)
+    {
+        return env != nullptr && index >= 0 && index < env->vecEnv->getNumEnvs();
+    }
+}
+
+void snake_vec_env_default_options(SnakeVecEnvOptions* options)
+{
+    if (options == nullptr)
+    {
+        return;
+    }
+    const VecEnvConfig defaults;
+    options->num_envs = defaults.numEnvs;
+    options->num_threads = defaults.numThreads;
+    options->map_file = nullptr;
+    options->width = defaults.env.width;
+    options->height = defaults.env.height;
+    options->initial_length = defaults.env.initialLength;
+    options->lives = defaults.env.lives;
+    options->opponent = defaults.env.opponent ? 1 : 0;
+    options->max_steps = defaults.env.maxSteps;
+    options->item_duration_ticks = defaults.env.itemDurationTicks;
+    options->reward_death = defaults.env.rewardDeath;
+    options->reward_win = defaults.env.rewardWin;
+    options->reward_step = defaults.env.rewardStep;
+    options->seed = defaults.env.seed;
+}
+
+SnakeVecEnv* snake_vec_env_create(const SnakeVecEnvOptions* options)
+{
+    if (options == nullptr || options->num_envs <= 0 || options->initial_length <= 0 ||
+        options->width < 3 || options->height < 3)
+    {
+        return nullptr;
+    }
+
+    VecEnvConfig config;
+    config.numEnvs = options->num_envs;
+    config.numThreads = options->num_threads;
+    config.env.mapFile = options->map_file != nullptr ? options->map_file : "";
+    config.env.width = options->width;
+    config.env.height = options->height;
+    config.env.initialLength = options->initial_length;
+    config.env.lives = options->lives;
+    config.env.opponent = options->opponent != 0;
+    config.env.maxSteps = options->max_steps;
+    config.env.itemDurationTicks = options->item_duration_ticks;
+    config.env.rewardDeath = options->reward_death;
+    config.env.rewardWin = options->reward_win;
+    config.env.rewardStep = options->reward_step;
+    config.env.seed = options->seed;
+
+    // 不让异常穿过C边界
+    try
+    {
+        // VecEnv 构造成功之前由 unique_ptr 持有，构造抛出时不会泄漏
+        std::unique_ptr<SnakeVecEnv> env(new SnakeVecEnv);
+        env->vecEnv = new VecEnv(config);
+        return env.release();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void snake_vec_env_destroy(SnakeVecEnv* env)
+{
+    if (env != nullptr)
+    {
+        delete env->vecEnv;
+        delete env;
+    }
+}
+
+int snake_vec_env_num_envs(const SnakeVecEnv* env)
+{
+    return env != nullptr ? env->vecEnv->getNumEnvs() : -1;
+}
+
+int snake_vec_env_num_channels(const SnakeVecEnv* env)
+{
+    return env != nullptr ? env->vecEnv->getChannelCount() : -1;
+}
+
+int snake_vec_env_width(const SnakeVecEnv* env)
+{
+    return env != nullptr ? env->vecEnv->getWidth() : -1;
+}
+
+int snake_vec_env_height(const SnakeVecEnv* env)
+{
+    return env != nullptr ? env->vecEnv->getHeight() : -1;
+}
+
+int snake_vec_env_obs_size(const SnakeVecEnv* env)
+{
+    return env != nullptr ? env->vecEnv->getObservationSize() : -1;
+}
+
+int snake_vec_env_reset(SnakeVecEnv* env, uint8_t* observations)
+{
+    if (env == nullptr)
+    {
+        return -1;
+    }
+    env->vecEnv->reset(observations);
+    return 0;
+}
+
+int snake_vec_env_step(SnakeVecEnv* env, const int32_t* actions, uint8_t* observations,
+                       float* rewards, uint8_t* dones, uint8_t* truncated)
+{
+    if (env == nullptr || actions == nullptr || rewards == nullptr || dones == nullptr)
+    {
+        return -1;
+    }
+    env->vecEnv->step(reinterpret_cast<const int*>(actions), observations, rewards, dones, truncated);
+    return 0;
+}
+
+int snake_vec_env_last_episode_points(const SnakeVecEnv* env, int index)
+{
+    return isValidIndex(env, index) ? env->vecEnv->getLastEpisodePoints(index) : -1;
+}
+
+int snake_vec_env_last_episode_length(const SnakeVecEnv* env, int index)
+{
+    return isValidIndex(env, index) ? env->vecEnv->getLastEpisodeLength(index) : -1;
+}
+
+int snake_vec_env_last_episode_steps(const SnakeVecEnv* env, int index)
+{
+    return isValidIndex(env, index) ? env->vecEnv->getLastEpisodeSteps(index) : -1;
+}
@@ -0,0 +1,387 @@
+#include "story_index.h"
+
+#include <cstring>
+
+namespace
+{
+    bool startsWith(const char* begin, const char* end, const char* prefix)
+    {
+        size_t length = std::strlen(prefix);
+        return static_cast<size_t>(end - begin) >= length && std::memcmp(begin, prefix, length) == 0;
+    }
+
+    bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // 以 [ 开头、以 ] 结尾的整行标记，或 [标签]: 开头的行（如 [Animation]: ...）
+    bool isMarker(const char* begin, const char* end)
+    {
+        if (*begin != '[')
+        {
+            return false;
+        }
+        if (end[-1] == ']')
+        {
+            return true;
+        }
+        const char* close = static_cast<const char*>(std::memchr(begin, ']', end - begin));
+        return close != nullptr && close + 1 < end && close[1] == ':';
+    }
+
+    // UTF-8 字符数（不计后续字节）
+    size_t charCount(const std::string& text)
+    {
+        size_t count = 0;
+        for (unsigned char c : text)
+        {
+            if ((c & 0xC0) != 0x80)
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // 章节标题行对应的章节号，不是标题行时返回 -1
+    int sectionOf(const char* begin, const char* end)
+    {
+        if (startsWith(begin, end, "Prologue:"))
+        {
+            return StoryIndex::kPrologue;
+        }
+        if (startsWith(begin, end, "Epilogue:"))
+        {
+            return StoryIndex::kEpilogue;
+        }
+        if (startsWith(begin, end, "Final Level:"))
+        {
+            return 5;
+        }
+        if (startsWith(begin, end, "Level ") && end - begin > 7 && begin[6] >= '1' && begin[6] <= '5' && begin[7] == ':')
+        {
+            return begin[6] - '0';
+        }
+        return -1;
+    }
+}
+
+StoryIndex& StoryIndex::shared()
+{
+    static StoryIndex index;
+    return index;
+}
+
+StoryIndex::StoryIndex()
+{
+}
+
+bool StoryIndex::open(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFile.data() != nullptr)
+    {
+        return true;
+    }
+    if (!mFile.open(path, mLastError))
+    {
+        return false;
+    }
+    buildIndex();
+    return true;
+}
+
+bool StoryIndex::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFile.data() != nullptr;
+}
+
+std::string StoryIndex::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLastError;
+}
+
+std::string StoryIndex::title(int section) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (section < 0 || section >= static_cast<int>(mSections.size()))
+    {
+        return std::string();
+    }
+    return text(mSections[section].titleOffset, mSections[section].titleLength);
+}
+
+size_t StoryIndex::paragraphCount(int section) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (section < 0 || section >= static_cast<int>(mSections.size()))
+    {
+        return 0;
+    }
+    return mSections[section].paragraphs.size();
+}
+
+std::string StoryIndex::paragraph(int section, size_t index) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (section < 0 || section >= static_cast<int>(mSections.size()) || index >= mSections[section].paragraphs.size())
+    {
+        return std::string();
+    }
+    const Paragraph& paragraph = mSections[section].paragraphs[index];
+    return paragraphText(paragraph);
+}
+
+std::vector<std::string> StoryIndex::paragraphs(int section, Part part, int branch) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<std::string> result;
+    if (section < 0 || section >= static_cast<int>(mSections.size()))
+    {
+        return result;
+    }
+    for (const Paragraph& paragraph : mSections[section].paragraphs)
+    {
+        if (selected(paragraph, part, branch))
+        {
+            result.push_back(paragraphText(paragraph));
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<std::string>> StoryIndex::layout(int section, Part part, int branch, int width)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto key = std::make_tuple(section, static_cast<int>(part), branch, width);
+    auto found = mLayouts.find(key);
+    if (found != mLayouts.end())
+    {
+        return found->second;
+    }
+
+    std::vector<std::vector<std::string>> lines;
+    if (section >= 0 && section < static_cast<int>(mSections.size()))
+    {
+        for (const Paragraph& paragraph : mSections[section].paragraphs)
+        {
+            if (selected(paragraph, part, branch))
+            {
+                lines.push_back(wrapText(paragraphText(paragraph), width));
+            }
+        }
+    }
+    mLayouts[key] = lines;
+    return lines;
+}
+
+std::vector<std::string> StoryIndex::wrapText(const std::string& text, int width)
+{
+    std::vector<std::string> lines;
+    const size_t maxWidth = width > 0 ? static_cast<size_t>(width) : 1;
+    std::string currentLine;
+    size_t currentWidth = 0;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+        {
+            pos++;
+        }
+        size_t wordEnd = pos;
+        while (wordEnd < text.size() && text[wordEnd] != ' ' && text[wordEnd] != '\t')
+        {
+            wordEnd++;
+        }
+        if (wordEnd == pos)
+        {
+            break;
+        }
+        std::string word = text.substr(pos, wordEnd - pos);
+        size_t wordWidth = charCount(word);
+        pos = wordEnd;
+
+        // 加上这个词会超出宽度时另起一行
+        if (!currentLine.empty() && currentWidth + 1 + wordWidth > maxWidth)
+        {
+            lines.push_back(currentLine);
+            currentLine.clear();
+            currentWidth = 0;
+        }
+        // 单词本身比一行还长时按字符断开，不拆开多字节字符
+        while (currentLine.empty() && wordWidth > maxWidth)
+        {
+            size_t cut = 0;
+            for (size_t chars = 0; cut < word.size() && chars < maxWidth; chars++)
+            {
+                cut++;
+                while (cut < word.size() && (static_cast<unsigned char>(word[cut]) & 0xC0) == 0x80)
+                {
+                    cut++;
+                }
+            }
+            lines.push_back(word.substr(0, cut));
+            word.erase(0, cut);
+            wordWidth -= maxWidth;
+        }
+        if (!currentLine.empty())
+        {
+            currentLine += ' ';
+            currentWidth++;
+        }
+        currentLine += word;
+        currentWidth += wordWidth;
+    }
+    if (!currentLine.empty() || lines.empty())
+    {
+        lines.push_back(currentLine);
+    }
+    return lines;
+}
+
+void StoryIndex::buildIndex()
+{
+    mSections.assign(kSectionCount, Section());
+    mLayouts.clear();
+
+    const char* base = reinterpret_cast<const char*>(mFile.data());
+    const char* end = base + mFile.size();
+    int section = -1;
+    Part part = Part::Intro;
+    int branch = 0;
+    int branchCount = 0;
+    bool inText = false;
+
+    const char* lineStart = base;
+    while (lineStart < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', end - lineStart));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+
+        // 去掉首尾空白和行尾的 \r
+        const char* first = lineStart;
+        const char* last = lineEnd;
+        while (first < last && isBlank(*first))
+        {
+            first++;
+        }
+        while (last > first && isBlank(last[-1]))
+        {
+            last--;
+        }
+        lineStart = next;
+        if (first == last)
+        {
+            continue;
+        }
+
+        int heading = sectionOf(first, last);
+        if (heading >= 0)
+        {
+            section = heading;
+            part = Part::Intro;
+            branch = 0;
+            branchCount = 0;
+            inText = false;
+            const char* title = static_cast<const char*>(std::memchr(first, ':', last - first)) + 1;
+            while (title < last && isBlank(*title))
+            {
+                title++;
+            }
+            mSections[section].titleOffset = static_cast<uint32_t>(title - base);
+            mSections[section].titleLength = static_cast<uint32_t>(last - title);
+            continue;
+        }
+        if (section < 0)
+        {
+            continue;
+        }
+
+        if (startsWith(first, last, "[Text]:") || startsWith(first, last, "[Scene]:"))
+        {
+            inText = true;
+            continue;
+        }
+        if (startsWith(first, last, "[Item Acquired]:"))
+        {
+            // 获得物品单独成段，只记下物品名，去掉全角括号【】，显示时换成ASCII格式
+            const char* name = first + std::strlen("[Item Acquired]:");
+            const char* nameEnd = last;
+            while (name < nameEnd && isBlank(*name))
+            {
+                name++;
+            }
+            if (startsWith(name, nameEnd, "\xE3\x80\x90"))
+            {
+                name += 3;
+            }
+            if (nameEnd - name >= 3 && std::memcmp(nameEnd - 3, "\xE3\x80\x91", 3) == 0)
+            {
+                nameEnd -= 3;
+            }
+            Paragraph paragraph;
+            paragraph.offset = static_cast<uint32_t>(name - base);
+            paragraph.length = static_cast<uint32_t>(nameEnd - name);
+            paragraph.part = part;
+            paragraph.branch = branch;
+            paragraph.item = true;
+            mSections[section].paragraphs.push_back(paragraph);
+            inText = false;
+            continue;
+        }
+        if (isMarker(first, last))
+        {
+            // 其余标记行（包括 [Animation]: 这类舞台说明）结束当前文字块，同时决定后面的段落属于哪一部分、哪个分支
+            if (startsWith(first, last, "[After the level") || startsWith(first, last, "[After the boss"))
+            {
+                part = Part::Outro;
+            }
+            else if (startsWith(first, last, "[If "))
+            {
+                branch = ++branchCount;
+            }
+            else if (startsWith(first, last, "[Common"))
+            {
+                branch = 0;
+            }
+            inText = false;
+            continue;
+        }
+        if (inText)
+        {
+            Paragraph paragraph;
+            paragraph.offset = static_cast<uint32_t>(first - base);
+            paragraph.length = static_cast<uint32_t>(last - first);
+            paragraph.part = part;
+            paragraph.branch = branch;
+            paragraph.item = false;
+            mSections[section].paragraphs.push_back(paragraph);
+        }
+    }
+}
+
+bool StoryIndex::selected(const Paragraph& paragraph, Part part, int branch) const
+{
+    return paragraph.part == part && (branch == kAllBranches || paragraph.branch == 0 || paragraph.branch == branch);
+}
+
+std::string StoryIndex::text(uint32_t offset, uint32_t length) const
+{
+    return std::string(reinterpret_cast<const char*>(mFile.data()) + offset, length);
+}
+
+std::string StoryIndex::paragraphText(const Paragraph& paragraph) const
+{
+    if (paragraph.item)
+    {
+        return "[Item Acquired]: *" + text(paragraph.offset, paragraph.length) + "*";
+    }
+    return text(paragraph.offset, paragraph.length);
+}
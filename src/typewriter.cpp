@@ -0,0 +1,69 @@
+#include "typewriter.h"
+
+void TypewriterPage::layoutCentered(const std::vector<std::string>& lines, int firstRow, int width, int minCol)
+{
+    mGlyphs.clear();
+    size_t total = 0;
+    for (const std::string& line : lines)
+    {
+        total += line.length();
+    }
+    mGlyphs.reserve(total);
+
+    for (size_t lineIdx = 0; lineIdx < lines.size(); lineIdx++)
+    {
+        const std::string& line = lines[lineIdx];
+        // 计算当前行的水平居中位置
+        int startCol = (width - static_cast<int>(line.length())) / 2;
+        if (startCol < minCol)
+        {
+            startCol = minCol;
+        }
+        for (size_t j = 0; j < line.length(); j++)
+        {
+            TypewriterGlyph glyph;
+            glyph.row = firstRow + static_cast<int>(lineIdx);
+            glyph.col = startCol + static_cast<int>(j);
+            glyph.ch = line[j];
+            mGlyphs.push_back(glyph);
+        }
+    }
+}
+
+TypewriterClock::TypewriterClock(int msPerGlyph)
+    : mPerGlyph(std::chrono::milliseconds(msPerGlyph > 0 ? msPerGlyph : 1))
+{
+}
+
+void TypewriterClock::start(size_t glyphCount, Clock::time_point now)
+{
+    mGlyphCount = glyphCount;
+    mStart = now;
+    mFinished = false;
+}
+
+void TypewriterClock::finish()
+{
+    mFinished = true;
+}
+
+size_t TypewriterClock::revealedAt(Clock::time_point now) const
+{
+    if (mFinished)
+    {
+        return mGlyphCount;
+    }
+    if (now < mStart)
+    {
+        return 0;
+    }
+    // 第一个字形在开始后立即出现，与原来“先画再等待”的节奏一致
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - mStart);
+    const size_t revealed = static_cast<size_t>(elapsed / mPerGlyph) + 1;
+    return revealed < mGlyphCount ? revealed : mGlyphCount;
+}
+
+bool TypewriterClock::isFinished(Clock::time_point now) const
+{
+    return revealedAt(now) >= mGlyphCount;
+}
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include "vec_env.h"
+
+VecEnv::VecEnv(const VecEnvConfig& config) : mConfig(config)
+{
+    mConfig.numEnvs = std::max(1, mConfig.numEnvs);
+
+    mEnvs.reserve(mConfig.numEnvs);
+    for (int i = 0; i < mConfig.numEnvs; i++)
+    {
+        SnakeEnvConfig envConfig = mConfig.env;
+        // 每局独立的随机种子，避免各局走出同样的序列
+        envConfig.seed = mConfig.env.seed * 2654435761u + static_cast<unsigned int>(i) * 40503u + 1u;
+        if (envConfig.seed == 0)
+        {
+            envConfig.seed = 1;
+        }
+        mEnvs.emplace_back(new SnakeEnv(envConfig));
+    }
+    mLastPoints.assign(mConfig.numEnvs, 0);
+    mLastLength.assign(mConfig.numEnvs, 0);
+    mLastSteps.assign(mConfig.numEnvs, 0);
+
+    startWorkers();
+}
+
+VecEnv::~VecEnv()
+{
+    stopWorkers();
+}
+
+void VecEnv::reset(uint8_t* observations)
+{
+    mJobReset = true;
+    mJobActions = nullptr;
+    mJobObservations = observations;
+    mJobRewards = nullptr;
+    mJobDones = nullptr;
+    mJobTruncated = nullptr;
+    runAll();
+}
+
+void VecEnv::step(const int* actions, uint8_t* observations, float* rewards, uint8_t* dones, uint8_t* truncated)
+{
+    mJobReset = false;
+    mJobActions = actions;
+    mJobObservations = observations;
+    mJobRewards = rewards;
+    mJobDones = dones;
+    mJobTruncated = truncated;
+    runAll();
+}
+
+void VecEnv::runRange(int begin, int end)
+{
+    const size_t observationSize = static_cast<size_t>(getObservationSize());
+    for (int i = begin; i < end; i++)
+    {
+        SnakeEnv& env = *mEnvs[i];
+        if (mJobReset)
+        {
+            env.reset();
+        }
+        else
+        {
+            float reward = env.step(mJobActions != nullptr ? mJobActions[i] : static_cast<int>(EnvAction::Keep));
+            const bool done = env.isDone();
+            if (mJobRewards != nullptr)
+            {
+                mJobRewards[i] = reward;
+            }
+            if (mJobDones != nullptr)
+            {
+                mJobDones[i] = done ? 1 : 0;
+            }
+            if (mJobTruncated != nullptr)
+            {
+                mJobTruncated[i] = env.isTruncated() ? 1 : 0;
+            }
+            if (done)
+            {
+                mLastPoints[i] = env.getPoints();
+                mLastLength[i] = env.getLength();
+                mLastSteps[i] = env.getSteps();
+                env.reset();
+            }
+        }
+        if (mJobObservations != nullptr)
+        {
+            // 每局只写自己的那一段，线程之间没有共享的写入
+            env.writeObservation(mJobObservations + observationSize * i);
+        }
+    }
+}
+
+void VecEnv::runAll()
+{
+    const int count = getNumEnvs();
+    if (mWorkers.empty())
+    {
+        runRange(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mPoolMutex);
+        mPoolPending = static_cast<int>(mWorkers.size());
+        mPoolGeneration++;
+    }
+    mPoolStart.notify_all();
+
+    // 主线程负责第0段
+    runRange(0, count / mThreadCount);
+
+    std::unique_lock<std::mutex> lock(mPoolMutex);
+    mPoolDone.wait(lock, [this] { return mPoolPending == 0; });
+}
+
+void VecEnv::startWorkers()
+{
+    int threads = mConfig.numThreads;
+    if (threads <= 0)
+    {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    // 线程数不超过局数
+    mThreadCount = std::max(1, std::min(threads, getNumEnvs()));
+
+    mPoolStop = false;
+    mPoolGeneration = 0;
+    for (int i = 1; i < mThreadCount; i++)
+    {
+        mWorkers.emplace_back(&VecEnv::workerLoop, this, i);
+    }
+}
+
+void VecEnv::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mPoolMutex);
+        mPoolStop = true;
+    }
+    mPoolStart.notify_all();
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+    mWorkers.clear();
+    mThreadCount = 1;
+}
+
+void VecEnv::workerLoop(int index)
+{
+    long long seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mPoolMutex);
+            mPoolStart.wait(lock, [this, seen] { return mPoolStop || mPoolGeneration != seen; });
+            if (mPoolStop)
+            {
+                return;
+            }
+            seen = mPoolGeneration;
+        }
+
+        const int count = getNumEnvs();
+        runRange(count * index / mThreadCount, count * (index + 1) / mThreadCount);
+
+        std::lock_guard<std::mutex> lock(mPoolMutex);
+        if (--mPoolPending == 0)
+        {
+            mPoolDone.notify_one();
+        }
+    }
+}
+
+int VecEnv::getNumEnvs() const
+{
+    return static_cast<int>(mEnvs.size());
+}
+
+int VecEnv::getThreadCount() const
+{
+    return mThreadCount;
+}
+
+int VecEnv::getChannelCount() const
+{
+    return static_cast<int>(EnvChannel::Count);
+}
+
+int VecEnv::getWidth() const
+{
+    return mEnvs.front()->getWidth();
+}
+
+int VecEnv::getHeight() const
+{
+    return mEnvs.front()->getHeight();
+}
+
+int VecEnv::getObservationSize() const
+{
+    return mEnvs.front()->getObservationSize();
+}
+
+int VecEnv::getLastEpisodePoints(int index) const
+{
+    return mLastPoints[index];
+}
+
+int VecEnv::getLastEpisodeLength(int index) const
+{
+    return mLastLength[index];
+}
+
+int VecEnv::getLastEpisodeSteps(int index) const
+{
+    return mLastSteps[index];
+}
+
+const SnakeEnv& VecEnv::getEnv(int index) const
+{
+    return *mEnvs[index];
+}
@@ -0,0 +1,78 @@
+// LeaderboardStore 日志丢失后的恢复测试：成绩合并进索引后删掉 leaderboard.log，
+// 再写一条新成绩并模拟崩溃（不析构，成绩只在日志里），重新打开后新成绩必须还在。
+// 日志序号如果从1重新开始，新成绩的序号不大于索引的 appliedSeq，重放时会被当成已合并而丢掉。
+//
+// 用法: ./leaderboard_store_test
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "leaderboard_store.h"
+
+namespace
+{
+    int gFailures = 0;
+
+    void expect(bool condition, const char* what)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED: %s\n", what);
+            gFailures++;
+        }
+    }
+
+    LeaderboardEntry makeEntry(int32_t score, int64_t timestamp)
+    {
+        LeaderboardEntry entry;
+        entry.score = score;
+        entry.length = 3;
+        entry.durationMs = 1000;
+        entry.timestamp = timestamp;
+        return entry;
+    }
+}
+
+int main()
+{
+    char pattern[] = "/tmp/leaderboard_store_test.XXXXXX";
+    if (::mkdtemp(pattern) == nullptr)
+    {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    const std::string directory = pattern;
+    LeaderboardKey key;
+    key.mode = 1;
+    key.map = "default";
+
+    {
+        // 两条成绩合并进索引，索引的 appliedSeq 为2，日志清空
+        LeaderboardStore store(directory);
+        expect(store.open(), "first open");
+        expect(store.insert(key, makeEntry(30, 1)), "insert 30");
+        expect(store.insert(key, makeEntry(20, 2)), "insert 20");
+        expect(store.flush(), "flush");
+    }
+
+    std::filesystem::remove(directory + "/leaderboard.log");
+
+    // 模拟崩溃：不析构，新成绩只在日志里，没有合并进索引
+    LeaderboardStore* crashed = new LeaderboardStore(directory);
+    expect(crashed->open(), "open without log");
+    expect(crashed->insert(key, makeEntry(25, 3)), "insert after log loss");
+    expect(crashed->size(key) == 3, "new score visible before reopen");
+
+    {
+        LeaderboardStore store(directory);
+        expect(store.open(), "reopen");
+        expect(store.size(key) == 3, "new score replayed after reopen");
+        const std::vector<LeaderboardEntry> top = store.topK(key, 3);
+        expect(top.size() == 3 && top[0].score == 30 && top[1].score == 25 && top[2].score == 20,
+               "ranking after reopen");
+    }
+
+    std::filesystem::remove_all(directory);
+    std::printf("leaderboard_store_test: %s\n", gFailures == 0 ? "ok" : "FAILED");
+    return gFailures == 0 ? 0 : 1;
+}
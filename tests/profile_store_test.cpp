@@ -0,0 +1,71 @@
+// ProfileStore 日志丢失后的恢复测试：事务写进快照后删掉 profile.wal，
+// 再提交新事务并模拟崩溃（不析构，事务只在日志里），重新打开后金币和关卡进度必须是新值。
+// 日志序号如果从1重新开始，新事务的序号不大于快照的 appliedSeq，重放时会被当成已应用而跳过。
+//
+// 用法: ./profile_store_test
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include "profile_store.h"
+
+namespace
+{
+    int gFailures = 0;
+
+    void expect(bool condition, const char* what)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED: %s\n", what);
+            gFailures++;
+        }
+    }
+}
+
+int main()
+{
+    char pattern[] = "/tmp/profile_store_test.XXXXXX";
+    if (::mkdtemp(pattern) == nullptr)
+    {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    const std::string directory = pattern;
+
+    {
+        // 三个事务写进快照，快照的 appliedSeq 为3，日志清空
+        ProfileStore store(directory);
+        expect(store.open(), "first open");
+        for (int level = 1; level <= 3; level++)
+        {
+            ProfileStore::Transaction transaction;
+            transaction.add(ProfileKeys::kCoins, 100);
+            transaction.set(ProfileKeys::level(level), 2);
+            expect(store.commit(transaction), "commit before checkpoint");
+        }
+        expect(store.checkpoint(), "checkpoint");
+    }
+
+    std::filesystem::remove(directory + "/profile.wal");
+
+    // 模拟崩溃：不析构，新事务只在日志里，没有写进快照
+    ProfileStore* crashed = new ProfileStore(directory);
+    expect(crashed->open(), "open without log");
+    expect(crashed->get(ProfileKeys::kCoins) == 300, "coins from snapshot");
+    ProfileStore::Transaction transaction;
+    transaction.add(ProfileKeys::kCoins, 50);
+    transaction.set(ProfileKeys::level(4), 1);
+    expect(crashed->commit(transaction), "commit after log loss");
+
+    {
+        ProfileStore store(directory);
+        expect(store.open(), "reopen");
+        expect(store.get(ProfileKeys::kCoins) == 350, "coins replayed after reopen");
+        expect(store.get(ProfileKeys::level(4)) == 1, "level progress replayed after reopen");
+    }
+
+    std::filesystem::remove_all(directory);
+    std::printf("profile_store_test: %s\n", gFailures == 0 ? "ok" : "FAILED");
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// SnakePopulation::advanceHeads 的一致性测试：在随机生成的地图上，把蛇头依次放在每个格子、
+// 朝四个方向，分别用AVX2内核、标量内核和单条 Snake（createNewHead + checkCollision）
+// 计算下一步的蛇头位置和是否撞墙/越界，逐格比较三者的结果。
+//
+// 用法: ./snake_population_test [--boards N] [--seed S]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "map.h"
+#include "snake.h"
+#include "snake_population.h"
+
+namespace
+{
+    const Direction kDirections[] = {Direction::Left, Direction::Right, Direction::Up, Direction::Down};
+
+    uint32_t nextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    struct HeadResult
+    {
+        int x;
+        int y;
+        bool blocked;
+    };
+
+    // 参考结果：单条蛇只有一节，先让蛇头前进一格，再用 Snake 自己的碰撞检查
+    HeadResult referenceHead(Snake& snake, int x, int y, Direction direction)
+    {
+        std::vector<SnakeBody>& body = snake.getSnake();
+        body.assign(1, SnakeBody(x, y));
+        // changeDirection 不允许直接掉头，先转到垂直方向
+        if (!snake.changeDirection(direction))
+        {
+            snake.changeDirection(direction == Direction::Left || direction == Direction::Right ? Direction::Up
+                                                                                                : Direction::Left);
+            snake.changeDirection(direction);
+        }
+        const SnakeBody next = snake.createNewHead();
+        body[0] = next;
+        return {next.getX(), next.getY(), snake.checkCollision()};
+    }
+
+    // 返回不一致的格子数
+    int checkBoard(uint32_t& rng, int board)
+    {
+        const int width = 3 + static_cast<int>(nextRandom(rng) % 70);
+        const int height = 3 + static_cast<int>(nextRandom(rng) % 40);
+        const int wallPercent = static_cast<int>(nextRandom(rng) % 50);
+
+        Map map(width, height);
+        // gather 一次读4字节，末尾留出填充
+        std::vector<uint8_t> walls(static_cast<size_t>(width) * height + 4, 0);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                const bool wall = static_cast<int>(nextRandom(rng) % 100) < wallPercent;
+                map.setTile(x, y, wall ? TileType::Wall : TileType::Empty);
+                walls[y * width + x] = map.isWall(x, y) ? 1 : 0;
+            }
+        }
+
+        // 每个格子、每个方向一条蛇；数量通常不是8的倍数，标量收尾部分也会被覆盖
+        const int count = width * height * 4;
+        SnakePopulation simd;
+        SnakePopulation scalar;
+        simd.reset(count, width, height);
+        scalar.reset(count, width, height);
+        simd.setUseSimd(true);
+        scalar.setUseSimd(false);
+        for (int cell = 0; cell < width * height; cell++)
+        {
+            for (int d = 0; d < 4; d++)
+            {
+                simd.place(cell * 4 + d, &cell, 1, kDirections[d]);
+                scalar.place(cell * 4 + d, &cell, 1, kDirections[d]);
+            }
+        }
+        simd.advanceHeads(walls.data());
+        scalar.advanceHeads(walls.data());
+
+        Snake snake(width, height, 1);
+        snake.setMap(&map);
+
+        int mismatches = 0;
+        for (int id = 0; id < count; id++)
+        {
+            const int cell = id / 4;
+            const HeadResult expected = referenceHead(snake, cell % width, cell / width, kDirections[id % 4]);
+            const HeadResult fromSimd = {simd.getNextX()[id], simd.getNextY()[id], simd.getBlocked()[id] != 0};
+            const HeadResult fromScalar = {scalar.getNextX()[id], scalar.getNextY()[id], scalar.getBlocked()[id] != 0};
+            for (const HeadResult* actual : {&fromSimd, &fromScalar})
+            {
+                if (actual->x != expected.x || actual->y != expected.y || actual->blocked != expected.blocked)
+                {
+                    if (mismatches < 10)
+                    {
+                        std::printf("board %d (%dx%d) cell (%d,%d) dir %d %s: got (%d,%d,%d), Snake (%d,%d,%d)\n",
+                                    board, width, height, cell % width, cell / width, id % 4,
+                                    actual == &fromSimd ? "avx2" : "scalar", actual->x, actual->y,
+                                    actual->blocked, expected.x, expected.y, expected.blocked);
+                    }
+                    mismatches++;
+                }
+            }
+        }
+        return mismatches;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int boards = 200;
+    uint32_t seed = 20261019;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--boards") == 0 && i + 1 < argc)
+        {
+            boards = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)) | 1u;
+        }
+        else
+        {
+            std::printf("usage: %s [--boards N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!SnakePopulation::isSimdAvailable())
+    {
+        // 没有AVX2时两条路径都是标量实现，仍然和 Snake 比较
+        std::printf("AVX2 not available, comparing the scalar kernel only\n");
+    }
+
+    uint32_t rng = seed;
+    int mismatches = 0;
+    for (int board = 0; board < boards; board++)
+    {
+        mismatches += checkBoard(rng, board);
+    }
+    std::printf("snake_population_test: %d boards, %d mismatches\n", boards, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
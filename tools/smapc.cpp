@@ -0,0 +1,72 @@
+// 地图编译器：把文本地图转换成可以直接mmap加载的 .smap 文件
+//
+// 用法: ./smapc input.txt [-o output.smap]
+//       ./smapc a.txt b.txt ...          每个输出写到同名的 .smap
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "map.h"
+
+namespace
+{
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr, "usage: %s input.txt [-o output.smap]\n", program);
+        std::fprintf(stderr, "       %s input1.txt input2.txt ...\n", program);
+    }
+
+    bool compileMap(const std::string& input, const std::string& output)
+    {
+        Map map(1, 1);
+        if (!map.loadTextMap(input))
+        {
+            // 错误信息已带 文件:行:列 位置
+            std::fprintf(stderr, "smapc: %s\n", map.getLastError().c_str());
+            return false;
+        }
+        if (!map.saveCompiledMap(output))
+        {
+            std::fprintf(stderr, "smapc: cannot write %s\n", output.c_str());
+            return false;
+        }
+        std::printf("%s -> %s (%dx%d, %d free cells)\n", input.c_str(), output.c_str(),
+                    map.getWidth(), map.getHeight(), map.getFreeCellCount());
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> inputs;
+    std::string output;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (argv[i][0] == '-')
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            inputs.push_back(argv[i]);
+        }
+    }
+
+    if (inputs.empty() || (!output.empty() && inputs.size() != 1))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    bool ok = true;
+    for (const std::string& input : inputs)
+    {
+        ok = compileMap(input, output.empty() ? Map::compiledMapPath(input) : output) && ok;
+    }
+    return ok ? 0 : 1;
+}